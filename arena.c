@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_ALIGN 16
+#define ARENA_HEADER ((sizeof(ArenaBlock) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+static char* block_data(ArenaBlock* b) {
+    return (char*)b + ARENA_HEADER;
+}
+
+static ArenaBlock* new_block(size_t cap) {
+    ArenaBlock* b = (ArenaBlock*)malloc(ARENA_HEADER + cap);
+    if (!b) {
+        printf("Error:: out of memory in arena\n");
+        exit(1);
+    }
+    b->next = NULL;
+    b->used = 0;
+    b->cap = cap;
+    return b;
+}
+
+void arena_init(Arena* a, size_t block_size) {
+    a->head = NULL;
+    a->current = NULL;
+    a->block_size = block_size ? block_size : ARENA_DEFAULT_BLOCK;
+    a->allocations = 0;
+}
+
+void* arena_alloc(Arena* a, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (a->block_size == 0) a->block_size = ARENA_DEFAULT_BLOCK;
+
+    ArenaBlock* b = a->current;
+    // move on through blocks kept from before a reset, then grow the chain
+    while (!b || b->used + size > b->cap) {
+        ArenaBlock* next = b ? b->next : a->head;
+        if (next && next->cap >= size) {
+            next->used = 0;
+            b = next;
+            continue;
+        }
+        ArenaBlock* fresh = new_block(size > a->block_size ? size : a->block_size);
+        if (!b) {
+            fresh->next = a->head;
+            a->head = fresh;
+        } else {
+            fresh->next = b->next;
+            b->next = fresh;
+        }
+        b = fresh;
+    }
+    a->current = b;
+
+    void* p = block_data(b) + b->used;
+    b->used += size;
+    a->allocations++;
+    memset(p, 0, size);
+    return p;
+}
+
+void arena_reset(Arena* a) {
+    a->current = a->head;
+    if (a->head) a->head->used = 0;
+    a->allocations = 0;
+}
+
+void arena_free(Arena* a) {
+    ArenaBlock* b = a->head;
+    while (b) {
+        ArenaBlock* next = b->next;
+        free(b);
+        b = next;
+    }
+    a->head = NULL;
+    a->current = NULL;
+    a->allocations = 0;
+}
+
+// the adopted blocks go in front of the chain, where allocation never returns
+// to before a reset, so what was allocated in them stays valid
+void arena_adopt(Arena* into, Arena* from) {
+    if (!from->head) return;
+    ArenaBlock* tail = from->head;
+    while (tail->next) tail = tail->next;
+    tail->next = into->head;
+    into->head = from->head;
+    if (!into->current) into->current = from->current;
+    into->allocations += from->allocations;
+    from->head = NULL;
+    from->current = NULL;
+    from->allocations = 0;
+}
+
+size_t arena_bytes(const Arena* a) {
+    size_t total = 0;
+    for (ArenaBlock* b = a->head; b; b = b->next) total += b->cap;
+    return total;
+}
@@ -0,0 +1,30 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// bump allocator: many small allocations, one release ======================
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t used;
+    size_t cap;
+    // data follows, 16-byte aligned
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock* head;       // first block, kept across resets
+    ArenaBlock* current;    // block allocations come from
+    size_t block_size;
+    size_t allocations;     // since the last reset, for statistics
+} Arena;
+
+#define ARENA_DEFAULT_BLOCK (64 * 1024)
+
+void arena_init(Arena* a, size_t block_size);
+void* arena_alloc(Arena* a, size_t size);       // zeroed, 16-byte aligned
+void arena_reset(Arena* a);                     // O(1); blocks are kept for reuse
+void arena_free(Arena* a);                      // give every block back
+size_t arena_bytes(const Arena* a);             // capacity currently held
+void arena_adopt(Arena* into, Arena* from);     // from's blocks now belong to into, from is emptied
+
+#endif
@@ -1,17 +1,92 @@
 #include "ast.h"
+#include "symbols.h"
+#include "arena.h"
+#include "compiler.h"
+#include "tree_writer.h"
+#include "ast_visit.h"
+
+const char* ast_kind_name[AST_KIND_COUNT] = {
+#define X(id, text) text,
+    AST_KINDS(X)
+#undef X
+};
+
+// small open addressing table over the kind names, filled on first use
+#define KIND_SLOTS 256
+static unsigned char kind_slots[KIND_SLOTS];     // kind + 1, 0 means empty
+static int kind_slots_ready = 0;
+
+static unsigned int kind_hash(const char* name) {
+    unsigned int h = 2166136261u;
+    for (; *name; name++) {
+        h ^= (unsigned char)*name;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+ASTKind ast_kind_from_name(const char* name) {
+    if (!name) return AST_UNKNOWN;
+    if (!kind_slots_ready) {
+        for (int k = 0; k < AST_KIND_COUNT; k++) {
+            unsigned int i = kind_hash(ast_kind_name[k]) & (KIND_SLOTS - 1);
+            while (kind_slots[i]) i = (i + 1) & (KIND_SLOTS - 1);
+            kind_slots[i] = (unsigned char)(k + 1);
+        }
+        kind_slots_ready = 1;
+    }
+    unsigned int i = kind_hash(name) & (KIND_SLOTS - 1);
+    while (kind_slots[i]) {
+        if (strcmp(ast_kind_name[kind_slots[i] - 1], name) == 0) return (ASTKind)(kind_slots[i] - 1);
+        i = (i + 1) & (KIND_SLOTS - 1);
+    }
+    return AST_UNKNOWN;
+}
+
+// nodes go into cc->ast_arena and are counted in cc->node_count (compiler.h);
+// parse workers fill and count their own
+static _Thread_local Arena* thread_arena = NULL;    // set on parallel parse workers
+static _Thread_local size_t* thread_count = NULL;
+
+void* ast_alloc(CompilerContext* cc, size_t size) {
+    return arena_alloc(thread_arena ? thread_arena : &cc->ast_arena, size);
+}
+
+void ast_use_arena(Arena* a, size_t* count) {
+    thread_arena = a;
+    thread_count = count;
+}
+
+void ast_adopt(CompilerContext* cc, Arena* a, size_t nodes) {
+    arena_adopt(&cc->ast_arena, a);
+    cc->node_count += nodes;
+}
+
+void ast_reset(CompilerContext* cc) {
+    arena_reset(&cc->ast_arena);
+    cc->node_count = 0;
+}
+
+void ast_release(CompilerContext* cc) {
+    arena_free(&cc->ast_arena);
+    cc->node_count = 0;
+}
+
+size_t ast_node_count(CompilerContext* cc) {
+    return cc->node_count;
+}
 
 // create new AST node with given name and lexeme =========================
-ASTNode* createNode(const char* name, const char* lexeme) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
+ASTNode* createNode(CompilerContext* cc, const char* name, const char* lexeme) {
+    ASTNode* node = (ASTNode*)ast_alloc(cc, sizeof(ASTNode));
     if (!node) return NULL;
+    if (thread_count) (*thread_count)++;
+    else cc->node_count++;
     strncpy(node->name, name, sizeof(node->name)-1);
     node->name[sizeof(node->name)-1] = '\0';
-    if (lexeme) {
-        strncpy(node->lexeme, lexeme, sizeof(node->lexeme)-1);
-        node->lexeme[sizeof(node->lexeme)-1] = '\0';
-    } else {
-        node->lexeme[0] = '\0';
-    }
+    node->kind = ast_kind_from_name(node->name);
+    node->lexeme_id = intern(cc, lexeme);
+    node->lexeme = intern_name(cc, node->lexeme_id);
     node->type = NULL;
     node->line = 0;
     node->child = NULL;
@@ -19,6 +94,15 @@ ASTNode* createNode(const char* name, const char* lexeme) {
     return node;
 }
 
+// create node for an already interned lexeme (tokens carry their id) ====
+ASTNode* createNodeWithId(CompilerContext* cc, const char* name, int lexeme_id) {
+    ASTNode* node = createNode(cc, name, NULL);
+    if (!node) return NULL;
+    node->lexeme_id = lexeme_id;
+    node->lexeme = intern_name(cc, lexeme_id);
+    return node;
+}
+
 void addChild(ASTNode* parent, ASTNode* child) {
     if (parent == NULL || child == NULL) return;
     if (parent->child == NULL)
@@ -38,82 +122,56 @@ void addSibling(ASTNode* node, ASTNode* sibling) {
     node->sibling = sibling;
 }
 
-void printAST(ASTNode* root, int level, FILE* output_file) {
-    if (root == NULL) return;
-
+// indented listing, two spaces per level; frame = the node's level
+static AstVisitResult print_pre(AstWalk* w, ASTNode* node, void* frame) {
+    FILE* output_file = (FILE*)ast_walk_user(w);
+    int level = *(int*)frame;
     for (int i = 0; i < level; i++) fprintf(output_file, "  ");
-    fprintf(output_file, "%s", root->name);
-    if (strlen(root->lexeme) > 0)
-        fprintf(output_file, " (%s)", root->lexeme);
+    fprintf(output_file, "%s", node->name);
+    if (strlen(node->lexeme) > 0)
+        fprintf(output_file, " (%s)", node->lexeme);
     fprintf(output_file, "\n");
-
-    printAST(root->child, level + 1, output_file);
-    printAST(root->sibling, level, output_file);
+    int inner = level + 1;
+    ast_walk_push_list(w, node->child, &inner);
+    return AST_VISIT_SKIP;
 }
 
-void freeAST(ASTNode* root) {
-    if (root == NULL) return;
-    freeAST(root->child);
-    freeAST(root->sibling);
-    free(root);
+// root and the siblings after it, like the recursive version did
+void printAST(ASTNode* root, int level, FILE* output_file) {
+    AstVisitor v = { print_pre, NULL, sizeof(int), output_file };
+    for (ASTNode* n = root; n; n = n->sibling) ast_walk(&v, n, &level);
 }
 
-// printing the created datastructure recursively till end
-static void printTreeRecursive(ASTNode* node, const char* prefix, int isLast, FILE* out) {
-    if (!node) return;
-    fprintf(out, "%s", prefix);
-    if (isLast) fprintf(out, "`-- "); else fprintf(out, "|-- ");
-    if (strlen(node->lexeme) > 0)
-        fprintf(out, "%s -> %s\n", node->name, node->lexeme);
-    else
-        fprintf(out, "%s\n", node->name);
-    char childPrefix[1024];
-    if (isLast)
-        snprintf(childPrefix, sizeof(childPrefix), "%s    ", prefix);
-    else
-        snprintf(childPrefix, sizeof(childPrefix), "%s|   ", prefix);
-    ASTNode* child = node->child;
-    int count = 0;
-    for (ASTNode* c = child; c; c = c->sibling) count++;
-
-    int idx = 0;
-    for (ASTNode* c = child; c; c = c->sibling) {
-        idx++;
-        printTreeRecursive(c, childPrefix, (idx == count), out);
-    }
+// nodes belong to the AST arena and go away together with ast_reset();
+// kept so callers that tear down a subtree still compile
+void freeAST(ASTNode* root) {
+    (void)root;
 }
 
-void printFormattedAST(ASTNode* root, FILE* output_file) {
+// the |-- / `-- drawing, written by tree_writer.c from a flattened copy
+void printFormattedAST(CompilerContext* cc, ASTNode* root, FILE* output_file) {
     if (!root || !output_file) return;
-    fprintf(output_file, "%s", root->name);
-    if (strlen(root->lexeme) > 0) fprintf(output_file, " -> %s", root->lexeme);
-    fprintf(output_file, "\n");
-    ASTNode* child = root->child;
-    int count = 0;
-    for (ASTNode* c = child; c; c = c->sibling) count++;
-
-    int idx = 0;
-    for (ASTNode* c = child; c; c = c->sibling) {
-        idx++;
-        printTreeRecursive(c, "", (idx == count), output_file);
-    }
+    CompactAST flat;
+    compact_init(&flat);
+    tree_write(cc, &flat, compact_from_tree(&flat, root, 0), TREE_TEXT, output_file);
+    compact_free(&flat);
 }
 
 // decide whether a node is a wrapper that can be collapsed.
 static int isWrapperNode(ASTNode* n) {
     if (!n) return 0;
-    // Common wrapper names from the grammar that don't add semantic meaning
-    const char* wrappers[] = {
-        "classOrImplOrFuncList", "classOrImplOrFunc", "funcDefList",
-        "varDeclOrStmtList", "varDeclOrStmt", "idnestList", "indiceList",
-        "arraySizeList", "fParamsTailList", "aParamsTailList", "fParams",
-        "fParamsTail", "aParams", "aParamsTail", "arithExprTail", "termTail",
-        "statmentList", "visibilitymemberDeclList", "idnestTail",
-        "idTail", "isaIdOpt", "returnType", "type"
-    };
-    int nwrap = sizeof(wrappers)/sizeof(wrappers[0]);
-    for (int i = 0; i < nwrap; ++i) if (strcmp(n->name, wrappers[i])==0) return 1;
-    return 0;
+    // Common wrapper kinds from the grammar that don't add semantic meaning
+    switch (n->kind) {
+    case AST_CLASSORIMPLORFUNCLIST: case AST_CLASSORIMPLORFUNC: case AST_FUNCDEFLIST:
+    case AST_VARDECLORSTMTLIST: case AST_VARDECLORSTMT: case AST_IDNESTLIST: case AST_INDICELIST:
+    case AST_ARRAYSIZELIST: case AST_FPARAMSTAILLIST: case AST_APARAMSTAILLIST: case AST_FPARAMS:
+    case AST_FPARAMSTAIL: case AST_APARAMS: case AST_APARAMSTAIL:
+    case AST_STATMENTLIST: case AST_VISIBILITYMEMBERDECLLIST: case AST_IDNESTTAIL:
+    case AST_IDTAIL: case AST_ISAIDOPT: case AST_RETURNTYPE: case AST_TYPE:
+        return 1;
+    default:
+        return 0;
+    }
 }
 
 // if node is with a single child, skip.
@@ -121,39 +179,24 @@ static ASTNode* collapseNode(ASTNode* n) {
     while (n && isWrapperNode(n) && n->child && n->child->sibling == NULL) n = n->child;
     return n;
 }
-static void printSimplifiedRec(ASTNode* node, const char* prefix, int isLast, FILE* output_file);
-void printSimplifiedAST(ASTNode* root, FILE* output_file) {
-    if (!root || !output_file) return;
-    fprintf(output_file, "%s\n", root->name);
-    ASTNode* child = root->child;
-    ASTNode* directChildren[128]; int dcount = 0;
-    for (ASTNode* c = child; c; c = c->sibling) directChildren[dcount++] = c;
-    for (int i = 0; i < dcount; ++i) printSimplifiedRec(directChildren[i], "", (i==dcount-1), output_file);
-}
-
-static void printSimplifiedRec(ASTNode* node, const char* prefix, int isLast, FILE* output_file) {
-    if (!node) return;
-    fprintf(output_file, "%s", prefix);
-    fprintf(output_file, isLast ? "`-- " : "|-- ");
-    if (strlen(node->lexeme) > 0) fprintf(output_file, "%s -> %s\n", node->name, node->lexeme);
-    else fprintf(output_file, "%s\n", node->name);
-
-    char childPrefix[1024];
-    snprintf(childPrefix, sizeof(childPrefix), "%s%s", prefix, (isLast ? "    " : "|   "));
-
-    ASTNode* visible[128]; int vcount = 0;
-    for (ASTNode* c = node->child; c; c = c->sibling) visible[vcount++] = c;
-    for (int i = 0; i < vcount; ++i) printSimplifiedRec(visible[i], childPrefix, (i==vcount-1), output_file);
+// nothing is collapsed any more: the same drawing as printFormattedAST
+void printSimplifiedAST(CompilerContext* cc, ASTNode* root, FILE* output_file) {
+    printFormattedAST(cc, root, output_file);
 }
 
 // decide if a node should be consider as a terminal in the detailed AST
 static int isTerminalNode(ASTNode* n) {
     if (!n) return 0;
-    if (strlen(n->lexeme) > 0) return 1;
-    const char* terminals[] = {"+","-","*","/",":=","<","<=",">",">=","<>","not","and","or","SELF","ID","intLit","floatLit","integer","float","void","PUBLIC","PRIVATE"};
-    int tcount = sizeof(terminals)/sizeof(terminals[0]);
-    for (int i = 0; i < tcount; ++i) if (strcmp(n->name, terminals[i])==0) return 1;
-    return 0;
+    if (n->lexeme[0]) return 1;
+    switch (n->kind) {
+    case AST_PLUS: case AST_MINUS: case AST_MULT: case AST_DIV: case AST_ASSIGN:
+    case AST_LT: case AST_LEQ: case AST_GT: case AST_GEQ: case AST_NEQ:
+    case AST_NOT: case AST_AND: case AST_OR: case AST_SELF: case AST_ID: case AST_INTLIT: case AST_FLOATLIT:
+    case AST_INTEGER: case AST_FLOAT: case AST_VOID: case AST_PUBLIC: case AST_PRIVATE:
+        return 1;
+    default:
+        return 0;
+    }
 }
 
 // collapse wrapper nodes but preserve a node if it is terminal or has multiple children
@@ -174,28 +217,7 @@ static ASTNode* collapseForDetailed(ASTNode* n) {
     return n;
 }
 
-// terminals are leaves.
-static void printDetailedRec(ASTNode* node, const char* prefix, int isLast, FILE* out) {
-    if (!node) return;
-    
-    fprintf(out, "%s", prefix);
-    fprintf(out, isLast ? "`-- " : "|-- ");
-    if (strlen(node->lexeme) > 0) fprintf(out, "%s -> %s\n", node->name, node->lexeme);
-    else fprintf(out, "%s\n", node->name);
-
-    char childPrefix[1024];
-    snprintf(childPrefix, sizeof(childPrefix), "%s%s", prefix, (isLast ? "    " : "|   "));
-
-    ASTNode* children[256]; int ccount = 0;
-    for (ASTNode* c = node->child; c; c = c->sibling) children[ccount++] = c;
-    for (int i = 0; i < ccount; ++i) printDetailedRec(children[i], childPrefix, (i == ccount-1), out);
-}
-
-void printDetailedAST(ASTNode* root, FILE* output_file) {
-    if (!root || !output_file) return;
-    fprintf(output_file, "%s\n", root->name);
-    
-    ASTNode* children[256]; int ccount = 0;
-    for (ASTNode* c = root->child; c; c = c->sibling) children[ccount++] = c;
-    for (int i = 0; i < ccount; ++i) printDetailedRec(children[i], "", (i==ccount-1), output_file);
+// same drawing, neither depth nor the number of children is limited
+void printDetailedAST(CompilerContext* cc, ASTNode* root, FILE* output_file) {
+    printFormattedAST(cc, root, output_file);
 }
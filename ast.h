@@ -4,14 +4,21 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "ast_kind.h"
+#include "arena.h"
 
 // forward-declare the Type struct (defined in symbol_table.h)
 typedef struct Type Type;
 
+// one compilation's state (compiler.h)
+struct CompilerContext;
+
 // AST struct data structure ==========================================
 typedef struct ASTNode {
-    char name[64];                
-    char lexeme[64];              
+    char name[64];                // only for printing; passes dispatch on kind
+    ASTKind kind;                 // set from the name when the parser creates the node
+    const char* lexeme;           // interned text, shared by every node with this spelling
+    int lexeme_id;                // interned id of lexeme, INTERN_NONE if empty
     Type* type;                
     int line;             
     struct ASTNode* child;        
@@ -19,13 +26,30 @@ typedef struct ASTNode {
 } ASTNode;
 
 // Functions for managing AST =============================================
-ASTNode* createNode(const char* name, const char* lexeme);
+ASTNode* createNode(struct CompilerContext* cc, const char* name, const char* lexeme);
+ASTNode* createNodeWithId(struct CompilerContext* cc, const char* name, int lexeme_id);
 void addChild(ASTNode* parent, ASTNode* child);
 void addSibling(ASTNode* node, ASTNode* sibling);
 void printAST(ASTNode* root, int level, FILE* output_file);
-void printFormattedAST(ASTNode* root, FILE* output_file);
-void printDetailedAST(ASTNode* root, FILE* output_file);
+void printFormattedAST(struct CompilerContext* cc, ASTNode* root, FILE* output_file);
+void printDetailedAST(struct CompilerContext* cc, ASTNode* root, FILE* output_file);
 void freeAST(ASTNode* root);
 
+// Memory for the AST ======================================================
+// every node (and the Type / dimension data hung off it by semantic analysis)
+// is carved out of one arena owned by the compilation; ast_reset drops it all
+// at once and keeps the blocks for the next compilation.
+void* ast_alloc(struct CompilerContext* cc, size_t size);
+void ast_reset(struct CompilerContext* cc);
+void ast_release(struct CompilerContext* cc);
+size_t ast_node_count(struct CompilerContext* cc);
+
+// parallel parse: a worker thread allocates from its own arena and counts
+// its nodes in *count (NULL, NULL switches back to the compilation's), and
+// once joined its blocks and node count are handed to the compilation so
+// they go away with it
+void ast_use_arena(Arena* a, size_t* count);
+void ast_adopt(struct CompilerContext* cc, Arena* a, size_t nodes);
+
 
 #endif
@@ -0,0 +1,95 @@
+#ifndef AST_KIND_H
+#define AST_KIND_H
+
+// every node name the parser produces, so a node can be tagged with a small
+// number instead of carrying its name; the text is only needed for printing
+#define AST_KINDS(X) \
+    X(AST_UNKNOWN,                  "unknown") \
+    X(AST_PROG,                     "prog") \
+    X(AST_CLASSORIMPLORFUNCLIST,    "classOrImplOrFuncList") \
+    X(AST_CLASSORIMPLORFUNC,        "classOrImplOrFunc") \
+    X(AST_CLASSDECL,                "classDecl") \
+    X(AST_ISAIDOPT,                 "isaIdOpt") \
+    X(AST_IDTAIL,                   "idTail") \
+    X(AST_IMPLDEF,                  "implDef") \
+    X(AST_FUNCDEFLIST,              "funcDefList") \
+    X(AST_FUNCDEF,                  "funcDef") \
+    X(AST_VISIBILITYMEMBERDECLLIST, "visibilitymemberDeclList") \
+    X(AST_VISIBILITY,               "visibility") \
+    X(AST_PUBLIC,                   "PUBLIC") \
+    X(AST_PRIVATE,                  "PRIVATE") \
+    X(AST_MEMBERDECL,               "memberDecl") \
+    X(AST_FUNCDECL,                 "funcDecl") \
+    X(AST_FUNCHEAD,                 "funcHead") \
+    X(AST_FUNCBODY,                 "funcBody") \
+    X(AST_FPARAMS,                  "fParams") \
+    X(AST_FPARAMSTAILLIST,          "fParamsTailList") \
+    X(AST_FPARAMSTAIL,              "fParamsTail") \
+    X(AST_RETURNTYPE,               "returnType") \
+    X(AST_TYPE,                     "type") \
+    X(AST_INTEGER,                  "integer") \
+    X(AST_FLOAT,                    "float") \
+    X(AST_VOID,                     "void") \
+    X(AST_ARRAYSIZELIST,            "arraySizeList") \
+    X(AST_ARRAYSIZE,                "arraySize") \
+    X(AST_VARDECLORSTMTLIST,        "varDeclOrStmtList") \
+    X(AST_VARDECLORSTMT,            "varDeclOrStmt") \
+    X(AST_LOCALVARDECL,             "localVarDecl") \
+    X(AST_ATTRIBUTEDECL,            "attributeDecl") \
+    X(AST_VARDECL,                  "varDecl") \
+    X(AST_STATEMENT,                "statement") \
+    X(AST_IF,                       "if") \
+    X(AST_WHILE,                    "while") \
+    X(AST_READ,                     "read") \
+    X(AST_WRITE,                    "write") \
+    X(AST_RETURN,                   "return") \
+    X(AST_STATBLOCK,                "statBlock") \
+    X(AST_STATMENTLIST,             "statmentList") \
+    X(AST_ASSIGNSTAT,               "assignStat") \
+    X(AST_ASSIGNOP,                 "assignOp") \
+    X(AST_ASSIGN,                   ":=") \
+    X(AST_EXPR,                     "expr") \
+    X(AST_RELEXPR,                  "relExpr") \
+    X(AST_LT,                       "<") \
+    X(AST_GT,                       ">") \
+    X(AST_LEQ,                      "<=") \
+    X(AST_GEQ,                      ">=") \
+    X(AST_NEQ,                      "<>") \
+    X(AST_PLUS,                     "+") \
+    X(AST_MINUS,                    "-") \
+    X(AST_MULT,                     "*") \
+    X(AST_DIV,                      "/") \
+    X(AST_NEG,                      "neg") \
+    X(AST_POS,                      "pos") \
+    X(AST_NOT,                      "not") \
+    X(AST_AND,                      "and") \
+    X(AST_OR,                       "or") \
+    X(AST_VARIABLE,                 "variable") \
+    X(AST_FUNCTIONCALL,             "functionCall") \
+    X(AST_IDNESTLIST,               "idnestList") \
+    X(AST_IDNEST,                   "idnest") \
+    X(AST_IDNESTTAIL,               "idnestTail") \
+    X(AST_IDORSELF,                 "idOrSelf") \
+    X(AST_INDICELIST,               "indiceList") \
+    X(AST_INDICE,                   "indice") \
+    X(AST_APARAMS,                  "aParams") \
+    X(AST_APARAMSTAILLIST,          "aParamsTailList") \
+    X(AST_APARAMSTAIL,              "aParamsTail") \
+    X(AST_ID,                       "ID") \
+    X(AST_SELF,                     "SELF") \
+    X(AST_INTLIT,                   "intLit") \
+    X(AST_FLOATLIT,                 "floatLit")
+
+typedef enum {
+#define X(id, text) id,
+    AST_KINDS(X)
+#undef X
+    AST_KIND_COUNT
+} ASTKind;
+
+extern const char* ast_kind_name[AST_KIND_COUNT];
+
+// AST_UNKNOWN for a name the parser never produces
+ASTKind ast_kind_from_name(const char* name);
+
+#endif
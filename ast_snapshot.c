@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast_snapshot.h"
+#include "symbols.h"
+#include "compiler.h"
+
+const char* ast_snapshot_save_path = NULL;
+
+static unsigned int kind_names_hash() {
+    unsigned int h = 2166136261u;
+    for (int k = 0; k < AST_KIND_COUNT; k++) {
+        for (const char* p = ast_kind_name[k]; ; p++) {
+            h ^= (unsigned char)*p;         // the terminator too, so names can't run together
+            h *= 16777619u;
+            if (!*p) break;
+        }
+    }
+    return h;
+}
+
+// ====== save ============================================================
+static unsigned long long pad_to_8(FILE* f, unsigned long long at) {
+    static const char zeros[8] = {0};
+    unsigned long long padded = (at + 7) & ~7ull;
+    fwrite(zeros, 1, (size_t)(padded - at), f);
+    return padded;
+}
+
+static unsigned long long write_array(FILE* f, unsigned long long* at, const void* data, size_t elem, uint32_t count) {
+    unsigned long long offset = pad_to_8(f, *at);
+    fwrite(data, elem, count, f);
+    *at = offset + (unsigned long long)elem * count;
+    return offset;
+}
+
+int ast_snapshot_save(CompilerContext* cc, const CompactAST* c, NodeRef root, const char* path) {
+    if (root == NODE_NIL || root >= c->count) return -1;
+    char tmp[1024];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* f = fopen(tmp, "wb");
+    if (!f) {
+        printf("Warning:: cannot write AST snapshot %s\n", tmp);
+        return -1;
+    }
+
+    AstSnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, AST_SNAPSHOT_MAGIC, 8);
+    h.kind_count = AST_KIND_COUNT;
+    h.kind_hash = kind_names_hash();
+    h.node_count = c->count;
+    h.root = root;
+    h.symbol_count = intern_count(cc);
+    fwrite(&h, sizeof(h), 1, f);     // rewritten below once the offsets are known
+
+    symbols_write(cc, f);
+    unsigned long long at = (unsigned long long)ftell(f);
+    h.kind_offset = write_array(f, &at, c->kind, sizeof(uint16_t), c->count);
+    h.lexeme_offset = write_array(f, &at, c->lexeme, sizeof(int32_t), c->count);
+    h.line_offset = write_array(f, &at, c->line, sizeof(int32_t), c->count);
+    h.child_offset = write_array(f, &at, c->child, sizeof(NodeRef), c->count);
+    h.sibling_offset = write_array(f, &at, c->sibling, sizeof(NodeRef), c->count);
+    h.file_size = at;
+
+    fseek(f, 0, SEEK_SET);
+    fwrite(&h, sizeof(h), 1, f);
+    int failed = ferror(f);
+    if (fclose(f) != 0 || failed) {
+        remove(tmp);
+        printf("Warning:: cannot write AST snapshot %s\n", tmp);
+        return -1;
+    }
+    remove(path);   // rename() won't replace an existing file on Windows
+    rename(tmp, path);
+    return 0;
+}
+
+// ====== load ============================================================
+static int array_fits(const AstSnapshotHeader* h, unsigned long long offset, size_t elem) {
+    return (offset & 7) == 0 && offset <= h->file_size && (h->file_size - offset) / elem >= h->node_count;
+}
+
+// every reference in the node arrays must stay inside the snapshot and the
+// links must form a tree. Saved trees are in preorder (compact_from_tree), so a
+// child or sibling always comes after its node, which rules out cycles, and no
+// node is linked twice, which rules out shared subtrees that a walk would
+// visit over and over
+static int nodes_valid(const AstSnapshot* s, int symbol_count) {
+    const CompactAST* c = &s->tree;
+    unsigned char* linked = (unsigned char*)calloc(c->count, 1);
+    if (!linked) return 0;
+    int ok = 1;
+    for (uint32_t n = 0; n < c->count && ok; n++) {
+        NodeRef refs[2] = { c->child[n], c->sibling[n] };
+        if (c->kind[n] >= AST_KIND_COUNT) ok = 0;
+        if (c->lexeme[n] < INTERN_NONE || c->lexeme[n] >= symbol_count) ok = 0;
+        for (int r = 0; r < 2 && ok; r++) {
+            if (refs[r] == NODE_NIL) continue;
+            if (refs[r] <= n || refs[r] >= c->count || linked[refs[r]]) ok = 0;
+            else linked[refs[r]] = 1;
+        }
+    }
+    free(linked);
+    return ok;
+}
+
+int ast_snapshot_open(CompilerContext* cc, AstSnapshot* snap, const char* path) {
+    memset(snap, 0, sizeof(*snap));
+    snap->root = NODE_NIL;
+    if (source_open(&snap->file, path) != 0) return -1;
+
+    const char* base = snap->file.data;
+    size_t size = snap->file.length;
+    AstSnapshotHeader h;
+    if (size < sizeof(h)) goto bad;
+    memcpy(&h, base, sizeof(h));
+    if (memcmp(h.magic, AST_SNAPSHOT_MAGIC, 8) != 0) goto bad;
+    if (h.kind_count != AST_KIND_COUNT || h.kind_hash != kind_names_hash()) goto bad;
+    if (h.file_size != size || h.node_count == 0 || h.root >= h.node_count || h.symbol_count < 0) goto bad;
+    if (!array_fits(&h, h.kind_offset, sizeof(uint16_t)) || !array_fits(&h, h.lexeme_offset, sizeof(int32_t)) ||
+        !array_fits(&h, h.line_offset, sizeof(int32_t)) || !array_fits(&h, h.child_offset, sizeof(NodeRef)) ||
+        !array_fits(&h, h.sibling_offset, sizeof(NodeRef))) goto bad;
+
+    // the arrays are used in place: the mapping is page aligned and every
+    // array starts at a multiple of 8 in the file
+    CompactAST* c = &snap->tree;
+    c->kind = (uint16_t*)(base + h.kind_offset);
+    c->lexeme = (int32_t*)(base + h.lexeme_offset);
+    c->line = (int32_t*)(base + h.line_offset);
+    c->child = (NodeRef*)(base + h.child_offset);
+    c->sibling = (NodeRef*)(base + h.sibling_offset);
+    c->origin = NULL;
+    c->count = c->cap = h.node_count;
+    if (!nodes_valid(snap, h.symbol_count)) goto bad;
+
+    // lexeme ids in the arrays are only valid if re-interning hands out the
+    // same ones: what is already interned must be a prefix of the saved table
+    size_t pos = sizeof(h);
+    if (!symbols_check(cc, base, size, &pos, h.symbol_count)) goto bad;
+    symbols_replay(cc, base, sizeof(h), h.symbol_count);
+    snap->root = h.root;
+    return 0;
+
+bad:
+    ast_snapshot_close(snap);
+    return -2;
+}
+
+void ast_snapshot_close(AstSnapshot* snap) {
+    source_close(&snap->file);
+    memset(&snap->tree, 0, sizeof(snap->tree));
+    snap->root = NODE_NIL;
+}
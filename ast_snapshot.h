@@ -0,0 +1,58 @@
+#ifndef AST_SNAPSHOT_H
+#define AST_SNAPSHOT_H
+
+#include "compact_ast.h"
+#include "source.h"
+
+// ====== syntax tree snapshots ===========================================
+// --save-ast=FILE stores the tree of a clean parse (node kinds, interned
+// lexemes with their lexer types, lines) in one relocatable file: no
+// pointers, only offsets from the start of the file. --load-ast=FILE maps it
+// and points a CompactAST straight at the node arrays in the mapping, so the
+// back end runs without lexing or parsing the source again.
+//
+// layout (native byte order, the snapshot is local to one machine):
+//   AstSnapshotHeader
+//   symbol_count x { int length; int kind; char text[length]; }   as in token_cache.c
+//   kind    u16[node_count]         each array starts 8-byte aligned
+//   lexeme  i32[node_count]         interned ids, valid once the symbols are replayed
+//   line    i32[node_count]
+//   child   u32[node_count]
+//   sibling u32[node_count]
+#define AST_SNAPSHOT_MAGIC "TMA3AST2"
+
+typedef struct {
+    char magic[8];
+    unsigned int kind_count;            // AST_KIND_COUNT when saved
+    unsigned int kind_hash;             // over the kind names, so renumbered kinds are rejected
+    unsigned int node_count;
+    unsigned int root;
+    int symbol_count;
+    unsigned int reserved;
+    unsigned long long kind_offset;
+    unsigned long long lexeme_offset;
+    unsigned long long line_offset;
+    unsigned long long child_offset;
+    unsigned long long sibling_offset;
+    unsigned long long file_size;
+} AstSnapshotHeader;
+
+typedef struct {
+    SourceBuffer file;      // the mapping the tree arrays point into
+    CompactAST tree;        // read-only view, never compact_free'd
+    NodeRef root;
+} AstSnapshot;
+
+// NULL = off (--save-ast=FILE)
+extern const char* ast_snapshot_save_path;
+
+// write every node of c (root marks the tree's root) and cc's interned
+// symbols; 0 on success
+int ast_snapshot_save(struct CompilerContext* cc, const CompactAST* c, NodeRef root, const char* path);
+
+// map path, check it, and replay its symbols into cc, which must not have
+// interned anything the snapshot disagrees with; 0 on success
+int ast_snapshot_open(struct CompilerContext* cc, AstSnapshot* snap, const char* path);
+void ast_snapshot_close(AstSnapshot* snap);
+
+#endif
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast_visit.h"
+
+typedef union {
+    void* align_p;
+    long long align_l;
+    double align_d;
+    unsigned char bytes[AST_VISIT_FRAME_MAX];
+} VisitFrame;
+
+// a node still to visit, or (post set) one whose subtree is done
+typedef struct {
+    ASTNode* node;
+    int post;
+    VisitFrame frame;
+} VisitEntry;
+
+struct AstWalk {
+    const AstVisitor* v;
+    VisitEntry* entries;
+    int depth, cap;
+    VisitFrame current;     // frame of the node in pre; entries may move while it runs
+};
+
+static void walk_push_entry(AstWalk* w, ASTNode* node, int post, const void* frame) {
+    if (w->depth == w->cap) {
+        w->cap = w->cap ? w->cap * 2 : 256;
+        w->entries = (VisitEntry*)realloc(w->entries, sizeof(VisitEntry) * w->cap);
+        if (!w->entries) {
+            printf("Error:: out of memory walking the AST\n");
+            exit(1);
+        }
+    }
+    VisitEntry* e = &w->entries[w->depth++];
+    e->node = node;
+    e->post = post;
+    memcpy(e->frame.bytes, frame, w->v->frame_size);
+}
+
+void ast_walk_push(AstWalk* w, ASTNode* node, const void* frame) {
+    if (!node) return;
+    walk_push_entry(w, node, 0, frame ? frame : (const void*)w->current.bytes);
+}
+
+void ast_walk_push_list(AstWalk* w, ASTNode* first, const void* frame) {
+    for (ASTNode* n = first; n; n = n->sibling) ast_walk_push(w, n, frame);
+}
+
+void* ast_walk_user(AstWalk* w) {
+    return w->v->user;
+}
+
+// pushes land in visiting order; the stack pops the last one first
+static void walk_reverse(AstWalk* w, int from) {
+    for (int i = from, j = w->depth - 1; i < j; i++, j--) {
+        VisitEntry t = w->entries[i];
+        w->entries[i] = w->entries[j];
+        w->entries[j] = t;
+    }
+}
+
+void ast_walk(const AstVisitor* v, ASTNode* root, const void* frame) {
+    if (!root) return;
+    if (v->frame_size > AST_VISIT_FRAME_MAX) {
+        printf("Error:: AST visitor frame of %zu bytes (at most %d)\n", v->frame_size, AST_VISIT_FRAME_MAX);
+        exit(1);
+    }
+    AstWalk w;
+    memset(&w, 0, sizeof(w));
+    w.v = v;
+    walk_push_entry(&w, root, 0, frame ? frame : (const void*)w.current.bytes);
+
+    while (w.depth > 0) {
+        VisitEntry e = w.entries[--w.depth];
+        if (e.post) {
+            v->post(&w, e.node, e.frame.bytes);
+            continue;
+        }
+
+        int post_at = -1;
+        if (v->post) {
+            post_at = w.depth;
+            walk_push_entry(&w, e.node, 1, e.frame.bytes);
+        }
+        int first = w.depth;
+        w.current = e.frame;
+        AstVisitResult r = v->pre ? v->pre(&w, e.node, w.current.bytes) : AST_VISIT_CHILDREN;
+        if (r == AST_VISIT_CHILDREN) ast_walk_push_list(&w, e.node->child, NULL);
+        if (post_at >= 0) w.entries[post_at].frame = w.current;
+        walk_reverse(&w, first);
+    }
+    free(w.entries);
+}
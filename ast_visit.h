@@ -0,0 +1,55 @@
+#ifndef AST_VISIT_H
+#define AST_VISIT_H
+
+#include <stddef.h>
+#include "ast.h"
+
+// ====== explicit-stack tree walks =======================================
+// Lists in the concrete tree are right-nested (varDeclOrStmtList holds the
+// next varDeclOrStmtList), so a pass that recurses on child or sibling needs
+// a C stack frame per list element. ast_walk keeps the pending nodes on a
+// heap-allocated stack instead: C stack use is the same for 10 statements
+// and for a million.
+//
+// Every node reached is visited once: pre runs before its subtree, post
+// (if set) after it. Each node carries frame_size bytes of pass state
+// (current class and function, whether pre entered a scope, ...). Pre gets
+// the frame its parent handed down and may change it; post sees the same
+// frame, so what pre opens post can close.
+//
+// pre decides where the walk goes below the node: AST_VISIT_CHILDREN visits
+// every child with the node's frame, AST_VISIT_SKIP only what pre queued
+// with ast_walk_push (each with its own frame). Queued nodes are visited in
+// the order they were pushed, before the children of AST_VISIT_CHILDREN,
+// and all of them before the node's post.
+typedef enum {
+    AST_VISIT_CHILDREN,
+    AST_VISIT_SKIP
+} AstVisitResult;
+
+// bytes of pass state a node can carry
+#define AST_VISIT_FRAME_MAX 32
+
+typedef struct AstWalk AstWalk;
+
+typedef struct {
+    AstVisitResult (*pre)(AstWalk* w, ASTNode* node, void* frame);    // NULL = visit children
+    void (*post)(AstWalk* w, ASTNode* node, void* frame);             // NULL = none
+    size_t frame_size;      // at most AST_VISIT_FRAME_MAX
+    void* user;             // handed to the hooks through ast_walk_user
+} AstVisitor;
+
+// walk the subtree at root (not root's siblings); frame is the root's
+// initial state, NULL for all zero
+void ast_walk(const AstVisitor* v, ASTNode* root, const void* frame);
+
+// from pre: visit node (NULL is ignored) below the current one, with frame
+// (NULL = the current node's frame as it is now)
+void ast_walk_push(AstWalk* w, ASTNode* node, const void* frame);
+
+// from pre: ast_walk_push node and each sibling after it
+void ast_walk_push_list(AstWalk* w, ASTNode* first, const void* frame);
+
+void* ast_walk_user(AstWalk* w);
+
+#endif
@@ -0,0 +1,25 @@
+# Benchmark: lexing a comment-dense source (one comment per code line)
+$inputFile = ".\bench_comments.txt"
+$lines = 20000
+
+$sb = New-Object System.Text.StringBuilder
+[void]$sb.AppendLine("func bench(x: integer) => integer {")
+[void]$sb.AppendLine("    local a: integer;")
+for ($i = 1; $i -le $lines; $i++) {
+    [void]$sb.AppendLine("    // step $i of the benchmark, a line comment")
+    [void]$sb.AppendLine("    a := a + $i; /* block $i */")
+    if ($i % 100 -eq 0) {
+        [void]$sb.AppendLine("    /* multi-line comment")
+        [void]$sb.AppendLine("       number $i */")
+    }
+}
+[void]$sb.AppendLine("    return (a);")
+[void]$sb.AppendLine("};")
+Set-Content -Path $inputFile -Value $sb.ToString()
+
+$time = Measure-Command { .\tma3.exe $inputFile > $null }
+$size = (Get-Item $inputFile).Length
+$result = "comment-dense source: $size bytes, $lines code lines, $($time.TotalMilliseconds) ms"
+$result | Out-File -FilePath ".\bench_output.txt"
+Write-Host $result
+Remove-Item $inputFile
@@ -0,0 +1,35 @@
+# Benchmark: recursive descent vs table-driven LL(1) vs LALR(1) Bison parser on a statement-heavy source
+$inputFile = ".\bench_parser.txt"
+$statements = 100000
+
+$sb = New-Object System.Text.StringBuilder
+[void]$sb.AppendLine("func bench(x: integer) => integer {")
+[void]$sb.AppendLine("    local a: integer;")
+for ($i = 1; $i -le $statements; $i++) {
+    [void]$sb.AppendLine("    a := a + $i * (x - 1);")
+}
+[void]$sb.AppendLine("    return (a);")
+[void]$sb.AppendLine("};")
+Set-Content -Path $inputFile -Value $sb.ToString()
+
+# parse only, no derivation file, so the front ends are what differs;
+# peak working set is sampled while the run goes on (it only grows)
+$size = (Get-Item $inputFile).Length
+$results = @()
+foreach ($parser in @("rd", "table", "lalr")) {
+    $watch = [System.Diagnostics.Stopwatch]::StartNew()
+    $proc = Start-Process -FilePath ".\tma3.exe" -ArgumentList "--parser=$parser", "--syntax-only", "--derivation=ring", $inputFile `
+        -RedirectStandardOutput ".\bench_parser_stdout.txt" -NoNewWindow -PassThru
+    $peak = 0
+    while (-not $proc.HasExited) {
+        $proc.Refresh()
+        try { $peak = [Math]::Max($peak, $proc.PeakWorkingSet64) } catch { }
+        Start-Sleep -Milliseconds 5
+    }
+    $watch.Stop()
+    $results += "$parser parser: $size bytes, $statements statements, $($watch.Elapsed.TotalMilliseconds) ms, peak $([Math]::Round($peak / 1MB, 1)) MB"
+}
+Remove-Item ".\bench_parser_stdout.txt"
+$results | Out-File -FilePath ".\bench_parser_output.txt"
+$results | ForEach-Object { Write-Host $_ }
+Remove-Item $inputFile
@@ -3,496 +3,333 @@
 #include <string.h>
 #include <ctype.h>
 #include "codegen.h"
+#include "lower.h"
+#include "symbols.h"
 #include "symbol_table.h"
 #include "stack.h"
 #include "isa2.h"
+#include "log.h"
+#include "compiler.h"
+#include "func_cache.h"
 
-static int temp_counter = 0;
-static int label_counter = 0;
-static char* new_temp() { char b[32]; snprintf(b,32,"t%d",++temp_counter); return strdup(b); }
-static char* new_label() { char b[32]; snprintf(b,32,"L%d",++label_counter); return strdup(b); }
-
-static char* emit_expr(ASTNode* n);
-static char* emit_term(ASTNode* n);
-static char* emit_arithExpr(ASTNode* n);
-static void emit_statements(ASTNode* n);
-
-// ================================== quadruple structures =============================
-static Quadruple* quad_list = NULL;
-static int quad_count = 0;
-static int quad_cap = 0;
+static char* new_temp(CompilerContext* cc) { char b[32]; snprintf(b,32,"t%d",++cc->temp_counter); return strdup(b); }
+static char* new_label(CompilerContext* cc) { char b[32]; snprintf(b,32,"L%d",++cc->label_counter); return strdup(b); }
 
 // stack-based variable address
-int get_var_address(const char* name) {
-    return get_variable_location(name);
+int get_var_address(CompilerContext* cc, const char* name) {
+    return get_variable_location(cc, name);
 }
 
-Quadruple* get_quad_list() { return quad_list; }
-int get_quad_count() { return quad_count; }
-
-static void emit_quad(const char* op, const char* a1, const char* a2, const char* res) {
-    if (quad_count >= quad_cap) { quad_cap = (quad_cap==0)?64:quad_cap*2; quad_list = realloc(quad_list, sizeof(Quadruple)*quad_cap); }
-    quad_list[quad_count].op = op?strdup(op):NULL;
-    quad_list[quad_count].arg1 = a1?strdup(a1):NULL;
-    quad_list[quad_count].arg2 = a2?strdup(a2):NULL;
-    quad_list[quad_count].res = res?strdup(res):NULL;
-    quad_count++;
+int get_var_address_id(CompilerContext* cc, int name_id) {
+    return get_variable_location_id(cc, name_id);
 }
 
+Quadruple* get_quad_list(CompilerContext* cc) { return cc->quad_list; }
+int get_quad_count(CompilerContext* cc) { return cc->quad_count; }
 
-static ASTNode* find_child(ASTNode* n, const char* name) {
-    if (!n) return NULL;
-    for (ASTNode* c=n->child; c; c=c->sibling) if(strcmp(c->name, name)==0) return c;
-    return NULL;
+void free_ir(CompilerContext* cc) {
+    for (int i = 0; i < cc->quad_count; i++) {
+        free(cc->quad_list[i].op);
+        free(cc->quad_list[i].arg1);
+        free(cc->quad_list[i].arg2);
+        free(cc->quad_list[i].res);
+    }
+    free(cc->quad_list);
+    cc->quad_list = NULL;
+    cc->quad_count = cc->quad_cap = 0;
 }
 
-static char* find_first_lexeme(ASTNode* root) {
-    if (!root) return NULL;
-    
-    if (root->lexeme && strlen(root->lexeme) > 0) {
-        char c = root->lexeme[0];
-        if (isalpha(c) || c == '_') { 
-             if (strcmp(root->lexeme, "if")!=0 && strcmp(root->lexeme, "while")!=0 && 
-                 strcmp(root->lexeme, "return")!=0 && strcmp(root->lexeme, "integer")!=0 &&
-                 strcmp(root->lexeme, "float")!=0 && strcmp(root->lexeme, "void")!=0 &&
-                 strcmp(root->lexeme, "func")!=0 && strcmp(root->lexeme, "class")!=0 &&
-                 strcmp(root->lexeme, "implement")!=0 && strcmp(root->lexeme, "then")!=0 &&
-                 strcmp(root->lexeme, "else")!=0) {
-                 return strdup(root->lexeme);
-             }
-        }
+void emit_quad(CompilerContext* cc, const char* op, const char* a1, const char* a2, const char* res) {
+    if (cc->quad_count >= cc->quad_cap) { cc->quad_cap = (cc->quad_cap==0)?64:cc->quad_cap*2; cc->quad_list = realloc(cc->quad_list, sizeof(Quadruple)*cc->quad_cap); }
+    cc->quad_list[cc->quad_count].op = op?strdup(op):NULL;
+    cc->quad_list[cc->quad_count].arg1 = a1?strdup(a1):NULL;
+    cc->quad_list[cc->quad_count].arg2 = a2?strdup(a2):NULL;
+    cc->quad_list[cc->quad_count].res = res?strdup(res):NULL;
+    cc->quad_list[cc->quad_count].arg1_id = intern(cc, a1);
+    cc->quad_list[cc->quad_count].arg2_id = intern(cc, a2);
+    cc->quad_list[cc->quad_count].res_id = intern(cc, res);
+    cc->quad_count++;
+}
+
+
+// ====== operand lookup on the lowered tree =====
+// first literal under n, operands in source order
+static const AbsNode* first_literal(const AbsNode* n) {
+    if (!n) return NULL;
+    switch (n->kind) {
+    case ABS_INT_LIT:
+    case ABS_FLOAT_LIT: return n;
+    case ABS_BINARY: {
+        const AbsNode* l = first_literal(n->as.binary.lhs);
+        return l ? l : first_literal(n->as.binary.rhs);
     }
-    
-    for (ASTNode* c = root->child; c; c = c->sibling) {
-        char* res = find_first_lexeme(c);
-        if (res) return res;
+    case ABS_UNARY:  return first_literal(n->as.unary.operand);
+    case ABS_MEMBER: return first_literal(n->as.member.object);
+    case ABS_INDEX: {
+        const AbsNode* l = first_literal(n->as.index.base);
+        return l ? l : first_literal(n->as.index.index);
+    }
+    case ABS_CALL: {
+        const AbsNode* l = first_literal(n->as.call.callee);
+        for (int i = 0; !l && i < n->count; i++) l = first_literal(n->items[i]);
+        return l;
+    }
+    default: return NULL;
     }
-    return NULL;
 }
 
-static char* find_literal(ASTNode* root) {
-    if (!root) return NULL;
-    if (root->lexeme && (isdigit(root->lexeme[0]) || root->lexeme[0] == '-')) return strdup(root->lexeme);
-    for (ASTNode* c = root->child; c; c = c->sibling) {
-        char* res = find_literal(c);
-        if (res) return res;
+// first name under n (self included), operands in source order
+static int first_name(const AbsNode* n) {
+    if (!n) return INTERN_NONE;
+    int id = INTERN_NONE;
+    switch (n->kind) {
+    case ABS_NAME:
+    case ABS_SELF:   return n->name;
+    case ABS_MEMBER:
+        id = first_name(n->as.member.object);
+        return id != INTERN_NONE ? id : n->name;
+    case ABS_BINARY:
+        id = first_name(n->as.binary.lhs);
+        return id != INTERN_NONE ? id : first_name(n->as.binary.rhs);
+    case ABS_UNARY:  return first_name(n->as.unary.operand);
+    case ABS_INDEX:
+        id = first_name(n->as.index.base);
+        return id != INTERN_NONE ? id : first_name(n->as.index.index);
+    case ABS_CALL:
+        id = first_name(n->as.call.callee);
+        for (int i = 0; id == INTERN_NONE && i < n->count; i++) id = first_name(n->items[i]);
+        return id;
+    default:         return INTERN_NONE;
     }
-    return NULL;
 }
 
-static char* get_operator(ASTNode* opNode) {
-    if (!opNode) return strdup("+");
-    
-    if (opNode->lexeme && strlen(opNode->lexeme) > 0 && strchr("+-*/<>=", opNode->lexeme[0])) {
-        return strdup(opNode->lexeme);
+static const char* arith_op(AbsOp op) {
+    switch (op) {
+    case ABS_OP_SUB: return "-";
+    case ABS_OP_MUL:
+    case ABS_OP_DIV: return absOpText(op);
+    case ABS_OP_AND: return "*";     // no logical quads yet: and/or ride on * and +
+    default:         return "+";
     }
-    
-    for (ASTNode* c = opNode->child; c; c = c->sibling) {
-        printf("[DEBUG]   Checking child: name='%s', lexeme='%s'\n", c->name, c->lexeme ? c->lexeme : "(null)");
-        if (c->lexeme && strlen(c->lexeme) > 0 && strchr("+-*/<>=", c->lexeme[0])) {
-            printf("[DEBUG]     Found in child lexeme: '%s'\n", c->lexeme);
-            return strdup(c->lexeme);
-        }
+}
 
-        if (strcmp(c->name, "+") == 0) { printf("[DEBUG]     Found + by name\n"); return strdup("+"); }
-        if (strcmp(c->name, "-") == 0) { printf("[DEBUG]     Found - by name\n"); return strdup("-"); }
-        if (strcmp(c->name, "*") == 0) { printf("[DEBUG]     Found * by name\n"); return strdup("*"); }
-        if (strcmp(c->name, "/") == 0) { printf("[DEBUG]     Found / by name\n"); return strdup("/"); }
-        if (strcmp(c->name, "<") == 0) { printf("[DEBUG]     Found < by name\n"); return strdup("<"); }
-        if (strcmp(c->name, ">") == 0) { printf("[DEBUG]     Found > by name\n"); return strdup(">"); }
-        if (strcmp(c->name, "==") == 0) { printf("[DEBUG]     Found == by name\n"); return strdup("=="); }
-        if (strcmp(c->name, "<=") == 0) { printf("[DEBUG]     Found <= by name\n"); return strdup("<="); }
-        if (strcmp(c->name, ">=") == 0) { printf("[DEBUG]     Found >= by name\n"); return strdup(">="); }
-        
-        if (strcmp(c->name, "multOp") == 0 || strcmp(c->name, "addOp") == 0) {
-            printf("[DEBUG]     Recursing into %s\n", c->name);
-            char* op_result = get_operator(c);
-            if (op_result && strlen(op_result) > 0) return op_result;
-        }
+// branch taken when the condition fails; <> has no inverse here and falls back to ==
+static const char* inverted_rel_op(AbsOp op) {
+    switch (op) {
+    case ABS_OP_LT:  return ">=";
+    case ABS_OP_GT:  return "<=";
+    case ABS_OP_LEQ: return ">";
+    case ABS_OP_GEQ: return "<";
+    default:         return "==";
     }
-    
-    if (strstr(opNode->name, "mult")) { printf("[DEBUG]   Fallback mult -> *\n"); return strdup("*"); }
-    if (strstr(opNode->name, "div")) { printf("[DEBUG]   Fallback div -> /\n"); return strdup("/"); }
-    if (strstr(opNode->name, "add")) { printf("[DEBUG]   Fallback add -> +\n"); return strdup("+"); }
-    if (strstr(opNode->name, "sub")) { printf("[DEBUG]   Fallback sub -> -\n"); return strdup("-"); }
-    
-    printf("[DEBUG]   Final fallback -> +\n");
-    return strdup("+");
 }
 
-
 // ===================================== stack operations =====================================
-static char* emit_variable(ASTNode* n, int want_rvalue) {
-    char* name = find_first_lexeme(n);
-    if (!name) name = strdup("unknown_var");
-    
-    printf("[DEBUG] emit_variable: name='%s', is_local=%d\n", name, is_local_variable(name));
-    
-    // local variable 
-    if (is_local_variable(name)) {
-        int offset = get_stack_offset(name);
-        printf("[DEBUG]   Local variable '%s' at offset %d\n", name, offset);
-        
+static char* emit_variable(CompilerContext* cc, const char* name, int want_rvalue) {
+    LOG_DEBUG(LOG_CODEGEN, "[DEBUG] emit_variable: name='%s', is_local=%d\n", name, is_local_variable(cc, name));
+
+    // local variable
+    if (is_local_variable(cc, name)) {
+        int offset = get_stack_offset(cc, name);
+        LOG_DEBUG(LOG_CODEGEN, "[DEBUG]   Local variable '%s' at offset %d\n", name, offset);
+
         // address calculation: addr_temp = BP + offset
         char offsetStr[16];
         snprintf(offsetStr, 16, "%d", offset);
-        
-        char* addrTemp = new_temp();
-        emit_quad("frameAddr", "BP", offsetStr, addrTemp); 
-        
+
+        char* addrTemp = new_temp(cc);
+        emit_quad(cc, "frameAddr", "BP", offsetStr, addrTemp);
+
         if (want_rvalue) {
-            char* val = new_temp();
-            emit_quad("loadStack", addrTemp, "0", val);
-            free(name);
+            char* val = new_temp(cc);
+            emit_quad(cc, "loadStack", addrTemp, "0", val);
+            free(addrTemp);
             return val;
-        } else {
-            char* marker = malloc(64);
-            snprintf(marker, 64, "STACK[%s]", addrTemp);
-            free(name);
-            return marker;
-        }
-    }
-    
-    ASTNode* idxNode = NULL;
-    if (n) {
-        ASTNode* stack[50]; int top=0; stack[top++]=n;
-        while(top>0) {
-            ASTNode* cur = stack[--top];
-            if (strstr(cur->name, "indice")) { idxNode = cur; break; }
-            for(ASTNode* k=cur->child; k; k=k->sibling) stack[top++]=k;
-        }
-    }
-
-    if (idxNode) {
-        ASTNode* arith = NULL;
-        for(ASTNode* k=idxNode->child; k; k=k->sibling) {
-             if(strstr(k->name, "arithExpr")) { arith=k; break; }
-        }
-        if (!arith && idxNode->child) arith = idxNode->child;
-
-        if (arith) {
-            char* idx = emit_arithExpr(arith);
-            char* width = strdup("4");
-            char* off = new_temp();
-            emit_quad("*", idx, width, off);
-            free(idx); free(width);
-            if (want_rvalue) {
-                char* val = new_temp();
-                emit_quad("load", name, off, val);
-                free(name); free(off);
-                return val;
-            } else {
-                char b[64]; snprintf(b, 64, "%s@%s", name, off);
-                free(name); free(off);
-                return strdup(b);
-            }
         }
+        return addrTemp;
     }
-    return name;
+    return NULL;
 }
 
-static char* emit_factor(ASTNode* n) {
+static char* emit_value(CompilerContext* cc, const AbsNode* n) {
     if (!n) return strdup("0");
-    
-    if (strcmp(n->name, "functionCall") == 0) {
-        char* lbl = find_first_lexeme(n);
-        if (!lbl) lbl = strdup("func");
-        char* res = new_temp();
-        char fLabel[64]; snprintf(fLabel, 64, "F_%s", lbl);
-        emit_quad("call", fLabel, "0", res);
-        free(lbl);
-        return res;
-    }
-
-    ASTNode* child = n->child;
-    if (child && strstr(child->name, "arithExpr")) return emit_arithExpr(child);
-    if (child && strstr(child->name, "expr")) return emit_expr(child);
 
-    if (strstr(n->name, "arithExpr")) return emit_arithExpr(n);
-    if (strstr(n->name, "expr")) return emit_expr(n);
-
-    char* lit = find_literal(n);
-    if (lit) return lit;
+    switch (n->kind) {
+    case ABS_INT_LIT:
+    case ABS_FLOAT_LIT:
+        return strdup(intern_name(cc, n->name));
+    case ABS_BINARY: {
+        char* l = emit_value(cc, n->as.binary.lhs);
+        char* r = emit_value(cc, n->as.binary.rhs);
+        char* t = new_temp(cc);
+        emit_quad(cc, arith_op(n->op), l, r, t);
+        free(l); free(r);
+        return t;
+    }
+    default:
+        break;
+    }
 
-    char* var = find_first_lexeme(n);
-    if (var) return emit_variable(n, 1);
+    // names, members, indexing, calls and unary operators are not lowered
+    // further yet: the operand is the first literal, else the first name
+    const AbsNode* lit = first_literal(n);
+    if (lit) return strdup(intern_name(cc, lit->name));
 
-    if (n->child) return emit_factor(n->child);
-    return strdup("0");
+    int id = first_name(n);
+    if (id == INTERN_NONE) return strdup("0");
+    const char* name = intern_name(cc, id);
+    char* val = emit_variable(cc, name, 1);
+    return val ? val : strdup(name);
 }
 
-static char* emit_term(ASTNode* n) {
-    if (!n) return strdup("0");
-    char* left = emit_factor(find_child(n, "factor"));
-    
-    ASTNode* tail = find_child(n, "termTail");
-    while (tail) {
-        ASTNode* nextFactor = NULL;
-        ASTNode* opNode = NULL;
-        int foundData = 0;
-
-        for (ASTNode* c = tail->child; c; c = c->sibling) {
-            if (strcmp(c->name, "factor") == 0) {
-                nextFactor = c;
-                foundData = 1;
-            } else if (!opNode && (strstr(c->name, "multOp") || strchr("*/", c->lexeme ? c->lexeme[0] : ' '))) {
-                opNode = c;
-            }
-        }
-
-        if (!foundData) break;
-        
-        char* op = get_operator(opNode ? opNode : tail);
-        char* right = emit_factor(nextFactor);
-        char* t = new_temp();
-        
-        emit_quad(op, left, right, t);
-        free(left); free(right); free(op);
-        left = t;
-        
-        tail = find_child(tail, "termTail");
-    }
-    return left;
-}
-
-static char* emit_arithExpr(ASTNode* n) {
-    if (!n) return strdup("0");
-    char* left = emit_term(find_child(n, "term"));
-    
-    ASTNode* tail = find_child(n, "arithExprTail");
-    while (tail) {
-        ASTNode* nextTerm = NULL;
-        ASTNode* opNode = NULL;
-        int foundData = 0;
-
-        for (ASTNode* c = tail->child; c; c = c->sibling) {
-            if (strcmp(c->name, "term") == 0) {
-                nextTerm = c;
-                foundData = 1;
-            } else if (!opNode && (strstr(c->name, "addOp") || strchr("+-", c->lexeme ? c->lexeme[0] : ' '))) {
-                opNode = c;
-            }
-        }
-
-        if (!foundData) break;
-        
-        char* op = get_operator(opNode ? opNode : tail);
-        char* right = emit_term(nextTerm);
-        char* t = new_temp();
-        
-        emit_quad(op, left, right, t);
-        free(left); free(right); free(op);
-        left = t;
-        
-        tail = find_child(tail, "arithExprTail");
-    }
-    return left;
+// a relational expression only yields its left operand as a value
+static char* emit_expr(CompilerContext* cc, const AbsNode* n) {
+    if (n && n->kind == ABS_BINARY && isRelationalOp(n->op)) return emit_value(cc, n->as.binary.lhs);
+    return emit_value(cc, n);
 }
 
-static char* emit_expr(ASTNode* n) {
-    if (find_child(n, "relExpr")) {
-        ASTNode* rel = find_child(n, "relExpr");
-        return emit_arithExpr(find_child(rel, "arithExpr"));
-    }
-    return emit_arithExpr(find_child(n, "arithExpr"));
+static void emit_branch_unless(CompilerContext* cc, const AbsNode* cond, const char* target) {
+    if (!cond || cond->kind != ABS_BINARY) return;
+    char* l = emit_value(cc, cond->as.binary.lhs);
+    char* r = emit_value(cc, cond->as.binary.rhs);
+    emit_quad(cc, inverted_rel_op(cond->op), l, r, target);
+    free(l); free(r);
 }
 
-static void emit_statement(ASTNode* n) {
+static void emit_statement(CompilerContext* cc, const AbsNode* n) {
     if (!n) return;
-    ASTNode* ch = n->child;
-    if (!ch) return;
-
-    if (strcmp(ch->name, "assignStat")==0) {
-        ASTNode* v = find_child(ch, "variable");
-        ASTNode* e = find_child(ch, "expr");
-        if (v && e) {
-            char* val = emit_expr(e);
-            char* tgt = emit_variable(v, 0);
-            
-            // check if is stack-based variable
-            if (strncmp(tgt, "STACK[", 6) == 0) {
-                char* addrTemp = strdup(tgt + 6);
-                char* bracket = strchr(addrTemp, ']');
-                if (bracket) *bracket = '\0';
-                emit_quad("storeStack", val, "0", addrTemp);
-                free(addrTemp);
-            } else {
-                // global
-                char* at = strchr(tgt, '@');
-                if (at) {
-                    *at = '\0';
-                    emit_quad("store", val, at+1, tgt);
-                } else {
-                    emit_quad("assign", val, NULL, tgt);
-                }
-            }
-            free(val); free(tgt);
-        }
+
+    switch (n->kind) {
+    case ABS_BLOCK:
+        for (int i = 0; i < n->count; i++) emit_statement(cc, n->items[i]);
         return;
-    }
 
-    if (find_child(n, "while") || (ch && strcmp(ch->name, "while")==0)) {
-        ASTNode* rel = find_child(n, "relExpr");
-        
-        ASTNode* blk = NULL;
-        for(ASTNode* c=n->child; c; c=c->sibling) {
-            if(strstr(c->name, "Block") || strstr(c->name, "List")) { blk=c; break; }
-        }
-        
-        char* lStart = new_label();
-        char* lEnd = new_label();
-        emit_quad("label", NULL, NULL, lStart);
-        
-        if (rel) {
-            ASTNode* lNode = find_child(rel, "arithExpr");
-            ASTNode* rNode = lNode ? lNode->sibling->sibling : NULL; 
-            if (!rNode) rNode = lNode;
-            ASTNode* opNode = lNode ? lNode->sibling : NULL;
-            
-            char* l = emit_arithExpr(lNode);
-            char* r = emit_arithExpr(rNode);
-            char* op = get_operator(opNode);
-            
-            char* inv = "==";
-            if (strcmp(op, "<")==0) inv = ">=";
-            else if (strcmp(op, ">")==0) inv = "<=";
-            else if (strcmp(op, "<=")==0) inv = ">";
-            else if (strcmp(op, ">=")==0) inv = "<";
-            else if (strcmp(op, "==")==0) inv = "<>";
-            
-            emit_quad(inv, l, r, lEnd);
-            free(l); free(r); free(op);
+    case ABS_ASSIGN: {
+        char* val = emit_expr(cc, n->as.assign.value);
+        int id = first_name(n->as.assign.target);
+        const char* name = id != INTERN_NONE ? intern_name(cc, id) : "unknown_var";
+
+        // stack-based variable: store through the frame address
+        char* addrTemp = emit_variable(cc, name, 0);
+        if (addrTemp) {
+            emit_quad(cc, "storeStack", val, "0", addrTemp);
+            free(addrTemp);
+        } else {
+            emit_quad(cc, "assign", val, NULL, name);
         }
-        if (blk) emit_statements(blk);
-        emit_quad("goto", NULL, NULL, lStart);
-        emit_quad("label", NULL, NULL, lEnd);
+        free(val);
         return;
     }
 
-    if (find_child(n, "if") || (find_child(n, "relExpr") && !find_child(n, "while"))) {
-        ASTNode* rel = find_child(n, "relExpr");
-        char* lElse = new_label();
-        char* lEnd = new_label();
-        
-        if (rel) {
-            ASTNode* lNode = find_child(rel, "arithExpr");
-            ASTNode* rNode = lNode ? lNode->sibling->sibling : NULL;
-            ASTNode* opNode = lNode ? lNode->sibling : NULL;
-            char* l = emit_arithExpr(lNode);
-            char* r = emit_arithExpr(rNode);
-            char* op = get_operator(opNode);
-            
-            char* inv = "==";
-            if (strcmp(op, "<")==0) inv = ">=";
-            else if (strcmp(op, ">")==0) inv = "<=";
-            else if (strcmp(op, "<=")==0) inv = ">";
-            else if (strcmp(op, ">=")==0) inv = "<";
-            else if (strcmp(op, "==")==0) inv = "<>";
-            
-            emit_quad(inv, l, r, lElse);
-            free(l); free(r); free(op);
-        }
-        
-        ASTNode* b1 = NULL; ASTNode* b2 = NULL;
-        int foundFirst = 0;
-        
-        for(ASTNode* c=n->child; c; c=c->sibling) {
-            if (strcmp(c->name, "if")==0 || strcmp(c->name, "relExpr")==0 || 
-                strcmp(c->name, "then")==0 || strcmp(c->name, "else")==0) continue;
-            
-            if (!foundFirst) { b1 = c; foundFirst = 1; }
-            else { b2 = c; }
-        }
-        
-        if (b1) emit_statements(b1);
-        emit_quad("goto", NULL, NULL, lEnd);
-        emit_quad("label", NULL, NULL, lElse);
-        if (b2) emit_statements(b2);
-        emit_quad("label", NULL, NULL, lEnd);
+    case ABS_WHILE: {
+        char* lStart = new_label(cc);
+        char* lEnd = new_label(cc);
+        emit_quad(cc, "label", NULL, NULL, lStart);
+        emit_branch_unless(cc, n->as.while_stmt.cond, lEnd);
+        emit_statement(cc, n->as.while_stmt.body);
+        emit_quad(cc, "goto", NULL, NULL, lStart);
+        emit_quad(cc, "label", NULL, NULL, lEnd);
+        free(lStart); free(lEnd);
         return;
     }
 
-    if (find_child(n, "return") || (ch && strstr(ch->name, "return"))) {
-        ASTNode* ex = find_child(n, "expr");
-        char* v = ex ? emit_expr(ex) : NULL;
-        emit_quad("return", v, NULL, NULL);
-        if(v) free(v);
+    case ABS_IF: {
+        char* lElse = new_label(cc);
+        char* lEnd = new_label(cc);
+        emit_branch_unless(cc, n->as.if_stmt.cond, lElse);
+        emit_statement(cc, n->as.if_stmt.then_part);
+        emit_quad(cc, "goto", NULL, NULL, lEnd);
+        emit_quad(cc, "label", NULL, NULL, lElse);
+        emit_statement(cc, n->as.if_stmt.else_part);
+        emit_quad(cc, "label", NULL, NULL, lEnd);
+        free(lElse); free(lEnd);
         return;
     }
-    
-    if (find_child(n, "write")) {
-        ASTNode* ex = find_child(n, "expr");
-        char* v = emit_expr(ex);
-        emit_quad("write", v, NULL, NULL);
+
+    case ABS_RETURN:
+    case ABS_WRITE: {
+        char* v = emit_expr(cc, n->as.io.operand);
+        emit_quad(cc, n->kind == ABS_RETURN ? "return" : "write", v, NULL, NULL);
         free(v);
         return;
     }
 
-    for (ASTNode* c=n->child; c; c=c->sibling) emit_statements(c);
+    default:
+        // declarations and read() produce no code
+        return;
+    }
 }
 
-static void emit_statements(ASTNode* n) {
-    if (!n) return;
-    if (strcmp(n->name, "statement")==0) { emit_statement(n); return; }
-    for (ASTNode* c=n->child; c; c=c->sibling) emit_statements(c);
+// label of a function: its name, or for a constructor its first parameter
+static const char* func_label_name(CompilerContext* cc, const AbsNode* f) {
+    if (f->name != INTERN_NONE) return intern_name(cc, f->name);
+    const AbsNode* params = f->as.func.params;
+    if (params && params->count > 0) return intern_name(cc, params->items[0]->name);
+    return NULL;
 }
 
-void traverse_func(ASTNode* n) {
-    char* name = find_first_lexeme(find_child(n, "funcHead"));
-    if (name) {
-        char l[64]; snprintf(l, 64, "F_%s", name);
-        emit_quad("label", NULL, NULL, l);
-        
+static void traverse_func(CompilerContext* cc, const AbsNode* f, int with_frame) {
+    const char* name = func_label_name(cc, f);
+    if (!name) return;
+
+    char l[64]; snprintf(l, 64, "F_%s", name);
+    emit_quad(cc, "label", NULL, NULL, l);
+
+    if (with_frame) {
         // save base pointer
-        emit_quad("pushBP", "BP", "SP", NULL);
-        
+        emit_quad(cc, "pushBP", "BP", "SP", NULL);
+
         // update base pointer: BP := SP
-        emit_quad("setBP", "SP", NULL, "BP");
-        
+        emit_quad(cc, "setBP", "SP", NULL, "BP");
+
         // allocate space for local variables
-        emit_quad("allocFrame", "SP", "32", "SP"); // Allocate 32 bytes
-        emit_statements(find_child(n, "funcBody"));
-        emit_quad("restoreSP", "BP", NULL, "SP");
-        emit_quad("popBP", "SP", NULL, "BP");
-        
-        emit_quad("return", NULL, NULL, NULL);
-        free(name);
+        emit_quad(cc, "allocFrame", "SP", "32", "SP"); // Allocate 32 bytes
+    }
+    emit_statement(cc, f->as.func.body);
+    if (with_frame) {
+        emit_quad(cc, "restoreSP", "BP", NULL, "SP");
+        emit_quad(cc, "popBP", "SP", NULL, "BP");
     }
+    emit_quad(cc, "return", NULL, NULL, NULL);
 }
 
-void traverse_all(ASTNode* n) {
-    if (!n) return;
-    
-    if (strcmp(n->name, "funcDef")==0) {
-        traverse_func(n);
-    }
-    if (strcmp(n->name, "memberDecl")==0) {
-        ASTNode* funcHead = find_child(n, "funcHead");
-        ASTNode* funcBody = find_child(n, "funcBody");
-        
-        if (funcHead && funcBody) {
-            char* name = find_first_lexeme(funcHead);
-            if (name) {
-                char l[64]; snprintf(l, 64, "F_%s", name);
-                emit_quad("label", NULL, NULL, l);
-                emit_statements(funcBody);
-                emit_quad("return", NULL, NULL, NULL);
-                free(name);
+// with --incremental the quadruples may come from the function cache
+static void emit_function(CompilerContext* cc, const AbsNode* f, int with_frame) {
+    if (func_cache_begin(cc, f, with_frame)) return;
+    traverse_func(cc, f, with_frame);
+    func_cache_end(cc);
+}
+
+// class member bodies are emitted inline without a frame; impl and free functions get one
+static void traverse_all(CompilerContext* cc, const AbsNode* prog) {
+    for (int i = 0; i < prog->count; i++) {
+        const AbsNode* item = prog->items[i];
+        switch (item->kind) {
+        case ABS_CLASS:
+            for (int j = 0; j < item->count; j++) {
+                const AbsNode* m = item->items[j];
+                if (m->kind == ABS_FUNC && m->as.func.body) emit_function(cc, m, 0);
             }
+            break;
+        case ABS_IMPL:
+            for (int j = 0; j < item->count; j++) emit_function(cc, item->items[j], 1);
+            break;
+        case ABS_FUNC:
+            emit_function(cc, item, 1);
+            break;
+        default:
+            break;
         }
     }
-    
-    if (n->child) traverse_all(n->child);
-    if (n->sibling) traverse_all(n->sibling);
 }
 
 // ====================================== write 3AC generated from the AST to file ===============================================
-static void dump_3ac(FILE* f) {
+static void dump_3ac(CompilerContext* cc, FILE* f) {
     fprintf(f, "==========================================\n");
     fprintf(f, "           Three-Address Code\n");
     fprintf(f, "==========================================\n");
-    for(int i=0; i<quad_count; i++) {
-        Quadruple* q = &quad_list[i];
+    for(int i=0; i<cc->quad_count; i++) {
+        Quadruple* q = &cc->quad_list[i];
         
         // Label
         if (strcmp(q->op, "label") == 0) {
@@ -577,12 +414,12 @@ static const char* get_quad_name(const char* op) {
 }
 
 // ===================================== write quadruples to file ============================================
-static void dump_quads(FILE* f) {
+static void dump_quads(CompilerContext* cc, FILE* f) {
     fprintf(f, "==========================================\n");
     fprintf(f, "               Quadruples\n");
     fprintf(f, "==========================================\n");
-    for(int i=0; i<quad_count; i++) {
-        Quadruple* q = &quad_list[i];
+    for(int i=0; i<cc->quad_count; i++) {
+        Quadruple* q = &cc->quad_list[i];
         const char* opName = get_quad_name(q->op ? q->op : "nop");
         char* r = q->res ? q->res : "_";
         char* a1 = q->arg1 ? q->arg1 : "_";
@@ -597,27 +434,34 @@ static void dump_quads(FILE* f) {
 }
 
 // ===================================== driver function =================================
-ASTNode* generate_ir(ASTNode* root) {
+ASTNode* generate_ir(CompilerContext* cc, ASTNode* root) {
     if (!root) return NULL;
     
     // Initialize stack management
-    init_stack_manager();
+    init_stack_manager(cc);
+    st_index_globals(cc);     // the table is complete; every operand is looked up in it
+    func_cache_open(cc);
     
+    // code is generated from the lowered tree; semantic checks still run on the parse tree
+    AbsNode* prog = lowerProgram(cc, root);
+    if (log_enabled(LOG_CODEGEN, LOG_LEVEL_DEBUG)) printAbstractAST(cc, prog, stdout);
+
     printf("[CODEGEN]: Traversing AST for 3AC...\n");
-    traverse_all(root);
+    traverse_all(cc, prog);
     
     #if defined(_WIN32) || defined(_WIN64)
-    _mkdir("files");
+    _mkdir(cc->output_dir);
     #else
-    mkdir("files", 0755);
+    mkdir(cc->output_dir, 0755);
     #endif
     
-    FILE* f = fopen("files/address_code.txt", "w");
-    if (f) { dump_3ac(f); fclose(f); }
+    FILE* f = compiler_open_output(cc, "address_code.txt", "w");
+    if (f) { dump_3ac(cc, f); fclose(f); }
 
-    FILE* fq = fopen("files/quads.txt", "w");
-    if (fq) { dump_quads(fq); fclose(fq); }
+    FILE* fq = compiler_open_output(cc, "quads.txt", "w");
+    if (fq) { dump_quads(cc, fq); fclose(fq); }
     
-    generate_isa2_target();
+    generate_isa2_target(cc);
+    func_cache_save(cc);
     return root;
 }
\ No newline at end of file
@@ -9,16 +9,24 @@ typedef struct {
     char* arg1;
     char* arg2;
     char* res;
+    int arg1_id;    // interned operands, compared instead of the strings
+    int arg2_id;
+    int res_id;
 } Quadruple;
 
-ASTNode* generate_ir(ASTNode* root);
+ASTNode* generate_ir(struct CompilerContext* cc, ASTNode* root);
 void write_program_ir(ASTNode* root);
 
+// append one quadruple (operands are copied)
+void emit_quad(struct CompilerContext* cc, const char* op, const char* a1, const char* a2, const char* res);
+
 // expose quadruple list
-Quadruple* get_quad_list();
-int get_quad_count();
+Quadruple* get_quad_list(struct CompilerContext* cc);
+int get_quad_count(struct CompilerContext* cc);
+void free_ir(struct CompilerContext* cc);
 
 // variable address lookup
-int get_var_address(const char* name);
+int get_var_address(struct CompilerContext* cc, const char* name);
+int get_var_address_id(struct CompilerContext* cc, int name_id);
 
 #endif
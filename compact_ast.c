@@ -0,0 +1,170 @@
+#include <stdlib.h>
+#include <string.h>
+#include "compact_ast.h"
+#include "symbols.h"
+#include "ast_visit.h"
+#include "compiler.h"
+
+#define COMPACT_NODE_BYTES (sizeof(uint16_t) + 2 * sizeof(int32_t) + 2 * sizeof(NodeRef))
+
+void compact_init(CompactAST* c) {
+    memset(c, 0, sizeof(*c));
+}
+
+void compact_reset(CompactAST* c) {
+    c->count = 0;
+}
+
+void compact_free(CompactAST* c) {
+    free(c->kind);
+    free(c->lexeme);
+    free(c->line);
+    free(c->child);
+    free(c->sibling);
+    free(c->origin);
+    compact_init(c);
+}
+
+static void* grow_array(void* p, size_t elem, uint32_t cap) {
+    void* q = realloc(p, elem * cap);
+    if (!q) {
+        printf("Error:: out of memory in compact AST\n");
+        exit(1);
+    }
+    return q;
+}
+
+static void grow(CompactAST* c) {
+    uint32_t cap = c->cap ? c->cap * 2 : 1024;
+    c->kind = (uint16_t*)grow_array(c->kind, sizeof(uint16_t), cap);
+    c->lexeme = (int32_t*)grow_array(c->lexeme, sizeof(int32_t), cap);
+    c->line = (int32_t*)grow_array(c->line, sizeof(int32_t), cap);
+    c->child = (NodeRef*)grow_array(c->child, sizeof(NodeRef), cap);
+    c->sibling = (NodeRef*)grow_array(c->sibling, sizeof(NodeRef), cap);
+    if (c->origin) c->origin = (ASTNode**)grow_array(c->origin, sizeof(ASTNode*), cap);
+    c->cap = cap;
+}
+
+NodeRef compact_add(CompactAST* c, ASTKind kind, int lexeme_id, int line) {
+    if (c->count == c->cap) grow(c);
+    NodeRef n = c->count++;
+    c->kind[n] = (uint16_t)kind;
+    c->lexeme[n] = lexeme_id;
+    c->line[n] = line;
+    c->child[n] = NODE_NIL;
+    c->sibling[n] = NODE_NIL;
+    if (c->origin) c->origin[n] = NULL;
+    return n;
+}
+
+void compact_add_child(CompactAST* c, NodeRef parent, NodeRef child) {
+    if (parent == NODE_NIL || child == NODE_NIL) return;
+    if (c->child[parent] == NODE_NIL) {
+        c->child[parent] = child;
+        return;
+    }
+    NodeRef n = c->child[parent];
+    while (c->sibling[n] != NODE_NIL) n = c->sibling[n];
+    c->sibling[n] = child;
+}
+
+const char* compact_name(const CompactAST* c, NodeRef n) {
+    return ast_kind_name[c->kind[n]];
+}
+
+const char* compact_lexeme(CompilerContext* cc, const CompactAST* c, NodeRef n) {
+    return intern_name(cc, c->lexeme[n]);
+}
+
+// ====== pointer tree -> arrays =====
+// preorder walk (ast_visit.h); frame = the parent's entry. last[] holds the
+// last child linked under each entry so far, so appending a child is O(1).
+typedef struct {
+    CompactAST* c;
+    NodeRef* last;
+    uint32_t last_cap;
+} Flatten;
+
+static AstVisitResult flatten_pre(AstWalk* w, ASTNode* node, void* frame) {
+    Flatten* fl = (Flatten*)ast_walk_user(w);
+    CompactAST* c = fl->c;
+    NodeRef parent = *(NodeRef*)frame;
+    NodeRef self = compact_add(c, node->kind, node->lexeme_id, node->line);
+    if (c->origin) c->origin[self] = node;
+    if (self >= fl->last_cap) {
+        fl->last_cap = c->cap;
+        fl->last = (NodeRef*)grow_array(fl->last, sizeof(NodeRef), fl->last_cap);
+    }
+    fl->last[self] = NODE_NIL;
+    if (parent != NODE_NIL) {
+        if (fl->last[parent] == NODE_NIL) c->child[parent] = self;
+        else c->sibling[fl->last[parent]] = self;
+        fl->last[parent] = self;
+    }
+    *(NodeRef*)frame = self;    // the children's parent
+    return AST_VISIT_CHILDREN;
+}
+
+NodeRef compact_from_tree(CompactAST* c, ASTNode* root, int keep_origin) {
+    if (!root) return NODE_NIL;
+    if (keep_origin && !c->origin) {
+        c->origin = (ASTNode**)grow_array(NULL, sizeof(ASTNode*), c->cap ? c->cap : 1);
+    } else if (!keep_origin && c->origin) {
+        free(c->origin);
+        c->origin = NULL;
+    }
+    NodeRef first = c->count;
+    Flatten fl = { c, NULL, 0 };
+    NodeRef none = NODE_NIL;
+    AstVisitor v = { flatten_pre, NULL, sizeof(NodeRef), &fl };
+    ast_walk(&v, root, &none);
+    free(fl.last);
+    return first;
+}
+
+// ====== arrays -> pointer tree =====
+// one frame per open level: the next entry to build there, the pointer node
+// it goes under and the last child linked to that node so far
+typedef struct {
+    NodeRef next;
+    ASTNode* parent;
+    ASTNode* last;
+} ToTreeFrame;
+
+ASTNode* compact_to_tree(CompilerContext* cc, const CompactAST* c, NodeRef root) {
+    if (root == NODE_NIL) return NULL;
+    ASTNode* top = createNodeWithId(cc, compact_name(c, root), c->lexeme[root]);
+    if (!top) return NULL;
+    top->line = c->line[root];
+    uint32_t depth = 0, cap = 64;
+    ToTreeFrame* frames = (ToTreeFrame*)grow_array(NULL, sizeof(ToTreeFrame), cap);
+    frames[depth++] = (ToTreeFrame){ c->child[root], top, NULL };
+    while (depth > 0) {
+        ToTreeFrame* f = &frames[depth - 1];
+        NodeRef n = f->next;
+        if (n == NODE_NIL) {
+            depth--;
+            continue;
+        }
+        f->next = c->sibling[n];
+        ASTNode* node = createNodeWithId(cc, compact_name(c, n), c->lexeme[n]);
+        if (!node) break;
+        node->line = c->line[n];
+        if (f->last) f->last->sibling = node;
+        else f->parent->child = node;
+        f->last = node;
+        if (c->child[n] != NODE_NIL) {
+            if (depth == cap) {
+                cap *= 2;
+                frames = (ToTreeFrame*)grow_array(frames, sizeof(ToTreeFrame), cap);
+            }
+            frames[depth++] = (ToTreeFrame){ c->child[n], node, NULL };
+        }
+    }
+    free(frames);
+    return top;
+}
+
+size_t compact_bytes(const CompactAST* c) {
+    return (size_t)c->count * COMPACT_NODE_BYTES;
+}
@@ -0,0 +1,53 @@
+#ifndef COMPACT_AST_H
+#define COMPACT_AST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "ast.h"
+
+// Compact AST =============================================================
+// the same tree as ASTNode, stored as parallel arrays indexed by node number:
+// 18 bytes per node instead of a full ASTNode, and a walk touches only the
+// arrays it needs. Node 0 is the first node added (the root after a flatten).
+typedef uint32_t NodeRef;
+#define NODE_NIL 0xFFFFFFFFu
+
+typedef struct {
+    uint16_t* kind;         // ASTKind
+    int32_t* lexeme;        // interned id, INTERN_NONE when empty
+    int32_t* line;
+    NodeRef* child;         // first child
+    NodeRef* sibling;       // next sibling
+    ASTNode** origin;       // adapter: pointer node each entry came from (may be NULL)
+    uint32_t count;
+    uint32_t cap;
+} CompactAST;
+
+void compact_init(CompactAST* c);
+void compact_reset(CompactAST* c);
+void compact_free(CompactAST* c);
+
+NodeRef compact_add(CompactAST* c, ASTKind kind, int lexeme_id, int line);
+void compact_add_child(CompactAST* c, NodeRef parent, NodeRef child);
+
+// accessors, so converted code reads like the pointer version
+static inline ASTKind compact_kind(const CompactAST* c, NodeRef n) { return (ASTKind)c->kind[n]; }
+static inline NodeRef compact_child(const CompactAST* c, NodeRef n) { return c->child[n]; }
+static inline NodeRef compact_sibling(const CompactAST* c, NodeRef n) { return c->sibling[n]; }
+static inline int compact_line(const CompactAST* c, NodeRef n) { return c->line[n]; }
+static inline int compact_lexeme_id(const CompactAST* c, NodeRef n) { return c->lexeme[n]; }
+const char* compact_name(const CompactAST* c, NodeRef n);
+const char* compact_lexeme(struct CompilerContext* cc, const CompactAST* c, NodeRef n);
+
+// adapter between the two layouts while passes move over one at a time:
+// from_tree flattens in preorder (keep_origin records the source pointers so
+// a converted pass can still call helpers that take ASTNode*), to_tree builds
+// pointer nodes back out of the arrays.
+NodeRef compact_from_tree(CompactAST* c, ASTNode* root, int keep_origin);
+ASTNode* compact_to_tree(struct CompilerContext* cc, const CompactAST* c, NodeRef root);
+static inline ASTNode* compact_origin(const CompactAST* c, NodeRef n) { return c->origin ? c->origin[n] : NULL; }
+
+// bytes the stored nodes take in the arrays (origin excluded)
+size_t compact_bytes(const CompactAST* c);
+
+#endif
@@ -3,13 +3,19 @@ Write-Host "==========Starting compilation.=========="
 flex tma3.l
 Write-Host "flex completed..............."
 
-bison -y -d tma3.y
+bison -d -o y.tab.c tma3.y
 Write-Host "bison completed.............."
 
 gcc -c .\lex.yy.c .\y.tab.c
 Write-Host "C compilation of lex and yacc files completed..............."
 
-gcc .\lex.yy.c .\y.tab.c .\symbols.c .\symbol_table.c .\semantic.c .\parser.c .\ast.c .\stack.c .\codegen.c .\isa2.c -o .\tma3.exe
+gcc .\lex.yy.c .\y.tab.c .\symbols.c .\symbol_table.c .\semantic.c .\parser.c .\ast.c .\stack.c .\codegen.c .\isa2.c .\tokens.c .\source.c .\log.c .\simd_scan.c .\token_queue.c .\token_cache.c .\derivation.c .\derivation_rules.c .\arena.c .\compact_ast.c .\lower.c .\ll1.c .\parallel_parse.c .\compiler.c .\tree_writer.c .\ast_snapshot.c .\func_cache.c .\ast_visit.c .\server.c -o .\tma3.exe
 Write-Host "Linking completed. Executable tma3.exe created................"
 
+gcc .\derivation_decode.c .\derivation_rules.c -o .\derivation_decode.exe
+Write-Host "Derivation decoder derivation_decode.exe created................"
+
+gcc .\ll1gen.c -o .\ll1gen.exe
+Write-Host "Parse table generator ll1gen.exe created................"
+
 Write-Host "==========Compilation process finished.=========="
\ No newline at end of file
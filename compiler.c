@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "compiler.h"
+#include "parser.h"
+#include "symbols.h"
+#include "simd_scan.h"
+#include "ll1.h"
+#include "stack.h"
+#include "semantic.h"
+#include "ast_snapshot.h"
+#include "tree_writer.h"
+#include "func_cache.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <direct.h>
+#define MKDIR(dir) _mkdir(dir)
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#define MKDIR(dir) mkdir(dir, 0755)
+#endif
+
+// ====== process-wide tables =============================================
+// these are filled on first use; filling them here, before any compilation
+// thread exists, keeps two first uses from racing
+void compiler_init() {
+    ast_kind_from_name("prog");
+    ll1_init();
+    simd_scan_width();
+}
+
+// ====== create / free ===================================================
+CompilerContext* compiler_create(const char* output_dir) {
+    CompilerContext* cc = (CompilerContext*)calloc(1, sizeof(CompilerContext));
+    if (!cc) {
+        printf("Error:: out of memory for the compiler context\n");
+        exit(1);
+    }
+    cc->output_dir = output_dir ? output_dir : "files";
+    cc->tree_format = TREE_TEXT;
+    cc->self_id = INTERN_NONE;
+    cc->derivation_step = 1;
+    arena_init(&cc->ast_arena, 0);
+    lexer_create(cc, &cc->lexer);
+    cc->next_global_addr = GLOBAL_BASE;
+    cc->sp_id = cc->bp_id = cc->ptr_id = INTERN_NONE;
+    return cc;
+}
+
+// what a compilation built, everything but the context itself and the arena
+static void compiler_release(CompilerContext* cc) {
+    tokens_drain(cc, &cc->token_stream);    // a lexer thread may still be running
+    tokens_free(&cc->token_stream);
+    compact_free(&cc->parse_tree);
+    free(cc->syntax_errors);
+    derivation_end(cc);
+    if (cc->errf) fclose(cc->errf);
+    st_free(cc);
+    free_ir(cc);
+    free(cc->global_addr);
+    free(cc->global_order);
+    func_cache_free(cc->func_cache);
+    init_symbols(cc);
+    free(cc->symbol_pages);
+    for (int i = 0; i < COMPILER_OUTPUT_MAX; i++) free(cc->outputs[i].data);
+}
+
+void compiler_free(CompilerContext* cc) {
+    if (!cc) return;
+    compiler_release(cc);
+    arena_free(&cc->ast_arena);
+    lexer_destroy(&cc->lexer);
+    free(cc);
+}
+
+void compiler_reset(CompilerContext* cc) {
+    compiler_release(cc);
+    ast_reset(cc);
+
+    CompilerContext keep = *cc;
+    memset(cc, 0, sizeof(*cc));
+    cc->output_dir = keep.output_dir;
+    cc->tree_format = keep.tree_format;
+    cc->outputs_in_memory = keep.outputs_in_memory;
+    cc->ast_arena = keep.ast_arena;
+    cc->lexer.cc = cc;
+    cc->lexer.scanner = keep.lexer.scanner;
+    cc->self_id = INTERN_NONE;
+    cc->derivation_step = 1;
+    cc->next_global_addr = GLOBAL_BASE;
+    cc->sp_id = cc->bp_id = cc->ptr_id = INTERN_NONE;
+}
+
+void compiler_exit(CompilerContext* cc, int status) {
+    if (!cc->abort_point) exit(status);
+    cc->exit_status = status;
+    longjmp(*cc->abort_point, 1);
+}
+
+// ====== one compilation on the calling thread ===========================
+ASTNode* compiler_run(CompilerContext* cc, char* data, size_t length) {
+    tokens_set_source(cc, data, length);
+    return parse_program(cc);
+}
+
+// the back end from a --save-ast snapshot: the syntax tree file is written
+// straight from the mapped arrays, and semantic analysis and code generation
+// get a pointer tree rebuilt from them
+ASTNode* compiler_run_snapshot(CompilerContext* cc, const char* path) {
+    AstSnapshot snap;
+    int rc = ast_snapshot_open(cc, &snap, path);
+    if (rc != 0) {
+        if (rc == -1) printf("Error:: Cannot read AST snapshot %s\n", path);
+        else printf("Error:: %s is not an AST snapshot of this compiler version\n", path);
+        return NULL;
+    }
+    printf("Loaded %u AST nodes from %s\n", snap.tree.count, path);
+
+    MKDIR(cc->output_dir);
+    tree_write_file(cc, &snap.tree, snap.root);
+    ASTNode* root = compact_to_tree(cc, &snap.tree, snap.root);
+    ast_snapshot_close(&snap);
+    run_semantic(cc, root);
+    return root;
+}
+
+// ====== output files ====================================================
+void compiler_output_path(CompilerContext* cc, char* out, size_t size, const char* name) {
+    snprintf(out, size, "%s/%s", cc->output_dir, name);
+}
+
+// ====== outputs kept in memory =========================================
+// open_memstream / fmemopen are POSIX; elsewhere the outputs are always files
+#if defined(_WIN32) || defined(_WIN64)
+static FILE* memory_output(CompilerContext* cc, const char* name, const char* mode) {
+    (void)cc; (void)name; (void)mode;
+    return NULL;
+}
+#else
+// the stream writes into the slot when it is flushed or closed; "a" starts
+// a new stream with what was there, "r" reads it
+static FILE* memory_output(CompilerContext* cc, const char* name, const char* mode) {
+    CompilerOutput* o = NULL;
+    for (int i = 0; i < COMPILER_OUTPUT_MAX && !o; i++)
+        if (strcmp(cc->outputs[i].name, name) == 0) o = &cc->outputs[i];
+    if (mode[0] == 'r') return o && o->size ? fmemopen(o->data, o->size, "r") : NULL;
+    for (int i = 0; i < COMPILER_OUTPUT_MAX && !o; i++)
+        if (!cc->outputs[i].name[0]) o = &cc->outputs[i];
+    if (!o) {
+        printf("Error:: more than %d output files in memory\n", COMPILER_OUTPUT_MAX);
+        return NULL;
+    }
+    snprintf(o->name, sizeof(o->name), "%s", name);
+    char* old = o->data;
+    size_t old_size = o->size;
+    o->data = NULL;
+    o->size = 0;
+    FILE* f = open_memstream(&o->data, &o->size);
+    if (f && mode[0] == 'a' && old_size) fwrite(old, 1, old_size, f);
+    free(old);
+    return f;
+}
+#endif
+
+const CompilerOutput* compiler_output(CompilerContext* cc, const char* name) {
+    for (int i = 0; i < COMPILER_OUTPUT_MAX; i++)
+        if (strcmp(cc->outputs[i].name, name) == 0) return &cc->outputs[i];
+    return NULL;
+}
+
+FILE* compiler_open_output(CompilerContext* cc, const char* name, const char* mode) {
+    if (cc->outputs_in_memory) return memory_output(cc, name, mode);
+    char path[1024];
+    compiler_output_path(cc, path, sizeof(path), name);
+    return fopen(path, mode);
+}
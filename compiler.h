@@ -0,0 +1,140 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include <stdio.h>
+#include <setjmp.h>
+#include "ast.h"
+#include "arena.h"
+#include "tokens.h"
+#include "compact_ast.h"
+#include "derivation.h"
+#include "symbol_table.h"
+#include "codegen.h"
+#include "parser.h"
+
+// an output file kept in memory instead of written (compile server)
+typedef struct {
+    char name[32];              // "" = unused
+    char* data;
+    size_t size;
+} CompilerOutput;
+
+#define COMPILER_OUTPUT_MAX 16
+
+// ====== one compilation =================================================
+// Everything a compilation builds up lives here instead of in file-scope
+// globals, so several compilations can run in one process, each on its own
+// thread. Every phase takes the context it works on as its first argument
+// (cc); threads a compilation starts (parse workers, the pipelined lexer)
+// are handed it too. The command line options (lex_scanner, parser_engine,
+// log levels, ...) stay process-wide: they are set once before anything is
+// compiled.
+// The parser position (lookahead_token, token_pos) is per thread, not per
+// compilation, because the parallel parse moves it on every worker.
+typedef struct CompilerContext {
+    const char* output_dir;     // where the phases write their files ("files")
+    int tree_format;            // syntax tree file layout (--tree, tree_writer.h)
+    // compile server: output files stay in memory (compiler_output)
+    int outputs_in_memory;
+    CompilerOutput outputs[COMPILER_OUTPUT_MAX];
+    // compile server: compiler_exit comes back here instead of ending the
+    // process; set for the length of one request only
+    jmp_buf* abort_point;
+    int exit_status;
+
+    // source and lexing (tokens.c)
+    char* source_data;
+    size_t source_length;
+    LexState lexer;             // the flex scanner (tma3.l)
+    struct TokenQueue* token_queue;     // lexer thread still feeding token_stream
+    int lex_errors;             // lexical errors this compilation's scan reported
+
+    // interned lexemes (symbols.c)
+    struct Symbol** symbol_pages;
+    int symbol_count;
+    struct TextBlock* text_blocks;
+    int* symbol_slots;
+    unsigned int symbol_slot_cap;
+
+    // parser (parser.c)
+    TokenVector token_stream;
+    CompactAST parse_tree;      // flattened copy of the tree write_syntax_tree wrote
+    int self_id;
+    SyntaxError* syntax_errors;
+    int syntax_error_count;
+    int syntax_error_cap;
+
+    // derivation trace (derivation.c)
+    FILE* trace_file;
+    int derivation_step;
+    unsigned char ring[DERIVATION_RING_SIZE];
+    int ring_count;
+
+    // syntax tree nodes (ast.c)
+    Arena ast_arena;
+    size_t node_count;          // nodes in ast_arena, parse workers' included
+
+    // scopes (symbol_table.c) and semantic analysis (semantic.c)
+    Scope* current_scope;
+    Scope* all_scopes;
+    int current_level;
+    ASTNode* g_root;
+    FILE* errf;
+    SymbolEntry** global_index;     // st_index_globals, by name id
+    int global_index_cap;
+
+    // static addresses of globals (stack.c)
+    int* global_addr;
+    int global_addr_cap;
+    int next_global_addr;
+    int sp_id, bp_id, ptr_id;
+    int* global_order;          // name ids in the order they got an address
+    int global_order_count;
+    int global_order_cap;
+    unsigned long long global_order_hash;
+
+    // per-function code reused across runs (func_cache.c)
+    struct FuncCache* func_cache;
+
+    // intermediate code (codegen.c)
+    int temp_counter;
+    int label_counter;
+    Quadruple* quad_list;
+    int quad_count;
+    int quad_cap;
+} CompilerContext;
+
+// tables shared by all compilations, built once before the first one starts
+void compiler_init();
+
+CompilerContext* compiler_create(const char* output_dir);
+void compiler_free(CompilerContext* cc);     // tree, scopes, code, lexemes: everything it built
+
+// drop everything the last compilation built and keep the settings
+// (output_dir, tree_format, outputs_in_memory); the tree arena keeps its blocks, so the
+// next compilation reuses them. The abort point is cleared: it belongs to the
+// request that set it
+void compiler_reset(CompilerContext* cc);
+
+// a compilation that cannot go on (the parser giving up, the EXIT token):
+// the process exits with status, or, with an abort point set, cc's
+// exit_status is set and the abort point is jumped to
+void compiler_exit(CompilerContext* cc, int status);
+
+// lex, parse, analyse and generate code for one in-memory source (two NULs
+// after length, see source.h) on the calling thread; returns the syntax tree
+ASTNode* compiler_run(CompilerContext* cc, char* data, size_t length);
+
+// the same from a tree saved with --save-ast (ast_snapshot.h), skipping
+// lexing and parsing; NULL if path is not a usable snapshot
+ASTNode* compiler_run_snapshot(CompilerContext* cc, const char* path);
+
+// output_dir/name of cc (in memory when outputs_in_memory;
+// "r" then reads what was written, NULL if it is empty)
+FILE* compiler_open_output(CompilerContext* cc, const char* name, const char* mode);
+void compiler_output_path(CompilerContext* cc, char* out, size_t size, const char* name);
+
+// an output kept in memory, NULL if the compilation did not write it
+const CompilerOutput* compiler_output(CompilerContext* cc, const char* name);
+
+#endif
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "derivation.h"
+#include "compiler.h"
+
+int derivation_mode = DERIVATION_TEXT;
+
+// set on parallel parse workers (derivation_capture)
+static _Thread_local DerivationBuffer* capture = NULL;
+
+// ====== open the trace for one parse ====================================
+void derivation_begin(CompilerContext* cc) {
+    cc->derivation_step = 1;
+    cc->ring_count = 0;
+    cc->trace_file = NULL;
+
+    if (derivation_mode == DERIVATION_TEXT) {
+        cc->trace_file = compiler_open_output(cc, "derivation.txt", "w");
+        if (!cc->trace_file) {
+            printf("Error:: Cannot create derivation file\n");
+            exit(1);
+        }
+        derivation_write_banner(cc->trace_file);
+    } else if (derivation_mode == DERIVATION_BINARY) {
+        cc->trace_file = compiler_open_output(cc, "derivation.bin", "wb");
+        if (!cc->trace_file) {
+            printf("Error:: Cannot create derivation file\n");
+            exit(1);
+        }
+        fwrite(DERIVATION_MAGIC, 1, 8, cc->trace_file);
+    }
+}
+
+// ====== one step: a byte in the ring, plus the file for text/binary =====
+void derivation_rule(CompilerContext* cc, int rule) {
+    if (capture) {
+        if (capture->count == capture->cap) {
+            capture->cap = capture->cap ? capture->cap * 2 : 4096;
+            capture->data = (unsigned char*)realloc(capture->data, capture->cap);
+            if (!capture->data) {
+                printf("Error:: out of memory for the derivation\n");
+                exit(1);
+            }
+        }
+        capture->data[capture->count++] = (unsigned char)rule;
+        return;
+    }
+    cc->ring[(cc->derivation_step - 1) % DERIVATION_RING_SIZE] = (unsigned char)rule;
+    if (cc->ring_count < DERIVATION_RING_SIZE) cc->ring_count++;
+
+    if (derivation_mode == DERIVATION_TEXT) {
+        fprintf(cc->trace_file, "Step %d: %s\n", cc->derivation_step, derivation_rule_text[rule]);
+    } else if (derivation_mode == DERIVATION_BINARY) {
+        putc(rule, cc->trace_file);
+    }
+    cc->derivation_step++;
+}
+
+// ====== per-thread buffers for the parallel parse =====================
+void derivation_capture(DerivationBuffer* into) {
+    capture = into;
+}
+
+void derivation_replay(CompilerContext* cc, const unsigned char* steps, size_t count) {
+    for (size_t k = 0; k < count; k++) derivation_rule(cc, steps[k]);
+}
+
+void derivation_buffer_free(DerivationBuffer* b) {
+    free(b->data);
+    b->data = NULL;
+    b->count = b->cap = 0;
+}
+
+void derivation_separator(CompilerContext* cc) {
+    if (derivation_mode == DERIVATION_TEXT) {
+        fprintf(cc->trace_file,"======================================\n");
+    } else if (derivation_mode == DERIVATION_BINARY) {
+        putc(DERIVATION_SEPARATOR, cc->trace_file);
+    }
+}
+
+void derivation_error(CompilerContext* cc, const char* message) {
+    if (derivation_mode == DERIVATION_TEXT) {
+        fprintf(cc->trace_file, "ERROR: %s\n", message);
+        return;
+    }
+    if (derivation_mode == DERIVATION_BINARY) {
+        size_t len = strlen(message);
+        if (len > 0xFFFF) len = 0xFFFF;
+        putc(DERIVATION_ERROR, cc->trace_file);
+        putc((int)(len & 0xFF), cc->trace_file);
+        putc((int)(len >> 8), cc->trace_file);
+        fwrite(message, 1, len, cc->trace_file);
+    }
+    // no readable trace on disk, so show where the parser was
+    printf("Last %d derivation steps:\n", cc->ring_count);
+    for (int k = cc->derivation_step - cc->ring_count; k < cc->derivation_step; k++) {
+        printf("Step %d: %s\n", k, derivation_rule_text[cc->ring[(k - 1) % DERIVATION_RING_SIZE]]);
+    }
+}
+
+void derivation_end(CompilerContext* cc) {
+    if (cc->trace_file) fclose(cc->trace_file);
+    cc->trace_file = NULL;
+}
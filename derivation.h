@@ -0,0 +1,112 @@
+#ifndef DERIVATION_H
+#define DERIVATION_H
+
+#include <stdio.h>
+
+struct CompilerContext;
+
+// every rule the recursive descent parser reports, in one place so the
+// trace can store a one-byte id instead of the text
+#define DERIVATION_RULES(X) \
+    X(RULE_PROG,                        "prog -> classOrImplOrFuncList") \
+    X(RULE_CLASSORIMPLORFUNCLIST_ITEM,  "classOrImplOrFuncList -> classOrImplOrFunc classOrImplOrFuncList") \
+    X(RULE_CLASSORIMPLORFUNCLIST_EMPTY, "classOrImplOrFuncList -> ε") \
+    X(RULE_CLASSORIMPLORFUNC_CLASSDECL, "classOrImplOrFunc -> classDecl") \
+    X(RULE_CLASSORIMPLORFUNC_IMPLDEF,   "classOrImplOrFunc -> implDef") \
+    X(RULE_CLASSORIMPLORFUNC_FUNCDEF,   "classOrImplOrFunc -> funcDef") \
+    X(RULE_CLASSDECL,                   "classDecl -> class id isaIdOpt { visibilitymemberDeclList } ;") \
+    X(RULE_IMPLDEF,                     "implDef -> implement id { funcDefList }") \
+    X(RULE_FUNCDEF,                     "funcDef -> funcHead funcBody") \
+    X(RULE_VISIBILITY_PUBLIC,           "visibility -> public") \
+    X(RULE_VISIBILITY_PRIVATE,          "visibility -> private") \
+    X(RULE_MEMBERDECL_FUNCDECL,         "memberDecl -> funcDecl") \
+    X(RULE_MEMBERDECL_FUNCDEF,          "memberDecl -> funcDef") \
+    X(RULE_MEMBERDECL_ATTRIBUTEDECL,    "memberDecl -> attributeDecl") \
+    X(RULE_FUNCHEAD_FUNC,               "funcHead -> func id (fParams) => returnType") \
+    X(RULE_FUNCHEAD_CONSTRUCTOR,        "funcHead -> constructor (fParams)") \
+    X(RULE_FUNCBODY,                    "funcBody -> { varDeclOrStmtList }") \
+    X(RULE_FUNCDECL,                    "funcDecl -> funcHead ;") \
+    X(RULE_VARDECLORSTMT_LOCALVARDECL,  "varDeclOrStmt -> localVarDecl") \
+    X(RULE_VARDECLORSTMT_STATEMENT,     "varDeclOrStmt -> statement") \
+    X(RULE_LOCALVARDECL,                "localVarDecl -> local varDecl") \
+    X(RULE_ATTRIBUTEDECL,               "attributeDecl -> attribute varDecl") \
+    X(RULE_STATEMENT_ASSIGN,            "statement -> assignStat ;") \
+    X(RULE_STATEMENT_CALL,              "statement -> functionCall ;") \
+    X(RULE_STATEMENT_IF,                "statement -> if ( relExpr ) then statBlock else statBlock ;") \
+    X(RULE_STATEMENT_WHILE,             "statement -> while ( relExpr ) statBlock ;") \
+    X(RULE_STATEMENT_READ,              "statement -> read ( variable ) ;") \
+    X(RULE_STATEMENT_WRITE,             "statement -> write ( expr ) ;") \
+    X(RULE_STATEMENT_RETURN,            "statement -> return ( expr ) ;") \
+    X(RULE_STATBLOCK,                   "statBlock -> { statmentList }") \
+    X(RULE_ASSIGNSTAT,                  "assignStat -> variable assignOp expr") \
+    X(RULE_ASSIGNOP,                    "assignOp -> :=") \
+    X(RULE_RELEXPR,                     "relExpr -> arithExpr relOp arithExpr") \
+    X(RULE_INDICE,                      "indice -> [ arithExpr ]") \
+    X(RULE_VARIABLE,                    "variable -> idnestList id indiceList") \
+    X(RULE_FUNCTIONCALL,                "functionCall -> idnestList id ( aParams )") \
+    X(RULE_ARRAYSIZELIST_ITEM,          "arraySizeList -> arraySize arraySizeList") \
+    X(RULE_ARRAYSIZELIST_EMPTY,         "arraySizeList -> ε") \
+    X(RULE_ARRAYSIZE,                   "arraySize -> [ intLit ] | [ ]") \
+    X(RULE_FPARAMSTAILLIST_ITEM,        "fParamsTailList -> fParamsTail fParamsTailList") \
+    X(RULE_FPARAMSTAILLIST_EMPTY,       "fParamsTailList -> ε") \
+    X(RULE_FPARAMSTAIL,                 "fParamsTail -> , id : type arraySizeList") \
+    X(RULE_FPARAMSTAIL_EMPTY,           "fParamsTail -> ε") \
+    X(RULE_IDTAIL,                      "idTail -> , id idTail") \
+    X(RULE_IDTAIL_EMPTY,                "idTail -> ε") \
+    X(RULE_ISAIDOPT,                    "isaIdOpt -> isa id idTail") \
+    X(RULE_ISAIDOPT_EMPTY,              "isaIdOpt -> ε") \
+    X(RULE_PARSE_DONE,                  "Parsing completed!") \
+    X(RULE_PARSE_EXIT,                  "Parsing completed (exit token)") \
+    X(RULE_PARSE_PRINT_SYMBOLS,         "Parsing completed (print_symbols token)")
+
+typedef enum {
+#define X(id, text) id,
+    DERIVATION_RULES(X)
+#undef X
+    RULE_COUNT
+} RuleId;
+
+extern const char* derivation_rule_text[RULE_COUNT];
+
+// files/derivation.txt (text, the default), files/derivation.bin (binary,
+// decode with derivation_decode), or only the in-memory ring (ring)
+typedef enum {
+    DERIVATION_TEXT,
+    DERIVATION_BINARY,
+    DERIVATION_RING
+} DerivationMode;
+
+extern int derivation_mode;
+
+// binary trace: magic, then one byte per step; the two markers below carry
+// the syntax tree separator and error lines of the text file
+#define DERIVATION_MAGIC      "TMA3DRV1"
+#define DERIVATION_SEPARATOR  0xFE
+#define DERIVATION_ERROR      0xFF      // followed by 2-byte length + message
+
+// last steps kept in memory, printed as context when a parse error occurs
+#define DERIVATION_RING_SIZE 32
+
+void derivation_begin(struct CompilerContext* cc);
+void derivation_rule(struct CompilerContext* cc, int rule);
+void derivation_separator(struct CompilerContext* cc);
+void derivation_error(struct CompilerContext* cc, const char* message);
+void derivation_end(struct CompilerContext* cc);
+
+// parallel parse: a worker thread records its steps into a buffer instead of
+// the trace (NULL goes back to the trace); the buffers are replayed in source
+// order once the workers are joined
+typedef struct {
+    unsigned char* data;
+    size_t count;
+    size_t cap;
+} DerivationBuffer;
+
+void derivation_capture(DerivationBuffer* into);
+void derivation_replay(struct CompilerContext* cc, const unsigned char* steps, size_t count);
+void derivation_buffer_free(DerivationBuffer* b);
+
+// text layout shared with the decoder
+void derivation_write_banner(FILE* out);
+
+#endif
@@ -0,0 +1,58 @@
+// derivation_decode: turn files/derivation.bin back into the text trace
+// usage: derivation_decode [input.bin] [output.txt]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "derivation.h"
+
+int main(int argc, char** argv) {
+    const char* in_path = (argc > 1) ? argv[1] : "files/derivation.bin";
+    FILE* in = fopen(in_path, "rb");
+    if (!in) {
+        printf("Error:: Cannot open %s\n", in_path);
+        return 1;
+    }
+    FILE* out = (argc > 2) ? fopen(argv[2], "w") : stdout;
+    if (!out) {
+        printf("Error:: Cannot create %s\n", argv[2]);
+        fclose(in);
+        return 1;
+    }
+
+    char magic[8];
+    if (fread(magic, 1, 8, in) != 8 || memcmp(magic, DERIVATION_MAGIC, 8) != 0) {
+        printf("Error:: %s is not a derivation trace\n", in_path);
+        fclose(in);
+        return 1;
+    }
+
+    derivation_write_banner(out);
+    int step = 1;
+    int c;
+    while ((c = getc(in)) != EOF) {
+        if (c < RULE_COUNT) {
+            fprintf(out, "Step %d: %s\n", step++, derivation_rule_text[c]);
+        } else if (c == DERIVATION_SEPARATOR) {
+            fprintf(out,"======================================\n");
+        } else if (c == DERIVATION_ERROR) {
+            int lo = getc(in), hi = getc(in);
+            if (lo == EOF || hi == EOF) break;
+            size_t len = (size_t)lo | ((size_t)hi << 8);
+            char* msg = (char*)malloc(len + 1);
+            if (!msg || fread(msg, 1, len, in) != len) {
+                free(msg);
+                break;
+            }
+            msg[len] = '\0';
+            fprintf(out, "ERROR: %s\n", msg);
+            free(msg);
+        } else {
+            printf("Error:: unknown rule id %d after step %d\n", c, step - 1);
+            break;
+        }
+    }
+
+    fclose(in);
+    if (out != stdout) fclose(out);
+    return 0;
+}
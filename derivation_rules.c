@@ -0,0 +1,22 @@
+#include <stdio.h>
+#include "derivation.h"
+
+// ====== rule texts and trace layout, shared with derivation_decode =====
+// kept apart from derivation.c, which writes the trace of a compilation,
+// so the decoder links without the rest of the compiler
+
+const char* derivation_rule_text[RULE_COUNT] = {
+#define X(id, text) text,
+    DERIVATION_RULES(X)
+#undef X
+};
+
+void derivation_write_banner(FILE* out) {
+    fprintf(out,"======================================\n");
+    fprintf(out,"EEX6363 - Compiler Construction.\n");
+    fprintf(out,"Name: W.M.A.T.Wanninayake.\n");
+    fprintf(out,"Reg: 321428456 | S.No: S92068456\n");
+    fprintf(out,"======================================\n\n");
+    fprintf(out, "Parsing steps of Program:\n");
+    fprintf(out, "=====================================\n\n");
+}
@@ -0,0 +1,444 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "func_cache.h"
+#include "codegen.h"
+#include "isa2.h"
+#include "stack.h"
+#include "symbols.h"
+#include "symbol_table.h"
+#include "source.h"
+#include "compiler.h"
+
+const char* func_cache_path = NULL;
+
+// code of one function; the last group of fields only means something for
+// the entries of the current run
+typedef struct {
+    unsigned long long key;
+    unsigned long long target_key;      // address map the text was emitted under, 0 = no text
+    int temp_after, label_after;
+    int quad_count;
+    char** quads;                       // 4 per quadruple: op, arg1, arg2, res
+    int alloc_count;
+    char** allocs;                      // names that got their address in this function's code
+    char* text;
+    size_t text_length;
+
+    int quad_start, quad_end;
+    long text_start, text_end;          // where in object_code.txt text generated now went
+    int text_pending;
+} FuncCode;
+
+typedef struct FuncCache {
+    FuncCode* old;                      // loaded from the file, looked up by key
+    int old_count;
+    int* slots;                         // index + 1, 0 = empty
+    unsigned int slot_cap;
+    FuncCode* now;                      // this run, in emission order
+    int now_count;
+    int now_cap;
+    int quads_reused;
+    int text_reused;
+} FuncCache;
+
+
+static void* cache_alloc(size_t size) {
+    void* p = calloc(1, size ? size : 1);
+    if (!p) {
+        printf("Error:: out of memory in the function cache\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void free_code(FuncCode* fc) {
+    for (int i = 0; fc->quads && i < 4 * fc->quad_count; i++) free(fc->quads[i]);
+    for (int i = 0; fc->allocs && i < fc->alloc_count; i++) free(fc->allocs[i]);
+    free(fc->quads);
+    free(fc->allocs);
+    free(fc->text);
+    memset(fc, 0, sizeof(*fc));
+}
+
+void func_cache_free(FuncCache* fc) {
+    if (!fc) return;
+    for (int i = 0; i < fc->old_count; i++) free_code(&fc->old[i]);
+    for (int i = 0; i < fc->now_count; i++) free_code(&fc->now[i]);
+    free(fc->old);
+    free(fc->now);
+    free(fc->slots);
+    free(fc);
+}
+
+int func_cache_active(CompilerContext* cc) {
+    return cc->func_cache != NULL;
+}
+
+// ====== fingerprints ====================================================
+#define FNV_BASIS 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+static unsigned long long hash_bytes(unsigned long long h, const void* p, size_t n) {
+    const unsigned char* b = (const unsigned char*)p;
+    for (size_t i = 0; i < n; i++) {
+        h ^= b[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static unsigned long long hash_int(unsigned long long h, long long v) {
+    return hash_bytes(h, &v, sizeof(v));
+}
+
+// a name by its text (ids differ between runs) and by what code generation
+// will make of it: is_local_variable / get_stack_offset only look at the
+// entry st_lookup_global finds
+static unsigned long long hash_name(CompilerContext* cc, unsigned long long h, int id) {
+    if (id == INTERN_NONE) return hash_int(h, -1);
+    const char* text = intern_name(cc, id);
+    h = hash_bytes(h, text, strlen(text) + 1);
+    SymbolEntry* sym = st_lookup_global_id(cc, id);
+    if (!sym) return hash_int(h, 0);
+    if (sym->scopeLevel > 0 && sym->kind != SYM_CLASS) return hash_int(hash_int(h, 1), sym->offset);
+    return hash_int(h, 2);
+}
+
+static unsigned long long hash_abs(CompilerContext* cc, unsigned long long h, const AbsNode* n) {
+    if (!n) return hash_int(h, -1);
+    h = hash_int(h, n->kind);
+    h = hash_int(h, n->op);
+    h = hash_name(cc, h, n->name);
+    switch (n->kind) {
+    case ABS_BINARY:
+        h = hash_abs(cc, h, n->as.binary.lhs);
+        h = hash_abs(cc, h, n->as.binary.rhs);
+        break;
+    case ABS_UNARY:
+        h = hash_abs(cc, h, n->as.unary.operand);
+        break;
+    case ABS_ASSIGN:
+        h = hash_abs(cc, h, n->as.assign.target);
+        h = hash_abs(cc, h, n->as.assign.value);
+        break;
+    case ABS_IF:
+        h = hash_abs(cc, h, n->as.if_stmt.cond);
+        h = hash_abs(cc, h, n->as.if_stmt.then_part);
+        h = hash_abs(cc, h, n->as.if_stmt.else_part);
+        break;
+    case ABS_WHILE:
+        h = hash_abs(cc, h, n->as.while_stmt.cond);
+        h = hash_abs(cc, h, n->as.while_stmt.body);
+        break;
+    case ABS_READ: case ABS_WRITE: case ABS_RETURN:
+        h = hash_abs(cc, h, n->as.io.operand);
+        break;
+    case ABS_MEMBER:
+        h = hash_abs(cc, h, n->as.member.object);
+        break;
+    case ABS_INDEX:
+        h = hash_abs(cc, h, n->as.index.base);
+        h = hash_abs(cc, h, n->as.index.index);
+        break;
+    case ABS_CALL:
+        h = hash_abs(cc, h, n->as.call.callee);
+        break;
+    case ABS_FUNC:
+        h = hash_int(h, n->as.func.is_member);
+        h = hash_abs(cc, h, n->as.func.params);
+        h = hash_abs(cc, h, n->as.func.body);
+        break;
+    case ABS_CLASS:
+        h = hash_abs(cc, h, n->as.class_decl.parents);
+        break;
+    default:
+        break;
+    }
+    h = hash_int(h, n->count);
+    for (int i = 0; i < n->count; i++) h = hash_abs(cc, h, n->items[i]);
+    return h;
+}
+
+// the address map is fixed by the names that got an address so far, in order
+static unsigned long long target_key(CompilerContext* cc, unsigned long long key) {
+    unsigned long long h = hash_int(key, cc->next_global_addr);
+    h = hash_int(h, (long long)cc->global_order_hash);
+    return h ? h : 1;
+}
+
+// ====== file ============================================================
+typedef struct {
+    const char* buf;
+    size_t size;
+    size_t pos;
+    int bad;
+} Reader;
+
+static void read_raw(Reader* r, void* out, size_t n) {
+    if (r->bad || r->size - r->pos < n) {
+        r->bad = 1;
+        memset(out, 0, n);
+        return;
+    }
+    memcpy(out, r->buf + r->pos, n);
+    r->pos += n;
+}
+
+static char* read_string(Reader* r) {
+    int length;
+    read_raw(r, &length, sizeof(length));
+    if (r->bad || length < 0) return NULL;
+    if (r->size - r->pos < (size_t)length) {
+        r->bad = 1;
+        return NULL;
+    }
+    char* s = (char*)cache_alloc((size_t)length + 1);
+    memcpy(s, r->buf + r->pos, (size_t)length);
+    r->pos += (size_t)length;
+    return s;
+}
+
+static int read_code(Reader* r, FuncCode* fc) {
+    unsigned long long text_length;
+    read_raw(r, &fc->key, sizeof(fc->key));
+    read_raw(r, &fc->target_key, sizeof(fc->target_key));
+    read_raw(r, &fc->temp_after, sizeof(int));
+    read_raw(r, &fc->label_after, sizeof(int));
+    read_raw(r, &fc->quad_count, sizeof(int));
+    read_raw(r, &fc->alloc_count, sizeof(int));
+    read_raw(r, &text_length, sizeof(text_length));
+    // every quadruple string and name takes at least its length field
+    size_t left = r->size - r->pos;
+    if (r->bad || fc->quad_count < 0 || fc->alloc_count < 0 ||
+        (size_t)fc->quad_count > left / (4 * sizeof(int)) || (size_t)fc->alloc_count > left / sizeof(int) ||
+        text_length > left) {
+        fc->quad_count = fc->alloc_count = 0;
+        return 0;
+    }
+    fc->quads = (char**)cache_alloc(sizeof(char*) * 4 * (size_t)fc->quad_count);
+    for (int i = 0; i < 4 * fc->quad_count; i++) fc->quads[i] = read_string(r);
+    fc->allocs = (char**)cache_alloc(sizeof(char*) * (size_t)fc->alloc_count);
+    for (int i = 0; i < fc->alloc_count; i++) {
+        fc->allocs[i] = read_string(r);
+        if (!fc->allocs[i]) r->bad = 1;
+    }
+    if (r->bad || r->size - r->pos < text_length) return 0;
+    fc->text_length = (size_t)text_length;
+    fc->text = (char*)cache_alloc(fc->text_length);
+    memcpy(fc->text, r->buf + r->pos, fc->text_length);
+    r->pos += fc->text_length;
+    return 1;
+}
+
+static void index_old(FuncCache* fc) {
+    fc->slot_cap = 16;
+    while (fc->slot_cap < (unsigned int)fc->old_count * 2) fc->slot_cap *= 2;
+    fc->slots = (int*)cache_alloc(sizeof(int) * fc->slot_cap);
+    for (int i = 0; i < fc->old_count; i++) {
+        unsigned int s = (unsigned int)fc->old[i].key & (fc->slot_cap - 1);
+        while (fc->slots[s]) s = (s + 1) & (fc->slot_cap - 1);
+        fc->slots[s] = i + 1;
+    }
+}
+
+void func_cache_open(CompilerContext* cc) {
+    func_cache_free(cc->func_cache);
+    cc->func_cache = NULL;
+    if (!func_cache_path) return;
+    FuncCache* fc = (FuncCache*)cache_alloc(sizeof(FuncCache));
+    cc->func_cache = fc;
+
+    // a missing, stale or damaged file just means nothing is reused
+    SourceBuffer file;
+    if (source_open(&file, func_cache_path) == 0) {
+        Reader r = { file.data, file.length, 0, 0 };
+        char magic[8];
+        int count = 0;
+        read_raw(&r, magic, sizeof(magic));
+        read_raw(&r, &count, sizeof(count));
+        if (!r.bad && memcmp(magic, FUNC_CACHE_MAGIC, 8) == 0 && count > 0 && (size_t)count <= file.length / 40) {
+            fc->old = (FuncCode*)cache_alloc(sizeof(FuncCode) * (size_t)count);
+            while (fc->old_count < count) {
+                int ok = read_code(&r, &fc->old[fc->old_count]);
+                fc->old_count++;
+                if (!ok) {
+                    for (int i = 0; i < fc->old_count; i++) free_code(&fc->old[i]);
+                    fc->old_count = 0;
+                    break;
+                }
+            }
+        }
+        source_close(&file);
+    }
+    index_old(fc);
+}
+
+static void write_string(FILE* f, const char* s) {
+    int length = s ? (int)strlen(s) : -1;
+    fwrite(&length, sizeof(length), 1, f);
+    if (s) fwrite(s, 1, (size_t)length, f);
+}
+
+void func_cache_save(CompilerContext* cc) {
+    FuncCache* fc = cc->func_cache;
+    if (!fc) return;
+    char tmp[1024];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", func_cache_path);
+    FILE* f = fopen(tmp, "wb");
+    if (!f) {
+        printf("Warning:: cannot write function cache %s\n", tmp);
+        return;
+    }
+    fwrite(FUNC_CACHE_MAGIC, 1, 8, f);
+    fwrite(&fc->now_count, sizeof(int), 1, f);
+    for (int i = 0; i < fc->now_count; i++) {
+        FuncCode* c = &fc->now[i];
+        unsigned long long text_length = c->text_length;
+        fwrite(&c->key, sizeof(c->key), 1, f);
+        fwrite(&c->target_key, sizeof(c->target_key), 1, f);
+        fwrite(&c->temp_after, sizeof(int), 1, f);
+        fwrite(&c->label_after, sizeof(int), 1, f);
+        fwrite(&c->quad_count, sizeof(int), 1, f);
+        fwrite(&c->alloc_count, sizeof(int), 1, f);
+        fwrite(&text_length, sizeof(text_length), 1, f);
+        for (int q = 0; q < 4 * c->quad_count; q++) write_string(f, c->quads[q]);
+        for (int a = 0; a < c->alloc_count; a++) write_string(f, c->allocs[a]);
+        fwrite(c->text, 1, c->text_length, f);
+    }
+    int failed = ferror(f);
+    if (fclose(f) != 0 || failed) {
+        remove(tmp);
+        printf("Warning:: cannot write function cache %s\n", tmp);
+        return;
+    }
+    remove(func_cache_path);   // rename() won't replace an existing file on Windows
+    rename(tmp, func_cache_path);
+    printf("[CODEGEN]: incremental: quadruples of %d/%d functions and object code of %d reused\n",
+           fc->quads_reused, fc->now_count, fc->text_reused);
+}
+
+// ====== quadruples ======================================================
+static FuncCode* take_old(FuncCache* fc, unsigned long long key) {
+    unsigned int s = (unsigned int)key & (fc->slot_cap - 1);
+    while (fc->slots[s]) {
+        FuncCode* old = &fc->old[fc->slots[s] - 1];
+        if (old->key == key && old->quads) return old;
+        s = (s + 1) & (fc->slot_cap - 1);
+    }
+    return NULL;
+}
+
+int func_cache_begin(CompilerContext* cc, const AbsNode* f, int with_frame) {
+    FuncCache* fc = cc->func_cache;
+    if (!fc) return 0;
+    if (fc->now_count == fc->now_cap) {
+        fc->now_cap = fc->now_cap ? fc->now_cap * 2 : 64;
+        fc->now = (FuncCode*)realloc(fc->now, sizeof(FuncCode) * fc->now_cap);
+        if (!fc->now) {
+            printf("Error:: out of memory in the function cache\n");
+            exit(1);
+        }
+    }
+    FuncCode* c = &fc->now[fc->now_count++];
+    memset(c, 0, sizeof(*c));
+
+    unsigned long long h = hash_int(FNV_BASIS, with_frame);
+    h = hash_int(h, cc->temp_counter);
+    h = hash_int(h, cc->label_counter);
+    h = hash_int(h, cc->quad_count);
+    c->key = hash_abs(cc, h, f);
+    c->quad_start = cc->quad_count;
+
+    FuncCode* old = take_old(fc, c->key);
+    if (!old) return 0;
+
+    // the entry moves over to this run
+    unsigned long long key = c->key;
+    *c = *old;
+    memset(old, 0, sizeof(*old));
+    c->key = key;
+    c->quad_start = cc->quad_count;
+    for (int i = 0; i < c->quad_count; i++) {
+        char** q = &c->quads[4 * i];
+        emit_quad(cc, q[0], q[1], q[2], q[3]);
+    }
+    c->quad_end = cc->quad_count;
+    cc->temp_counter = c->temp_after;
+    cc->label_counter = c->label_after;
+    fc->quads_reused++;
+    return 1;
+}
+
+void func_cache_end(CompilerContext* cc) {
+    FuncCache* fc = cc->func_cache;
+    if (!fc) return;
+    FuncCode* c = &fc->now[fc->now_count - 1];
+    Quadruple* q = get_quad_list(cc);
+    c->quad_end = cc->quad_count;
+    c->quad_count = c->quad_end - c->quad_start;
+    c->quads = (char**)cache_alloc(sizeof(char*) * 4 * (size_t)c->quad_count);
+    for (int i = 0; i < c->quad_count; i++) {
+        Quadruple* from = &q[c->quad_start + i];
+        c->quads[4 * i] = from->op ? strdup(from->op) : NULL;
+        c->quads[4 * i + 1] = from->arg1 ? strdup(from->arg1) : NULL;
+        c->quads[4 * i + 2] = from->arg2 ? strdup(from->arg2) : NULL;
+        c->quads[4 * i + 3] = from->res ? strdup(from->res) : NULL;
+    }
+    c->temp_after = cc->temp_counter;
+    c->label_after = cc->label_counter;
+}
+
+// ====== object code =====================================================
+static void emit_fresh(CompilerContext* cc, FILE* out, FuncCode* c, unsigned long long key) {
+    for (int i = 0; i < c->alloc_count; i++) free(c->allocs[i]);
+    free(c->allocs);
+    free(c->text);
+    c->text = NULL;
+    c->text_length = 0;
+
+    int order_start = cc->global_order_count;
+    c->target_key = key;
+    c->text_start = ftell(out);
+    isa2_emit_range(cc, out, c->quad_start, c->quad_end);
+    c->text_end = ftell(out);
+    c->text_pending = 1;
+
+    c->alloc_count = cc->global_order_count - order_start;
+    c->allocs = (char**)cache_alloc(sizeof(char*) * (size_t)c->alloc_count);
+    for (int i = 0; i < c->alloc_count; i++)
+        c->allocs[i] = strdup(intern_name(cc, cc->global_order[order_start + i]));
+}
+
+void func_cache_write_target(CompilerContext* cc, FILE* out) {
+    FuncCache* fc = cc->func_cache;
+    int done = 0;
+    for (int i = 0; i < fc->now_count; i++) {
+        FuncCode* c = &fc->now[i];
+        if (c->quad_start > done) isa2_emit_range(cc, out, done, c->quad_start);
+        unsigned long long key = target_key(cc, c->key);
+        if (c->text && c->target_key == key) {
+            // same quadruples, same addresses: hand out the addresses the text uses
+            for (int a = 0; a < c->alloc_count; a++) get_variable_location_id(cc, intern(cc, c->allocs[a]));
+            fwrite(c->text, 1, c->text_length, out);
+            fc->text_reused++;
+        } else {
+            emit_fresh(cc, out, c, key);
+        }
+        done = c->quad_end;
+    }
+    if (done < cc->quad_count) isa2_emit_range(cc, out, done, cc->quad_count);
+
+    // read back what was generated now (the file is open w+)
+    fflush(out);
+    for (int i = 0; i < fc->now_count; i++) {
+        FuncCode* c = &fc->now[i];
+        if (!c->text_pending) continue;
+        c->text_pending = 0;
+        size_t length = c->text_end > c->text_start ? (size_t)(c->text_end - c->text_start) : 0;
+        c->text = (char*)cache_alloc(length);
+        if (fseek(out, c->text_start, SEEK_SET) == 0) c->text_length = fread(c->text, 1, length, out);
+        if (c->text_length != length) c->target_key = 0;    // short read (text mode): don't reuse it
+    }
+    fseek(out, 0, SEEK_END);
+}
@@ -0,0 +1,55 @@
+#ifndef FUNC_CACHE_H
+#define FUNC_CACHE_H
+
+#include <stdio.h>
+#include "lower.h"
+
+// ====== function-granular incremental code generation ===================
+// --incremental=FILE keeps the quadruples and ISA2 text of every function in
+// FILE between runs. Code of a function depends on more than its own body:
+// temporaries and labels are numbered across the whole program, the _skip
+// labels of ISA2 use the quadruple index, st_lookup_global may find an entry
+// of another scope, and globals and temporaries get addresses in first-use
+// order. So the fingerprint a function's quadruples are reused under covers
+//   - its lowered subtree (kinds, operators, names, literals),
+//   - what the symbol table says about every name in it (local + offset),
+//   - the temporary and label counters and quadruple count it starts at,
+// and its object code is reused only if, in addition, the addresses handed
+// out before it are the same ones as when it was saved. An edit inside one
+// body that keeps its temporary, label and quadruple counts therefore
+// regenerates just that function; one that changes them regenerates the
+// functions after it as well.
+//
+// file layout (native byte order, like the token cache):
+//   "TMA3FNC1", int entry count, then per function in emission order
+//   u64 key, u64 target key, int temps after, int labels after,
+//   int quad count, int alloc count, u64 text length,
+//   4 x quad count strings (op, arg1, arg2, res), alloc count names,
+//   text bytes; a string is int length (-1 = NULL) followed by its bytes
+#define FUNC_CACHE_MAGIC "TMA3FNC1"
+
+struct FuncCache;
+
+// NULL = off (--incremental=FILE)
+extern const char* func_cache_path;
+
+// load FILE for cc; generate_ir calls it before the
+// first function
+void func_cache_open(struct CompilerContext* cc);
+int func_cache_active(struct CompilerContext* cc);
+
+// around the code of one function, in emission order: begin returns 1 if
+// the cached quadruples were replayed (skip the function), else the caller
+// generates them and calls end
+int func_cache_begin(struct CompilerContext* cc, const AbsNode* f, int with_frame);
+void func_cache_end(struct CompilerContext* cc);
+
+// the ISA2 body of object_code.txt: cached text where the fingerprint and
+// the address map still match, isa2_emit_range for the rest
+void func_cache_write_target(struct CompilerContext* cc, FILE* out);
+
+// write this run's functions back to FILE and report what was reused
+void func_cache_save(struct CompilerContext* cc);
+void func_cache_free(struct FuncCache* fc);
+
+#endif
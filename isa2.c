@@ -4,29 +4,13 @@
 #include "isa2.h"
 #include "codegen.h"
 #include "stack.h"
+#include "compiler.h"
+#include "func_cache.h"
 
-void generate_isa2_target() {
-    FILE* out = fopen("files/object_code.txt", "w");
-    if (!out) return;
-    
-    Quadruple* q = get_quad_list();
-    int count = get_quad_count();
-    
-    fprintf(out, "============================================================\n");
-    fprintf(out, "       ISA 2 Accumulator Assembly\n");
-    fprintf(out, "============================================================\n");
-    fprintf(out, "  stack pointer, base pointer have reserved addresses\n");
-    fprintf(out, "  seperate region for stack data memory\n");
-    fprintf(out, "  seperate region for global variables\n");
-    fprintf(out, "============================================================\n");
-    fprintf(out, "\n");
-    fprintf(out, "main_entry:\n");
-    fprintf(out, "        loadacc #%d\n", STACK_BASE); 
-    fprintf(out, "        storeacc %d\n", VREG_SP);
-    fprintf(out, "        storeacc %d\n", VREG_BP); 
-    fprintf(out, "\n");
+void isa2_emit_range(CompilerContext* cc, FILE* out, int from, int to) {
+    Quadruple* q = get_quad_list(cc);
 
-    for (int i=0; i<count; i++) {
+    for (int i=from; i<to; i++) {
         char* op = q[i].op ? q[i].op : "";
         
         if (strcmp(op, "label")==0) {
@@ -91,15 +75,15 @@ void generate_isa2_target() {
             } else {
                 fprintf(out, "        sub #%d\n", -offset);
             }
-            int resAddr = get_var_address(q[i].res);
+            int resAddr = get_var_address_id(cc, q[i].res_id);
             fprintf(out, "        storeacc %d\n", resAddr);
             continue;
         }
         
         if (strcmp(op, "loadStack")==0) {
             // load from stack
-            int addrTemp = get_var_address(q[i].arg1);
-            int resAddr = get_var_address(q[i].res);
+            int addrTemp = get_var_address_id(cc, q[i].arg1_id);
+            int resAddr = get_var_address_id(cc, q[i].res_id);
             fprintf(out, "        loadacc %d\n", addrTemp);
             fprintf(out, "        storeacc %d\n", VREG_PTR);
             fprintf(out, "        loadacc &%d\n", VREG_PTR);
@@ -109,8 +93,8 @@ void generate_isa2_target() {
         
         if (strcmp(op, "storeStack")==0) {
             // store to stack
-            int valAddr = get_var_address(q[i].arg1);
-            int addrTemp = get_var_address(q[i].res);
+            int valAddr = get_var_address_id(cc, q[i].arg1_id);
+            int addrTemp = get_var_address_id(cc, q[i].res_id);
             fprintf(out, "        loadacc %d\n", addrTemp);
             fprintf(out, "        storeacc %d\n", VREG_PTR);
             if (valAddr == -1) {
@@ -124,13 +108,13 @@ void generate_isa2_target() {
         
         if (strcmp(op, "call")==0) {
             fprintf(out, "        call %s\n", q[i].arg1);
-            int r = get_var_address(q[i].res);
+            int r = get_var_address_id(cc, q[i].res_id);
             fprintf(out, "        storeacc %d\n", r);
             continue;
         }
         if (strcmp(op, "return")==0) {
             if (q[i].arg1) {
-                int v = get_var_address(q[i].arg1);
+                int v = get_var_address_id(cc, q[i].arg1_id);
                 if (v==-1) fprintf(out, "        loadacc #%s\n", q[i].arg1);
                 else fprintf(out, "        loadacc %d\n", v);
             }
@@ -140,8 +124,8 @@ void generate_isa2_target() {
 
         // --- Assignment operations ---
         if (strcmp(op, "assign")==0) {
-            int s = get_var_address(q[i].arg1);
-            int d = get_var_address(q[i].res);
+            int s = get_var_address_id(cc, q[i].arg1_id);
+            int d = get_var_address_id(cc, q[i].res_id);
             if (s==-1) fprintf(out, "        loadacc #%s\n", q[i].arg1);
             else fprintf(out, "        loadacc %d\n", s);
             fprintf(out, "        storeacc %d\n", d);
@@ -150,12 +134,12 @@ void generate_isa2_target() {
 
         // --- Array operations---
         if (strcmp(op, "store")==0) { 
-            int b = get_var_address(q[i].res);
-            int o = get_var_address(q[i].arg2);
-            int v = get_var_address(q[i].arg1);
+            int b = get_var_address_id(cc, q[i].res_id);
+            int o = get_var_address_id(cc, q[i].arg2_id);
+            int v = get_var_address_id(cc, q[i].arg1_id);
             fprintf(out, "        loadacc #%d\n", b);
             fprintf(out, "        add %d\n", o);
-            int p = get_var_address("PTR");
+            int p = get_var_address(cc, "PTR");
             fprintf(out, "        storeacc %d\n", p);
             if (v==-1) fprintf(out, "        loadacc #%s\n", q[i].arg1);
             else fprintf(out, "        loadacc %d\n", v);
@@ -163,12 +147,12 @@ void generate_isa2_target() {
             continue;
         }
         if (strcmp(op, "load")==0) { 
-            int b = get_var_address(q[i].arg1);
-            int o = get_var_address(q[i].arg2);
-            int d = get_var_address(q[i].res);
+            int b = get_var_address_id(cc, q[i].arg1_id);
+            int o = get_var_address_id(cc, q[i].arg2_id);
+            int d = get_var_address_id(cc, q[i].res_id);
             fprintf(out, "        loadacc #%d\n", b);
             fprintf(out, "        add %d\n", o);
-            int p = get_var_address("PTR");
+            int p = get_var_address(cc, "PTR");
             fprintf(out, "        storeacc %d\n", p);
             fprintf(out, "        loadacc &%d\n", p);
             fprintf(out, "        storeacc %d\n", d);
@@ -179,9 +163,9 @@ void generate_isa2_target() {
         if (strcmp(op, "+")==0 || strcmp(op, "-")==0 || 
             strcmp(op, "*")==0 || strcmp(op, "/")==0) {
             
-            int a1 = get_var_address(q[i].arg1);
-            int a2 = get_var_address(q[i].arg2);
-            int r = get_var_address(q[i].res);
+            int a1 = get_var_address_id(cc, q[i].arg1_id);
+            int a2 = get_var_address_id(cc, q[i].arg2_id);
+            int r = get_var_address_id(cc, q[i].res_id);
             
             if (a1==-1) fprintf(out, "        loadacc #%s\n", q[i].arg1);
             else fprintf(out, "        loadacc %d\n", a1);
@@ -200,9 +184,9 @@ void generate_isa2_target() {
 
         // --- Logical operations---
         if (strcmp(op, "and")==0 || strcmp(op, "or")==0 || strcmp(op, "xor")==0) {
-            int a1 = get_var_address(q[i].arg1);
-            int a2 = get_var_address(q[i].arg2);
-            int r = get_var_address(q[i].res);
+            int a1 = get_var_address_id(cc, q[i].arg1_id);
+            int a2 = get_var_address_id(cc, q[i].arg2_id);
+            int r = get_var_address_id(cc, q[i].res_id);
 
             if (a1==-1) fprintf(out, "        loadacc #%s\n", q[i].arg1);
             else fprintf(out, "        loadacc %d\n", a1);
@@ -219,8 +203,8 @@ void generate_isa2_target() {
         }
 
         if (strcmp(op, "not")==0) {
-            int a1 = get_var_address(q[i].arg1);
-            int r = get_var_address(q[i].res);
+            int a1 = get_var_address_id(cc, q[i].arg1_id);
+            int r = get_var_address_id(cc, q[i].res_id);
             if (a1==-1) fprintf(out, "        loadacc #%s\n", q[i].arg1);
             else fprintf(out, "        loadacc %d\n", a1);
             fprintf(out, "        not\n");
@@ -231,8 +215,8 @@ void generate_isa2_target() {
         // --- Condition operations---
         if (strcmp(op, "==")==0 || strcmp(op, "<")==0 || strcmp(op, ">")==0 || 
             strcmp(op, ">=")==0 || strcmp(op, "<=")==0) {
-            int a1 = get_var_address(q[i].arg1);
-            int a2 = get_var_address(q[i].arg2);
+            int a1 = get_var_address_id(cc, q[i].arg1_id);
+            int a2 = get_var_address_id(cc, q[i].arg2_id);
             
             if (a1==-1) fprintf(out, "        loadacc #%s\n", q[i].arg1);
             else fprintf(out, "        loadacc %d\n", a1);
@@ -254,13 +238,36 @@ void generate_isa2_target() {
         }
         
         if (strcmp(op, "write")==0) {
-            int v = get_var_address(q[i].arg1);
+            int v = get_var_address_id(cc, q[i].arg1_id);
             if (v==-1) fprintf(out, "        loadacc #%s\n", q[i].arg1);
             else fprintf(out, "        loadacc %d\n", v);
             fprintf(out, "        storeacc 5000 ; Output\n");
             continue;
         }
     }
+}
+
+void generate_isa2_target(CompilerContext* cc) {
+    // read back by the function cache, hence w+
+    FILE* out = compiler_open_output(cc, "object_code.txt", "w+");
+    if (!out) return;
+    
+    fprintf(out, "============================================================\n");
+    fprintf(out, "       ISA 2 Accumulator Assembly\n");
+    fprintf(out, "============================================================\n");
+    fprintf(out, "  stack pointer, base pointer have reserved addresses\n");
+    fprintf(out, "  seperate region for stack data memory\n");
+    fprintf(out, "  seperate region for global variables\n");
+    fprintf(out, "============================================================\n");
+    fprintf(out, "\n");
+    fprintf(out, "main_entry:\n");
+    fprintf(out, "        loadacc #%d\n", STACK_BASE); 
+    fprintf(out, "        storeacc %d\n", VREG_SP);
+    fprintf(out, "        storeacc %d\n", VREG_BP); 
+    fprintf(out, "\n");
+
+    if (func_cache_active(cc)) func_cache_write_target(cc, out);
+    else isa2_emit_range(cc, out, 0, get_quad_count(cc));
     fprintf(out, "        hlt\n");
     fclose(out);
-}
\ No newline at end of file
+}
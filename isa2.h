@@ -1,8 +1,12 @@
 #ifndef ISA2_H
 #define ISA2_H
 
+#include <stdio.h>
 #include "codegen.h" 
 
-void generate_isa2_target();
+void generate_isa2_target(struct CompilerContext* cc);
+
+// ISA2 code for quadruples [from, to) of cc
+void isa2_emit_range(struct CompilerContext* cc, FILE* out, int from, int to);
 
 #endif
\ No newline at end of file
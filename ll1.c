@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ll1.h"
+#include "parser.h"
+#include "y.tab.h"
+#include "log.h"
+#include "compiler.h"
+#include "ll1_table.h"
+
+// token value -> table column, built on first use
+#define LL1_TOKEN_LIMIT 512
+static short token_column[LL1_TOKEN_LIMIT];
+static int columns_ready = 0;
+
+void ll1_init() {
+    if (columns_ready) return;
+    for (int t = 0; t < LL1_TOKEN_LIMIT; t++) token_column[t] = -1;
+    for (int c = 0; c < LL1_TERMINAL_COUNT; c++) token_column[ll1_terminal[c]] = (short)c;
+    columns_ready = 1;
+}
+
+static int column_of(int token) {
+    if (!columns_ready) ll1_init();
+    return (token >= 0 && token < LL1_TOKEN_LIMIT) ? token_column[token] : -1;
+}
+
+// ====== parse stack: pending symbols and the node their subtrees hang under =====
+typedef struct {
+    LL1Symbol symbol;
+    ASTNode* parent;
+} StackEntry;
+
+typedef struct {
+    StackEntry* data;
+    size_t count;
+    size_t cap;
+} ParseStack;
+
+static void stack_push(ParseStack* s, LL1Symbol symbol, ASTNode* parent) {
+    if (s->count == s->cap) {
+        s->cap = s->cap ? s->cap * 2 : 256;
+        s->data = (StackEntry*)realloc(s->data, sizeof(StackEntry) * s->cap);
+        if (!s->data) {
+            printf("Error:: out of memory for the parse stack\n");
+            exit(1);
+        }
+    }
+    s->data[s->count].symbol = symbol;
+    s->data[s->count].parent = parent;
+    s->count++;
+}
+
+// error() may leave the parse by longjmp (the compile server carries on after
+// it), so the stack is per thread rather than local: a parse that never got to
+// free it hands it to the next one instead of leaking it
+static _Thread_local ParseStack stack = {0};
+
+// ====== driver =====
+ASTNode* ll1_parse(CompilerContext* cc) {
+    stack.count = 0;
+    ASTNode* root = NULL;
+    size_t max_depth = 0;
+
+    LL1Symbol start = { LL1_N, 0 };
+    stack_push(&stack, start, NULL);
+    while (stack.count > 0) {
+        if (stack.count > max_depth) max_depth = stack.count;
+        StackEntry top = stack.data[--stack.count];
+        switch (top.symbol.type) {
+        case LL1_A:
+            write_derivation(cc, top.symbol.value);
+            break;
+
+        case LL1_T: {
+            // the leaf is taken from the current token before match() moves on
+            ASTNode* leaf = token_leaf(cc, top.symbol.value);
+            match(cc, top.symbol.value);
+            addChild(top.parent, leaf);
+            break;
+        }
+
+        case LL1_N: {
+            int nt = top.symbol.value;
+            if (ll1_external[nt]) {
+                // expressions: the precedence-climbing functions in parser.c
+                ASTNode* sub = ll1_external[nt](cc);
+                if (top.parent) addChild(top.parent, sub);
+                else root = sub;
+                break;
+            }
+            int col = column_of(lookahead_token);
+            int p = col >= 0 ? ll1_table[nt][col] : -1;
+            if (p < 0) p = ll1_default[nt];
+            if (p < 0) {
+                char error_msg[256];
+                snprintf(error_msg, sizeof(error_msg), "No rule for %s on token %d",
+                         ll1_nonterminal_text[nt], lookahead_token);
+                error(cc, error_msg);
+            }
+
+            ASTNode* parent = top.parent;
+            if (ll1_node_name[nt]) {
+                ASTNode* node = createNode(cc, ll1_node_name[nt], "");
+                if (parent) addChild(parent, node);
+                else root = node;
+                parent = node;
+            }
+            const LL1Production* prod = &ll1_productions[p];
+            for (int k = prod->length - 1; k >= 0; k--)
+                stack_push(&stack, ll1_symbols[prod->first + k], parent);
+            break;
+        }
+        }
+    }
+    LOG_DEBUG(LOG_PARSER, "LL(1) parse: stack depth max %zu\n", max_depth);
+    free(stack.data);
+    stack.data = NULL;
+    stack.cap = 0;
+    return root;
+}
@@ -0,0 +1,32 @@
+#ifndef LL1_H
+#define LL1_H
+
+#include "ast.h"
+
+// symbols in a production body of the generated table (ll1_table.h)
+typedef enum {
+    LL1_T,      // terminal: token to match
+    LL1_N,      // nonterminal: index into the table rows
+    LL1_A       // action: derivation rule to record
+} LL1SymbolType;
+
+typedef struct {
+    unsigned char type;
+    short value;
+} LL1Symbol;
+
+typedef struct {
+    int lhs;
+    int first;      // offset of the body in ll1_symbols
+    int length;
+} LL1Production;
+
+// --parser=table: parses prog with the table from grammar_ll1.txt and an
+// explicit stack on the heap, building the same tree as the recursive
+// descent functions; long lists and deep nesting no longer use C stack
+ASTNode* ll1_parse(struct CompilerContext* cc);
+
+// token -> table column map, built on first use (compiler_init builds it up front)
+void ll1_init();
+
+#endif
@@ -0,0 +1,653 @@
+// generated by ll1gen from grammar_ll1.txt, do not edit
+// regenerate: ll1gen grammar_ll1.txt ll1_table.h
+#ifndef LL1_TABLE_H
+#define LL1_TABLE_H
+
+#define LL1_NONTERMINAL_COUNT 59
+#define LL1_TERMINAL_COUNT 48
+#define LL1_PRODUCTION_COUNT 117
+
+static const char* const ll1_nonterminal_text[LL1_NONTERMINAL_COUNT] = {
+    "prog",
+    "classOrImplOrFuncList",
+    "classOrImplOrFunc",
+    "classDecl",
+    "isaIdOpt",
+    "idTail",
+    "visibilitymemberDeclList",
+    "implDef",
+    "funcDefList",
+    "funcDef",
+    "visibility",
+    "memberDecl",
+    "_memberDeclRest",
+    "_optSemicolon",
+    "funcHead",
+    "funcBody",
+    "varDeclOrStmtList",
+    "varDeclOrStmt",
+    "attributeDecl",
+    "localVarDecl",
+    "varDecl",
+    "arraySizeList",
+    "statement",
+    "assignStat",
+    "assignOp",
+    "statBlock",
+    "statmentList",
+    "expr",
+    "_relTail",
+    "relExpr",
+    "arithExpr",
+    "arithExprTail",
+    "sign",
+    "term",
+    "termTail",
+    "factor",
+    "variable",
+    "idnestList",
+    "idnestList~some",
+    "idnest",
+    "idnestTail",
+    "_optDot",
+    "indiceList",
+    "indiceList~some",
+    "idOrSelf",
+    "indice",
+    "arraySize",
+    "_optIntLit",
+    "type",
+    "returnType",
+    "fParams",
+    "fParamsTailList",
+    "fParamsTail",
+    "aParams",
+    "aParamsTailList",
+    "aParamsTail",
+    "relOp",
+    "addOp",
+    "multOp",
+};
+
+// AST node built for each nonterminal, NULL for helpers
+static const char* const ll1_node_name[LL1_NONTERMINAL_COUNT] = {
+    "prog",
+    "classOrImplOrFuncList",
+    "classOrImplOrFunc",
+    "classDecl",
+    "isaIdOpt",
+    "idTail",
+    "visibilitymemberDeclList",
+    "implDef",
+    "funcDefList",
+    "funcDef",
+    "visibility",
+    "memberDecl",
+    NULL,
+    NULL,
+    "funcHead",
+    "funcBody",
+    "varDeclOrStmtList",
+    "varDeclOrStmt",
+    "attributeDecl",
+    "localVarDecl",
+    "varDecl",
+    "arraySizeList",
+    "statement",
+    "assignStat",
+    "assignOp",
+    "statBlock",
+    "statmentList",
+    "expr",
+    NULL,
+    "relExpr",
+    "arithExpr",
+    "arithExprTail",
+    "sign",
+    "term",
+    "termTail",
+    "factor",
+    "variable",
+    "idnestList",
+    "idnestList",
+    "idnest",
+    "idnestTail",
+    NULL,
+    "indiceList",
+    "indiceList",
+    "idOrSelf",
+    "indice",
+    "arraySize",
+    NULL,
+    "type",
+    "returnType",
+    "fParams",
+    "fParamsTailList",
+    "fParamsTail",
+    "aParams",
+    "aParamsTailList",
+    "aParamsTail",
+    "relOp",
+    "addOp",
+    "multOp",
+};
+
+// parser.c function for each %external nonterminal, NULL for table-driven ones
+static ASTNode* (*const ll1_external[LL1_NONTERMINAL_COUNT])(CompilerContext*) = {
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    expr,
+    NULL,
+    relExpr,
+    arithExpr,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+};
+
+static const int ll1_terminal[LL1_TERMINAL_COUNT] = {
+    0,  // end of input
+    CLASS,  // class
+    ID,  // id
+    LEFTBRACE,  // {
+    RIGHTBRACE,  // }
+    SEMICOLON,  // ;
+    ISA,  // isa
+    COMMA,  // ,
+    IMPLEMENT,  // implement
+    PUBLIC,  // public
+    PRIVATE,  // private
+    FUNC,  // func
+    LEFTPAREN,  // (
+    RIGHTPAREN,  // )
+    ARROW,  // =>
+    CONSTRUCT,  // constructor
+    ATTRIBUTE,  // attribute
+    LOCAL,  // local
+    COLON,  // :
+    IF,  // if
+    THEN,  // then
+    ELSE,  // else
+    WHILE,  // while
+    READ,  // read
+    WRITE,  // write
+    RETURN,  // return
+    ASSIGN,  // :=
+    PLUS,  // +
+    MINUS,  // -
+    INTEGER_LITERAL,  // intLit
+    FLOAT_LITERAL,  // floatLit
+    NOT,  // not
+    DOT,  // .
+    SELF,  // self
+    LEFTBRACKET,  // [
+    RIGHTBRACKET,  // ]
+    INTEGER,  // integer
+    FLOAT,  // float
+    VOID,  // void
+    LESS,  // <
+    GREATER,  // >
+    LOEQ,  // <=
+    GOEQ,  // >=
+    NEQ,  // <>
+    OR,  // or
+    MULTIPLY,  // *
+    DIVIDE,  // /
+    AND,  // and
+};
+
+static const LL1Symbol ll1_symbols[] = {
+    // 0: prog -> classOrImplOrFuncList
+    {LL1_A, RULE_PROG}, {LL1_N, 1},
+    // 1: classOrImplOrFuncList -> classOrImplOrFunc classOrImplOrFuncList
+    {LL1_A, RULE_CLASSORIMPLORFUNCLIST_ITEM}, {LL1_N, 2}, {LL1_N, 1},
+    // 2: classOrImplOrFuncList -> ε
+    {LL1_A, RULE_CLASSORIMPLORFUNCLIST_EMPTY},
+    // 3: classOrImplOrFunc -> classDecl
+    {LL1_A, RULE_CLASSORIMPLORFUNC_CLASSDECL}, {LL1_N, 3},
+    // 4: classOrImplOrFunc -> implDef
+    {LL1_A, RULE_CLASSORIMPLORFUNC_IMPLDEF}, {LL1_N, 7},
+    // 5: classOrImplOrFunc -> funcDef
+    {LL1_A, RULE_CLASSORIMPLORFUNC_FUNCDEF}, {LL1_N, 9},
+    // 6: classDecl -> class id isaIdOpt { visibilitymemberDeclList } ;
+    {LL1_A, RULE_CLASSDECL}, {LL1_T, CLASS}, {LL1_T, ID}, {LL1_N, 4}, {LL1_T, LEFTBRACE}, {LL1_N, 6}, {LL1_T, RIGHTBRACE}, {LL1_T, SEMICOLON},
+    // 7: isaIdOpt -> isa id idTail
+    {LL1_A, RULE_ISAIDOPT}, {LL1_T, ISA}, {LL1_T, ID}, {LL1_N, 5},
+    // 8: isaIdOpt -> ε
+    {LL1_A, RULE_ISAIDOPT_EMPTY},
+    // 9: idTail -> , id idTail
+    {LL1_A, RULE_IDTAIL}, {LL1_T, COMMA}, {LL1_T, ID}, {LL1_N, 5},
+    // 10: idTail -> ε
+    {LL1_A, RULE_IDTAIL_EMPTY},
+    // 11: visibilitymemberDeclList -> visibility memberDecl visibilitymemberDeclList
+    {LL1_N, 10}, {LL1_N, 11}, {LL1_N, 6},
+    // 12: visibilitymemberDeclList -> ε
+    // 13: implDef -> implement id { funcDefList }
+    {LL1_A, RULE_IMPLDEF}, {LL1_T, IMPLEMENT}, {LL1_T, ID}, {LL1_T, LEFTBRACE}, {LL1_N, 8}, {LL1_T, RIGHTBRACE},
+    // 14: funcDefList -> funcDef funcDefList
+    {LL1_N, 9}, {LL1_N, 8},
+    // 15: funcDefList -> ε
+    // 16: funcDef -> funcHead funcBody
+    {LL1_A, RULE_FUNCDEF}, {LL1_N, 14}, {LL1_N, 15},
+    // 17: visibility -> public
+    {LL1_A, RULE_VISIBILITY_PUBLIC}, {LL1_T, PUBLIC},
+    // 18: visibility -> private
+    {LL1_A, RULE_VISIBILITY_PRIVATE}, {LL1_T, PRIVATE},
+    // 19: memberDecl -> funcHead _memberDeclRest
+    {LL1_N, 14}, {LL1_N, 12},
+    // 20: memberDecl -> attributeDecl
+    {LL1_A, RULE_MEMBERDECL_ATTRIBUTEDECL}, {LL1_N, 18},
+    // 21: _memberDeclRest -> ;
+    {LL1_A, RULE_MEMBERDECL_FUNCDECL}, {LL1_T, SEMICOLON},
+    // 22: _memberDeclRest -> funcBody _optSemicolon
+    {LL1_A, RULE_MEMBERDECL_FUNCDEF}, {LL1_N, 15}, {LL1_N, 13},
+    // 23: _optSemicolon -> ;
+    {LL1_T, SEMICOLON},
+    // 24: _optSemicolon -> ε
+    // 25: funcHead -> func id ( fParams ) => returnType
+    {LL1_A, RULE_FUNCHEAD_FUNC}, {LL1_T, FUNC}, {LL1_T, ID}, {LL1_T, LEFTPAREN}, {LL1_N, 50}, {LL1_T, RIGHTPAREN}, {LL1_T, ARROW}, {LL1_N, 49},
+    // 26: funcHead -> constructor ( fParams )
+    {LL1_A, RULE_FUNCHEAD_CONSTRUCTOR}, {LL1_T, CONSTRUCT}, {LL1_T, LEFTPAREN}, {LL1_N, 50}, {LL1_T, RIGHTPAREN},
+    // 27: funcBody -> { varDeclOrStmtList }
+    {LL1_A, RULE_FUNCBODY}, {LL1_T, LEFTBRACE}, {LL1_N, 16}, {LL1_T, RIGHTBRACE},
+    // 28: varDeclOrStmtList -> varDeclOrStmt varDeclOrStmtList
+    {LL1_N, 17}, {LL1_N, 16},
+    // 29: varDeclOrStmtList -> ε
+    // 30: varDeclOrStmt -> localVarDecl
+    {LL1_A, RULE_VARDECLORSTMT_LOCALVARDECL}, {LL1_N, 19},
+    // 31: varDeclOrStmt -> statement
+    {LL1_A, RULE_VARDECLORSTMT_STATEMENT}, {LL1_N, 22},
+    // 32: attributeDecl -> attribute varDecl
+    {LL1_A, RULE_ATTRIBUTEDECL}, {LL1_T, ATTRIBUTE}, {LL1_N, 20},
+    // 33: localVarDecl -> local varDecl
+    {LL1_A, RULE_LOCALVARDECL}, {LL1_T, LOCAL}, {LL1_N, 20},
+    // 34: varDecl -> id : type arraySizeList ;
+    {LL1_T, ID}, {LL1_T, COLON}, {LL1_N, 48}, {LL1_N, 21}, {LL1_T, SEMICOLON},
+    // 35: arraySizeList -> arraySize arraySizeList
+    {LL1_A, RULE_ARRAYSIZELIST_ITEM}, {LL1_N, 46}, {LL1_N, 21},
+    // 36: arraySizeList -> ε
+    {LL1_A, RULE_ARRAYSIZELIST_EMPTY},
+    // 37: statement -> assignStat ;
+    {LL1_A, RULE_STATEMENT_ASSIGN}, {LL1_N, 23}, {LL1_T, SEMICOLON},
+    // 38: statement -> if ( relExpr ) then statBlock else statBlock ;
+    {LL1_A, RULE_STATEMENT_IF}, {LL1_T, IF}, {LL1_T, LEFTPAREN}, {LL1_N, 29}, {LL1_T, RIGHTPAREN}, {LL1_T, THEN}, {LL1_N, 25}, {LL1_T, ELSE}, {LL1_N, 25}, {LL1_T, SEMICOLON},
+    // 39: statement -> while ( relExpr ) statBlock ;
+    {LL1_A, RULE_STATEMENT_WHILE}, {LL1_T, WHILE}, {LL1_T, LEFTPAREN}, {LL1_N, 29}, {LL1_T, RIGHTPAREN}, {LL1_N, 25}, {LL1_T, SEMICOLON},
+    // 40: statement -> read ( variable ) ;
+    {LL1_A, RULE_STATEMENT_READ}, {LL1_T, READ}, {LL1_T, LEFTPAREN}, {LL1_N, 36}, {LL1_T, RIGHTPAREN}, {LL1_T, SEMICOLON},
+    // 41: statement -> write ( expr ) ;
+    {LL1_A, RULE_STATEMENT_WRITE}, {LL1_T, WRITE}, {LL1_T, LEFTPAREN}, {LL1_N, 27}, {LL1_T, RIGHTPAREN}, {LL1_T, SEMICOLON},
+    // 42: statement -> return ( expr ) ;
+    {LL1_A, RULE_STATEMENT_RETURN}, {LL1_T, RETURN}, {LL1_T, LEFTPAREN}, {LL1_N, 27}, {LL1_T, RIGHTPAREN}, {LL1_T, SEMICOLON},
+    // 43: statement -> ε
+    // 44: assignStat -> variable assignOp expr
+    {LL1_A, RULE_ASSIGNSTAT}, {LL1_N, 36}, {LL1_N, 24}, {LL1_N, 27},
+    // 45: assignOp -> :=
+    {LL1_A, RULE_ASSIGNOP}, {LL1_T, ASSIGN},
+    // 46: assignOp -> ε
+    // 47: statBlock -> { statmentList }
+    {LL1_A, RULE_STATBLOCK}, {LL1_T, LEFTBRACE}, {LL1_N, 26}, {LL1_T, RIGHTBRACE},
+    // 48: statBlock -> statement
+    {LL1_N, 22},
+    // 49: statmentList -> statement statmentList
+    {LL1_N, 22}, {LL1_N, 26},
+    // 50: statmentList -> ε
+    // 51: expr -> arithExpr _relTail
+    {LL1_N, 30}, {LL1_N, 28},
+    // 52: _relTail -> relOp arithExpr
+    {LL1_N, 56}, {LL1_N, 30},
+    // 53: _relTail -> ε
+    // 54: relExpr -> arithExpr relOp arithExpr
+    {LL1_N, 30}, {LL1_N, 56}, {LL1_N, 30},
+    // 55: arithExpr -> term arithExprTail
+    {LL1_N, 33}, {LL1_N, 31},
+    // 56: arithExprTail -> addOp term arithExprTail
+    {LL1_N, 57}, {LL1_N, 33}, {LL1_N, 31},
+    // 57: arithExprTail -> ε
+    // 58: sign -> +
+    {LL1_T, PLUS},
+    // 59: sign -> -
+    {LL1_T, MINUS},
+    // 60: term -> factor termTail
+    {LL1_N, 35}, {LL1_N, 34},
+    // 61: termTail -> multOp factor termTail
+    {LL1_N, 58}, {LL1_N, 35}, {LL1_N, 34},
+    // 62: termTail -> ε
+    // 63: factor -> variable
+    {LL1_N, 36},
+    // 64: factor -> intLit
+    {LL1_T, INTEGER_LITERAL},
+    // 65: factor -> floatLit
+    {LL1_T, FLOAT_LITERAL},
+    // 66: factor -> ( arithExpr )
+    {LL1_T, LEFTPAREN}, {LL1_N, 30}, {LL1_T, RIGHTPAREN},
+    // 67: factor -> not factor
+    {LL1_T, NOT}, {LL1_N, 35},
+    // 68: factor -> sign factor
+    {LL1_N, 32}, {LL1_N, 35},
+    // 69: factor -> ε
+    // 70: variable -> idnestList~some indiceList
+    {LL1_A, RULE_VARIABLE}, {LL1_N, 38}, {LL1_N, 42},
+    // 71: idnestList -> idnest idnestList
+    {LL1_N, 39}, {LL1_N, 37},
+    // 72: idnestList -> ε
+    // 73: idnestList~some -> idnest idnestList
+    {LL1_N, 39}, {LL1_N, 37},
+    // 74: idnest -> idOrSelf idnestTail
+    {LL1_N, 44}, {LL1_N, 40},
+    // 75: idnestTail -> indiceList~some _optDot
+    {LL1_N, 43}, {LL1_N, 41},
+    // 76: idnestTail -> ( aParams ) _optDot
+    {LL1_T, LEFTPAREN}, {LL1_N, 53}, {LL1_T, RIGHTPAREN}, {LL1_N, 41},
+    // 77: idnestTail -> ε
+    // 78: _optDot -> .
+    {LL1_T, DOT},
+    // 79: _optDot -> ε
+    // 80: indiceList -> indice indiceList
+    {LL1_N, 45}, {LL1_N, 42},
+    // 81: indiceList -> ε
+    // 82: indiceList~some -> indice indiceList
+    {LL1_N, 45}, {LL1_N, 42},
+    // 83: idOrSelf -> id
+    {LL1_T, ID},
+    // 84: idOrSelf -> self
+    {LL1_T, SELF},
+    // 85: indice -> [ arithExpr ]
+    {LL1_A, RULE_INDICE}, {LL1_T, LEFTBRACKET}, {LL1_N, 30}, {LL1_T, RIGHTBRACKET},
+    // 86: arraySize -> [ _optIntLit ]
+    {LL1_A, RULE_ARRAYSIZE}, {LL1_T, LEFTBRACKET}, {LL1_N, 47}, {LL1_T, RIGHTBRACKET},
+    // 87: _optIntLit -> intLit
+    {LL1_T, INTEGER_LITERAL},
+    // 88: _optIntLit -> ε
+    // 89: type -> integer
+    {LL1_T, INTEGER},
+    // 90: type -> float
+    {LL1_T, FLOAT},
+    // 91: type -> id
+    {LL1_T, ID},
+    // 92: type -> ε
+    // 93: returnType -> void
+    {LL1_T, VOID},
+    // 94: returnType -> type
+    {LL1_N, 48},
+    // 95: fParams -> id : type arraySizeList fParamsTailList
+    {LL1_T, ID}, {LL1_T, COLON}, {LL1_N, 48}, {LL1_N, 21}, {LL1_N, 51},
+    // 96: fParams -> ε
+    // 97: fParamsTailList -> fParamsTail fParamsTailList
+    {LL1_A, RULE_FPARAMSTAILLIST_ITEM}, {LL1_N, 52}, {LL1_N, 51},
+    // 98: fParamsTailList -> ε
+    {LL1_A, RULE_FPARAMSTAILLIST_EMPTY},
+    // 99: fParamsTail -> , id : type arraySizeList
+    {LL1_A, RULE_FPARAMSTAIL}, {LL1_T, COMMA}, {LL1_T, ID}, {LL1_T, COLON}, {LL1_N, 48}, {LL1_N, 21},
+    // 100: aParams -> expr aParamsTailList
+    {LL1_N, 27}, {LL1_N, 54},
+    // 101: aParams -> ε
+    // 102: aParamsTailList -> aParamsTail aParamsTailList
+    {LL1_N, 55}, {LL1_N, 54},
+    // 103: aParamsTailList -> ε
+    // 104: aParamsTail -> , expr
+    {LL1_T, COMMA}, {LL1_N, 27},
+    // 105: relOp -> <
+    {LL1_T, LESS},
+    // 106: relOp -> >
+    {LL1_T, GREATER},
+    // 107: relOp -> <=
+    {LL1_T, LOEQ},
+    // 108: relOp -> >=
+    {LL1_T, GOEQ},
+    // 109: relOp -> <>
+    {LL1_T, NEQ},
+    // 110: relOp -> ε
+    // 111: addOp -> +
+    {LL1_T, PLUS},
+    // 112: addOp -> -
+    {LL1_T, MINUS},
+    // 113: addOp -> or
+    {LL1_T, OR},
+    // 114: multOp -> *
+    {LL1_T, MULTIPLY},
+    // 115: multOp -> /
+    {LL1_T, DIVIDE},
+    // 116: multOp -> and
+    {LL1_T, AND},
+};
+
+static const LL1Production ll1_productions[LL1_PRODUCTION_COUNT] = {
+    {0, 0, 2},
+    {1, 2, 3},
+    {1, 5, 1},
+    {2, 6, 2},
+    {2, 8, 2},
+    {2, 10, 2},
+    {3, 12, 8},
+    {4, 20, 4},
+    {4, 24, 1},
+    {5, 25, 4},
+    {5, 29, 1},
+    {6, 30, 3},
+    {6, 33, 0},
+    {7, 33, 6},
+    {8, 39, 2},
+    {8, 41, 0},
+    {9, 41, 3},
+    {10, 44, 2},
+    {10, 46, 2},
+    {11, 48, 2},
+    {11, 50, 2},
+    {12, 52, 2},
+    {12, 54, 3},
+    {13, 57, 1},
+    {13, 58, 0},
+    {14, 58, 8},
+    {14, 66, 5},
+    {15, 71, 4},
+    {16, 75, 2},
+    {16, 77, 0},
+    {17, 77, 2},
+    {17, 79, 2},
+    {18, 81, 3},
+    {19, 84, 3},
+    {20, 87, 5},
+    {21, 92, 3},
+    {21, 95, 1},
+    {22, 96, 3},
+    {22, 99, 10},
+    {22, 109, 7},
+    {22, 116, 6},
+    {22, 122, 6},
+    {22, 128, 6},
+    {22, 134, 0},
+    {23, 134, 4},
+    {24, 138, 2},
+    {24, 140, 0},
+    {25, 140, 4},
+    {25, 144, 1},
+    {26, 145, 2},
+    {26, 147, 0},
+    {27, 147, 2},
+    {28, 149, 2},
+    {28, 151, 0},
+    {29, 151, 3},
+    {30, 154, 2},
+    {31, 156, 3},
+    {31, 159, 0},
+    {32, 159, 1},
+    {32, 160, 1},
+    {33, 161, 2},
+    {34, 163, 3},
+    {34, 166, 0},
+    {35, 166, 1},
+    {35, 167, 1},
+    {35, 168, 1},
+    {35, 169, 3},
+    {35, 172, 2},
+    {35, 174, 2},
+    {35, 176, 0},
+    {36, 176, 3},
+    {37, 179, 2},
+    {37, 181, 0},
+    {38, 181, 2},
+    {39, 183, 2},
+    {40, 185, 2},
+    {40, 187, 4},
+    {40, 191, 0},
+    {41, 191, 1},
+    {41, 192, 0},
+    {42, 192, 2},
+    {42, 194, 0},
+    {43, 194, 2},
+    {44, 196, 1},
+    {44, 197, 1},
+    {45, 198, 4},
+    {46, 202, 4},
+    {47, 206, 1},
+    {47, 207, 0},
+    {48, 207, 1},
+    {48, 208, 1},
+    {48, 209, 1},
+    {48, 210, 0},
+    {49, 210, 1},
+    {49, 211, 1},
+    {50, 212, 5},
+    {50, 217, 0},
+    {51, 217, 3},
+    {51, 220, 1},
+    {52, 221, 6},
+    {53, 227, 2},
+    {53, 229, 0},
+    {54, 229, 2},
+    {54, 231, 0},
+    {55, 231, 2},
+    {56, 233, 1},
+    {56, 234, 1},
+    {56, 235, 1},
+    {56, 236, 1},
+    {56, 237, 1},
+    {56, 238, 0},
+    {57, 238, 1},
+    {57, 239, 1},
+    {57, 240, 1},
+    {58, 241, 1},
+    {58, 242, 1},
+    {58, 243, 1},
+};
+
+// production to expand for [nonterminal][terminal column], -1 = none
+static const short ll1_table[LL1_NONTERMINAL_COUNT][LL1_TERMINAL_COUNT] = {
+    {0,0,-1,-1,-1,-1,-1,-1,0,-1,-1,0,-1,-1,-1,0,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // prog
+    {2,1,-1,-1,-1,-1,-1,-1,1,-1,-1,1,-1,-1,-1,1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // classOrImplOrFuncList
+    {-1,3,-1,-1,-1,-1,-1,-1,4,-1,-1,5,-1,-1,-1,5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // classOrImplOrFunc
+    {-1,6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // classDecl
+    {-1,-1,-1,8,-1,-1,7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // isaIdOpt
+    {-1,-1,-1,10,-1,-1,-1,9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // idTail
+    {-1,-1,-1,-1,12,-1,-1,-1,-1,11,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // visibilitymemberDeclList
+    {-1,-1,-1,-1,-1,-1,-1,-1,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // implDef
+    {-1,-1,-1,-1,15,-1,-1,-1,-1,-1,-1,14,-1,-1,-1,14,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // funcDefList
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,16,-1,-1,-1,16,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // funcDef
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,17,18,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // visibility
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,19,-1,-1,-1,19,20,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // memberDecl
+    {-1,-1,-1,22,-1,21,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // _memberDeclRest
+    {-1,-1,-1,-1,24,23,-1,-1,-1,24,24,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // _optSemicolon
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,25,-1,-1,-1,26,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // funcHead
+    {-1,-1,-1,27,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // funcBody
+    {-1,-1,28,-1,29,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,28,-1,28,-1,-1,28,28,28,28,-1,-1,-1,-1,-1,-1,-1,28,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // varDeclOrStmtList
+    {-1,-1,31,-1,31,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,30,-1,31,-1,-1,31,31,31,31,-1,-1,-1,-1,-1,-1,-1,31,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // varDeclOrStmt
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,32,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // attributeDecl
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,33,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // localVarDecl
+    {-1,-1,34,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // varDecl
+    {-1,-1,-1,-1,-1,36,-1,36,-1,-1,-1,-1,-1,36,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,35,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // arraySizeList
+    {-1,-1,37,-1,43,43,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,43,-1,38,-1,43,39,40,41,42,-1,-1,-1,-1,-1,-1,-1,37,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // statement
+    {-1,-1,44,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,44,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // assignStat
+    {-1,-1,46,-1,-1,46,-1,-1,-1,-1,-1,-1,46,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,45,46,46,46,46,46,-1,46,-1,-1,-1,-1,-1,46,46,46,46,46,46,46,46,46},  // assignOp
+    {-1,-1,48,47,-1,48,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,48,-1,48,48,48,48,48,-1,-1,-1,-1,-1,-1,-1,48,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // statBlock
+    {-1,-1,49,-1,50,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,49,-1,-1,49,49,49,49,-1,-1,-1,-1,-1,-1,-1,49,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // statmentList
+    {-1,-1,51,-1,-1,51,-1,51,-1,-1,-1,-1,51,51,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,51,51,51,51,51,-1,51,-1,-1,-1,-1,-1,51,51,51,51,51,51,51,51,51},  // expr
+    {-1,-1,52,-1,-1,53,-1,53,-1,-1,-1,-1,52,53,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,52,52,52,52,52,-1,52,-1,-1,-1,-1,-1,52,52,52,52,52,52,52,52,52},  // _relTail
+    {-1,-1,54,-1,-1,-1,-1,-1,-1,-1,-1,-1,54,54,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,54,54,54,54,54,-1,54,-1,-1,-1,-1,-1,54,54,54,54,54,54,54,54,54},  // relExpr
+    {-1,-1,55,-1,-1,55,-1,55,-1,-1,-1,-1,55,55,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,55,55,55,55,55,-1,55,-1,55,-1,-1,-1,55,55,55,55,55,55,55,55,55},  // arithExpr
+    {-1,-1,57,-1,-1,57,-1,57,-1,-1,-1,-1,57,57,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,56,56,57,57,57,-1,57,-1,57,-1,-1,-1,57,57,57,57,57,56,57,57,57},  // arithExprTail
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,58,59,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // sign
+    {-1,-1,60,-1,-1,60,-1,60,-1,-1,-1,-1,60,60,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,60,60,60,60,60,-1,60,-1,60,-1,-1,-1,60,60,60,60,60,60,60,60,60},  // term
+    {-1,-1,62,-1,-1,62,-1,62,-1,-1,-1,-1,62,62,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,62,62,62,62,62,-1,62,-1,62,-1,-1,-1,62,62,62,62,62,62,61,61,61},  // termTail
+    {-1,-1,63,-1,-1,69,-1,69,-1,-1,-1,-1,66,69,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,68,68,64,65,67,-1,63,-1,69,-1,-1,-1,69,69,69,69,69,69,69,69,69},  // factor
+    {-1,-1,70,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,70,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // variable
+    {-1,-1,71,-1,-1,72,-1,72,-1,-1,-1,-1,72,72,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,72,72,72,72,72,72,-1,71,72,72,-1,-1,-1,72,72,72,72,72,72,72,72,72},  // idnestList
+    {-1,-1,73,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,73,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // idnestList~some
+    {-1,-1,74,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,74,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // idnest
+    {-1,-1,77,-1,-1,77,-1,77,-1,-1,-1,-1,76,77,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,77,77,77,77,77,77,-1,77,75,77,-1,-1,-1,77,77,77,77,77,77,77,77,77},  // idnestTail
+    {-1,-1,79,-1,-1,79,-1,79,-1,-1,-1,-1,79,79,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,79,79,79,79,79,79,78,79,79,79,-1,-1,-1,79,79,79,79,79,79,79,79,79},  // _optDot
+    {-1,-1,81,-1,-1,81,-1,81,-1,-1,-1,-1,81,81,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,81,81,81,81,81,81,81,81,80,81,-1,-1,-1,81,81,81,81,81,81,81,81,81},  // indiceList
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,82,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // indiceList~some
+    {-1,-1,83,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,84,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // idOrSelf
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,85,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // indice
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,86,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // arraySize
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,87,-1,-1,-1,-1,-1,88,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // _optIntLit
+    {-1,-1,91,92,-1,92,-1,92,-1,-1,-1,-1,-1,92,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,92,-1,89,90,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // type
+    {-1,-1,94,94,-1,94,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,94,94,93,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // returnType
+    {-1,-1,95,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,96,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // fParams
+    {-1,-1,-1,-1,-1,-1,-1,97,-1,-1,-1,-1,-1,98,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // fParamsTailList
+    {-1,-1,-1,-1,-1,-1,-1,99,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // fParamsTail
+    {-1,-1,100,-1,-1,-1,-1,100,-1,-1,-1,-1,100,101,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,100,100,100,100,100,-1,100,-1,-1,-1,-1,-1,100,100,100,100,100,100,100,100,100},  // aParams
+    {-1,-1,-1,-1,-1,-1,-1,102,-1,-1,-1,-1,-1,103,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // aParamsTailList
+    {-1,-1,-1,-1,-1,-1,-1,104,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},  // aParamsTail
+    {-1,-1,110,-1,-1,110,-1,110,-1,-1,-1,-1,110,110,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,110,110,110,110,110,-1,110,-1,-1,-1,-1,-1,105,106,107,108,109,110,110,110,110},  // relOp
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,111,112,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,113,-1,-1,-1},  // addOp
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,114,115,116},  // multOp
+};
+
+// empty alternative used when the lookahead has no entry, -1 = syntax error
+static const short ll1_default[LL1_NONTERMINAL_COUNT] = {
+    0, 2, -1, -1, 8, 10, 12, -1, 15, -1, -1, -1, -1, 24, -1, -1, 29, 31, -1, -1, -1, 36, 43, -1, 46, 48, 50, 51, 53, 54, 55, 57, -1, 60, 62, 69, -1, 72, -1, -1, 77, 79, 81, -1, -1, -1, -1, 88, 92, 94, 96, 98, -1, 101, 103, -1, 110, -1, -1,
+};
+
+#endif
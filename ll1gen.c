@@ -0,0 +1,463 @@
+// ll1gen: FIRST/FOLLOW sets and the LL(1) parse table for a grammar file
+// usage: ll1gen grammar.txt                 print the sets and any conflicts
+//        ll1gen grammar_ll1.txt ll1_table.h write the table used by --parser=table
+// Grammar notation is the one in grammar.txt ("->" or "→", "|", "ε"), plus the
+// annotations described at the top of grammar_ll1.txt.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define MAX_NONTERMINALS 128
+#define MAX_TERMINALS 96
+#define MAX_PRODUCTIONS 320
+#define MAX_BODY 16
+#define MAX_ACTIONS 96
+
+// symbol in a production body: kind in the top bits, index below
+#define SYM_T 0
+#define SYM_N 1
+#define SYM_A 2
+#define SYM(kind, idx) (((kind) << 12) | (idx))
+#define SYM_KIND(s) ((s) >> 12)
+#define SYM_INDEX(s) ((s) & 0xfff)
+
+// grammar spelling of a terminal -> token name in y.tab.h
+static const struct { const char* spelling; const char* token; } terminal_map[] = {
+    {"class", "CLASS"}, {"implement", "IMPLEMENT"}, {"func", "FUNC"},
+    {"constructor", "CONSTRUCT"}, {"construct", "CONSTRUCT"}, {"isa", "ISA"},
+    {"public", "PUBLIC"}, {"private", "PRIVATE"}, {"attribute", "ATTRIBUTE"},
+    {"local", "LOCAL"}, {"if", "IF"}, {"then", "THEN"}, {"else", "ELSE"},
+    {"while", "WHILE"}, {"read", "READ"}, {"write", "WRITE"}, {"return", "RETURN"},
+    {"self", "SELF"}, {"void", "VOID"}, {"integer", "INTEGER"}, {"float", "FLOAT"},
+    {"id", "ID"}, {"intLit", "INTEGER_LITERAL"}, {"floatLit", "FLOAT_LITERAL"},
+    {"and", "AND"}, {"or", "OR"}, {"not", "NOT"},
+    {"{", "LEFTBRACE"}, {"}", "RIGHTBRACE"}, {"(", "LEFTPAREN"}, {")", "RIGHTPAREN"},
+    {"[", "LEFTBRACKET"}, {"]", "RIGHTBRACKET"}, {";", "SEMICOLON"}, {",", "COMMA"},
+    {".", "DOT"}, {":", "COLON"}, {":=", "ASSIGN"}, {"=>", "ARROW"},
+    {"<", "LESS"}, {">", "GREATER"}, {"<=", "LOEQ"}, {">=", "GOEQ"}, {"<>", "NEQ"},
+    {"+", "PLUS"}, {"-", "MINUS"}, {"*", "MULTIPLY"}, {"/", "DIVIDE"},
+};
+
+typedef struct {
+    int lhs;
+    int body[MAX_BODY];
+    int length;
+    int symbols;        // grammar symbols in the body (actions not counted)
+} Production;
+
+static char* nonterminals[MAX_NONTERMINALS];
+static int nonterminal_count = 0;
+static char* terminals[MAX_TERMINALS];          // terminals[0] is end of input
+static const char* terminal_tokens[MAX_TERMINALS];
+static int terminal_count = 0;
+static unsigned char external[MAX_NONTERMINALS];   // parsed by the parser.c function of that name
+static char* actions[MAX_ACTIONS];
+static int action_count = 0;
+static Production productions[MAX_PRODUCTIONS];
+static int production_count = 0;
+
+static unsigned char nullable[MAX_NONTERMINALS];
+static unsigned char first[MAX_NONTERMINALS][MAX_TERMINALS];
+static unsigned char follow[MAX_NONTERMINALS][MAX_TERMINALS];
+static short table[MAX_NONTERMINALS][MAX_TERMINALS];
+static short defaults[MAX_NONTERMINALS];
+
+static int conflicts = 0;
+static int resolved = 0;
+
+static void fail(const char* message, const char* detail) {
+    printf("Error:: %s%s%s\n", message, detail ? ": " : "", detail ? detail : "");
+    exit(1);
+}
+
+static int find_name(char** names, int count, const char* name) {
+    for (int i = 0; i < count; i++)
+        if (strcmp(names[i], name) == 0) return i;
+    return -1;
+}
+
+static int add_name(char** names, int* count, int limit, const char* name) {
+    int i = find_name(names, *count, name);
+    if (i >= 0) return i;
+    if (*count >= limit) fail("grammar too large", name);
+    names[*count] = strdup(name);
+    return (*count)++;
+}
+
+static int terminal_index(const char* spelling) {
+    int i = find_name(terminals, terminal_count, spelling);
+    if (i >= 0) return i;
+    i = add_name(terminals, &terminal_count, MAX_TERMINALS, spelling);
+    terminal_tokens[i] = NULL;
+    for (size_t k = 0; k < sizeof(terminal_map) / sizeof(terminal_map[0]); k++)
+        if (strcmp(terminal_map[k].spelling, spelling) == 0) terminal_tokens[i] = terminal_map[k].token;
+    return i;
+}
+
+// ====== reading the grammar =====
+// next word of a rule: identifier, #action, UTF-8 "ε"/"→"/"–", or punctuation
+static const char* next_word(const char* p, char* out, size_t size) {
+    while (*p && isspace((unsigned char)*p)) p++;
+    if (!*p) return NULL;
+    size_t n = 0;
+    if (isalpha((unsigned char)*p) || *p == '_' || *p == '#') {
+        while (*p && (isalnum((unsigned char)*p) || *p == '_' || *p == '#' || *p == '~') && n + 1 < size) out[n++] = *p++;
+    } else if ((unsigned char)*p >= 0x80) {
+        do { out[n++] = *p++; } while (((unsigned char)*p & 0xc0) == 0x80 && n + 1 < size);
+        out[n] = '\0';
+        if (strcmp(out, "–") == 0) strcpy(out, "-");      // grammar.txt writes minus as an en dash
+        return p;
+    } else if (strchr(":=<>-", *p) && p[1] && strchr("=>", p[1])) {
+        out[n++] = *p++;
+        out[n++] = *p++;
+    } else {
+        out[n++] = *p++;
+    }
+    out[n] = '\0';
+    return p;
+}
+
+static int is_arrow(const char* w) {
+    return strcmp(w, "->") == 0 || strcmp(w, "→") == 0;
+}
+
+// one rule per arrow; lines without an arrow continue the previous rule,
+// "%name ..." lines are directives and kept apart
+static char** split_rules(FILE* in, int* count, char** directives, int* directive_count) {
+    static char* rules[MAX_PRODUCTIONS];
+    char line[1024];
+    *count = 0;
+    *directive_count = 0;
+    while (fgets(line, sizeof(line), in)) {
+        char* s = line;
+        while (isspace((unsigned char)*s)) s++;
+        if (!*s || strncmp(s, "//", 2) == 0) continue;
+        if (*s == '%') {
+            if (*directive_count >= MAX_NONTERMINALS) fail("too many directives", NULL);
+            directives[(*directive_count)++] = strdup(s);
+        } else if (strstr(s, "->") || strstr(s, "→")) {
+            if (*count >= MAX_PRODUCTIONS) fail("too many rules", NULL);
+            rules[(*count)++] = strdup(s);
+        } else if (*count > 0) {
+            char* prev = rules[*count - 1];
+            char* joined = malloc(strlen(prev) + strlen(s) + 2);
+            sprintf(joined, "%s %s", prev, s);
+            free(prev);
+            rules[*count - 1] = joined;
+        }
+    }
+    return rules;
+}
+
+static void read_grammar(const char* path) {
+    FILE* in = fopen(path, "r");
+    if (!in) fail("Cannot open grammar", path);
+    int rule_count, directive_count;
+    char* directives[MAX_NONTERMINALS];
+    char** rules = split_rules(in, &rule_count, directives, &directive_count);
+    fclose(in);
+
+    terminal_index("$");    // end of input is terminal 0
+
+    // left-hand sides first, so a body can use a nonterminal defined further down
+    char word[128];
+    for (int r = 0; r < rule_count; r++) {
+        if (!next_word(rules[r], word, sizeof(word))) continue;
+        add_name(nonterminals, &nonterminal_count, MAX_NONTERMINALS, word);
+    }
+
+    for (int r = 0; r < rule_count; r++) {
+        const char* p = next_word(rules[r], word, sizeof(word));
+        int lhs = find_name(nonterminals, nonterminal_count, word);
+        p = next_word(p, word, sizeof(word));
+        if (!p || !is_arrow(word)) fail("expected an arrow after", nonterminals[lhs]);
+
+        Production cur = { lhs, {0}, 0, 0 };
+        for (;;) {
+            p = next_word(p, word, sizeof(word));
+            if (!p || strcmp(word, "|") == 0) {
+                // repeated alternatives (grammar.txt lists indiceList twice) are kept once
+                int duplicate = 0;
+                for (int i = 0; i < production_count && !duplicate; i++)
+                    duplicate = productions[i].lhs == lhs && productions[i].length == cur.length &&
+                                memcmp(productions[i].body, cur.body, sizeof(int) * cur.length) == 0;
+                if (!duplicate) {
+                    if (production_count >= MAX_PRODUCTIONS) fail("too many productions", NULL);
+                    productions[production_count++] = cur;
+                }
+                if (!p) break;
+                cur.length = cur.symbols = 0;
+                continue;
+            }
+            if (strcmp(word, "ε") == 0) continue;
+            if (cur.length >= MAX_BODY) fail("production too long", nonterminals[lhs]);
+            int sym;
+            int nt = find_name(nonterminals, nonterminal_count, word);
+            if (word[0] == '#') sym = SYM(SYM_A, add_name(actions, &action_count, MAX_ACTIONS, word + 1));
+            else if (nt >= 0) sym = SYM(SYM_N, nt);
+            else sym = SYM(SYM_T, terminal_index(word));
+            cur.body[cur.length++] = sym;
+            if (SYM_KIND(sym) != SYM_A) cur.symbols++;
+        }
+    }
+    if (nonterminal_count == 0) fail("no rules in", path);
+
+    // %external a b c: the rules of a, b, c still give FIRST/FOLLOW, but the
+    // driver hands those nonterminals to the parser.c functions of the same name
+    for (int d = 0; d < directive_count; d++) {
+        const char* p = next_word(directives[d] + 1, word, sizeof(word));
+        if (!p || strcmp(word, "external") != 0) fail("unknown directive", directives[d]);
+        while ((p = next_word(p, word, sizeof(word))) != NULL) {
+            int nt = find_name(nonterminals, nonterminal_count, word);
+            if (nt < 0) fail("external is not a nonterminal:", word);
+            external[nt] = 1;
+        }
+        free(directives[d]);
+    }
+}
+
+// ====== FIRST / FOLLOW =====
+static int merge(unsigned char* into, const unsigned char* from) {
+    int changed = 0;
+    for (int t = 0; t < terminal_count; t++)
+        if (from[t] && !into[t]) into[t] = changed = 1;
+    return changed;
+}
+
+// FIRST of body[from..], returns whether that suffix is nullable
+static int first_of(const Production* p, int from, unsigned char* out) {
+    for (int i = from; i < p->length; i++) {
+        int s = p->body[i];
+        if (SYM_KIND(s) == SYM_A) continue;
+        if (SYM_KIND(s) == SYM_T) { out[SYM_INDEX(s)] = 1; return 0; }
+        merge(out, first[SYM_INDEX(s)]);
+        if (!nullable[SYM_INDEX(s)]) return 0;
+    }
+    return 1;
+}
+
+static void compute_sets() {
+    for (int changed = 1; changed; ) {
+        changed = 0;
+        for (int i = 0; i < production_count; i++) {
+            Production* p = &productions[i];
+            unsigned char f[MAX_TERMINALS] = {0};
+            int n = first_of(p, 0, f);
+            changed |= merge(first[p->lhs], f);
+            if (n && !nullable[p->lhs]) nullable[p->lhs] = changed = 1;
+        }
+    }
+
+    follow[0][0] = 1;       // start symbol is followed by end of input
+    for (int changed = 1; changed; ) {
+        changed = 0;
+        for (int i = 0; i < production_count; i++) {
+            Production* p = &productions[i];
+            for (int k = 0; k < p->length; k++) {
+                if (SYM_KIND(p->body[k]) != SYM_N) continue;
+                int b = SYM_INDEX(p->body[k]);
+                unsigned char f[MAX_TERMINALS] = {0};
+                int rest_nullable = first_of(p, k + 1, f);
+                changed |= merge(follow[b], f);
+                if (rest_nullable) changed |= merge(follow[b], follow[p->lhs]);
+            }
+        }
+    }
+}
+
+// ====== the table =====
+// A branch is taken on the tokens it starts with; reaching the lookahead only
+// through an empty body counts for less. Between two such nullable-only
+// candidates the shorter body wins, so the empty alternative is the fallback.
+// Two alternatives starting with the same token is a real conflict: the
+// earlier one is kept and the conflict reported.
+static void print_production(FILE* out, int i) {
+    const Production* p = &productions[i];
+    fprintf(out, "%s ->", nonterminals[p->lhs]);
+    if (p->symbols == 0) fprintf(out, " ε");
+    for (int k = 0; k < p->length; k++) {
+        int s = p->body[k];
+        if (SYM_KIND(s) == SYM_A) continue;
+        fprintf(out, " %s", SYM_KIND(s) == SYM_N ? nonterminals[SYM_INDEX(s)] : terminals[SYM_INDEX(s)]);
+    }
+}
+
+static void build_table(int verbose) {
+    static unsigned char from_first[MAX_NONTERMINALS][MAX_TERMINALS];
+    for (int a = 0; a < nonterminal_count; a++) {
+        defaults[a] = -1;
+        for (int t = 0; t < terminal_count; t++) table[a][t] = -1;
+    }
+    for (int i = 0; i < production_count; i++) {
+        Production* p = &productions[i];
+        unsigned char f[MAX_TERMINALS] = {0};
+        int n = first_of(p, 0, f);
+        for (int t = 0; t < terminal_count; t++) {
+            int via_first = f[t];
+            if (!via_first && !(n && follow[p->lhs][t])) continue;
+            short* cell = &table[p->lhs][t];
+            if (*cell < 0) {
+                *cell = i;
+                from_first[p->lhs][t] = via_first;
+                continue;
+            }
+            Production* q = &productions[*cell];
+            int take;
+            if (via_first && from_first[p->lhs][t]) {
+                conflicts++;
+                printf("conflict: on '%s' ", terminals[t]);
+                print_production(stdout, *cell);
+                printf("  vs  ");
+                print_production(stdout, i);
+                printf("  (keeping the first)\n");
+                take = 0;
+            } else {
+                take = via_first || (!from_first[p->lhs][t] && p->symbols < q->symbols);
+                resolved++;
+                if (verbose) {
+                    printf("resolved: on '%s' ", terminals[t]);
+                    print_production(stdout, take ? i : *cell);
+                    printf("  over  ");
+                    print_production(stdout, take ? *cell : i);
+                    printf("\n");
+                }
+            }
+            if (take) {
+                *cell = i;
+                from_first[p->lhs][t] = via_first;
+            }
+        }
+        if (n && (defaults[p->lhs] < 0 || p->symbols < productions[defaults[p->lhs]].symbols)) defaults[p->lhs] = i;
+    }
+}
+
+static void print_set(const char* label, const unsigned char* set) {
+    printf("  %s {", label);
+    for (int t = 0, first_item = 1; t < terminal_count; t++)
+        if (set[t]) { printf("%s %s", first_item ? "" : ",", terminals[t]); first_item = 0; }
+    printf(" }\n");
+}
+
+static void print_report() {
+    for (int a = 0; a < nonterminal_count; a++) {
+        printf("%s%s%s\n", nonterminals[a], nullable[a] ? " (nullable)" : "", external[a] ? " (external)" : "");
+        print_set("FIRST ", first[a]);
+        print_set("FOLLOW", follow[a]);
+    }
+}
+
+// ====== writing ll1_table.h =====
+static const char* node_name(const char* nonterminal, char* buffer) {
+    if (nonterminal[0] == '_') return NULL;
+    strcpy(buffer, nonterminal);
+    char* tag = strchr(buffer, '~');
+    if (tag) *tag = '\0';
+    return buffer;
+}
+
+static void write_table(const char* grammar_path, const char* path) {
+    for (int t = 1; t < terminal_count; t++)
+        if (!terminal_tokens[t]) fail("no token for terminal", terminals[t]);
+
+    FILE* out = fopen(path, "w");
+    if (!out) fail("Cannot create", path);
+    const char* grammar_name = strrchr(grammar_path, '/');
+    grammar_name = grammar_name ? grammar_name + 1 : grammar_path;
+
+    fprintf(out, "// generated by ll1gen from %s, do not edit\n", grammar_name);
+    fprintf(out, "// regenerate: ll1gen %s ll1_table.h\n", grammar_name);
+    fprintf(out, "#ifndef LL1_TABLE_H\n#define LL1_TABLE_H\n\n");
+    fprintf(out, "#define LL1_NONTERMINAL_COUNT %d\n", nonterminal_count);
+    fprintf(out, "#define LL1_TERMINAL_COUNT %d\n", terminal_count);
+    fprintf(out, "#define LL1_PRODUCTION_COUNT %d\n\n", production_count);
+
+    char buffer[128];
+    fprintf(out, "static const char* const ll1_nonterminal_text[LL1_NONTERMINAL_COUNT] = {\n");
+    for (int a = 0; a < nonterminal_count; a++) fprintf(out, "    \"%s\",\n", nonterminals[a]);
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "// AST node built for each nonterminal, NULL for helpers\n");
+    fprintf(out, "static const char* const ll1_node_name[LL1_NONTERMINAL_COUNT] = {\n");
+    for (int a = 0; a < nonterminal_count; a++) {
+        const char* name = node_name(nonterminals[a], buffer);
+        if (name) fprintf(out, "    \"%s\",\n", name);
+        else fprintf(out, "    NULL,\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "// parser.c function for each %%external nonterminal, NULL for table-driven ones\n");
+    fprintf(out, "static ASTNode* (*const ll1_external[LL1_NONTERMINAL_COUNT])(CompilerContext*) = {\n");
+    for (int a = 0; a < nonterminal_count; a++) fprintf(out, "    %s,\n", external[a] ? nonterminals[a] : "NULL");
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const int ll1_terminal[LL1_TERMINAL_COUNT] = {\n    0,  // end of input\n");
+    for (int t = 1; t < terminal_count; t++) fprintf(out, "    %s,  // %s\n", terminal_tokens[t], terminals[t]);
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const LL1Symbol ll1_symbols[] = {\n");
+    int offset = 0;
+    int offsets[MAX_PRODUCTIONS];
+    for (int i = 0; i < production_count; i++) {
+        Production* p = &productions[i];
+        offsets[i] = offset;
+        fprintf(out, "    // %d: ", i);
+        print_production(out, i);
+        fprintf(out, "\n");
+        if (p->length == 0) continue;
+        fprintf(out, "   ");
+        for (int k = 0; k < p->length; k++) {
+            int s = p->body[k];
+            if (SYM_KIND(s) == SYM_T) fprintf(out, " {LL1_T, %s},", terminal_tokens[SYM_INDEX(s)]);
+            else if (SYM_KIND(s) == SYM_N) fprintf(out, " {LL1_N, %d},", SYM_INDEX(s));
+            else fprintf(out, " {LL1_A, %s},", actions[SYM_INDEX(s)]);
+        }
+        fprintf(out, "\n");
+        offset += p->length;
+    }
+    if (offset == 0) fprintf(out, "    {LL1_A, 0}\n");
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static const LL1Production ll1_productions[LL1_PRODUCTION_COUNT] = {\n");
+    for (int i = 0; i < production_count; i++)
+        fprintf(out, "    {%d, %d, %d},\n", productions[i].lhs, offsets[i], productions[i].length);
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "// production to expand for [nonterminal][terminal column], -1 = none\n");
+    fprintf(out, "static const short ll1_table[LL1_NONTERMINAL_COUNT][LL1_TERMINAL_COUNT] = {\n");
+    for (int a = 0; a < nonterminal_count; a++) {
+        fprintf(out, "    {");
+        for (int t = 0; t < terminal_count; t++) fprintf(out, "%s%d", t ? "," : "", table[a][t]);
+        fprintf(out, "},  // %s\n", nonterminals[a]);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "// empty alternative used when the lookahead has no entry, -1 = syntax error\n");
+    fprintf(out, "static const short ll1_default[LL1_NONTERMINAL_COUNT] = {\n   ");
+    for (int a = 0; a < nonterminal_count; a++) fprintf(out, " %d,", defaults[a]);
+    fprintf(out, "\n};\n\n#endif\n");
+    fclose(out);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printf("usage: ll1gen grammar.txt [ll1_table.h]\n");
+        return 1;
+    }
+    read_grammar(argv[1]);
+    compute_sets();
+    int report = argc < 3;
+    if (report) print_report();
+    build_table(report);
+    printf("%d nonterminals, %d terminals, %d productions, %d resolved by preference, %d conflicts\n",
+           nonterminal_count, terminal_count - 1, production_count, resolved, conflicts);
+    if (report) {
+        for (int t = 1; t < terminal_count; t++)
+            if (!terminal_tokens[t]) printf("note: no token for terminal '%s'\n", terminals[t]);
+        return conflicts ? 1 : 0;
+    }
+    if (conflicts) fail("grammar is not LL(1), no table written", NULL);
+    write_table(argv[1], argv[2]);
+    printf("Table written to %s\n", argv[2]);
+    return 0;
+}
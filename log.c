@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "log.h"
+
+int log_levels[LOG_CATEGORY_COUNT] = {
+    LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO
+};
+
+static const char* category_names[LOG_CATEGORY_COUNT] = {
+    "lexer", "parser", "semantic", "codegen"
+};
+
+static const char* level_names[] = {
+    "off", "error", "warn", "info", "debug", "trace"
+};
+
+static int parse_level(const char* s, size_t n) {
+    for (int i = 0; i <= LOG_LEVEL_TRACE; i++) {
+        if (strlen(level_names[i]) == n && strncmp(level_names[i], s, n) == 0) return i;
+    }
+    return -1;
+}
+
+static int parse_category(const char* s, size_t n) {
+    for (int i = 0; i < LOG_CATEGORY_COUNT; i++) {
+        if (strlen(category_names[i]) == n && strncmp(category_names[i], s, n) == 0) return i;
+    }
+    return -1;
+}
+
+// ====== apply a "level" or "cat=level,..." spec =========================
+int log_configure(const char* spec) {
+    if (!spec) return 0;
+    const char* p = spec;
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t n = end ? (size_t)(end - p) : strlen(p);
+        const char* eq = memchr(p, '=', n);
+
+        int cat = -1;   // -1 = every category
+        const char* lv = p;
+        size_t lv_len = n;
+        if (eq) {
+            size_t cat_len = (size_t)(eq - p);
+            if (!(cat_len == 3 && strncmp(p, "all", 3) == 0)) {
+                cat = parse_category(p, cat_len);
+                if (cat < 0) {
+                    printf("Error:: unknown log category '%.*s'\n", (int)cat_len, p);
+                    return -1;
+                }
+            }
+            lv = eq + 1;
+            lv_len = n - cat_len - 1;
+        }
+        int level = parse_level(lv, lv_len);
+        if (level < 0) {
+            printf("Error:: unknown log level '%.*s'\n", (int)lv_len, lv);
+            return -1;
+        }
+        if (level > LOG_MAX_LEVEL) {
+            printf("Warning:: log level '%s' is compiled out of this build\n", level_names[level]);
+        }
+        for (int i = 0; i < LOG_CATEGORY_COUNT; i++) {
+            if (cat < 0 || cat == i) log_levels[i] = level;
+        }
+        p = end ? end + 1 : p + n;
+    }
+    return 0;
+}
+
+void log_init() {
+    const char* env = getenv("TMA3_LOG");
+    if (env && env[0]) log_configure(env);
+}
+
+void log_write(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stdout, fmt, ap);
+    va_end(ap);
+}
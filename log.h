@@ -0,0 +1,74 @@
+#ifndef LOG_H
+#define LOG_H
+
+// ====== leveled, per-category diagnostic output =========================
+// Runtime: every category starts at LOG_LEVEL_INFO; TMA3_LOG or --log=SPEC
+// raises/lowers it. SPEC is "level" or "cat=level[,cat=level...]", e.g.
+// "trace", "lexer=trace,codegen=debug", "all=off".
+// Build: LOG_MAX_LEVEL caps what is compiled in. -DTMA3_RELEASE caps it at
+// INFO, so DEBUG/TRACE calls (the per-token and per-rule tracing) vanish.
+
+typedef enum {
+    LOG_LEXER,
+    LOG_PARSER,
+    LOG_SEMANTIC,
+    LOG_CODEGEN,
+    LOG_CATEGORY_COUNT
+} LogCategory;
+
+typedef enum {
+    LOG_LEVEL_OFF,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_TRACE
+} LogLevel;
+
+#ifndef LOG_MAX_LEVEL
+    #ifdef TMA3_RELEASE
+        #define LOG_MAX_LEVEL LOG_LEVEL_INFO
+    #else
+        #define LOG_MAX_LEVEL LOG_LEVEL_TRACE
+    #endif
+#endif
+
+extern int log_levels[LOG_CATEGORY_COUNT];
+
+void log_init();                        // reads TMA3_LOG
+int log_configure(const char* spec);    // returns 0 on success
+void log_write(const char* fmt, ...);
+
+#define log_enabled(cat, level) (log_levels[(cat)] >= (level))
+
+// message text is printed verbatim (callers own their prefixes and newlines)
+#define LOG_AT(cat, level, ...) \
+    do { if (log_enabled(cat, level)) log_write(__VA_ARGS__); } while (0)
+
+#if LOG_MAX_LEVEL >= LOG_LEVEL_ERROR
+    #define LOG_ERROR(cat, ...) LOG_AT(cat, LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+    #define LOG_ERROR(cat, ...) ((void)0)
+#endif
+#if LOG_MAX_LEVEL >= LOG_LEVEL_WARN
+    #define LOG_WARN(cat, ...) LOG_AT(cat, LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+    #define LOG_WARN(cat, ...) ((void)0)
+#endif
+#if LOG_MAX_LEVEL >= LOG_LEVEL_INFO
+    #define LOG_INFO(cat, ...) LOG_AT(cat, LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+    #define LOG_INFO(cat, ...) ((void)0)
+#endif
+#if LOG_MAX_LEVEL >= LOG_LEVEL_DEBUG
+    #define LOG_DEBUG(cat, ...) LOG_AT(cat, LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+    #define LOG_DEBUG(cat, ...) ((void)0)
+#endif
+#if LOG_MAX_LEVEL >= LOG_LEVEL_TRACE
+    #define LOG_TRACE(cat, ...) LOG_AT(cat, LOG_LEVEL_TRACE, __VA_ARGS__)
+#else
+    #define LOG_TRACE(cat, ...) ((void)0)
+#endif
+
+#endif
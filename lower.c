@@ -0,0 +1,439 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lower.h"
+#include "symbols.h"
+#include "compiler.h"
+
+// growable list used while a node's items are collected, copied into the arena at the end
+typedef struct {
+    AbsNode** data;
+    int count;
+    int cap;
+} AbsList;
+
+static void listPush(AbsList* l, AbsNode* n) {
+    if (!n) return;
+    if (l->count == l->cap) {
+        l->cap = l->cap ? l->cap * 2 : 8;
+        l->data = (AbsNode**)realloc(l->data, sizeof(AbsNode*) * l->cap);
+        if (!l->data) {
+            printf("Error:: out of memory while lowering the AST\n");
+            exit(1);
+        }
+    }
+    l->data[l->count++] = n;
+}
+
+static void listFinish(CompilerContext* cc, AbsNode* owner, AbsList* l) {
+    owner->count = l->count;
+    owner->items = NULL;
+    if (l->count > 0) {
+        owner->items = (AbsNode**)ast_alloc(cc, sizeof(AbsNode*) * l->count);
+        memcpy(owner->items, l->data, sizeof(AbsNode*) * l->count);
+    }
+    free(l->data);
+    l->data = NULL;
+    l->count = l->cap = 0;
+}
+
+static AbsNode* newAbs(CompilerContext* cc, AbsKind kind, ASTNode* source) {
+    AbsNode* n = (AbsNode*)ast_alloc(cc, sizeof(AbsNode));
+    n->kind = kind;
+    n->op = ABS_OP_NONE;
+    n->name = INTERN_NONE;
+    n->source = source;
+    n->line = source ? source->line : 0;
+    return n;
+}
+
+static ASTNode* childOf(ASTNode* n, ASTKind kind) {
+    if (!n) return NULL;
+    for (ASTNode* c = n->child; c; c = c->sibling)
+        if (c->kind == kind) return c;
+    return NULL;
+}
+
+static AbsNode* newBinary(CompilerContext* cc, AbsOp op, AbsNode* lhs, AbsNode* rhs, ASTNode* source) {
+    AbsNode* n = newAbs(cc, ABS_BINARY, source);
+    n->op = op;
+    n->as.binary.lhs = lhs;
+    n->as.binary.rhs = rhs;
+    if (lhs && lhs->line) n->line = lhs->line;
+    return n;
+}
+
+// ====== expressions =====
+static AbsNode* lowerOperand(CompilerContext* cc, ASTNode* n);
+static AbsNode* lowerVariable(CompilerContext* cc, ASTNode* n);
+
+// the parser builds one node per operator, its kind is the operator
+static AbsOp opFromKind(ASTKind kind) {
+    switch (kind) {
+    case AST_PLUS:  return ABS_OP_ADD;
+    case AST_MINUS: return ABS_OP_SUB;
+    case AST_OR:    return ABS_OP_OR;
+    case AST_MULT:  return ABS_OP_MUL;
+    case AST_DIV:   return ABS_OP_DIV;
+    case AST_AND:   return ABS_OP_AND;
+    case AST_LT:    return ABS_OP_LT;
+    case AST_GT:    return ABS_OP_GT;
+    case AST_LEQ:   return ABS_OP_LEQ;
+    case AST_GEQ:   return ABS_OP_GEQ;
+    case AST_NEQ:   return ABS_OP_NEQ;
+    case AST_NOT:   return ABS_OP_NOT;
+    case AST_POS:   return ABS_OP_PLUS;
+    case AST_NEG:   return ABS_OP_MINUS;
+    default:        return ABS_OP_NONE;
+    }
+}
+
+// expr and relExpr wrap one operator tree (none for a call statement)
+static AbsNode* lowerExpr(CompilerContext* cc, ASTNode* n) {
+    return n ? lowerOperand(cc, n->child) : NULL;
+}
+
+static AbsNode* lowerOperand(CompilerContext* cc, ASTNode* n) {
+    if (!n) return NULL;
+    switch (n->kind) {
+    case AST_VARIABLE:
+        return lowerVariable(cc, n);
+    case AST_INTLIT:
+    case AST_FLOATLIT: {
+        AbsNode* lit = newAbs(cc, n->kind == AST_INTLIT ? ABS_INT_LIT : ABS_FLOAT_LIT, n);
+        lit->name = n->lexeme_id;
+        return lit;
+    }
+    case AST_NOT:
+    case AST_NEG:
+    case AST_POS: {
+        AbsNode* u = newAbs(cc, ABS_UNARY, n);
+        u->op = opFromKind(n->kind);
+        u->as.unary.operand = lowerOperand(cc, n->child);
+        if (u->as.unary.operand) u->line = u->as.unary.operand->line;
+        return u;
+    }
+    default: {
+        AbsOp op = opFromKind(n->kind);
+        if (op == ABS_OP_NONE || !n->child) return NULL;
+        return newBinary(cc, op, lowerOperand(cc, n->child), lowerOperand(cc, n->child->sibling), n);
+    }
+    }
+}
+
+static AbsNode* lowerIndices(CompilerContext* cc, AbsNode* base, ASTNode* indiceList) {
+    for (ASTNode* l = indiceList; l && l->child; l = childOf(l, AST_INDICELIST)) {
+        ASTNode* ind = childOf(l, AST_INDICE);
+        AbsNode* ix = newAbs(cc, ABS_INDEX, ind);
+        ix->as.index.base = base;
+        ix->as.index.index = lowerOperand(cc, ind ? ind->child : NULL);
+        ix->line = base ? base->line : ix->line;
+        base = ix;
+    }
+    return base;
+}
+
+static AbsNode* lowerCall(CompilerContext* cc, AbsNode* callee, ASTNode* aParams) {
+    AbsNode* call = newAbs(cc, ABS_CALL, aParams);
+    call->as.call.callee = callee;
+    call->line = callee ? callee->line : call->line;
+    AbsList args = {0};
+    listPush(&args, lowerExpr(cc, childOf(aParams, AST_EXPR)));
+    for (ASTNode* l = childOf(aParams, AST_APARAMSTAILLIST); l && l->child; l = childOf(l, AST_APARAMSTAILLIST))
+        listPush(&args, lowerExpr(cc, childOf(childOf(l, AST_APARAMSTAIL), AST_EXPR)));
+    listFinish(cc, call, &args);
+    return call;
+}
+
+// name or self, as the head of a chain or as a member of base
+static AbsNode* lowerName(CompilerContext* cc, AbsNode* base, ASTNode* id) {
+    AbsNode* n;
+    if (base) {
+        n = newAbs(cc, ABS_MEMBER, id);
+        n->as.member.object = base;
+    } else {
+        n = newAbs(cc, id->kind == AST_SELF ? ABS_SELF : ABS_NAME, id);
+    }
+    n->name = id->lexeme_id;
+    return n;
+}
+
+// variable -> idnestList id indiceList, idnest -> idOrSelf idnestTail
+static AbsNode* lowerVariable(CompilerContext* cc, ASTNode* n) {
+    if (!n) return NULL;
+    AbsNode* base = NULL;
+    for (ASTNode* l = childOf(n, AST_IDNESTLIST); l && l->child; l = childOf(l, AST_IDNESTLIST)) {
+        ASTNode* nest = childOf(l, AST_IDNEST);
+        ASTNode* ios = childOf(nest, AST_IDORSELF);
+        if (ios && ios->child) base = lowerName(cc, base, ios->child);
+        ASTNode* tail = childOf(nest, AST_IDNESTTAIL);
+        if (tail && tail->child) {
+            if (tail->child->kind == AST_INDICELIST) base = lowerIndices(cc, base, tail->child);
+            else if (tail->child->kind == AST_APARAMS) base = lowerCall(cc, base, tail->child);
+        }
+    }
+    ASTNode* id = childOf(n, AST_ID);
+    if (id) base = lowerName(cc, base, id);
+    return lowerIndices(cc, base, childOf(n, AST_INDICELIST));
+}
+
+// ====== statements =====
+static AbsNode* lowerStatement(CompilerContext* cc, ASTNode* n);
+
+static void collectStatements(CompilerContext* cc, AbsList* out, ASTNode* list) {
+    for (ASTNode* l = list; l && l->child; l = childOf(l, AST_STATMENTLIST))
+        listPush(out, lowerStatement(cc, childOf(l, AST_STATEMENT)));
+}
+
+static AbsNode* lowerStatBlock(CompilerContext* cc, ASTNode* n) {
+    if (!n) return NULL;
+    AbsNode* b = newAbs(cc, ABS_BLOCK, n);
+    AbsList items = {0};
+    if (n->child && n->child->kind == AST_STATEMENT) listPush(&items, lowerStatement(cc, n->child));
+    else collectStatements(cc, &items, childOf(n, AST_STATMENTLIST));
+    listFinish(cc, b, &items);
+    return b;
+}
+
+static AbsNode* lowerVarDecl(CompilerContext* cc, ASTNode* n) {
+    ASTNode* id = childOf(n, AST_ID);
+    if (!id) return NULL;
+    AbsNode* d = newAbs(cc, ABS_VAR_DECL, n);
+    d->name = id->lexeme_id;
+    d->line = id->line;
+    return d;
+}
+
+static AbsNode* lowerStatement(CompilerContext* cc, ASTNode* n) {
+    if (!n || !n->child) return NULL;
+    ASTNode* ch = n->child;
+    AbsNode* s = NULL;
+    switch (ch->kind) {
+    case AST_ASSIGNSTAT:
+        // a call statement parses as an assignment without an operator; its value is NULL
+        s = newAbs(cc, ABS_ASSIGN, n);
+        s->as.assign.target = lowerVariable(cc, childOf(ch, AST_VARIABLE));
+        s->as.assign.value = lowerExpr(cc, childOf(ch, AST_EXPR));
+        break;
+    case AST_IF: {
+        s = newAbs(cc, ABS_IF, n);
+        ASTNode* thenBlock = childOf(n, AST_STATBLOCK);
+        s->as.if_stmt.cond = lowerExpr(cc, childOf(n, AST_RELEXPR));
+        s->as.if_stmt.then_part = lowerStatBlock(cc, thenBlock);
+        s->as.if_stmt.else_part = lowerStatBlock(cc, thenBlock ? thenBlock->sibling : NULL);
+        break;
+    }
+    case AST_WHILE:
+        s = newAbs(cc, ABS_WHILE, n);
+        s->as.while_stmt.cond = lowerExpr(cc, childOf(n, AST_RELEXPR));
+        s->as.while_stmt.body = lowerStatBlock(cc, childOf(n, AST_STATBLOCK));
+        break;
+    case AST_READ:
+        s = newAbs(cc, ABS_READ, n);
+        s->as.io.operand = lowerVariable(cc, childOf(n, AST_VARIABLE));
+        break;
+    case AST_WRITE:
+    case AST_RETURN:
+        s = newAbs(cc, ch->kind == AST_WRITE ? ABS_WRITE : ABS_RETURN, n);
+        s->as.io.operand = lowerExpr(cc, childOf(n, AST_EXPR));
+        break;
+    default:
+        return NULL;
+    }
+    return s;
+}
+
+// ====== declarations =====
+static AbsNode* lowerFunc(CompilerContext* cc, ASTNode* head, ASTNode* body, ASTNode* source, int is_member) {
+    AbsNode* f = newAbs(cc, ABS_FUNC, source);
+    f->as.func.is_member = is_member;
+    ASTNode* id = childOf(head, AST_ID);
+    if (id) {
+        f->name = id->lexeme_id;
+        f->line = id->line;
+    }
+
+    // fParams -> id : type arraySizeList fParamsTailList
+    AbsNode* params = newAbs(cc, ABS_BLOCK, childOf(head, AST_FPARAMS));
+    AbsList plist = {0};
+    ASTNode* fp = childOf(head, AST_FPARAMS);
+    ASTNode* pid = childOf(fp, AST_ID);
+    for (;;) {
+        if (pid) {
+            AbsNode* p = newAbs(cc, ABS_PARAM, pid);
+            p->name = pid->lexeme_id;
+            listPush(&plist, p);
+        }
+        fp = childOf(fp, AST_FPARAMSTAILLIST);
+        if (!fp || !fp->child) break;
+        pid = childOf(childOf(fp, AST_FPARAMSTAIL), AST_ID);
+    }
+    listFinish(cc, params, &plist);
+    f->as.func.params = params;
+
+    if (body) {
+        AbsNode* b = newAbs(cc, ABS_BLOCK, body);
+        AbsList items = {0};
+        for (ASTNode* l = childOf(body, AST_VARDECLORSTMTLIST); l && l->child; l = childOf(l, AST_VARDECLORSTMTLIST)) {
+            ASTNode* item = childOf(l, AST_VARDECLORSTMT);
+            if (!item || !item->child) continue;
+            if (item->child->kind == AST_LOCALVARDECL) listPush(&items, lowerVarDecl(cc, childOf(item->child, AST_VARDECL)));
+            else listPush(&items, lowerStatement(cc, item->child));
+        }
+        listFinish(cc, b, &items);
+        f->as.func.body = b;
+    }
+    return f;
+}
+
+static AbsNode* lowerClass(CompilerContext* cc, ASTNode* n) {
+    AbsNode* c = newAbs(cc, ABS_CLASS, n);
+    ASTNode* id = childOf(n, AST_ID);
+    if (id) {
+        c->name = id->lexeme_id;
+        c->line = id->line;
+    }
+
+    // isaIdOpt -> isa id idTail, idTail -> , id idTail | ε
+    AbsNode* parents = newAbs(cc, ABS_BLOCK, childOf(n, AST_ISAIDOPT));
+    AbsList plist = {0};
+    for (ASTNode* l = childOf(n, AST_ISAIDOPT); l && l->child; l = childOf(l, AST_IDTAIL)) {
+        ASTNode* pid = childOf(l, AST_ID);
+        if (pid) listPush(&plist, lowerName(cc, NULL, pid));
+    }
+    listFinish(cc, parents, &plist);
+    c->as.class_decl.parents = parents;
+
+    AbsList members = {0};
+    for (ASTNode* l = childOf(n, AST_VISIBILITYMEMBERDECLLIST); l && l->child; l = childOf(l, AST_VISIBILITYMEMBERDECLLIST)) {
+        ASTNode* m = childOf(l, AST_MEMBERDECL);
+        if (!m || !m->child) continue;
+        if (m->child->kind == AST_FUNCHEAD) listPush(&members, lowerFunc(cc, m->child, childOf(m, AST_FUNCBODY), m, 1));
+        else if (m->child->kind == AST_ATTRIBUTEDECL) listPush(&members, lowerVarDecl(cc, childOf(m->child, AST_VARDECL)));
+    }
+    listFinish(cc, c, &members);
+    return c;
+}
+
+static AbsNode* lowerImpl(CompilerContext* cc, ASTNode* n) {
+    AbsNode* im = newAbs(cc, ABS_IMPL, n);
+    ASTNode* id = childOf(n, AST_ID);
+    if (id) {
+        im->name = id->lexeme_id;
+        im->line = id->line;
+    }
+    AbsList funcs = {0};
+    for (ASTNode* l = childOf(n, AST_FUNCDEFLIST); l && l->child; l = childOf(l, AST_FUNCDEFLIST)) {
+        ASTNode* fd = childOf(l, AST_FUNCDEF);
+        if (fd) listPush(&funcs, lowerFunc(cc, childOf(fd, AST_FUNCHEAD), childOf(fd, AST_FUNCBODY), fd, 0));
+    }
+    listFinish(cc, im, &funcs);
+    return im;
+}
+
+AbsNode* lowerProgram(CompilerContext* cc, ASTNode* root) {
+    if (!root) return NULL;
+    AbsNode* prog = newAbs(cc, ABS_PROGRAM, root);
+    AbsList items = {0};
+    for (ASTNode* l = childOf(root, AST_CLASSORIMPLORFUNCLIST); l && l->child; l = childOf(l, AST_CLASSORIMPLORFUNCLIST)) {
+        ASTNode* item = childOf(l, AST_CLASSORIMPLORFUNC);
+        if (!item || !item->child) continue;
+        switch (item->child->kind) {
+        case AST_CLASSDECL: listPush(&items, lowerClass(cc, item->child)); break;
+        case AST_IMPLDEF:   listPush(&items, lowerImpl(cc, item->child)); break;
+        case AST_FUNCDEF:
+            listPush(&items, lowerFunc(cc, childOf(item->child, AST_FUNCHEAD), childOf(item->child, AST_FUNCBODY), item->child, 0));
+            break;
+        default:
+            break;
+        }
+    }
+    listFinish(cc, prog, &items);
+    return prog;
+}
+
+// ====== helpers shared with the passes =====
+int isRelationalOp(AbsOp op) {
+    return op >= ABS_OP_LT && op <= ABS_OP_NEQ;
+}
+
+const char* absOpText(AbsOp op) {
+    static const char* text[] = {
+        "", "+", "-", "or", "*", "/", "and", "<", ">", "<=", ">=", "<>", "not", "+", "-"
+    };
+    return text[op];
+}
+
+const char* absKindName(AbsKind kind) {
+    static const char* names[] = {
+        "Program", "Class", "Impl", "Func", "Param", "VarDecl", "Block", "Assign", "If", "While",
+        "Read", "Write", "Return", "BinaryOp", "UnaryOp", "Name", "Self", "IntLit", "FloatLit",
+        "MemberAccess", "Index", "Call"
+    };
+    return names[kind];
+}
+
+// ====== printing, one node per line =====
+static void printAbsRec(CompilerContext* cc, AbsNode* n, int level, const char* slot, FILE* out) {
+    for (int i = 0; i < level; i++) fprintf(out, "  ");
+    if (slot) fprintf(out, "%s: ", slot);
+    if (!n) {
+        fprintf(out, "(none)\n");
+        return;
+    }
+    fprintf(out, "%s", absKindName(n->kind));
+    if (n->op != ABS_OP_NONE) fprintf(out, " [%s]", absOpText(n->op));
+    if (n->name != INTERN_NONE) fprintf(out, " %s", intern_name(cc, n->name));
+    fprintf(out, "\n");
+
+    switch (n->kind) {
+    case ABS_BINARY:
+        printAbsRec(cc, n->as.binary.lhs, level + 1, "lhs", out);
+        printAbsRec(cc, n->as.binary.rhs, level + 1, "rhs", out);
+        break;
+    case ABS_UNARY:
+        printAbsRec(cc, n->as.unary.operand, level + 1, "operand", out);
+        break;
+    case ABS_ASSIGN:
+        printAbsRec(cc, n->as.assign.target, level + 1, "target", out);
+        printAbsRec(cc, n->as.assign.value, level + 1, "value", out);
+        break;
+    case ABS_IF:
+        printAbsRec(cc, n->as.if_stmt.cond, level + 1, "cond", out);
+        printAbsRec(cc, n->as.if_stmt.then_part, level + 1, "then", out);
+        printAbsRec(cc, n->as.if_stmt.else_part, level + 1, "else", out);
+        break;
+    case ABS_WHILE:
+        printAbsRec(cc, n->as.while_stmt.cond, level + 1, "cond", out);
+        printAbsRec(cc, n->as.while_stmt.body, level + 1, "body", out);
+        break;
+    case ABS_READ: case ABS_WRITE: case ABS_RETURN:
+        printAbsRec(cc, n->as.io.operand, level + 1, NULL, out);
+        break;
+    case ABS_MEMBER:
+        printAbsRec(cc, n->as.member.object, level + 1, "object", out);
+        break;
+    case ABS_INDEX:
+        printAbsRec(cc, n->as.index.base, level + 1, "base", out);
+        printAbsRec(cc, n->as.index.index, level + 1, "index", out);
+        break;
+    case ABS_CALL:
+        printAbsRec(cc, n->as.call.callee, level + 1, "callee", out);
+        break;
+    case ABS_FUNC:
+        printAbsRec(cc, n->as.func.params, level + 1, "params", out);
+        if (n->as.func.body) printAbsRec(cc, n->as.func.body, level + 1, "body", out);
+        break;
+    case ABS_CLASS:
+        printAbsRec(cc, n->as.class_decl.parents, level + 1, "parents", out);
+        break;
+    default:
+        break;
+    }
+    for (int i = 0; i < n->count; i++) printAbsRec(cc, n->items[i], level + 1, NULL, out);
+}
+
+void printAbstractAST(CompilerContext* cc, AbsNode* root, FILE* output_file) {
+    if (!root || !output_file) return;
+    printAbsRec(cc, root, 0, NULL, output_file);
+}
@@ -0,0 +1,75 @@
+#ifndef LOWER_H
+#define LOWER_H
+
+#include <stdio.h>
+#include "ast.h"
+
+// Abstract syntax tree ====================================================
+// lowered from the concrete parse tree: no tail/list/epsilon wrappers, every
+// node keeps its operands in fixed slots so later passes read them directly
+// instead of searching subtrees. Nodes live in the AST arena (ast_alloc).
+typedef enum {
+    ABS_PROGRAM,        // items: classes, impls, funcs in source order
+    ABS_CLASS,          // name, parents, members
+    ABS_IMPL,           // name, items: funcs
+    ABS_FUNC,           // name (INTERN_NONE for a constructor), params, body
+    ABS_PARAM,          // name
+    ABS_VAR_DECL,       // name (locals and attributes)
+    ABS_BLOCK,          // items: statements and local declarations
+    ABS_ASSIGN,         // assign.target, assign.value
+    ABS_IF,             // if_stmt.cond, then_part, else_part
+    ABS_WHILE,          // while_stmt.cond, body
+    ABS_READ,           // io.operand (the variable)
+    ABS_WRITE,          // io.operand
+    ABS_RETURN,         // io.operand
+    ABS_BINARY,         // op, binary.lhs, binary.rhs
+    ABS_UNARY,          // op, unary.operand
+    ABS_NAME,           // name
+    ABS_SELF,
+    ABS_INT_LIT,        // name holds the literal text
+    ABS_FLOAT_LIT,
+    ABS_MEMBER,         // member.object . name
+    ABS_INDEX,          // index.base [ index.index ]
+    ABS_CALL            // call.callee ( items )
+} AbsKind;
+
+typedef enum {
+    ABS_OP_NONE,
+    ABS_OP_ADD, ABS_OP_SUB, ABS_OP_OR,
+    ABS_OP_MUL, ABS_OP_DIV, ABS_OP_AND,
+    ABS_OP_LT, ABS_OP_GT, ABS_OP_LEQ, ABS_OP_GEQ, ABS_OP_NEQ,
+    ABS_OP_NOT, ABS_OP_PLUS, ABS_OP_MINUS
+} AbsOp;
+
+typedef struct AbsNode {
+    AbsKind kind;
+    AbsOp op;
+    int name;                   // interned id: declared/used name or literal text
+    int line;
+    ASTNode* source;            // concrete node this was lowered from
+    union {
+        struct { struct AbsNode* lhs; struct AbsNode* rhs; } binary;
+        struct { struct AbsNode* operand; } unary;
+        struct { struct AbsNode* target; struct AbsNode* value; } assign;
+        struct { struct AbsNode* cond; struct AbsNode* then_part; struct AbsNode* else_part; } if_stmt;
+        struct { struct AbsNode* cond; struct AbsNode* body; } while_stmt;
+        struct { struct AbsNode* operand; } io;
+        struct { struct AbsNode* object; } member;
+        struct { struct AbsNode* base; struct AbsNode* index; } index;
+        struct { struct AbsNode* callee; } call;
+        struct { struct AbsNode* params; struct AbsNode* body; int is_member; } func;   // params is an ABS_BLOCK of ABS_PARAM
+        struct { struct AbsNode* parents; } class_decl;                               // ABS_BLOCK of ABS_NAME
+    } as;
+    struct AbsNode** items;     // list payload (program, class members, block, call args)
+    int count;
+} AbsNode;
+
+AbsNode* lowerProgram(struct CompilerContext* cc, ASTNode* root);
+
+int isRelationalOp(AbsOp op);
+const char* absOpText(AbsOp op);
+const char* absKindName(AbsKind kind);
+
+void printAbstractAST(struct CompilerContext* cc, AbsNode* root, FILE* output_file);
+
+#endif
@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "parallel_parse.h"
+#include "parser.h"
+#include "y.tab.h"
+#include "log.h"
+#include "compiler.h"
+
+int parse_threads = 1;
+
+// ====== units and the workers that parse them ===========================
+typedef struct {
+    int begin, end;         // token range [begin, end)
+    ASTNode* root;          // classOrImplOrFunc node
+    size_t trace_end;       // end of its steps in the worker's trace
+} ParseUnit;
+
+typedef struct {
+    CompilerContext* cc;    // the compilation being parsed
+    ParseUnit* units;       // a run of consecutive units
+    int count;
+    Arena arena;
+    DerivationBuffer trace;
+    size_t nodes;
+    int failed;
+} ParseWorker;
+
+// every unit runs through the same grammar functions as prog(); a unit
+// that does not end exactly where the next one starts (or hits error())
+// fails the worker
+static void parse_units(ParseWorker* w) {
+    CompilerContext* cc = w->cc;
+    jmp_buf abort_point;
+    ast_use_arena(&w->arena, &w->nodes);
+    derivation_capture(&w->trace);
+    if (setjmp(abort_point) == 0) {
+        parser_abort = &abort_point;
+        for (int k = 0; k < w->count; k++) {
+            ParseUnit* u = &w->units[k];
+            token_pos = u->begin;
+            lookahead_token = cc->token_stream.data[u->begin].kind;
+            u->root = classOrImplOrFunc(cc);
+            u->trace_end = w->trace.count;
+            if (token_pos != u->end) {
+                w->failed = 1;
+                break;
+            }
+        }
+    } else {
+        w->failed = 1;
+    }
+    parser_abort = NULL;
+    parser_release_expr_stacks();
+    derivation_capture(NULL);
+    ast_use_arena(NULL, NULL);
+}
+
+// parse threads need the same stack as the main thread: the grammar functions recurse
+#define PARSE_THREAD_STACK (8u * 1024 * 1024)
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+typedef HANDLE ParseThread;
+
+static DWORD WINAPI parse_worker(LPVOID arg) {
+    parse_units((ParseWorker*)arg);
+    return 0;
+}
+
+static int parse_thread_start(ParseThread* t, ParseWorker* w) {
+    *t = CreateThread(NULL, PARSE_THREAD_STACK, parse_worker, w, 0, NULL);
+    return *t ? 0 : -1;
+}
+
+static void parse_thread_join(ParseThread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+#else
+#include <pthread.h>
+typedef pthread_t ParseThread;
+
+static void* parse_worker(void* arg) {
+    parse_units((ParseWorker*)arg);
+    return NULL;
+}
+
+static int parse_thread_start(ParseThread* t, ParseWorker* w) {
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, PARSE_THREAD_STACK);
+    int rc = pthread_create(t, &attr, parse_worker, w);
+    pthread_attr_destroy(&attr);
+    return rc;
+}
+
+static void parse_thread_join(ParseThread t) {
+    pthread_join(t, NULL);
+}
+#endif
+
+// ====== brace-matching pre-pass =========================================
+// a unit starts at class/implement/func/constructor outside any braces and
+// runs up to the next one (or the end of input). Returns the unit count,
+// 0 when the token stream cannot be split this way.
+static int find_units(const TokenVector* tokens, ParseUnit** out) {
+    int cap = 64, count = 0, depth = 0;
+    ParseUnit* units = (ParseUnit*)malloc(sizeof(ParseUnit) * cap);
+    if (!units) return 0;
+    for (int i = 0; i < tokens->count; i++) {
+        int kind = tokens->data[i].kind;
+        if (kind == LEFTBRACE) depth++;
+        else if (kind == RIGHTBRACE && --depth < 0) break;
+        else if (kind == EXIT || kind == PRINT_SYMBOLS) break;     // handled by match() as they come
+        else if (kind == 0 && depth == 0 && count > 0) {
+            units[count - 1].end = i;
+            *out = units;
+            return count;
+        } else if (depth == 0 && (kind == CLASS || kind == IMPLEMENT || kind == FUNC || kind == CONSTRUCT)) {
+            if (count > 0) units[count - 1].end = i;
+            if (count == cap) {
+                cap *= 2;
+                ParseUnit* grown = (ParseUnit*)realloc(units, sizeof(ParseUnit) * cap);
+                if (!grown) break;
+                units = grown;
+            }
+            units[count].begin = i;
+            units[count].root = NULL;
+            count++;
+        } else if (count == 0) {
+            break;      // something before the first unit: leave it to prog()
+        }
+    }
+    free(units);
+    return 0;
+}
+
+// ====== driver ===========================================================
+ASTNode* parallel_prog(CompilerContext* cc) {
+    // the grammar functions log each step; in parallel the lines would interleave
+    if (parse_threads <= 1 || log_enabled(LOG_PARSER, LOG_LEVEL_DEBUG)) return NULL;
+    TokenVector* tokens = &cc->token_stream;
+    tokens_drain(cc, tokens);
+
+    ParseUnit* units = NULL;
+    int unit_count = find_units(tokens, &units);
+    if (unit_count < 2) {
+        free(units);
+        return NULL;
+    }
+
+    // consecutive runs of units with about the same number of tokens each
+    int threads = parse_threads < unit_count ? parse_threads : unit_count;
+    ParseWorker* workers = (ParseWorker*)calloc(threads, sizeof(ParseWorker));
+    ParseThread* handles = (ParseThread*)calloc(threads, sizeof(ParseThread));
+    if (!workers || !handles) {
+        printf("Error:: out of memory for the parallel parse\n");
+        exit(1);
+    }
+    long total = units[unit_count - 1].end - units[0].begin;
+    int next = 0;
+    for (int w = 0; w < threads; w++) {
+        workers[w].cc = cc;
+        workers[w].units = &units[next];
+        arena_init(&workers[w].arena, 0);
+        long target = total * (w + 1) / threads;
+        int remaining = threads - w - 1;
+        while (next < unit_count - remaining &&
+               (workers[w].count == 0 || units[next].end - units[0].begin <= target || w == threads - 1)) {
+            workers[w].count++;
+            next++;
+        }
+    }
+
+    int started = 0;
+    for (; started < threads; started++)
+        if (parse_thread_start(&handles[started], &workers[started]) != 0) break;
+    for (int w = 0; w < started; w++) parse_thread_join(handles[w]);
+    for (int w = started; w < threads; w++) parse_units(&workers[w]);     // no thread left: run it here
+
+    int failed = 0;
+    for (int w = 0; w < threads; w++) failed |= workers[w].failed;
+    LOG_INFO(LOG_PARSER, "Parallel parse: %d units on %d threads%s\n",
+             unit_count, threads, failed ? ", syntax error: parsing serially" : "");
+
+    ASTNode* root = NULL;
+    if (!failed) {
+        // what prog() and classOrImplOrFuncList() record and build around the units
+        write_derivation(cc, RULE_PROG);
+        root = createNode(cc, "prog", "");
+        ASTNode* list = createNode(cc, "classOrImplOrFuncList", "");
+        addChild(root, list);
+        for (int w = 0; w < threads; w++) {
+            size_t from = 0;
+            for (int k = 0; k < workers[w].count; k++) {
+                ParseUnit* u = &workers[w].units[k];
+                write_derivation(cc, RULE_CLASSORIMPLORFUNCLIST_ITEM);
+                derivation_replay(cc, workers[w].trace.data + from, u->trace_end - from);
+                from = u->trace_end;
+                addChild(list, u->root);
+                ASTNode* rest = createNode(cc, "classOrImplOrFuncList", "");
+                addChild(list, rest);
+                list = rest;
+            }
+        }
+        write_derivation(cc, RULE_CLASSORIMPLORFUNCLIST_EMPTY);
+        token_pos = units[unit_count - 1].end;
+        lookahead_token = tokens->data[token_pos].kind;
+    }
+
+    for (int w = 0; w < threads; w++) {
+        if (failed) arena_free(&workers[w].arena);
+        else ast_adopt(cc, &workers[w].arena, workers[w].nodes);
+        derivation_buffer_free(&workers[w].trace);
+    }
+    free(handles);
+    free(workers);
+    free(units);
+    return root;
+}
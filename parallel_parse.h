@@ -0,0 +1,17 @@
+#ifndef PARALLEL_PARSE_H
+#define PARALLEL_PARSE_H
+
+#include "ast.h"
+
+// --parse-threads=N: top-level units parsed on N threads, 1 = serial
+extern int parse_threads;
+
+// prog() for the recursive descent parser with the top-level classDecl,
+// implDef and funcDef units parsed on parse_threads threads, each into its own
+// arena, and spliced under classOrImplOrFuncList in source order. Tree and
+// derivation are the ones prog() builds. Returns NULL, having consumed and
+// recorded nothing, when the input does not split into units cleanly or a
+// unit has a syntax error; the caller then parses serially.
+ASTNode* parallel_prog(struct CompilerContext* cc);
+
+#endif
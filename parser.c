@@ -1,6 +1,12 @@
 #include "parser.h"
 #include "y.tab.h"
 #include "semantic.h"
+#include "log.h"
+#include "ll1.h"
+#include "parallel_parse.h"
+#include "compiler.h"
+#include "tree_writer.h"
+#include "ast_snapshot.h"
 
 #if defined(_WIN32) || defined(_WIN64) 
 #include <direct.h>
@@ -11,120 +17,316 @@
 #define MKDIR(dir) mkdir(dir, 0755)
 #endif
 
-FILE* log_file;
-int lookahead_token;
-int derivation_step = 1;
-extern int lineno;
+_Thread_local int lookahead_token;
+_Thread_local int token_pos = 0;
+_Thread_local jmp_buf* parser_abort = NULL;
+int parser_engine = PARSER_RECURSIVE;
+int parser_syntax_only = 0;
+
+// tokens and trees live in the compilation (compiler.h); self_id is interned
+// before lexing starts, so the parser never inserts
 
 // ====== Initialize parser =====
-void init_parser() {
+void init_parser(CompilerContext* cc) {
     // ensure output directory exists
-    MKDIR("files");
-    log_file = fopen("files/derivation.txt", "w");
-    if (!log_file) {
-        printf("Error:: Cannot create derivation file\n");
-        exit(1);
-    }
-    fprintf(log_file,"======================================\n");
-    fprintf(log_file,"EEX6363 - Compiler Construction.\n");
-    fprintf(log_file,"Name: W.M.A.T.Wanninayake.\n");
-    fprintf(log_file,"Reg: 321428456 | S.No: S92068456\n");
-    fprintf(log_file,"======================================\n\n");
-    fprintf(log_file, "Parsing steps of Program:\n");
-    fprintf(log_file, "=====================================\n\n");
+    MKDIR(cc->output_dir);
+    derivation_begin(cc);
+
+    // lexing pass: the whole input becomes one token array before parsing,
+    // or (--pipeline) the array is filled from the lexer thread on demand
+    cc->self_id = intern(cc, "self");
+    tokens_free(&cc->token_stream);
+    tokens_start(cc, &cc->token_stream);
+    token_pos = 0;
+    lookahead_token = cc->token_stream.data[0].kind;
+}
 
-    lookahead_token = yylex();
+// ====== k-token lookahead over the token array (k = 0 is the current token) =====
+LexToken* peek_token(CompilerContext* cc, int k) {
+    int i = token_pos + k;
+    tokens_fill(cc, &cc->token_stream, i);
+    if (i >= cc->token_stream.count) i = cc->token_stream.count - 1;
+    return &cc->token_stream.data[i];
 }
 
-// ====== Write the rules to the file =====
-void write_derivation(char* rule) {
-    fprintf(log_file, "Step %d: %s\n", derivation_step++, rule);
-    printf("Derivation: %s\n", rule);
+void advance_token(CompilerContext* cc) {
+    tokens_fill(cc, &cc->token_stream, token_pos + 1);
+    if (token_pos < cc->token_stream.count - 1) token_pos++;
+    lookahead_token = cc->token_stream.data[token_pos].kind;
 }
 
-// ====== write the rules to the file ==============================
-void write_syntax_tree(ASTNode* root) {
-    FILE* output_file = fopen("files/syntax_tree.txt", "w");
-    if (!output_file) {
-        printf("Error:: Cannot create syntax tree file\n");
-        exit(1);
+// ====== leaf node for the current token's lexeme =====
+static ASTNode* token_node(CompilerContext* cc, const char* name) {
+    LexToken* tok = peek_token(cc, 0);
+    ASTNode* node = createNodeWithId(cc, name, tok->id);
+    node->line = tok->line;
+    return node;
+}
+
+// ====== leaf the grammar functions build for a matched token, NULL if it leaves none =====
+ASTNode* token_leaf(CompilerContext* cc, int kind) {
+    switch (kind) {
+    case ID:              return token_node(cc, "ID");
+    case SELF:            return createNodeWithId(cc, "SELF", cc->self_id);
+    case INTEGER_LITERAL: return createNodeWithId(cc, "intLit", peek_token(cc, 0)->id);
+    case FLOAT_LITERAL:   return createNodeWithId(cc, "floatLit", peek_token(cc, 0)->id);
+    case PUBLIC:          return createNode(cc, "PUBLIC", "");
+    case PRIVATE:         return createNode(cc, "PRIVATE", "");
+    case IF:              return createNode(cc, "if", "");
+    case WHILE:           return createNode(cc, "while", "");
+    case READ:            return createNode(cc, "read", "");
+    case WRITE:           return createNode(cc, "write", "");
+    case RETURN:          return createNode(cc, "return", "");
+    case ASSIGN:          return createNode(cc, ":=", "");
+    case LESS:            return createNode(cc, "<", "");
+    case GREATER:         return createNode(cc, ">", "");
+    case LOEQ:            return createNode(cc, "<=", "");
+    case GOEQ:            return createNode(cc, ">=", "");
+    case NEQ:             return createNode(cc, "<>", "");
+    case PLUS:            return createNode(cc, "+", "");
+    case MINUS:           return createNode(cc, "-", "");
+    case OR:              return createNode(cc, "or", "");
+    case MULTIPLY:        return createNode(cc, "*", "");
+    case DIVIDE:          return createNode(cc, "/", "");
+    case AND:             return createNode(cc, "and", "");
+    case NOT:             return createNode(cc, "not", "");
+    case INTEGER:         return createNode(cc, "integer", "");
+    case FLOAT:           return createNode(cc, "float", "");
+    case VOID:            return createNode(cc, "void", "");
+    default:              return NULL;
     }
-    fprintf(log_file,"======================================\n");
-    printDetailedAST(root, output_file);
-    fclose(output_file);
-    printf("Syntax tree written to syntax_tree.txt\n");
+}
+
+// ====== Record one derivation step (rule ids: derivation.h) =====
+void write_derivation(CompilerContext* cc, int rule) {
+    derivation_rule(cc, rule);
+    LOG_DEBUG(LOG_PARSER, "Derivation: %s\n", derivation_rule_text[rule]);
+}
+
+// ====== write the rules to the file ==============================
+void write_syntax_tree(CompilerContext* cc, ASTNode* root) {
+    derivation_separator(cc);
+    // printed from the compact layout; passes not yet converted keep using root
+    compact_reset(&cc->parse_tree);
+    NodeRef tree = compact_from_tree(&cc->parse_tree, root, 1);
+    LOG_DEBUG(LOG_PARSER, "AST: %u nodes, %zu bytes compact, %zu bytes as ASTNode\n",
+              cc->parse_tree.count, compact_bytes(&cc->parse_tree), (size_t)cc->parse_tree.count * sizeof(ASTNode));
+    tree_write_file(cc, &cc->parse_tree, tree);
+
+    // a snapshot of a partial tree would hide the syntax errors from whoever loads it
+    if (ast_snapshot_save_path && cc->syntax_error_count == 0 && ast_snapshot_save(cc, &cc->parse_tree, tree, ast_snapshot_save_path) == 0)
+        printf("AST snapshot written to %s\n", ast_snapshot_save_path);
 }
 
 // ====== Match the expected and current token and notify issues =====
-void match(int required_token) {
+void match(CompilerContext* cc, int required_token) {
     if (lookahead_token == EXIT) {
         printf("Parser:: EXIT.\n");
-        print_symbols();
-        exit(0);
+        tokens_drain(cc, &cc->token_stream);    // symbol table is complete once the lexer is done
+        print_symbols(cc);
+        compiler_exit(cc, 0);
     }
     if (lookahead_token == PRINT_SYMBOLS) {
         printf("Parser:: PRINT_SYMBOLS.\n");
-        print_symbols();
-        lookahead_token = yylex();
+        tokens_drain(cc, &cc->token_stream);
+        print_symbols(cc);
+        advance_token(cc);
     }   
     if (lookahead_token == required_token) {
-        printf("Matched token: %d\n", required_token);
-        lookahead_token = yylex();
-        printf("Next token: %d\n", lookahead_token);
+        LOG_TRACE(LOG_PARSER, "Matched token: %d\n", required_token);
+        advance_token(cc);
+        LOG_TRACE(LOG_PARSER, "Next token: %d\n", lookahead_token);
     } else {
         char error_msg[256];
         sprintf(error_msg, "Expected token %d, but found %d", 
                 required_token, lookahead_token);
-        error(error_msg);
+        error(cc, error_msg);
+
+    }
+}
+
+// ====== panic-mode recovery =====
+// each list item is parsed under a recovery point; error() jumps back to the
+// innermost one, which skips to a token the list can go on from
+typedef enum {
+    SYNC_UNIT,          // class, implement, function: the next one at brace depth 0
+    SYNC_MEMBER,        // class member / implementation function: ';', '}', the next member
+    SYNC_STATEMENT      // ';' or '}' of the enclosing block
+} SyncLevel;
+
+typedef struct RecoveryPoint {
+    jmp_buf env;
+    SyncLevel level;
+    int start;                      // token_pos when the item started
+    int expr_depth;                 // expression stacks in use when the item started
+    struct RecoveryPoint* outer;
+} RecoveryPoint;
+
+static _Thread_local RecoveryPoint* recovery = NULL;
+static _Thread_local int expr_depth = 0;    // operator_expression calls under way (see below)
+#define RECOVER_PASSED_UP 2         // longjmp value: an inner point gave up, already reported
+
+static void record_syntax_error(CompilerContext* cc, const char* message) {
+    if (cc->syntax_error_count == cc->syntax_error_cap) {
+        cc->syntax_error_cap = cc->syntax_error_cap ? cc->syntax_error_cap * 2 : 16;
+        cc->syntax_errors = (SyntaxError*)realloc(cc->syntax_errors, sizeof(SyntaxError) * cc->syntax_error_cap);
+        if (!cc->syntax_errors) {
+            printf("Error:: out of memory for syntax errors\n");
+            exit(1);
+        }
+    }
+    SyntaxError* e = &cc->syntax_errors[cc->syntax_error_count++];
+    e->line = peek_token(cc, 0)->line;
+    e->found = lookahead_token;
+    snprintf(e->message, sizeof(e->message), "%s", message);
+}
+
+static void write_syntax_errors(CompilerContext* cc) {
+    FILE* f = compiler_open_output(cc, "syntax_errors.txt", "w");
+    if (!f) return;
+    for (int i = 0; i < cc->syntax_error_count; i++)
+        fprintf(f, "Line %d: %s\n", cc->syntax_errors[i].line, cc->syntax_errors[i].message);
+    fclose(f);
+}
+
+static int starts_unit(int token) {
+    return token == CLASS || token == IMPLEMENT || token == FUNC || token == CONSTRUCT;
+}
+
+// top level: on to the next class/implement (they only occur there) or
+// func/constructor outside braces; braces are counted from the unit's start
+static void sync_unit(CompilerContext* cc, RecoveryPoint* rp, int passed_up) {
+    int depth = 0;
+    for (int i = rp->start; i < token_pos; i++) {
+        int kind = cc->token_stream.data[i].kind;
+        if (kind == LEFTBRACE) depth++;
+        else if (kind == RIGHTBRACE) depth--;
+    }
+    // a statement or member that ran into a unit keyword: the braces before it never closed
+    if (passed_up && starts_unit(lookahead_token)) return;
+    if (token_pos == rp->start) advance_token(cc);
+    while (lookahead_token != 0 && lookahead_token != EXIT) {
+        if (lookahead_token == CLASS || lookahead_token == IMPLEMENT) return;
+        if (depth <= 0 && starts_unit(lookahead_token)) return;
+        if (lookahead_token == LEFTBRACE) depth++;
+        else if (lookahead_token == RIGHTBRACE) depth--;
+        advance_token(cc);
+    }
+}
+
+// members and statements: braces are counted from the error; a ';' at depth 0
+// ends the item, a '}' at depth 0 closes the enclosing block. Returns 0 when
+// a construct of an enclosing level comes first.
+static int sync_item(CompilerContext* cc, RecoveryPoint* rp) {
+    int depth = 0;
+    if (token_pos == rp->start) advance_token(cc);
+    for (;;) {
+        int t = lookahead_token;
+        if (t == 0 || t == EXIT || t == CLASS || t == IMPLEMENT) return 0;
+        if (depth == 0) {
+            if (t == RIGHTBRACE) return 1;
+            if (t == SEMICOLON) {
+                advance_token(cc);
+                return 1;
+            }
+            if (t == FUNC || t == CONSTRUCT) return rp->level == SYNC_MEMBER;
+            if (rp->level == SYNC_MEMBER && (t == PUBLIC || t == PRIVATE)) return 1;
+        }
+        if (t == LEFTBRACE) depth++;
+        else if (t == RIGHTBRACE) depth--;
+        advance_token(cc);
+    }
+}
+
+static void give_up(CompilerContext* cc) {
+    write_syntax_errors(cc);
+    derivation_end(cc);
+    compiler_exit(cc, 1);
+}
 
+// one list item: rule()'s tree, or NULL when it had a syntax error
+static ASTNode* parse_item(CompilerContext* cc, ASTNode* (*rule)(CompilerContext*), SyncLevel level) {
+    RecoveryPoint rp;
+    rp.level = level;
+    rp.start = token_pos;
+    rp.expr_depth = expr_depth;
+    rp.outer = recovery;
+    ASTNode* item = NULL;
+    recovery = &rp;
+    switch (setjmp(rp.env)) {
+    case 0:
+        item = rule(cc);
+        break;
+    default:
+        recovery = rp.outer;
+        expr_depth = rp.expr_depth;     // the expressions error() left are done with
+        if (level == SYNC_UNIT) {
+            sync_unit(cc, &rp, 0);
+        } else if (!sync_item(cc, &rp)) {
+            if (!rp.outer) give_up(cc);
+            longjmp(rp.outer->env, RECOVER_PASSED_UP);
+        }
+        break;
+    case RECOVER_PASSED_UP:
+        recovery = rp.outer;
+        expr_depth = rp.expr_depth;
+        if (level == SYNC_UNIT) sync_unit(cc, &rp, 1);
+        else if (!rp.outer) give_up(cc);
+        else longjmp(rp.outer->env, RECOVER_PASSED_UP);
+        break;
     }
+    recovery = rp.outer;
+    return item;
 }
 
 // ====== Handle the errors =====
-void error(char* message) {
+void error(CompilerContext* cc, char* message) {
+    if (parser_abort) longjmp(*parser_abort, 1);    // the serial parse reports it
     printf("Parser Error Occurred:: %s\n", message);
-    fprintf(log_file, "ERROR: %s\n", message);
-    fclose(log_file);
-    exit(1);
+    derivation_error(cc, message);
+    record_syntax_error(cc, message);
+    if (recovery && cc->syntax_error_count < SYNTAX_ERROR_LIMIT) longjmp(recovery->env, 1);
+    if (recovery) printf("Too many syntax errors (%d), stopping\n", cc->syntax_error_count);
+    give_up(cc);
 }
 
 
 // ====AST Node creation for the starting point of the parsing process====
 
-ASTNode* prog() {
-    write_derivation("prog -> classOrImplOrFuncList");
-    ASTNode* node = createNode("prog", "");
-    addChild(node, classOrImplOrFuncList());
+ASTNode* prog(CompilerContext* cc) {
+    write_derivation(cc, RULE_PROG);
+    ASTNode* node = createNode(cc, "prog", "");
+    addChild(node, classOrImplOrFuncList(cc));
     return node;
 }
-ASTNode* classOrImplOrFuncList() {
-    ASTNode* node = createNode("classOrImplOrFuncList", "");
+ASTNode* classOrImplOrFuncList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "classOrImplOrFuncList", "");
     if (lookahead_token == CLASS || lookahead_token == IMPLEMENT || 
         lookahead_token == FUNC || lookahead_token == CONSTRUCT) {
-        write_derivation("classOrImplOrFuncList -> classOrImplOrFunc classOrImplOrFuncList");
-        addChild(node, classOrImplOrFunc());
-        addChild(node, classOrImplOrFuncList());
+        write_derivation(cc, RULE_CLASSORIMPLORFUNCLIST_ITEM);
+        addChild(node, parse_item(cc, classOrImplOrFunc, SYNC_UNIT));
+        addChild(node, classOrImplOrFuncList(cc));
         return node;
     } else {
-        write_derivation("classOrImplOrFuncList -> ε");
+        write_derivation(cc, RULE_CLASSORIMPLORFUNCLIST_EMPTY);
         return node; // returning node even for ε to maintain tree structure
     }
 }   
-ASTNode* classOrImplOrFunc() {
-    ASTNode* node = createNode("classOrImplOrFunc", "");
+ASTNode* classOrImplOrFunc(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "classOrImplOrFunc", "");
     if (lookahead_token == CLASS) {
-        write_derivation("classOrImplOrFunc -> classDecl");
-        ASTNode* child = classDecl();
+        write_derivation(cc, RULE_CLASSORIMPLORFUNC_CLASSDECL);
+        ASTNode* child = classDecl(cc);
         addChild(node, child);
         return node;
     } else if (lookahead_token == IMPLEMENT) {
-        write_derivation("classOrImplOrFunc -> implDef");
-        ASTNode* child = implDef();
+        write_derivation(cc, RULE_CLASSORIMPLORFUNC_IMPLDEF);
+        ASTNode* child = implDef(cc);
         addChild(node, child);
         return node;
     } else if (lookahead_token == FUNC || lookahead_token == CONSTRUCT) {
-        write_derivation("classOrImplOrFunc -> funcDef");
-        ASTNode* child = funcDef();
+        write_derivation(cc, RULE_CLASSORIMPLORFUNC_FUNCDEF);
+        ASTNode* child = funcDef(cc);
         addChild(node, child);
         return node;
     } else {
@@ -133,59 +335,57 @@ ASTNode* classOrImplOrFunc() {
     }
 }
 
-ASTNode* classDecl() {
-    write_derivation("classDecl -> class id isaIdOpt { visibilitymemberDeclList } ;");
-    ASTNode* node = createNode("classDecl", "");
+ASTNode* classDecl(CompilerContext* cc) {
+    write_derivation(cc, RULE_CLASSDECL);
+    ASTNode* node = createNode(cc, "classDecl", "");
     if (lookahead_token == CLASS) {
-        match(CLASS);
+        match(cc, CLASS);
         if (lookahead_token == ID) {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
-            match(ID);
+            ASTNode* idnode = token_node(cc, "ID");
+            match(cc, ID);
             addChild(node, idnode);
         }
         // optional isaIdOpt
-        addChild(node, isaIdOpt());
-        match(LEFTBRACE);
-        addChild(node, visibilitymemberDeclList());
-        match(RIGHTBRACE);
-        match(SEMICOLON);
+        addChild(node, isaIdOpt(cc));
+        match(cc, LEFTBRACE);
+        addChild(node, visibilitymemberDeclList(cc));
+        match(cc, RIGHTBRACE);
+        match(cc, SEMICOLON);
     }
     return node;
 }
 
-ASTNode* implDef() {
-    write_derivation("implDef -> implement id { funcDefList }");
-    ASTNode* node = createNode("implDef", "");
+ASTNode* implDef(CompilerContext* cc) {
+    write_derivation(cc, RULE_IMPLDEF);
+    ASTNode* node = createNode(cc, "implDef", "");
     if (lookahead_token == IMPLEMENT) {
-        match(IMPLEMENT);
+        match(cc, IMPLEMENT);
         if (lookahead_token == ID) {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
-            match(ID);
+            ASTNode* idnode = token_node(cc, "ID");
+            match(cc, ID);
             addChild(node, idnode);
         }
-        match(LEFTBRACE);
-        addChild(node, funcDefList());
-        match(RIGHTBRACE);
+        match(cc, LEFTBRACE);
+        addChild(node, funcDefList(cc));
+        match(cc, RIGHTBRACE);
     }
     return node;
 }
 
-ASTNode* funcDef() {
-    write_derivation("funcDef -> funcHead funcBody");
-    ASTNode* node = createNode("funcDef", "");
+ASTNode* funcDef(CompilerContext* cc) {
+    write_derivation(cc, RULE_FUNCDEF);
+    ASTNode* node = createNode(cc, "funcDef", "");
     // funcHead creates its own node and children
-    addChild(node, funcHead());
-    addChild(node, funcBody());
+    addChild(node, funcHead(cc));
+    addChild(node, funcBody(cc));
     return node;
 }
 
-ASTNode* funcDefList() {
-    ASTNode* node = createNode("funcDefList", "");
+ASTNode* funcDefList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "funcDefList", "");
     if (lookahead_token == FUNC || lookahead_token == CONSTRUCT) {
-        addChild(node, funcDef());
-        addChild(node, funcDefList());
+        addChild(node, parse_item(cc, funcDef, SYNC_MEMBER));
+        addChild(node, funcDefList(cc));
         return node;
     } else {
         // epsilon
@@ -193,48 +393,48 @@ ASTNode* funcDefList() {
     }
 }
 
-ASTNode* visibilitymemberDeclList() {
-    ASTNode* node = createNode("visibilitymemberDeclList", "");
+ASTNode* visibilitymemberDeclList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "visibilitymemberDeclList", "");
     if (lookahead_token == PUBLIC || lookahead_token == PRIVATE) {
-        addChild(node, visibility());
-        addChild(node, memberDecl());
-        addChild(node, visibilitymemberDeclList());
+        addChild(node, visibility(cc));
+        addChild(node, parse_item(cc, memberDecl, SYNC_MEMBER));
+        addChild(node, visibilitymemberDeclList(cc));
     }
     return node;
 }
 
-ASTNode* visibility() {
-    ASTNode* node = createNode("visibility", "");
+ASTNode* visibility(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "visibility", "");
     if (lookahead_token == PUBLIC) {
-        write_derivation("visibility -> public");
-        match(PUBLIC);
-        addChild(node, createNode("PUBLIC", ""));
+        write_derivation(cc, RULE_VISIBILITY_PUBLIC);
+        match(cc, PUBLIC);
+        addChild(node, createNode(cc, "PUBLIC", ""));
     } else if (lookahead_token == PRIVATE) {
-        write_derivation("visibility -> private");
-        match(PRIVATE);
-        addChild(node, createNode("PRIVATE", ""));
+        write_derivation(cc, RULE_VISIBILITY_PRIVATE);
+        match(cc, PRIVATE);
+        addChild(node, createNode(cc, "PRIVATE", ""));
     }
     return node;
 }
 
 // ========= RESOLVED AMBIGUITY IN memberDecl = funcDecl | funcDef | attributeDecl ========
-ASTNode* memberDecl() {
-    ASTNode* node = createNode("memberDecl", "");
+ASTNode* memberDecl(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "memberDecl", "");
     if (lookahead_token == FUNC || lookahead_token == CONSTRUCT) {
-        ASTNode* head = funcHead();
+        ASTNode* head = funcHead(cc);
         if (lookahead_token == SEMICOLON) {
-            write_derivation("memberDecl -> funcDecl");
+            write_derivation(cc, RULE_MEMBERDECL_FUNCDECL);
             addChild(node, head);
-            match(SEMICOLON);
+            match(cc, SEMICOLON);
         } else if (lookahead_token == LEFTBRACE) {
-            write_derivation("memberDecl -> funcDef");
+            write_derivation(cc, RULE_MEMBERDECL_FUNCDEF);
             addChild(node, head);
-            addChild(node, funcBody());
-            if (lookahead_token == SEMICOLON) match(SEMICOLON);
+            addChild(node, funcBody(cc));
+            if (lookahead_token == SEMICOLON) match(cc, SEMICOLON);
         }
     } else if (lookahead_token == ATTRIBUTE) {
-        write_derivation("memberDecl -> attributeDecl");
-        addChild(node, attributeDecl());
+        write_derivation(cc, RULE_MEMBERDECL_ATTRIBUTEDECL);
+        addChild(node, attributeDecl(cc));
     }
     else {
         printf("Expected 'func', 'construct', or 'attribute' in memberDecl\n");
@@ -242,30 +442,29 @@ ASTNode* memberDecl() {
     return node;
 }
 
-ASTNode* funcHead() {
-    ASTNode* node = createNode("funcHead", "");
+ASTNode* funcHead(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "funcHead", "");
     if (lookahead_token == FUNC) {
-        write_derivation("funcHead -> func id (fParams) => returnType");
-        match(FUNC);
+        write_derivation(cc, RULE_FUNCHEAD_FUNC);
+        match(cc, FUNC);
         if (lookahead_token == ID) {
             {
-                ASTNode* idnode = createNode("ID", yytext);
-                idnode->line = lineno;
+                ASTNode* idnode = token_node(cc, "ID");
                 addChild(node, idnode);
             }
-            match(ID);
+            match(cc, ID);
         }
-        match(LEFTPAREN);
-        addChild(node, fParams());
-        match(RIGHTPAREN);
-        match(ARROW);
-        addChild(node, returnType());
+        match(cc, LEFTPAREN);
+        addChild(node, fParams(cc));
+        match(cc, RIGHTPAREN);
+        match(cc, ARROW);
+        addChild(node, returnType(cc));
     } else if (lookahead_token == CONSTRUCT) {
-        write_derivation("funcHead -> constructor (fParams)");
-        match(CONSTRUCT);
-        match(LEFTPAREN);
-        addChild(node, fParams());
-        match(RIGHTPAREN);
+        write_derivation(cc, RULE_FUNCHEAD_CONSTRUCTOR);
+        match(cc, CONSTRUCT);
+        match(cc, LEFTPAREN);
+        addChild(node, fParams(cc));
+        match(cc, RIGHTPAREN);
     }
     else {
         printf("Expected 'func' or 'construct' in funcHead\n");
@@ -273,102 +472,101 @@ ASTNode* funcHead() {
     return node;
 }
 
-ASTNode* funcBody() {
-    ASTNode* node = createNode("funcBody", "");
+ASTNode* funcBody(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "funcBody", "");
     if (lookahead_token == LEFTBRACE) {
-        write_derivation("funcBody -> { varDeclOrStmtList }");
-        match(LEFTBRACE);
-        addChild(node, varDeclOrStmtList());
-        match(RIGHTBRACE);
+        write_derivation(cc, RULE_FUNCBODY);
+        match(cc, LEFTBRACE);
+        addChild(node, varDeclOrStmtList(cc));
+        match(cc, RIGHTBRACE);
     }
     return node;
 }
 
-ASTNode* funcDecl() {
-    ASTNode* node = createNode("funcDecl", "");
+ASTNode* funcDecl(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "funcDecl", "");
     if (lookahead_token == FUNC || lookahead_token == CONSTRUCT) {
-        write_derivation("funcDecl -> funcHead ;");
-        addChild(node, funcHead());
-        match(SEMICOLON);
+        write_derivation(cc, RULE_FUNCDECL);
+        addChild(node, funcHead(cc));
+        match(cc, SEMICOLON);
     }
     return node;
 }
 
-ASTNode* varDeclOrStmtList() {
-    ASTNode* node = createNode("varDeclOrStmtList", "");
+ASTNode* varDeclOrStmtList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "varDeclOrStmtList", "");
     if (lookahead_token == LOCAL || lookahead_token == ID || 
         lookahead_token == IF || lookahead_token == WHILE ||
         lookahead_token == READ || lookahead_token == WRITE ||
         lookahead_token == RETURN || lookahead_token == SELF) {
-        addChild(node, varDeclOrStmt());
-        addChild(node, varDeclOrStmtList());
+        addChild(node, parse_item(cc, varDeclOrStmt, SYNC_STATEMENT));
+        addChild(node, varDeclOrStmtList(cc));
     }
     return node;
 }
 
-ASTNode* varDeclOrStmt() {
-    ASTNode* node = createNode("varDeclOrStmt", "");
+ASTNode* varDeclOrStmt(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "varDeclOrStmt", "");
     if (lookahead_token == LOCAL) {
-        write_derivation("varDeclOrStmt -> localVarDecl");
-        addChild(node, localVarDecl());
+        write_derivation(cc, RULE_VARDECLORSTMT_LOCALVARDECL);
+        addChild(node, localVarDecl(cc));
     } else {
-        write_derivation("varDeclOrStmt -> statement");
-        addChild(node, statement());
+        write_derivation(cc, RULE_VARDECLORSTMT_STATEMENT);
+        addChild(node, statement(cc));
     }
     return node;
 }
 
-ASTNode* localVarDecl() {
-    ASTNode* node = createNode("localVarDecl", "");
+ASTNode* localVarDecl(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "localVarDecl", "");
     if (lookahead_token == LOCAL) {
-        write_derivation("localVarDecl -> local varDecl");
-        match(LOCAL);
-        addChild(node, varDecl());
+        write_derivation(cc, RULE_LOCALVARDECL);
+        match(cc, LOCAL);
+        addChild(node, varDecl(cc));
     }
     return node;
 }
 
-ASTNode* varDecl() {
-    ASTNode* node = createNode("varDecl", "");
+ASTNode* varDecl(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "varDecl", "");
     if (lookahead_token == ID) {
         {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
+            ASTNode* idnode = token_node(cc, "ID");
             addChild(node, idnode);
         }
-        match(ID);
-        match(COLON);
-        addChild(node, type());
-        addChild(node, arraySizeList());
-        match(SEMICOLON);
+        match(cc, ID);
+        match(cc, COLON);
+        addChild(node, type(cc));
+        addChild(node, arraySizeList(cc));
+        match(cc, SEMICOLON);
     }
     return node;
 }
 
-ASTNode* attributeDecl() {
-    ASTNode* node = createNode("attributeDecl", "");
+ASTNode* attributeDecl(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "attributeDecl", "");
     if (lookahead_token == ATTRIBUTE) {
-        write_derivation("attributeDecl -> attribute varDecl");
-        match(ATTRIBUTE);
-        addChild(node, varDecl());
+        write_derivation(cc, RULE_ATTRIBUTEDECL);
+        match(cc, ATTRIBUTE);
+        addChild(node, varDecl(cc));
     }
     return node;
 }
 
-ASTNode* statement() {
-    ASTNode* node = createNode("statement", "");
+ASTNode* statement(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "statement", "");
     if (lookahead_token == ID || lookahead_token == SELF) {
         // assignment or method call starting with id/self
-        write_derivation("statement -> assignStat ;");
-        addChild(node, assignStat());
-        match(SEMICOLON);
+        write_derivation(cc, RULE_STATEMENT_ASSIGN);
+        addChild(node, assignStat(cc));
+        match(cc, SEMICOLON);
         // addChild(node, idnestList());
         // if (lookahead_token == ID) {
         //     // peek ahead: if next token after ID is ASSIGN -> assignStat
         //     match(ID);
         //     if ( lookahead_token = LEFTPAREN ) {
         //         // function call
-        //         write_derivation("statement -> functionCall ;");
+        //         write_derivation(RULE_STATEMENT_CALL);
         //         match(LEFTPAREN);
         //         addChild(node, aParams());
         //         match(RIGHTPAREN);
@@ -377,7 +575,7 @@ ASTNode* statement() {
         //     } else if (lookahead_token == ASSIGN) {
         //         addChild(node, indiceList());
         //         if (lookahead_token == ASSIGN) {
-        //             write_derivation("statement -> assignStat ;");
+        //             write_derivation(RULE_STATEMENT_ASSIGN);
         //             match(ASSIGN);
         //             addChild(node, expr());
         //             match(SEMICOLON);
@@ -387,510 +585,543 @@ ASTNode* statement() {
         // }
         return node;
     } else if (lookahead_token == IF) {
-        write_derivation("statement -> if ( relExpr ) then statBlock else statBlock ;");
-        addChild(node, createNode("if", ""));
-        match(IF);
-        match(LEFTPAREN);
-        addChild(node, relExpr());
-        match(RIGHTPAREN);
-        match(THEN);
-        addChild(node, statBlock());
-        match(ELSE);
-        addChild(node, statBlock());
-        match(SEMICOLON);
+        write_derivation(cc, RULE_STATEMENT_IF);
+        addChild(node, createNode(cc, "if", ""));
+        match(cc, IF);
+        match(cc, LEFTPAREN);
+        addChild(node, relExpr(cc));
+        match(cc, RIGHTPAREN);
+        match(cc, THEN);
+        addChild(node, statBlock(cc));
+        match(cc, ELSE);
+        addChild(node, statBlock(cc));
+        match(cc, SEMICOLON);
     } else if (lookahead_token == WHILE) {
-        write_derivation("statement -> while ( relExpr ) statBlock ;");
-        addChild(node, createNode("while", ""));
-        match(WHILE);
-        match(LEFTPAREN);
-        addChild(node, relExpr());
-        match(RIGHTPAREN);
-        addChild(node, statBlock());
-        match(SEMICOLON);
+        write_derivation(cc, RULE_STATEMENT_WHILE);
+        addChild(node, createNode(cc, "while", ""));
+        match(cc, WHILE);
+        match(cc, LEFTPAREN);
+        addChild(node, relExpr(cc));
+        match(cc, RIGHTPAREN);
+        addChild(node, statBlock(cc));
+        match(cc, SEMICOLON);
     } else if (lookahead_token == READ) {
-        write_derivation("statement -> read ( variable ) ;");
-        addChild(node, createNode("read", ""));
-        match(READ);
-        match(LEFTPAREN);
-        addChild(node, variable());
-        match(RIGHTPAREN);
-        match(SEMICOLON);
+        write_derivation(cc, RULE_STATEMENT_READ);
+        addChild(node, createNode(cc, "read", ""));
+        match(cc, READ);
+        match(cc, LEFTPAREN);
+        addChild(node, variable(cc));
+        match(cc, RIGHTPAREN);
+        match(cc, SEMICOLON);
     } else if (lookahead_token == WRITE) {
-        write_derivation("statement -> write ( expr ) ;");
-        addChild(node, createNode("write", ""));
-        match(WRITE);
-        match(LEFTPAREN);
-        addChild(node, expr());
-        match(RIGHTPAREN);
-        match(SEMICOLON);
+        write_derivation(cc, RULE_STATEMENT_WRITE);
+        addChild(node, createNode(cc, "write", ""));
+        match(cc, WRITE);
+        match(cc, LEFTPAREN);
+        addChild(node, expr(cc));
+        match(cc, RIGHTPAREN);
+        match(cc, SEMICOLON);
     } else if (lookahead_token == RETURN) {
-        write_derivation("statement -> return ( expr ) ;");
-        addChild(node, createNode("return", ""));
-        match(RETURN);
-        match(LEFTPAREN);
-        addChild(node, expr());
-        match(RIGHTPAREN);
-        match(SEMICOLON);
+        write_derivation(cc, RULE_STATEMENT_RETURN);
+        addChild(node, createNode(cc, "return", ""));
+        match(cc, RETURN);
+        match(cc, LEFTPAREN);
+        addChild(node, expr(cc));
+        match(cc, RIGHTPAREN);
+        match(cc, SEMICOLON);
     }
     return node;
 }
 
-ASTNode* statBlock() {
-    ASTNode* node = createNode("statBlock", "");
+ASTNode* statBlock(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "statBlock", "");
     if (lookahead_token == LEFTBRACE) {
-        write_derivation("statBlock -> { statmentList }");
-        match(LEFTBRACE);
-        addChild(node, statmentList());
-        match(RIGHTBRACE);
+        write_derivation(cc, RULE_STATBLOCK);
+        match(cc, LEFTBRACE);
+        addChild(node, statmentList(cc));
+        match(cc, RIGHTBRACE);
     } else {
-        addChild(node, statement());
+        addChild(node, statement(cc));
     }
     return node;
 }
 
-ASTNode* statmentList() {
-    ASTNode* node = createNode("statmentList", "");
+ASTNode* statmentList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "statmentList", "");
     if (lookahead_token == ID || lookahead_token == IF || 
         lookahead_token == WHILE || lookahead_token == READ ||
         lookahead_token == WRITE || lookahead_token == RETURN ||
         lookahead_token == SELF) {
-        addChild(node, statement());
-        addChild(node, statmentList());
+        addChild(node, parse_item(cc, statement, SYNC_STATEMENT));
+        addChild(node, statmentList(cc));
     }
     return node;
 }
 
-ASTNode* assignStat() {
-    ASTNode* node = createNode("assignStat", "");
+ASTNode* assignStat(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "assignStat", "");
     if (lookahead_token == ID || lookahead_token == SELF) {
-        write_derivation("assignStat -> variable assignOp expr");
-        addChild(node, variable());
-        addChild(node, assignOp());
-        addChild(node, expr());
+        write_derivation(cc, RULE_ASSIGNSTAT);
+        addChild(node, variable(cc));
+        addChild(node, assignOp(cc));
+        addChild(node, expr(cc));
     }
     return node;
 }
 
-ASTNode* assignOp() {
-    ASTNode* node = createNode("assignOp", "");
+ASTNode* assignOp(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "assignOp", "");
     if (lookahead_token == ASSIGN) {
-        write_derivation("assignOp -> :=");
-        addChild(node, createNode(":=", ""));
-        match(ASSIGN);
+        write_derivation(cc, RULE_ASSIGNOP);
+        addChild(node, createNode(cc, ":=", ""));
+        match(cc, ASSIGN);
     }
     return node;
 }
 
-ASTNode* relExpr() {
-    write_derivation("relExpr -> arithExpr relOp arithExpr");
-    ASTNode* node = createNode("relExpr", "");
-    addChild(node, arithExpr());
-    addChild(node, relOp());
-    addChild(node, arithExpr());
-    return node;
+// ====== Expressions: precedence climbing over explicit stacks =====
+// every operator becomes one node whose kind is the operator (AST_PLUS, AST_LT, ...),
+// binary ones hold lhs and rhs, not/neg/pos hold their operand; operands are
+// variable, intLit and floatLit nodes and parentheses only group. Both stacks
+// are on the heap, so the nesting depth of parentheses costs no C stack.
+#define EXPR_GROUP (-1)     // operator stack marker for an open '('
+
+typedef struct {
+    int* ops;               // operator tokens, EXPR_GROUP for '(' ; negated for prefix operators
+    int op_count, op_cap;
+    ASTNode** operands;
+    int operand_count, operand_cap;
+} ExprStacks;
+
+// one ExprStacks per nesting level (an index or argument holds a whole
+// expression), kept per thread and reused. error() can leave an expression by
+// longjmp; the recovery point then only puts expr_depth back, nothing leaks
+static _Thread_local ExprStacks** expr_pool = NULL;
+static _Thread_local int expr_pool_count = 0, expr_pool_cap = 0;
+
+static ExprStacks* expr_stacks_enter() {
+    if (expr_depth == expr_pool_count) {
+        if (expr_pool_count == expr_pool_cap) {
+            expr_pool_cap = expr_pool_cap ? expr_pool_cap * 2 : 8;
+            expr_pool = (ExprStacks**)realloc(expr_pool, sizeof(ExprStacks*) * expr_pool_cap);
+        }
+        ExprStacks* fresh = expr_pool ? (ExprStacks*)calloc(1, sizeof(ExprStacks)) : NULL;
+        if (!fresh) {
+            printf("Error:: out of memory while parsing an expression\n");
+            exit(1);
+        }
+        expr_pool[expr_pool_count++] = fresh;
+    }
+    ExprStacks* s = expr_pool[expr_depth++];
+    s->op_count = 0;
+    s->operand_count = 0;
+    return s;
 }
 
-ASTNode* relOp() {
-    ASTNode* node = createNode("relOp", "");
-    if (lookahead_token == LESS) {
-        addChild(node, createNode("<", ""));
-        match(LESS);
-    } else if (lookahead_token == GREATER) {
-        addChild(node, createNode(">", ""));
-        match(GREATER);
-    } else if (lookahead_token == LOEQ) {
-        addChild(node, createNode("<=", ""));
-        match(LOEQ);
-    } else if (lookahead_token == GOEQ) {
-        addChild(node, createNode(">=", ""));
-        match(GOEQ);
-    } else if (lookahead_token == NEQ) {
-        addChild(node, createNode("<>", ""));
-        match(NEQ);
+void parser_release_expr_stacks() {
+    for (int i = 0; i < expr_pool_count; i++) {
+        free(expr_pool[i]->ops);
+        free(expr_pool[i]->operands);
+        free(expr_pool[i]);
     }
-    return node;
+    free(expr_pool);
+    expr_pool = NULL;
+    expr_pool_count = expr_pool_cap = 0;
+    expr_depth = 0;
 }
 
-ASTNode* expr() {
-    // expr -> arithExpr [relOp arithExpr]
-    ASTNode* node = createNode("expr", "");
-    addChild(node, arithExpr());
-    if (lookahead_token == LESS || lookahead_token == GREATER ||
-        lookahead_token == LOEQ || lookahead_token == GOEQ ||
-        lookahead_token == NEQ) {
-        addChild(node, relOp());
-        addChild(node, arithExpr());
+static void expr_push_op(CompilerContext* cc, ExprStacks* s, int op) {
+    if (s->op_count == s->op_cap) {
+        s->op_cap = s->op_cap ? s->op_cap * 2 : 16;
+        s->ops = (int*)realloc(s->ops, sizeof(int) * s->op_cap);
+        if (!s->ops) error(cc, "Out of memory while parsing an expression");
     }
-    return node;
+    s->ops[s->op_count++] = op;
+}
+
+static void expr_push_operand(CompilerContext* cc, ExprStacks* s, ASTNode* n) {
+    if (s->operand_count == s->operand_cap) {
+        s->operand_cap = s->operand_cap ? s->operand_cap * 2 : 16;
+        s->operands = (ASTNode**)realloc(s->operands, sizeof(ASTNode*) * s->operand_cap);
+        if (!s->operands) error(cc, "Out of memory while parsing an expression");
+    }
+    s->operands[s->operand_count++] = n;
+}
+
+// binding strength of a binary operator token, 0 if the token ends the expression
+static int binary_precedence(int token, int allow_relational) {
+    switch (token) {
+    case MULTIPLY: case DIVIDE: case AND:
+        return 3;
+    case PLUS: case MINUS: case OR:
+        return 2;
+    case LESS: case GREATER: case LOEQ: case GOEQ: case NEQ:
+        return allow_relational ? 1 : 0;
+    default:
+        return 0;
+    }
+}
+
+// pop the top operator and build its node from the operand stack
+static void expr_reduce(CompilerContext* cc, ExprStacks* s) {
+    int op = s->ops[--s->op_count];
+    ASTNode* node;
+    if (op < 0) {
+        op = -op;
+        node = op == NOT ? createNode(cc, "not", "") : createNode(cc, op == MINUS ? "neg" : "pos", "");
+        addChild(node, s->operands[s->operand_count - 1]);
+        s->operands[s->operand_count - 1] = node;
+        return;
+    }
+    node = token_leaf(cc, op);
+    ASTNode* rhs = s->operands[--s->operand_count];
+    addChild(node, s->operands[s->operand_count - 1]);
+    addChild(node, rhs);
+    s->operands[s->operand_count - 1] = node;
+}
+
+static void expr_reduce_prefix(CompilerContext* cc, ExprStacks* s) {
+    while (s->op_count > 0 && s->ops[s->op_count - 1] < 0 && s->ops[s->op_count - 1] != EXPR_GROUP)
+        expr_reduce(cc, s);
+}
+
+// expr -> arithExpr [relOp arithExpr], arithExpr -> term { addOp term },
+// term -> factor { multOp factor }, factor -> variable | intLit | floatLit
+// | ( arithExpr ) | not factor | sign factor. NULL for an empty expression
+// (a call statement has no value); a relational operator is accepted once,
+// outside parentheses, when allow_relational is set
+static ASTNode* operator_expression(CompilerContext* cc, int allow_relational) {
+    ExprStacks* s = expr_stacks_enter();
+    int depth = 0;          // open parentheses
+    int relational = 0;
+    ASTNode* result = NULL;
+
+    for (;;) {
+        // operand, after any prefix operators and '('
+        int prefixed = 0;
+        for (;;) {
+            if (lookahead_token == NOT || lookahead_token == PLUS || lookahead_token == MINUS) {
+                expr_push_op(cc, s, -lookahead_token);
+                match(cc, lookahead_token);
+            } else if (lookahead_token == LEFTPAREN) {
+                expr_push_op(cc, s, EXPR_GROUP);
+                match(cc, LEFTPAREN);
+                depth++;
+            } else {
+                break;
+            }
+            prefixed = 1;
+        }
+        if (lookahead_token == ID || lookahead_token == SELF) {
+            expr_push_operand(cc, s, variable(cc));
+        } else if (lookahead_token == INTEGER_LITERAL || lookahead_token == FLOAT_LITERAL) {
+            expr_push_operand(cc, s, token_leaf(cc, lookahead_token));
+            match(cc, lookahead_token);
+        } else if (!prefixed && s->op_count == 0) {
+            break;              // empty expression
+        } else {
+            char msg[128];
+            snprintf(msg, sizeof(msg), "Expected an operand, but found %d", lookahead_token);
+            error(cc, msg);
+        }
+        expr_reduce_prefix(cc, s);
+
+        // closing parentheses, then the next binary operator or the end
+        while (depth > 0 && lookahead_token == RIGHTPAREN) {
+            while (s->ops[s->op_count - 1] != EXPR_GROUP) expr_reduce(cc, s);
+            s->op_count--;
+            match(cc, RIGHTPAREN);
+            depth--;
+            expr_reduce_prefix(cc, s);
+        }
+        int prec = binary_precedence(lookahead_token, allow_relational && depth == 0 && !relational);
+        if (prec == 0) {
+            if (depth > 0) match(cc, RIGHTPAREN);   // reports the missing ')'
+            while (s->op_count > 0) expr_reduce(cc, s);
+            result = s->operands[0];
+            break;
+        }
+        while (s->op_count > 0 && s->ops[s->op_count - 1] > 0 && binary_precedence(s->ops[s->op_count - 1], 1) >= prec)
+            expr_reduce(cc, s);
+        if (prec == 1) relational = 1;
+        expr_push_op(cc, s, lookahead_token);
+        match(cc, lookahead_token);
+    }
+    expr_depth--;
+    return result;
 }
 
-ASTNode* arithExpr() {
-    ASTNode* node = createNode("arithExpr", "");
-    addChild(node, term());
-    addChild(node, arithExprTail());
+ASTNode* relExpr(CompilerContext* cc) {
+    write_derivation(cc, RULE_RELEXPR);
+    ASTNode* node = createNode(cc, "relExpr", "");
+    addChild(node, operator_expression(cc, 1));
     return node;
 }
 
-ASTNode* term() {
-    ASTNode* node = createNode("term", "");
-    addChild(node, factor());
-    addChild(node, termTail());
+ASTNode* expr(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "expr", "");
+    addChild(node, operator_expression(cc, 1));
     return node;
 }
 
-ASTNode* idOrSelf() {
-    ASTNode* node = createNode("idOrSelf", "");
+// the operator tree itself, no wrapper node (indices and the table parser)
+ASTNode* arithExpr(CompilerContext* cc) {
+    return operator_expression(cc, 0);
+}
+
+ASTNode* idOrSelf(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "idOrSelf", "");
     if (lookahead_token == ID) {
         {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
+            ASTNode* idnode = token_node(cc, "ID");
             addChild(node, idnode);
         }
-        match(ID);
+        match(cc, ID);
     } else if (lookahead_token == SELF) {
-        addChild(node, createNode("SELF", yytext));
-        match(SELF);
+        addChild(node, createNodeWithId(cc, "SELF", cc->self_id));
+        match(cc, SELF);
     }
     return node;
 }
 
-ASTNode* idnestTail() {
-    ASTNode* node = createNode("idnestTail", "");
+ASTNode* idnestTail(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "idnestTail", "");
     if (lookahead_token == LEFTBRACKET) {
-        addChild(node, indiceList());
-        if (lookahead_token == DOT) match(DOT);
+        addChild(node, indiceList(cc));
+        if (lookahead_token == DOT) match(cc, DOT);
     } else if (lookahead_token == LEFTPAREN) {
-        match(LEFTPAREN);
-        addChild(node, aParams());
-        match(RIGHTPAREN);
-        if (lookahead_token == DOT) match(DOT);
+        match(cc, LEFTPAREN);
+        addChild(node, aParams(cc));
+        match(cc, RIGHTPAREN);
+        if (lookahead_token == DOT) match(cc, DOT);
     }
     return node;
 }
 
-ASTNode* idnest() {
-    ASTNode* node = createNode("idnest", "");
-    addChild(node, idOrSelf());
-    addChild(node, idnestTail());
+ASTNode* idnest(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "idnest", "");
+    addChild(node, idOrSelf(cc));
+    addChild(node, idnestTail(cc));
     return node;
 }
 
-ASTNode* idnestList() {
-    ASTNode* node = createNode("idnestList", "");
+ASTNode* idnestList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "idnestList", "");
     // idnestList -> idnest idnestList | epsilon
     if (lookahead_token == ID || lookahead_token == SELF) {
-        addChild(node, idnest());
-        addChild(node, idnestList());
+        addChild(node, idnest(cc));
+        addChild(node, idnestList(cc));
     }
     return node;
 }
 
-ASTNode* indiceList() {
-    ASTNode* node = createNode("indiceList", "");
+ASTNode* indiceList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "indiceList", "");
     if (lookahead_token == LEFTBRACKET) {
-        addChild(node, indice());
-        addChild(node, indiceList());
+        addChild(node, indice(cc));
+        addChild(node, indiceList(cc));
     }
     return node;
 }
 
-ASTNode* indice() {
-    write_derivation("indice -> [ arithExpr ]");
-    ASTNode* node = createNode("indice", "");
-    match(LEFTBRACKET);
-    addChild(node, arithExpr());
-    match(RIGHTBRACKET);
+ASTNode* indice(CompilerContext* cc) {
+    write_derivation(cc, RULE_INDICE);
+    ASTNode* node = createNode(cc, "indice", "");
+    match(cc, LEFTBRACKET);
+    addChild(node, arithExpr(cc));
+    match(cc, RIGHTBRACKET);
     return node;
 }
 
-ASTNode* variable() {
-    write_derivation("variable -> idnestList id indiceList");
-    ASTNode* node = createNode("variable", "");
-    addChild(node, idnestList());
+ASTNode* variable(CompilerContext* cc) {
+    write_derivation(cc, RULE_VARIABLE);
+    ASTNode* node = createNode(cc, "variable", "");
+    addChild(node, idnestList(cc));
     if (lookahead_token == ID) {
-        ASTNode* idnode = createNode("ID", yytext);
-        idnode->line = lineno;
+        ASTNode* idnode = token_node(cc, "ID");
         addChild(node, idnode);
-        match(ID);
+        match(cc, ID);
     }
-    addChild(node, indiceList());
+    addChild(node, indiceList(cc));
     return node;
 }
 
-ASTNode* functionCall() {
-    write_derivation("functionCall -> idnestList id ( aParams )");
-    ASTNode* node = createNode("functionCall", "");
-    addChild(node, idnestList());
+ASTNode* functionCall(CompilerContext* cc) {
+    write_derivation(cc, RULE_FUNCTIONCALL);
+    ASTNode* node = createNode(cc, "functionCall", "");
+    addChild(node, idnestList(cc));
     if (lookahead_token == ID) {
-        ASTNode* idnode = createNode("ID", yytext);
-        idnode->line = lineno;
+        ASTNode* idnode = token_node(cc, "ID");
         addChild(node, idnode);
-        match(ID);
+        match(cc, ID);
     }
-    match(LEFTPAREN);
-    addChild(node, aParams());
-    match(RIGHTPAREN);
+    match(cc, LEFTPAREN);
+    addChild(node, aParams(cc));
+    match(cc, RIGHTPAREN);
     return node;
 }
 
-ASTNode* aParams() {
-    ASTNode* node = createNode("aParams", "");
+ASTNode* aParams(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "aParams", "");
     if (lookahead_token == ID || lookahead_token == INTEGER_LITERAL || 
         lookahead_token == FLOAT_LITERAL || lookahead_token == LEFTPAREN ||
         lookahead_token == NOT || lookahead_token == PLUS ||
         lookahead_token == MINUS || lookahead_token == SELF) {
-        addChild(node, expr());
-        addChild(node, aParamsTailList());
+        addChild(node, expr(cc));
+        addChild(node, aParamsTailList(cc));
     }
     return node;
 }
 
-ASTNode* aParamsTailList() {
-    ASTNode* node = createNode("aParamsTailList", "");
+ASTNode* aParamsTailList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "aParamsTailList", "");
     if (lookahead_token == COMMA) {
-        addChild(node, aParamsTail());
-        addChild(node, aParamsTailList());
-    }
-    return node;
-}
-
-ASTNode* aParamsTail() {
-    ASTNode* node = createNode("aParamsTail", "");
-    match(COMMA);
-    addChild(node, expr());
-    return node;
-}
-
-ASTNode* arithExprTail() {
-    ASTNode* node = createNode("arithExprTail", "");
-    if (lookahead_token == PLUS || lookahead_token == MINUS || lookahead_token == OR) {
-        addChild(node, addOp());
-        addChild(node, term());
-        addChild(node, arithExprTail());
-    }
-    return node;
-}
-
-ASTNode* addOp(){
-    ASTNode* node = createNode("addOp", "");
-    if(lookahead_token == PLUS){
-        addChild(node, createNode("+", ""));
-        match(PLUS);
-    }
-    else if(lookahead_token == MINUS){
-        addChild(node, createNode("-", ""));
-        match(MINUS);
-    }
-    else if(lookahead_token == OR){
-        addChild(node, createNode("or", ""));
-        match(OR);
-    }
-    return node;
-}
-
-ASTNode* termTail() {
-    ASTNode* node = createNode("termTail", "");
-    if (lookahead_token == MULTIPLY || lookahead_token == DIVIDE || 
-        lookahead_token == AND) {
-        addChild(node, multOp());
-        addChild(node, factor());
-        addChild(node, termTail());
-    }
-    return node;
-}
-
-ASTNode* multOp(){
-    ASTNode* node = createNode("multOp", "");
-    if(lookahead_token == MULTIPLY){
-        addChild(node, createNode("*", ""));
-        match(MULTIPLY);
-    }
-    else if(lookahead_token == DIVIDE){
-        addChild(node, createNode("/", ""));
-        match(DIVIDE);
-    }
-    else if(lookahead_token == AND){
-        addChild(node, createNode("and", ""));
-        match(AND);
-    }
-    return node;
-}
-
-ASTNode* sign() {
-    ASTNode* node = createNode("sign", "");
-    if (lookahead_token == PLUS) {
-        addChild(node, createNode("+", ""));
-        match(PLUS);
-    } else if (lookahead_token == MINUS) {
-        addChild(node, createNode("-", ""));
-        match(MINUS);
+        addChild(node, aParamsTail(cc));
+        addChild(node, aParamsTailList(cc));
     }
     return node;
 }
 
-ASTNode* factor() {
-    ASTNode* node = createNode("factor", "");
-    if (lookahead_token == ID || lookahead_token == SELF) {
-        addChild(node, variable());
-    } else if (lookahead_token == INTEGER_LITERAL) {
-        addChild(node, createNode("intLit", yytext));
-        match(INTEGER_LITERAL);
-    } else if (lookahead_token == FLOAT_LITERAL) {
-        addChild(node, createNode("floatLit", yytext));
-        match(FLOAT_LITERAL);
-    } else if (lookahead_token == LEFTPAREN) {
-        match(LEFTPAREN);
-        addChild(node, arithExpr());
-        match(RIGHTPAREN);
-    } else if (lookahead_token == NOT) {
-        addChild(node, createNode("not", ""));
-        match(NOT);
-        addChild(node, factor());
-    } else if (lookahead_token == PLUS || lookahead_token == MINUS) {
-        addChild(node, sign());
-        addChild(node, factor());
-    }
+ASTNode* aParamsTail(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "aParamsTail", "");
+    match(cc, COMMA);
+    addChild(node, expr(cc));
     return node;
 }
 
-ASTNode* arraySizeList() {
-    ASTNode* node = createNode("arraySizeList", "");
+ASTNode* arraySizeList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "arraySizeList", "");
     if (lookahead_token == LEFTBRACKET) {
-        write_derivation("arraySizeList -> arraySize arraySizeList");
-        addChild(node, arraySize());
-        addChild(node, arraySizeList());
+        write_derivation(cc, RULE_ARRAYSIZELIST_ITEM);
+        addChild(node, arraySize(cc));
+        addChild(node, arraySizeList(cc));
     } else {
-        write_derivation("arraySizeList -> ε");
+        write_derivation(cc, RULE_ARRAYSIZELIST_EMPTY);
     }
     return node;
 }
 
-ASTNode* arraySize() {
-    ASTNode* node = createNode("arraySize", "");
+ASTNode* arraySize(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "arraySize", "");
     if (lookahead_token == LEFTBRACKET) {
-        write_derivation("arraySize -> [ intLit ] | [ ]");
-        match(LEFTBRACKET);
+        write_derivation(cc, RULE_ARRAYSIZE);
+        match(cc, LEFTBRACKET);
         if (lookahead_token == INTEGER_LITERAL) {
-            addChild(node, createNode("intLit", yytext));
-            match(INTEGER_LITERAL);
+            addChild(node, createNodeWithId(cc, "intLit", peek_token(cc, 0)->id));
+            match(cc, INTEGER_LITERAL);
         }
-        match(RIGHTBRACKET);
+        match(cc, RIGHTBRACKET);
     }
     return node;
 }
 
 
-ASTNode* type() {
-    ASTNode* node = createNode("type", "");
+ASTNode* type(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "type", "");
     if (lookahead_token == INTEGER) {
-        addChild(node, createNode("integer", ""));
-        match(INTEGER);
+        addChild(node, createNode(cc, "integer", ""));
+        match(cc, INTEGER);
     } else if (lookahead_token == FLOAT) {
-        addChild(node, createNode("float", ""));
-        match(FLOAT);
+        addChild(node, createNode(cc, "float", ""));
+        match(cc, FLOAT);
     } else if (lookahead_token == ID) {
         {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
+            ASTNode* idnode = token_node(cc, "ID");
             addChild(node, idnode);
         }
-        match(ID);
+        match(cc, ID);
     }
     return node;
 }
 
-ASTNode* returnType() {
-    ASTNode* node = createNode("returnType", "");
+ASTNode* returnType(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "returnType", "");
     if (lookahead_token == VOID) {
-        addChild(node, createNode("void", ""));
-        match(VOID);
+        addChild(node, createNode(cc, "void", ""));
+        match(cc, VOID);
     } else {
-        addChild(node, type());
+        addChild(node, type(cc));
     }
     return node;
 }
 
-ASTNode* fParams() {
-    ASTNode* node = createNode("fParams", "");
+ASTNode* fParams(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "fParams", "");
     if (lookahead_token == ID) {
         {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
+            ASTNode* idnode = token_node(cc, "ID");
             addChild(node, idnode);
         }
-        match(ID);
-        match(COLON);
-        addChild(node, type());
-        addChild(node, arraySizeList());
-        addChild(node, fParamsTailList());
+        match(cc, ID);
+        match(cc, COLON);
+        addChild(node, type(cc));
+        addChild(node, arraySizeList(cc));
+        addChild(node, fParamsTailList(cc));
     }
     return node;
 }
 
-ASTNode* fParamsTailList() {
-    ASTNode* node = createNode("fParamsTailList", "");
+ASTNode* fParamsTailList(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "fParamsTailList", "");
     if (lookahead_token == COMMA) {
-        write_derivation("fParamsTailList -> fParamsTail fParamsTailList");
-        addChild(node, fParamsTail());
-        addChild(node, fParamsTailList());
+        write_derivation(cc, RULE_FPARAMSTAILLIST_ITEM);
+        addChild(node, fParamsTail(cc));
+        addChild(node, fParamsTailList(cc));
     } else {
-        write_derivation("fParamsTailList -> ε");
+        write_derivation(cc, RULE_FPARAMSTAILLIST_EMPTY);
     }
     return node;
 }
 
-ASTNode* fParamsTail() {
-    ASTNode* node = createNode("fParamsTail", "");
+ASTNode* fParamsTail(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "fParamsTail", "");
     if (lookahead_token == COMMA) {
-        write_derivation("fParamsTail -> , id : type arraySizeList");
-        match(COMMA);
+        write_derivation(cc, RULE_FPARAMSTAIL);
+        match(cc, COMMA);
         if (lookahead_token == ID) {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
+            ASTNode* idnode = token_node(cc, "ID");
             addChild(node, idnode);
-            match(ID);
+            match(cc, ID);
         }
-        match(COLON);
-        addChild(node, type());
-        addChild(node, arraySizeList());
+        match(cc, COLON);
+        addChild(node, type(cc));
+        addChild(node, arraySizeList(cc));
     } else {
-        write_derivation("fParamsTail -> ε");
+        write_derivation(cc, RULE_FPARAMSTAIL_EMPTY);
     }
     return node;
 }
 
-ASTNode* idTail() {
-    ASTNode* node = createNode("idTail", "");
+ASTNode* idTail(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "idTail", "");
     if (lookahead_token == COMMA) {
-        write_derivation("idTail -> , id idTail");
-        match(COMMA);
+        write_derivation(cc, RULE_IDTAIL);
+        match(cc, COMMA);
         if (lookahead_token == ID) {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
+            ASTNode* idnode = token_node(cc, "ID");
             addChild(node, idnode);
-            match(ID);
+            match(cc, ID);
         }
-        addChild(node, idTail());
+        addChild(node, idTail(cc));
     } else {
-        write_derivation("idTail -> ε");
+        write_derivation(cc, RULE_IDTAIL_EMPTY);
     }
     return node;
 }
 
-ASTNode* isaIdOpt() {
-    ASTNode* node = createNode("isaIdOpt", "");
+ASTNode* isaIdOpt(CompilerContext* cc) {
+    ASTNode* node = createNode(cc, "isaIdOpt", "");
     if (lookahead_token == ISA) {
-        write_derivation("isaIdOpt -> isa id idTail");
-        match(ISA);
+        write_derivation(cc, RULE_ISAIDOPT);
+        match(cc, ISA);
         if (lookahead_token == ID) {
-            ASTNode* idnode = createNode("ID", yytext);
-            idnode->line = lineno;
+            ASTNode* idnode = token_node(cc, "ID");
             addChild(node, idnode);
-            match(ID);
+            match(cc, ID);
         }
-        addChild(node, idTail());
+        addChild(node, idTail(cc));
     } else {
-        write_derivation("isaIdOpt -> ε");
+        write_derivation(cc, RULE_ISAIDOPT_EMPTY);
     }
     return node;
 }
@@ -898,40 +1129,63 @@ ASTNode* isaIdOpt() {
 
 // ====== Driver function to run recursive descent parser =====
 // called by yacc
-ASTNode* parse_program() {
-    init_parser();
-    printf("Starting parsing using recursive descent parser...\n");
-
-    ASTNode* root = prog();
+ASTNode* parse_program(CompilerContext* cc) {
+    // a compile server's last request may have left through compiler_exit
+    recovery = NULL;
+    expr_depth = 0;
+    init_parser(cc);
+    ASTNode* root;
+    if (parser_engine == PARSER_TABLE) {
+        printf("Starting parsing using LL(1) parse table...\n");
+        root = ll1_parse(cc);
+    } else if (parser_engine == PARSER_LALR) {
+        printf("Starting parsing using LALR(1) parser...\n");
+        root = lalr_parse(cc);
+    } else {
+        printf("Starting parsing using recursive descent parser...\n");
+        root = parallel_prog(cc);
+        if (!root) root = prog(cc);
+    }
+    parser_release_expr_stacks();
     printf("Final lookahead token (numeric): %d\n", lookahead_token);
 
     // safety limit prevents infinite loops.
     int safety = 0;
     while (lookahead_token != 0 && lookahead_token != EXIT && lookahead_token != PRINT_SYMBOLS && safety < 1000) {
-        lookahead_token = yylex();
+        advance_token(cc);
         safety++;
     }
+    write_syntax_errors(cc);
 
     if (lookahead_token == 0) {
-        printf("Parsing completed successfully!\n");
-        write_derivation("Parsing completed!");
-        write_syntax_tree(root);
-        
-        // start semantic analysis
-        run_semantic(root);
+        if (cc->syntax_error_count > 0)
+            printf("Parsing completed with %d syntax error(s), see syntax_errors.txt\n", cc->syntax_error_count);
+        else
+            printf("Parsing completed successfully!\n");
+        write_derivation(cc, RULE_PARSE_DONE);
+        if (parser_syntax_only) {
+            printf("Syntax check only: no syntax tree file, no semantic analysis\n");
+        } else {
+            write_syntax_tree(cc, root);
+
+            // start semantic analysis
+            run_semantic(cc, root);
+        }
     } else if (lookahead_token == EXIT) {
         printf("Parser:: EXIT.\n");
-        write_derivation("Parsing completed (exit token)");
-        write_syntax_tree(root);
+        write_derivation(cc, RULE_PARSE_EXIT);
+        write_syntax_tree(cc, root);
     } else if (lookahead_token == PRINT_SYMBOLS) {
         printf("Parser:: PRINT_SYMBOLS.\n");
-        write_derivation("Parsing completed (print_symbols token)");
-        write_syntax_tree(root);
+        write_derivation(cc, RULE_PARSE_PRINT_SYMBOLS);
+        write_syntax_tree(cc, root);
     } else {
         printf("Unexpected token at end of file\n");
     }
 
-    fclose(log_file);
-    printf("Derivation written to derivation.txt\n");
+    tokens_drain(cc, &cc->token_stream);
+    derivation_end(cc);
+    if (derivation_mode == DERIVATION_TEXT) printf("Derivation written to derivation.txt\n");
+    else if (derivation_mode == DERIVATION_BINARY) printf("Derivation written to derivation.bin\n");
     return root;
 }
\ No newline at end of file
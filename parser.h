@@ -5,83 +5,112 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <setjmp.h>
 #include "symbols.h"
 #include "ast.h"
+#include "tokens.h"
+#include "derivation.h"
+#include "compact_ast.h"
 
 
-extern int yylex();
-extern char* yytext;
-extern int lineno;
-
 // Global variables for parser
-extern FILE* log_file;
-extern int lookahead_token;
-extern int derivation_step;
+// (the position is per thread: parallel_parse.c runs the grammar functions on workers)
+extern _Thread_local int lookahead_token;
+
+// position in the compilation's token stream (compiler.h), walked by index
+extern _Thread_local int token_pos;
+// set on a parallel parse worker: error() jumps here instead of exiting
+extern _Thread_local jmp_buf* parser_abort;
+
+// front end used by parse_program (--parser=rd|table|lalr)
+typedef enum {
+    PARSER_RECURSIVE,   // the grammar functions below
+    PARSER_TABLE,       // ll1.c, driven by ll1_table.h
+    PARSER_LALR         // the Bison grammar in tma3.y
+} ParserEngine;
+
+extern int parser_engine;
+// --syntax-only: stop after a successful parse (front end benchmarks)
+extern int parser_syntax_only;
 
 // Main parser function
-ASTNode* parse_program();
-void init_parser();
+ASTNode* parse_program(struct CompilerContext* cc);
+void init_parser(struct CompilerContext* cc);
+// tma3.y: the whole program with the Bison parser, derivation included
+ASTNode* lalr_parse(struct CompilerContext* cc);
 
 // Grammar rule functions
 // forward declarations: all functions now return ASTNode*
-ASTNode* prog();
-ASTNode* classOrImplOrFuncList();
-ASTNode* classOrImplOrFunc();
-ASTNode* classDecl();
-ASTNode* isaIdOpt();
-ASTNode* idTail();
-ASTNode* visibilitymemberDeclList();
-ASTNode* implDef();
-ASTNode* funcDefList();
-ASTNode* funcDef();
-ASTNode* visibility();
-ASTNode* memberDecl();
-ASTNode* funcHead();
-ASTNode* funcBody();
-ASTNode* varDeclOrStmtList();
-ASTNode* varDeclOrStmt();
-ASTNode* attributeDecl();
-ASTNode* localVarDecl();
-ASTNode* varDecl();
-ASTNode* arraySizeList();
-ASTNode* statement();
-ASTNode* assignStat();
-ASTNode* assignOp();
-ASTNode* statBlock();
-ASTNode* statmentList();
-ASTNode* expr();
-ASTNode* relExpr();
-ASTNode* relOp();
-ASTNode* arithExpr();
-ASTNode* arithExprTail();
-ASTNode* addOp();
-ASTNode* term();
-ASTNode* termTail();
-ASTNode* multOp();
-ASTNode* factor();
-ASTNode* sign();
-ASTNode* variable();
-ASTNode* idnestList();
-ASTNode* indiceList();
-ASTNode* functionCall();
-ASTNode* idnest();
-ASTNode* idnestTail();
-ASTNode* idOrSelf();
-ASTNode* indice();
-ASTNode* arraySize();
-ASTNode* type();
-ASTNode* returnType();
-ASTNode* fParams();
-ASTNode* fParamsTailList();
-ASTNode* aParams();
-ASTNode* aParamsTailList();
-ASTNode* fParamsTail();
-ASTNode* aParamsTail();
+ASTNode* prog(struct CompilerContext* cc);
+ASTNode* classOrImplOrFuncList(struct CompilerContext* cc);
+ASTNode* classOrImplOrFunc(struct CompilerContext* cc);
+ASTNode* classDecl(struct CompilerContext* cc);
+ASTNode* isaIdOpt(struct CompilerContext* cc);
+ASTNode* idTail(struct CompilerContext* cc);
+ASTNode* visibilitymemberDeclList(struct CompilerContext* cc);
+ASTNode* implDef(struct CompilerContext* cc);
+ASTNode* funcDefList(struct CompilerContext* cc);
+ASTNode* funcDef(struct CompilerContext* cc);
+ASTNode* visibility(struct CompilerContext* cc);
+ASTNode* memberDecl(struct CompilerContext* cc);
+ASTNode* funcHead(struct CompilerContext* cc);
+ASTNode* funcBody(struct CompilerContext* cc);
+ASTNode* varDeclOrStmtList(struct CompilerContext* cc);
+ASTNode* varDeclOrStmt(struct CompilerContext* cc);
+ASTNode* attributeDecl(struct CompilerContext* cc);
+ASTNode* localVarDecl(struct CompilerContext* cc);
+ASTNode* varDecl(struct CompilerContext* cc);
+ASTNode* arraySizeList(struct CompilerContext* cc);
+ASTNode* statement(struct CompilerContext* cc);
+ASTNode* assignStat(struct CompilerContext* cc);
+ASTNode* assignOp(struct CompilerContext* cc);
+ASTNode* statBlock(struct CompilerContext* cc);
+ASTNode* statmentList(struct CompilerContext* cc);
+ASTNode* expr(struct CompilerContext* cc);
+ASTNode* relExpr(struct CompilerContext* cc);
+ASTNode* arithExpr(struct CompilerContext* cc);
+ASTNode* variable(struct CompilerContext* cc);
+ASTNode* idnestList(struct CompilerContext* cc);
+ASTNode* indiceList(struct CompilerContext* cc);
+ASTNode* functionCall(struct CompilerContext* cc);
+ASTNode* idnest(struct CompilerContext* cc);
+ASTNode* idnestTail(struct CompilerContext* cc);
+ASTNode* idOrSelf(struct CompilerContext* cc);
+ASTNode* indice(struct CompilerContext* cc);
+ASTNode* arraySize(struct CompilerContext* cc);
+ASTNode* type(struct CompilerContext* cc);
+ASTNode* returnType(struct CompilerContext* cc);
+ASTNode* fParams(struct CompilerContext* cc);
+ASTNode* fParamsTailList(struct CompilerContext* cc);
+ASTNode* aParams(struct CompilerContext* cc);
+ASTNode* aParamsTailList(struct CompilerContext* cc);
+ASTNode* fParamsTail(struct CompilerContext* cc);
+ASTNode* aParamsTail(struct CompilerContext* cc);
 
 
+// ====== syntax errors =====
+// error() records each one and, inside a list (top-level units, class
+// members, implementation functions, statements), skips ahead to a
+// synchronising token instead of exiting: the item is left out of the tree
+// and parsing goes on. syntax_errors.txt lists them after the parse.
+typedef struct {
+    int line;
+    int found;              // token the parser stopped at
+    char message[128];
+} SyntaxError;
+
+// recovery gives up and exits after this many
+#define SYNTAX_ERROR_LIMIT 100
+
 // Utility functions
-void match(int expected_token);
-void error(char* message);
-void write_derivation(char* rule);
+LexToken* peek_token(struct CompilerContext* cc, int k);
+void advance_token(struct CompilerContext* cc);
+void match(struct CompilerContext* cc, int expected_token);
+void error(struct CompilerContext* cc, char* message);
+void write_derivation(struct CompilerContext* cc, int rule);
+ASTNode* token_leaf(struct CompilerContext* cc, int kind);
+
+// expression stacks of the calling thread, reused from one expression to the next
+void parser_release_expr_stacks();
 
 #endif
\ No newline at end of file
@@ -3,19 +3,22 @@
 #include <string.h>
 #include <stdarg.h>
 #include "symbol_table.h"
+#include "symbols.h"
 #include "ast.h"
+#include "ast_visit.h"
 #include "codegen.h"
+#include "log.h"
+#include "compiler.h"
 
 static ASTNode* find_rightmost_id(ASTNode* n);
-static ASTNode* find_child(ASTNode* node, const char* name);
+static ASTNode* find_child(ASTNode* node, ASTKind kind);
 static Type get_type_from_typeNode(ASTNode* typeNode); 
-static ASTNode* g_root = NULL;
-static FILE* errf = NULL;
 
 static int count_array_dims(ASTNode* node) {
     if (!node) return 0;
     int cnt = 0;
-    if (strstr(node->name ? node->name : "", "array") || strstr(node->name ? node->name : "", "indice")) {
+    if (node->kind == AST_ARRAYSIZELIST || node->kind == AST_ARRAYSIZE ||
+        node->kind == AST_INDICELIST || node->kind == AST_INDICE) {
             for (ASTNode* c = node->child; c; c = c->sibling) {
                 cnt++;
             }
@@ -23,7 +26,7 @@ static int count_array_dims(ASTNode* node) {
     }
     ASTNode* asl = NULL;
     for (ASTNode* c = node->child; c; c = c->sibling) {
-        if (strstr(c->name ? c->name : "", "arraySize") != NULL) {
+        if (c->kind == AST_ARRAYSIZELIST || c->kind == AST_ARRAYSIZE) {
             asl = c;
             break;
         }
@@ -35,9 +38,9 @@ static int count_array_dims(ASTNode* node) {
     return cnt;
 }
 
-static Type make_array_type(Type base, int dims, ASTNode* declNode) {
+static Type make_array_type(CompilerContext* cc, Type base, int dims, ASTNode* declNode) {
     Type at = make_basic_type(TYPE_ARRAY);
-    Type* elem = (Type*)malloc(sizeof(Type));
+    Type* elem = (Type*)ast_alloc(cc, sizeof(Type));
     *elem = base;
     at.elementType = elem;
     at.dimensions = dims;
@@ -54,29 +57,31 @@ static Type make_array_type(Type base, int dims, ASTNode* declNode) {
         ASTNode* cur = stack->node;
         StackItem* next = stack->next; free(stack); stack = next;
         if (!cur) continue;
-        if (cur->name && (strcmp(cur->name, "arraySizeList") == 0 || strcmp(cur->name, "arraySize") == 0)) { asl = cur; break; }
+        if (cur->kind == AST_ARRAYSIZELIST || cur->kind == AST_ARRAYSIZE) { asl = cur; break; }
         if (cur->child) { StackItem* it = (StackItem*)malloc(sizeof(StackItem)); it->node = cur->child; it->next = stack; stack = it; }
         for (ASTNode* sib = cur->sibling; sib; sib = sib->sibling) { StackItem* it = (StackItem*)malloc(sizeof(StackItem)); it->node = sib; it->next = stack; stack = it; }
     }
+    // the search stops at the first size list, with the rest still stacked
+    while (stack) { StackItem* next = stack->next; free(stack); stack = next; }
     if (!asl) return at;
 
     // collect integer extents into a dynamic array
     size_t cap = 4; size_t cnt = 0; size_t* sizes = (size_t*)malloc(sizeof(size_t) * cap);
     int ok = 1;
-    if (strcmp(asl->name, "arraySizeList") == 0) {
+    if (asl->kind == AST_ARRAYSIZELIST) {
         for (ASTNode* a = asl->child; a; a = a->sibling) {
             if (!a) continue;
-            if (strcmp(a->name, "arraySize") != 0) continue;
-            if (a->child && a->child->name && strcmp(a->child->name, "intLit") == 0 && a->child->lexeme) {
+            if (a->kind != AST_ARRAYSIZE) continue;
+            if (a->child && a->child->kind == AST_INTLIT && a->child->lexeme) {
                 long v = atol(a->child->lexeme);
                 if (v <= 0) { ok = 0; break; }
                 if (cnt >= cap) { cap *= 2; sizes = (size_t*)realloc(sizes, sizeof(size_t) * cap); }
                 sizes[cnt++] = (size_t)v;
             } else { ok = 0; break; }
         }
-    } else if (strcmp(asl->name, "arraySize") == 0) {
+    } else if (asl->kind == AST_ARRAYSIZE) {
         ASTNode* a = asl;
-        if (a->child && a->child->name && strcmp(a->child->name, "intLit") == 0 && a->child->lexeme) {
+        if (a->child && a->child->kind == AST_INTLIT && a->child->lexeme) {
             long v = atol(a->child->lexeme);
             if (v <= 0) ok = 0; else { sizes[cnt++] = (size_t)v; }
         } else ok = 0;
@@ -87,44 +92,47 @@ static Type make_array_type(Type base, int dims, ASTNode* declNode) {
         at.dimSizes = NULL;
         at.dimensions = 0;
     } else {
-        // shrink to exact size
-        sizes = (size_t*)realloc(sizes, sizeof(size_t) * cnt);
-        at.dimSizes = sizes;
+        // exact-size copy in the AST arena, it lives as long as the tree
+        at.dimSizes = (size_t*)ast_alloc(cc, sizeof(size_t) * cnt);
+        memcpy(at.dimSizes, sizes, sizeof(size_t) * cnt);
         at.dimensions = (int)cnt;
+        free(sizes);
     }
     return at;
 }
 
 // scans the classdeclNode for attributeDecl or funcDef with the given name.
-static Type resolve_member_type(Type classType, const char* memberName) {
+static Type resolve_member_type(CompilerContext* cc, Type classType, const char* memberName) {
     Type unknown = make_basic_type(TYPE_UNKNOWN);
     if (!memberName) return unknown;
     if (classType.kind != TYPE_CLASS) return unknown;
-    SymbolEntry* classSym = st_lookup(classType.name);
+    int memberId = intern_find(cc, memberName);
+    if (memberId == INTERN_NONE) return unknown;
+    SymbolEntry* classSym = st_lookup(cc, classType.name);
     if (!classSym || !classSym->declNode) return unknown;
     ASTNode* classDecl = classSym->declNode;
     for (ASTNode* c = classDecl->child; c; c = c->sibling) {
         if (!c) continue;
-        if (strcmp(c->name, "visibilitymemberDeclList") == 0) {
+        if (c->kind == AST_VISIBILITYMEMBERDECLLIST) {
             for (ASTNode* m = c->child; m; m = m->sibling) {
                 if (!m) continue;
                 // attributeDecl -> varDecl
-                if (strcmp(m->name, "attributeDecl") == 0) {
+                if (m->kind == AST_ATTRIBUTEDECL) {
                     ASTNode* vd = m->child;
                     ASTNode* id = NULL;
                     ASTNode* typeNode = NULL;
-                    if (vd) { id = find_child(vd, "ID"); typeNode = find_child(vd, "type"); }
-                    if (id && id->lexeme && strcmp(id->lexeme, memberName) == 0) {
+                    if (vd) { id = find_child(vd, AST_ID); typeNode = find_child(vd, AST_TYPE); }
+                    if (id && id->lexeme_id == memberId) {
                         return get_type_from_typeNode(typeNode);
                     }
                 }
                 // function declarations inside class
-                if (strcmp(m->name, "funcDef") == 0 || strcmp(m->name, "funcDecl") == 0) {
-                    ASTNode* hd = (strcmp(m->name, "funcDef") == 0) ? m->child : find_child(m, "funcHead");
+                if (m->kind == AST_FUNCDEF || m->kind == AST_FUNCDECL) {
+                    ASTNode* hd = (m->kind == AST_FUNCDEF) ? m->child : find_child(m, AST_FUNCHEAD);
                     if (hd) {
-                        ASTNode* id = find_child(hd, "ID");
-                        ASTNode* rt = find_child(hd, "returnType");
-                        if (id && id->lexeme && strcmp(id->lexeme, memberName) == 0) {
+                        ASTNode* id = find_child(hd, AST_ID);
+                        ASTNode* rt = find_child(hd, AST_RETURNTYPE);
+                        if (id && id->lexeme_id == memberId) {
                             return rt ? get_type_from_typeNode(rt) : make_basic_type(TYPE_VOID);
                         }
                     }
@@ -136,13 +144,13 @@ static Type resolve_member_type(Type classType, const char* memberName) {
 }
 
 // lookup member type following parent chain if necessary
-static Type resolve_member_with_inheritance(Type classType, const char* memberName) {
+static Type resolve_member_with_inheritance(CompilerContext* cc, Type classType, const char* memberName) {
     Type cur = classType;
     while (cur.kind == TYPE_CLASS) {
-        Type found = resolve_member_type(cur, memberName);
+        Type found = resolve_member_type(cc, cur, memberName);
         if (found.kind != TYPE_UNKNOWN) return found;
         if (cur.parent_name && cur.parent_name[0]) {
-            SymbolEntry* ps = st_lookup(cur.parent_name);
+            SymbolEntry* ps = st_lookup(cc, cur.parent_name);
             if (!ps) break;
             cur = ps->type;
         } else break;
@@ -151,24 +159,25 @@ static Type resolve_member_with_inheritance(Type classType, const char* memberNa
 }
 
 // forward declare helper used before its definition
-static void add_symbol_if_missing(const char* lexeme, SymbolKind kind, Type t, ASTNode* declNode, int line, const char* dupMsg);
+static void add_symbol_if_missing(CompilerContext* cc, const char* lexeme, SymbolKind kind, Type t, ASTNode* declNode, int line, const char* dupMsg);
 
-static ASTNode* find_child(ASTNode* node, const char* name) {
+static ASTNode* find_child(ASTNode* node, ASTKind kind) {
     if (!node) return NULL;
     for (ASTNode* c = node->child; c; c = c->sibling) {
-        if (strcmp(c->name, name) == 0) return c;
+        if (c->kind == kind) return c;
     }
     return NULL;
 }
 
 // insert any ID nodes found as parameters
-static void insert_params_recursive(ASTNode* n, SymbolEntry* current_class, SymbolEntry* current_function) {
-    if (!n) return;
-    if (strcmp(n->name, "ID") == 0 && n->lexeme) {
+static AstVisitResult insert_param_pre(AstWalk* w, ASTNode* n, void* frame) {
+    CompilerContext* cc = (CompilerContext*)ast_walk_user(w);
+    (void)frame;
+    if (n->kind == AST_ID && n->lexeme) {
         ASTNode* sib = n->sibling;
         ASTNode* typeNode = NULL;
         for (int steps = 0; sib && steps < 6; sib = sib->sibling, ++steps) {
-            if (strcmp(sib->name, "type") == 0) { typeNode = sib; break; }
+            if (sib->kind == AST_TYPE) { typeNode = sib; break; }
         }
         Type ptype = get_type_from_typeNode(typeNode);
         // array size information from nearby subtree
@@ -180,36 +189,42 @@ static void insert_params_recursive(ASTNode* n, SymbolEntry* current_class, Symb
         while (stack) {
             ASTNode* cur = stack->node; StackItem* next = stack->next; free(stack); stack = next;
             if (!cur) continue;
-            if (cur->name && (strcmp(cur->name, "arraySizeList") == 0 || strcmp(cur->name, "arraySize") == 0)) { asl = cur; break; }
+            if (cur->kind == AST_ARRAYSIZELIST || cur->kind == AST_ARRAYSIZE) { asl = cur; break; }
             if (cur->child) { StackItem* it = (StackItem*)malloc(sizeof(StackItem)); it->node = cur->child; it->next = stack; stack = it; }
             for (ASTNode* sib = cur->sibling; sib; sib = sib->sibling) { StackItem* it = (StackItem*)malloc(sizeof(StackItem)); it->node = sib; it->next = stack; stack = it; }
         }
+        while (stack) { StackItem* next = stack->next; free(stack); stack = next; }
         int dims = 0;
         if (asl) {
-            if (strcmp(asl->name, "arraySizeList") == 0) {
+            if (asl->kind == AST_ARRAYSIZELIST) {
                 for (ASTNode* a = asl->child; a; a = a->sibling) {
                     if (!a) continue;
-                    if (strcmp(a->name, "arraySize") == 0) dims++;
+                    if (a->kind == AST_ARRAYSIZE) dims++;
                 }
-            } else if (strcmp(asl->name, "arraySize") == 0) dims = 1;
+            } else if (asl->kind == AST_ARRAYSIZE) dims = 1;
         }
-        if (dims > 0) ptype = make_array_type(ptype, dims, decl_for_sizes);
+        if (dims > 0) ptype = make_array_type(cc, ptype, dims, decl_for_sizes);
     // Pass the node that actually contains the type/arraySize information
     ASTNode* decl_for_symbol = decl_for_sizes ? decl_for_sizes : n;
-    add_symbol_if_missing(n->lexeme, SYM_PARAM, ptype, decl_for_symbol, n->line, "Duplicate parameter '%s'");
+    add_symbol_if_missing(cc, n->lexeme, SYM_PARAM, ptype, decl_for_symbol, n->line, "Duplicate parameter '%s'");
     }
-    for (ASTNode* c = n->child; c; c = c->sibling) insert_params_recursive(c, current_class, current_function);
+    return AST_VISIT_CHILDREN;
+}
+
+static void insert_params(CompilerContext* cc, ASTNode* params) {
+    AstVisitor v = { insert_param_pre, NULL, 0, cc };
+    ast_walk(&v, params, NULL);
 }
 
 // add symbol in current scope
-static void add_symbol_if_missing(const char* lexeme, SymbolKind kind, Type t, ASTNode* declNode, int line, const char* dupMsg) {
+static void add_symbol_if_missing(CompilerContext* cc, const char* lexeme, SymbolKind kind, Type t, ASTNode* declNode, int line, const char* dupMsg) {
     if (!lexeme) return;
-    SymbolEntry* existing = st_lookup_local(lexeme);
+    SymbolEntry* existing = st_lookup_local(cc, lexeme);
     if (existing) {
-        if (existing->declNode != declNode) semantic_error_rule(line, "Duplicate declaration in same scope", dupMsg, lexeme);
+        if (existing->declNode != declNode) semantic_error_rule(cc, line, "Duplicate declaration in same scope", dupMsg, lexeme);
     } else {
-        SymbolEntry* e = st_add_symbol(lexeme, kind, t, declNode, line);
-        if (!e) semantic_error_rule(line, "Duplicate declaration in same scope", dupMsg, lexeme);
+        SymbolEntry* e = st_add_symbol(cc, lexeme, kind, t, declNode, line);
+        if (!e) semantic_error_rule(cc, line, "Duplicate declaration in same scope", dupMsg, lexeme);
     }
 }
 
@@ -218,190 +233,255 @@ static Type get_type_from_typeNode(ASTNode* typeNode) {
     if (!typeNode) return make_basic_type(TYPE_UNKNOWN);
     
     // Direct type match
-    if (strcmp(typeNode->name, "integer") == 0) return make_basic_type(TYPE_INT);
-    if (strcmp(typeNode->name, "float") == 0) return make_basic_type(TYPE_FLOAT);
-    if (strcmp(typeNode->name, "void") == 0) return make_basic_type(TYPE_VOID);
+    if (typeNode->kind == AST_INTEGER) return make_basic_type(TYPE_INT);
+    if (typeNode->kind == AST_FLOAT) return make_basic_type(TYPE_FLOAT);
+    if (typeNode->kind == AST_VOID) return make_basic_type(TYPE_VOID);
     
     // Check child (may be "type" node or direct type)
     if (typeNode->child) {
         ASTNode* ch = typeNode->child;
         
         // If child is "type", go one level deeper
-        if (strcmp(ch->name, "type") == 0 && ch->child) {
+        if (ch->kind == AST_TYPE && ch->child) {
             ch = ch->child;
         }
         
-        if (strcmp(ch->name, "integer") == 0) return make_basic_type(TYPE_INT);
-        if (strcmp(ch->name, "float") == 0) return make_basic_type(TYPE_FLOAT);
-        if (strcmp(ch->name, "void") == 0) return make_basic_type(TYPE_VOID);
-        if (strcmp(ch->name, "ID") == 0 && ch->lexeme) return make_class_type(ch->lexeme);
+        if (ch->kind == AST_INTEGER) return make_basic_type(TYPE_INT);
+        if (ch->kind == AST_FLOAT) return make_basic_type(TYPE_FLOAT);
+        if (ch->kind == AST_VOID) return make_basic_type(TYPE_VOID);
+        if (ch->kind == AST_ID && ch->lexeme) return make_class_type(ch->lexeme);
     }
     
     // Check if typeNode itself is an ID (class type)
-    if (strcmp(typeNode->name, "ID") == 0 && typeNode->lexeme) return make_class_type(typeNode->lexeme);
+    if (typeNode->kind == AST_ID && typeNode->lexeme) return make_class_type(typeNode->lexeme);
     
     return make_basic_type(TYPE_UNKNOWN);
 }
 
-static void declaration_pass_rec(ASTNode* node, SymbolEntry* current_class, SymbolEntry* current_function) {
-    if (!node) return;
-    if (strcmp(node->name, "classDecl") == 0) {
-        ASTNode* id = find_child(node, "ID");
-        if (id) {
-            Type t = make_class_type(id->lexeme);
-            ASTNode* isa = find_child(node, "isaIdOpt");
-            if (isa && isa->child) {
-                for (ASTNode* p = isa->child; p; p = p->sibling) {
-                    if (strcmp(p->name, "ID") == 0 && p->lexeme) {
-                        strncpy(t.parent_name, p->lexeme, sizeof(t.parent_name)-1);
-                        t.parent_name[sizeof(t.parent_name)-1] = '\0';
-                        break;
-                    }
+// pass state every node of a semantic walk carries (ast_visit.h)
+typedef struct {
+    SymbolEntry* current_class;
+    SymbolEntry* current_function;
+    int scoped;                     // pre entered a scope, post leaves it
+} SemanticFrame;
+
+static SemanticFrame inner_frame(SymbolEntry* current_class, SymbolEntry* current_function) {
+    SemanticFrame f = { current_class, current_function, 0 };
+    return f;
+}
+
+static void enter_scope(CompilerContext* cc, SemanticFrame* f, const char* name) {
+    st_enter_scope(cc, name);
+    f->scoped = 1;
+}
+
+static void leave_scope(AstWalk* w, ASTNode* node, void* frame) {
+    (void)node;
+    if (((SemanticFrame*)frame)->scoped) st_exit_scope((CompilerContext*)ast_walk_user(w));
+}
+
+static AstVisitResult declaration_pre(AstWalk* w, ASTNode* node, void* frame) {
+    CompilerContext* cc = (CompilerContext*)ast_walk_user(w);
+    SemanticFrame* f = (SemanticFrame*)frame;
+    SymbolEntry* current_class = f->current_class;
+    SymbolEntry* current_function = f->current_function;
+    f->scoped = 0;
+    switch (node->kind) {
+    case AST_CLASSDECL: {
+        ASTNode* id = find_child(node, AST_ID);
+        if (!id) return AST_VISIT_SKIP;
+        Type t = make_class_type(id->lexeme);
+        ASTNode* isa = find_child(node, AST_ISAIDOPT);
+        if (isa && isa->child) {
+            for (ASTNode* p = isa->child; p; p = p->sibling) {
+                if (p->kind == AST_ID && p->lexeme) {
+                    strncpy(t.parent_name, p->lexeme, sizeof(t.parent_name)-1);
+                    t.parent_name[sizeof(t.parent_name)-1] = '\0';
+                    break;
                 }
             }
-            add_symbol_if_missing(id->lexeme, SYM_CLASS, t, node, id->line, "Duplicate class declaration '%s'");
-            isa = find_child(node, "isaIdOpt");
-            if (isa && isa->child) {
-                for (ASTNode* p = isa->child; p; p = p->sibling) {
-                    if (strcmp(p->name, "ID") == 0) {
-                        SymbolEntry* ps = st_lookup(p->lexeme);
-                        if (!ps) semantic_error_rule(p->line, "Inheritance rule: parent must be a previously defined class", "Undefined parent class '%s'", p->lexeme);
-                        else if (ps->kind != SYM_CLASS) semantic_error_rule(p->line, "Inheritance rule: parent must be a class", "'%s' is not a class", p->lexeme);
-                    }
+        }
+        add_symbol_if_missing(cc, id->lexeme, SYM_CLASS, t, node, id->line, "Duplicate class declaration '%s'");
+        if (isa && isa->child) {
+            for (ASTNode* p = isa->child; p; p = p->sibling) {
+                if (p->kind == AST_ID) {
+                    SymbolEntry* ps = st_lookup_id(cc, p->lexeme_id);
+                    if (!ps) semantic_error_rule(cc, p->line, "Inheritance rule: parent must be a previously defined class", "Undefined parent class '%s'", p->lexeme);
+                    else if (ps->kind != SYM_CLASS) semantic_error_rule(cc, p->line, "Inheritance rule: parent must be a class", "'%s' is not a class", p->lexeme);
                 }
             }
-            st_enter_scope(id->lexeme);
-            SymbolEntry* classSym = st_lookup(id->lexeme);
-            ASTNode* members = find_child(node, "visibilitymemberDeclList");
-            if (members) declaration_pass_rec(members, classSym, current_function);
-            st_exit_scope();
         }
-        declaration_pass_rec(node->sibling, current_class, current_function);
-        return;
+        enter_scope(cc, f, id->lexeme);
+        SemanticFrame inner = inner_frame(st_lookup_id(cc, id->lexeme_id), current_function);
+        ast_walk_push_list(w, find_child(node, AST_VISIBILITYMEMBERDECLLIST), &inner);
+        return AST_VISIT_SKIP;
     }
 
-    if (strcmp(node->name, "funcDef") == 0) {
+    case AST_FUNCDEF: {
         ASTNode* head = node->child; // funcHead
-        if (head) {
-            ASTNode* id = find_child(head, "ID");
-            ASTNode* rt = find_child(head, "returnType");
-            Type fnType = rt ? get_type_from_typeNode(rt) : make_basic_type(TYPE_VOID);
-            if (id) {
-                add_symbol_if_missing(id->lexeme, SYM_FUNCTION, fnType, node, id->line, "Duplicate function '%s'");
-                st_enter_scope(id->lexeme);
-                SymbolEntry* funcSym = st_lookup(id->lexeme);
-                for (ASTNode* ch = head->child; ch; ch = ch->sibling) declaration_pass_rec(ch, current_class, funcSym);
-                ASTNode* body = head->sibling;
-                if (body) {
-                    declaration_pass_rec(body, current_class, funcSym);
-                }
-                st_exit_scope();
-            }
-        }
-        declaration_pass_rec(node->sibling, current_class, current_function);
-        return;
+        ASTNode* id = head ? find_child(head, AST_ID) : NULL;
+        if (!id) return AST_VISIT_SKIP;
+        ASTNode* rt = find_child(head, AST_RETURNTYPE);
+        Type fnType = rt ? get_type_from_typeNode(rt) : make_basic_type(TYPE_VOID);
+        add_symbol_if_missing(cc, id->lexeme, SYM_FUNCTION, fnType, node, id->line, "Duplicate function '%s'");
+        enter_scope(cc, f, id->lexeme);
+        SemanticFrame inner = inner_frame(current_class, st_lookup_id(cc, id->lexeme_id));
+        ast_walk_push_list(w, head->child, &inner);
+        ast_walk_push_list(w, head->sibling, &inner);    // funcBody
+        return AST_VISIT_SKIP;
     }
 
-    if (strcmp(node->name, "implDef") == 0 || strcmp(node->name, "implement") == 0) {
+    case AST_IMPLDEF: {
         // implDef -> implement ID { funcDefList }
-        ASTNode* id = find_child(node, "ID");
-        if (id) {
-            SymbolEntry* cs = st_lookup(id->lexeme);
-            if (!cs) semantic_error_rule(id->line, "Implement rule: target must be a previously declared class", "Undefined class '%s' in implement", id->lexeme);
-            else if (cs->kind != SYM_CLASS) semantic_error_rule(id->line, "Implement rule: target must be a class", "'%s' is not a class", id->lexeme);
-            else {
-                st_enter_scope(id->lexeme);
-                SymbolEntry* targetClass = st_lookup(id->lexeme);
-                for (ASTNode* c = node->child; c; c = c->sibling) {
-                    declaration_pass_rec(c, targetClass, current_function);
-                }
-                st_exit_scope();
-            }
+        ASTNode* id = find_child(node, AST_ID);
+        if (!id) return AST_VISIT_SKIP;
+        SymbolEntry* cs = st_lookup_id(cc, id->lexeme_id);
+        if (!cs) semantic_error_rule(cc, id->line, "Implement rule: target must be a previously declared class", "Undefined class '%s' in implement", id->lexeme);
+        else if (cs->kind != SYM_CLASS) semantic_error_rule(cc, id->line, "Implement rule: target must be a class", "'%s' is not a class", id->lexeme);
+        else {
+            enter_scope(cc, f, id->lexeme);
+            SemanticFrame inner = inner_frame(st_lookup_id(cc, id->lexeme_id), current_function);
+            ast_walk_push_list(w, node->child, &inner);
         }
-        declaration_pass_rec(node->sibling, current_class, current_function);
-        return;
+        return AST_VISIT_SKIP;
     }
 
-    if (strcmp(node->name, "funcHead") == 0) {
-        ASTNode* id = find_child(node, "ID");
-        ASTNode* rt = find_child(node, "returnType");
+    case AST_FUNCHEAD: {
+        ASTNode* id = find_child(node, AST_ID);
+        ASTNode* rt = find_child(node, AST_RETURNTYPE);
         Type fnType = rt ? get_type_from_typeNode(rt) : make_basic_type(TYPE_VOID);
         if (id) {
-            add_symbol_if_missing(id->lexeme, SYM_FUNCTION, fnType, node, id->line, "Duplicate function '%s'");
-            ASTNode* params = find_child(node, "fParams");
-            if (params) declaration_pass_rec(params, current_class, current_function);
+            add_symbol_if_missing(cc, id->lexeme, SYM_FUNCTION, fnType, node, id->line, "Duplicate function '%s'");
+            ast_walk_push_list(w, find_child(node, AST_FPARAMS), NULL);
         }
-        declaration_pass_rec(node->sibling, current_class, current_function);
-        return;
+        return AST_VISIT_SKIP;
     }
 
     // handle function parameter list
-    if (strcmp(node->name, "fParams") == 0) {
-        // Use recursive insertion to catch parameters nested inside fParamsTailList
-        insert_params_recursive(node, current_class, current_function);
-        declaration_pass_rec(node->sibling, current_class, current_function);
-        return;
-    }
+    case AST_FPARAMS:
+        // catches parameters nested inside fParamsTailList too
+        insert_params(cc, node);
+        return AST_VISIT_SKIP;
 
-    if (strcmp(node->name, "funcDecl") == 0) {
-        declaration_pass_rec(node->child, current_class, current_function);
-        declaration_pass_rec(node->sibling, current_class, current_function);
-        return;
-    }
-    if (strcmp(node->name, "attributeDecl") == 0) {
+    case AST_ATTRIBUTEDECL: {
         // attributeDecl -> varDecl
         ASTNode* vd = node->child;
-        ASTNode* id = find_child(vd, "ID");
-        ASTNode* typeNode = find_child(vd, "type");
-    Type base = get_type_from_typeNode(typeNode);
-    int dims = count_array_dims(vd);
-    Type t = dims > 0 ? make_array_type(base, dims, vd) : base;
-        if (id) add_symbol_if_missing(id->lexeme, SYM_ATTRIBUTE, t, node, id->line, "Duplicate attribute '%s'");
-        declaration_pass_rec(node->sibling, current_class, current_function);
-        return;
+        ASTNode* id = find_child(vd, AST_ID);
+        ASTNode* typeNode = find_child(vd, AST_TYPE);
+        Type base = get_type_from_typeNode(typeNode);
+        int dims = count_array_dims(vd);
+        Type t = dims > 0 ? make_array_type(cc, base, dims, vd) : base;
+        if (id) add_symbol_if_missing(cc, id->lexeme, SYM_ATTRIBUTE, t, node, id->line, "Duplicate attribute '%s'");
+        return AST_VISIT_SKIP;
+    }
+
+    case AST_VARDECL: {
+        ASTNode* id = find_child(node, AST_ID);
+        ASTNode* typeNode = find_child(node, AST_TYPE);
+        Type t = get_type_from_typeNode(typeNode);
+        int dims = count_array_dims(node);
+        if (dims > 0) t = make_array_type(cc, t, dims, node);
+        if (id) add_symbol_if_missing(cc, id->lexeme, SYM_VARIABLE, t, node, id->line, "Duplicate variable '%s'");
+        return AST_VISIT_SKIP;
+    }
+    default:
+        return AST_VISIT_CHILDREN;
     }
+}
 
-    
+void declaration_pass(CompilerContext* cc, ASTNode* root) {
+    AstVisitor v = { declaration_pre, leave_scope, sizeof(SemanticFrame), cc };
+    ast_walk(&v, root, NULL);
+}
 
-    if (strcmp(node->name, "varDecl") == 0) {
-        ASTNode* id = find_child(node, "ID");
-        ASTNode* typeNode = find_child(node, "type");
-    Type t = get_type_from_typeNode(typeNode);
-    int dims = count_array_dims(node);
-    if (dims > 0) t = make_array_type(t, dims, node);
-    if (id) add_symbol_if_missing(id->lexeme, SYM_VARIABLE, t, node, id->line, "Duplicate variable '%s'");
-        declaration_pass_rec(node->sibling, current_class, current_function);
-        return;
+// type checking 
+static Type resolve_id_chain(CompilerContext* cc, ASTNode* idnest, SymbolEntry* current_class, SymbolEntry* current_function, int reportErrors);
+static Type type_check_expr(CompilerContext* cc, ASTNode* node, SymbolEntry* current_class, SymbolEntry* current_func);
+static int is_return_node(ASTNode* n);
+
+static int check_assignStat(CompilerContext* cc, ASTNode* assignNode, SymbolEntry* current_class, SymbolEntry* current_func);
+static int check_varDecl(CompilerContext* cc, ASTNode* varDeclNode, SymbolEntry* current_class, SymbolEntry* current_func);
+static int check_if_condition(CompilerContext* cc, ASTNode* ifNode, SymbolEntry* current_class, SymbolEntry* current_func);
+static int check_while_condition(CompilerContext* cc, ASTNode* whileNode, SymbolEntry* current_class, SymbolEntry* current_func);
+static int check_return_vs_function(CompilerContext* cc, ASTNode* returnNode, SymbolEntry* current_class, SymbolEntry* current_func);
+static int check_functionCall_args_bool(CompilerContext* cc, ASTNode* callNode, SymbolEntry* current_class, SymbolEntry* current_func);
+
+// walks declarations and statements with the scope they were declared in;
+// every expression is handed to type_check_expr as a whole
+static AstVisitResult type_check_pre(AstWalk* w, ASTNode* node, void* frame) {
+    CompilerContext* cc = (CompilerContext*)ast_walk_user(w);
+    SemanticFrame* f = (SemanticFrame*)frame;
+    SymbolEntry* current_class = f->current_class;
+    SymbolEntry* current_func = f->current_function;
+    f->scoped = 0;
+
+    switch (node->kind) {
+    case AST_FUNCDEF: {
+        ASTNode* head = node->child; // funcHead
+        if (!head) return AST_VISIT_SKIP;
+        ASTNode* id = find_child(head, AST_ID);
+        SymbolEntry* funcSym = NULL;
+        if (id) {
+            /* enter the function scope to lookup type checking find parameters and local variables */
+            enter_scope(cc, f, id->lexeme);
+            funcSym = st_lookup_id(cc, id->lexeme_id);
+        }
+        SemanticFrame inner = inner_frame(current_class, funcSym);
+        ast_walk_push_list(w, head->child, &inner);
+        ast_walk_push(w, head->sibling, &inner);     // funcBody
+        return AST_VISIT_SKIP;
     }
 
-    declaration_pass_rec(node->child, current_class, current_function);
-    declaration_pass_rec(node->sibling, current_class, current_function);
-    return;
-}
+    /* statBlock -> { statementList } -- introduce a block scope */
+    case AST_STATBLOCK:
+        enter_scope(cc, f, "<block>");
+        return AST_VISIT_CHILDREN;
 
-void declaration_pass(ASTNode* root) {
-    declaration_pass_rec(root, NULL, NULL);
-}
+    case AST_CLASSDECL: {
+        ASTNode* id = find_child(node, AST_ID);
+        if (id) {
+            enter_scope(cc, f, id->lexeme);
+            SemanticFrame inner = inner_frame(st_lookup_id(cc, id->lexeme_id), current_func);
+            ast_walk_push(w, find_child(node, AST_VISIBILITYMEMBERDECLLIST), &inner);
+        }
+        return AST_VISIT_SKIP;
+    }
 
-// type checking 
-static void resolution_pass_rec(ASTNode* node, SymbolEntry* current_class, SymbolEntry* current_function);
-static Type resolve_id_chain(ASTNode* idnest, SymbolEntry* current_class, SymbolEntry* current_function, int reportErrors);
-static Type type_check_pass_rec(ASTNode* node, SymbolEntry* current_class, SymbolEntry* current_func);
+    case AST_IMPLDEF: {
+        ASTNode* id = find_child(node, AST_ID);
+        if (id) {
+            enter_scope(cc, f, id->lexeme);
+            SemanticFrame inner = inner_frame(st_lookup_id(cc, id->lexeme_id), current_func);
+            ast_walk_push_list(w, node->child, &inner);
+        }
+        return AST_VISIT_SKIP;
+    }
 
-static int check_assignStat(ASTNode* assignNode, SymbolEntry* current_class, SymbolEntry* current_func);
-static int check_varDecl(ASTNode* varDeclNode, SymbolEntry* current_class, SymbolEntry* current_func);
-static int check_if_condition(ASTNode* ifNode, SymbolEntry* current_class, SymbolEntry* current_func);
-static int check_while_condition(ASTNode* whileNode, SymbolEntry* current_class, SymbolEntry* current_func);
-static int check_return_vs_function(ASTNode* returnNode, SymbolEntry* current_class, SymbolEntry* current_func);
-static int check_functionCall_args_bool(ASTNode* callNode, SymbolEntry* current_class, SymbolEntry* current_func);
+    case AST_STATEMENT:
+        if (!is_return_node(node)) return AST_VISIT_CHILDREN;
+        type_check_expr(cc, node, current_class, current_func);
+        return AST_VISIT_SKIP;
+
+    case AST_FUNCTIONCALL: case AST_RELEXPR: case AST_ASSIGNSTAT: case AST_VARIABLE: case AST_EXPR:
+    case AST_LT: case AST_GT: case AST_LEQ: case AST_GEQ: case AST_NEQ:
+    case AST_PLUS: case AST_MINUS: case AST_OR: case AST_MULT: case AST_DIV: case AST_AND:
+    case AST_NOT: case AST_NEG: case AST_POS: case AST_INTLIT: case AST_FLOATLIT:
+        type_check_expr(cc, node, current_class, current_func);
+        return AST_VISIT_SKIP;
+
+    default:
+        return AST_VISIT_CHILDREN;
+    }
+}
 
 // write type checking results to semantic_errors.txt
-void type_check_pass(ASTNode* root) {
-    if (errf) fclose(errf);
-    errf = fopen("files/semantic_errors.txt", "a");
-    if (!errf) return;
-    type_check_pass_rec(root, NULL, NULL);
-    fclose(errf); errf = NULL;
+void type_check_pass(CompilerContext* cc, ASTNode* root) {
+    if (cc->errf) fclose(cc->errf);
+    cc->errf = compiler_open_output(cc, "semantic_errors.txt", "a");
+    if (!cc->errf) return;
+    AstVisitor v = { type_check_pre, leave_scope, sizeof(SemanticFrame), cc };
+    ast_walk(&v, root, NULL);
+    fclose(cc->errf); cc->errf = NULL;
 }
 
 // Helper to count indices in a variable node
@@ -417,9 +497,9 @@ static int count_variable_indices(ASTNode* varNode) {
         StackItem* nx = stack->next; free(stack); stack = nx;
         if (!cur) continue;
         // Check if this is an indiceList with actual indice children
-        if (cur->name && strcmp(cur->name, "indiceList") == 0) {
+        if (cur->kind == AST_INDICELIST) {
             for (ASTNode* ch = cur->child; ch; ch = ch->sibling) {
-                if (ch->name && strcmp(ch->name, "indice") == 0) {
+                if (ch->kind == AST_INDICE) {
                     count++;
                 }
             }
@@ -436,9 +516,9 @@ static int count_variable_indices(ASTNode* varNode) {
     return count;
 }
 
-static Type get_variable_type(ASTNode* idnode) {
-    if (!idnode || strcmp(idnode->name, "ID") != 0) return make_basic_type(TYPE_UNKNOWN);
-    SymbolEntry* s = st_lookup(idnode->lexeme);
+static Type get_variable_type(CompilerContext* cc, ASTNode* idnode) {
+    if (!idnode || idnode->kind != AST_ID) return make_basic_type(TYPE_UNKNOWN);
+    SymbolEntry* s = st_lookup_id(cc, idnode->lexeme_id);
     if (s) return s->type;
     return make_basic_type(TYPE_UNKNOWN);
 }
@@ -462,21 +542,13 @@ static int get_node_line(ASTNode* n) {
 // check whether an AST node represents a return statement
 static int is_return_node(ASTNode* n) {
     if (!n) return 0;
-    if (strcmp(n->name, "returnStat") == 0 || strcmp(n->name, "returnStatement") == 0) return 1;
-    if (strcmp(n->name, "statement") == 0 && n->child) {
-        if ((n->child->name && strcmp(n->child->name, "RETURN") == 0) ||
-            (n->child->lexeme && strcmp(n->child->lexeme, "return") == 0) ||
-            (strstr(n->child->name ? n->child->name : "", "return") != NULL && strcmp(n->child->name, "returnType") != 0)) {
-            return 1;
-        }
-    }
-    return 0;
+    return n->kind == AST_STATEMENT && n->child && n->child->kind == AST_RETURN;
 }
 
 // recursively search subtree
 static ASTNode* find_expr_in_subtree(ASTNode* n) {
     if (!n) return NULL;
-    if (n->name && (strcmp(n->name, "expr") == 0 || strcmp(n->name, "arithExpr") == 0 || strcmp(n->name, "variable") == 0)) return n;
+    if (n->kind == AST_EXPR || n->kind == AST_VARIABLE) return n;
     for (ASTNode* c = n->child; c; c = c->sibling) {
         ASTNode* r = find_expr_in_subtree(c);
         if (r) return r;
@@ -488,14 +560,14 @@ static ASTNode* find_expr_in_subtree(ASTNode* n) {
 static Type* get_param_types_from_decl(ASTNode* declNode, int* out_count) {
     *out_count = 0;
     if (!declNode) return NULL;
-    ASTNode* fparams = find_child(declNode, "fParams");
+    ASTNode* fparams = find_child(declNode, AST_FPARAMS);
     if (!fparams) {
-        if (strcmp(declNode->name, "funcHead") == 0) fparams = find_child(declNode, "fParams");
+        if (declNode->kind == AST_FUNCHEAD) fparams = find_child(declNode, AST_FPARAMS);
     }
     if (!fparams) return NULL;
     int cnt = 0;
     for (ASTNode* ch = fparams->child; ch; ch = ch->sibling) {
-        if (strcmp(ch->name, "ID") == 0) cnt++;
+        if (ch->kind == AST_ID) cnt++;
     }
     if (cnt == 0) {
         *out_count = 0;
@@ -505,11 +577,11 @@ static Type* get_param_types_from_decl(ASTNode* declNode, int* out_count) {
     Type* types = (Type*)malloc(sizeof(Type) * cnt);
     int idx = 0;
     for (ASTNode* ch = fparams->child; ch; ch = ch->sibling) {
-        if (strcmp(ch->name, "ID") == 0) {
+        if (ch->kind == AST_ID) {
             ASTNode* sib = ch->sibling;
             ASTNode* typeNode = NULL;
             for (int steps = 0; sib && steps < 6; sib = sib->sibling, ++steps) {
-                if (strcmp(sib->name, "type") == 0) { typeNode = sib; break; }
+                if (sib->kind == AST_TYPE) { typeNode = sib; break; }
             }
             types[idx++] = get_type_from_typeNode(typeNode);
         }
@@ -519,14 +591,14 @@ static Type* get_param_types_from_decl(ASTNode* declNode, int* out_count) {
 }
 
 // check a function argument match declared parameter list
-static void check_function_call_args(ASTNode* callNode, SymbolEntry* funcSym, SymbolEntry* current_class, SymbolEntry* current_func) {
+static void check_function_call_args(CompilerContext* cc, ASTNode* callNode, SymbolEntry* funcSym, SymbolEntry* current_class, SymbolEntry* current_func) {
     if (!callNode || !funcSym) return;
-    ASTNode* aparams = find_child(callNode, "aParams");
+    ASTNode* aparams = find_child(callNode, AST_APARAMS);
     int argCount = 0;
     ASTNode* arg;
     if (aparams) {
         for (ASTNode* ch = aparams->child; ch; ch = ch->sibling) {
-            if (strcmp(ch->name, "expr") == 0 || strcmp(ch->name, "arithExpr") == 0 || strcmp(ch->name,"variable")==0) argCount++;
+            if (ch->kind == AST_EXPR || ch->kind == AST_VARIABLE) argCount++;
         }
     }
 
@@ -535,18 +607,18 @@ static void check_function_call_args(ASTNode* callNode, SymbolEntry* funcSym, Sy
     if (paramTypes || argCount > 0) {
         if (paramCount != argCount) {
             int line = get_node_line(callNode);
-            semantic_error(line ? line : callNode->line, "Argument count mismatch in call to '%s' (expected %d, got %d)", funcSym->name, paramCount, argCount);
+            semantic_error(cc, line ? line : callNode->line, "Argument count mismatch in call to '%s' (expected %d, got %d)", funcSym->name, paramCount, argCount);
         }
     }
     if (paramTypes && aparams) {
         int pidx = 0;
         for (ASTNode* ch = aparams->child; ch; ch = ch->sibling) {
-            if (!(strcmp(ch->name, "expr") == 0 || strcmp(ch->name, "arithExpr") == 0 || strcmp(ch->name,"variable")==0)) continue;
-            Type at = type_check_pass_rec(ch, current_class, current_func);
+            if (!(ch->kind == AST_EXPR || ch->kind == AST_VARIABLE)) continue;
+            Type at = type_check_expr(cc, ch, current_class, current_func);
             if (pidx < paramCount) {
                 if (!type_equal(&at, &paramTypes[pidx])) {
                     int line = get_node_line(ch);
-                    semantic_error(line ? line : ch->line, "Argument type mismatch in call to '%s' for parameter %d (expected %d, got %d)", funcSym->name, pidx+1, paramTypes[pidx].kind, at.kind);
+                    semantic_error(cc, line ? line : ch->line, "Argument type mismatch in call to '%s' for parameter %d (expected %d, got %d)", funcSym->name, pidx+1, paramTypes[pidx].kind, at.kind);
                 }
             }
             pidx++;
@@ -556,115 +628,68 @@ static void check_function_call_args(ASTNode* callNode, SymbolEntry* funcSym, Sy
     if (paramTypes) free(paramTypes);
 }
 
-// main recursive type checking function
-static Type type_check_pass_rec(ASTNode* node, SymbolEntry* current_class, SymbolEntry* current_func) {
+// type of an expression (a return statement: of its operand), checking it on
+// the way; recursion here follows expression nesting only, statement and
+// declaration lists are walked by type_check_pre
+static Type type_check_expr(CompilerContext* cc, ASTNode* node, SymbolEntry* current_class, SymbolEntry* current_func) {
     if (!node) return make_basic_type(TYPE_UNKNOWN);
 
-    if (strcmp(node->name, "funcDef") == 0) {
-        ASTNode* head = node->child; // funcHead
-        SymbolEntry* funcSym = NULL;
-        if (head) {
-            ASTNode* id = find_child(head, "ID");
-            if (id) {
-                /* enter the function scope to lookup type checking find parameters and local variables */
-                st_enter_scope(id->lexeme);
-                funcSym = st_lookup(id->lexeme);
-            }
-            for (ASTNode* ch = head->child; ch; ch = ch->sibling) type_check_pass_rec(ch, current_class, funcSym);
-            ASTNode* body = head->sibling;
-            if (body) type_check_pass_rec(body, current_class, funcSym);
-            if (id) st_exit_scope();
-        }
-        return type_check_pass_rec(node->sibling, current_class, current_func);
-    }
-
-    /* statBlock -> { statementList } -- introduce a block scope */
-    if (strcmp(node->name, "statBlock") == 0 || strcmp(node->name, "block") == 0) {
-        st_enter_scope("<block>");
-        type_check_pass_rec(node->child, current_class, current_func);
-        st_exit_scope();
-        return type_check_pass_rec(node->sibling, current_class, current_func);
-    }
-
-    if (strcmp(node->name, "classDecl") == 0) {
-        for (ASTNode* ch = node->child; ch; ch = ch->sibling) {
-            if (strcmp(ch->name, "ID") == 0) {
-                st_enter_scope(ch->lexeme);
-                SymbolEntry* classSym = st_lookup(ch->lexeme);
-                for (ASTNode* m = node->child; m; m = m->sibling) {
-                    if (strcmp(m->name, "visibilitymemberDeclList") == 0) {
-                        type_check_pass_rec(m, classSym, current_func);
-                        break;
-                    }
-                }
-                st_exit_scope();
-                break;
-            }
-        }
-        return type_check_pass_rec(node->sibling, current_class, current_func);
-    }
-
-    if (strcmp(node->name, "implDef") == 0 || strcmp(node->name, "implement") == 0) {
-        ASTNode* id = find_child(node, "ID");
-        if (id) {
-            st_enter_scope(id->lexeme);
-            SymbolEntry* targetClass = st_lookup(id->lexeme);
-            for (ASTNode* c = node->child; c; c = c->sibling) {
-                type_check_pass_rec(c, targetClass, current_func);
-            }
-            st_exit_scope();
-        }
-        return type_check_pass_rec(node->sibling, current_class, current_func);
-    }
-    if (is_return_node(node)) {
-        check_return_vs_function(node, current_class, current_func);
+    switch (node->kind) {
+    case AST_STATEMENT: {
+        if (!is_return_node(node)) break;
+        check_return_vs_function(cc, node, current_class, current_func);
         ASTNode* expr = find_expr_in_subtree(node);
         Type exprType = make_basic_type(TYPE_UNKNOWN);
-        if (expr) exprType = type_check_pass_rec(expr, current_class, current_func);
+        if (expr) exprType = type_check_expr(cc, expr, current_class, current_func);
         return exprType;
     }
     // functionCall -> idnestList ( aParamsOpt )
-    if (strcmp(node->name, "functionCall") == 0) {
+    case AST_FUNCTIONCALL: {
         // find rightmost ID for target
         ASTNode* idnode = find_rightmost_id(node->child);
         if (idnode) {
-            SymbolEntry* s = st_lookup(idnode->lexeme);
+            SymbolEntry* s = st_lookup_id(cc, idnode->lexeme_id);
             if (s) {
-                check_function_call_args(node, s, current_class, current_func);
+                check_function_call_args(cc, node, s, current_class, current_func);
                 return s->type;
             } else {
-                semantic_error(idnode->line, "Undeclared function '%s'", idnode->lexeme);
+                semantic_error(cc, idnode->line, "Undeclared function '%s'", idnode->lexeme);
             }
         }
     for (ASTNode* c = node->child; c; c = c->sibling) {
-        type_check_pass_rec(c, current_class, current_func);
+        type_check_expr(cc, c, current_class, current_func);
     }
         return make_basic_type(TYPE_UNKNOWN);
     }
 
-    // relExpr -> arithExpr relOp arithExpr
-    if (strcmp(node->name, "relExpr") == 0) {
+    // relExpr -> expression; the relational operator is a node inside it
+    case AST_RELEXPR: {
+        type_check_expr(cc, node->child, current_class, current_func);
+        return make_basic_type(TYPE_INT);
+    }
+
+    // lhs relOp rhs
+    case AST_LT: case AST_GT: case AST_LEQ: case AST_GEQ: case AST_NEQ: {
         ASTNode* left = node->child;
-        ASTNode* op = left ? left->sibling : NULL;
-        ASTNode* right = op ? op->sibling : NULL;
-    Type lt = type_check_pass_rec(left, current_class, current_func);
-    Type rt = type_check_pass_rec(right, current_class, current_func);
+        ASTNode* right = left ? left->sibling : NULL;
+    Type lt = type_check_expr(cc, left, current_class, current_func);
+    Type rt = type_check_expr(cc, right, current_class, current_func);
         if (!((lt.kind == TYPE_INT || lt.kind == TYPE_FLOAT) && (rt.kind == TYPE_INT || rt.kind == TYPE_FLOAT))) {
             if (!(lt.kind == TYPE_UNKNOWN || rt.kind == TYPE_UNKNOWN || (lt.kind == rt.kind && lt.kind != TYPE_UNKNOWN))) {
                 int line = get_node_line(node);
-                semantic_error(line ? line : node->line, "Type error: incompatible types for relational operator (%d vs %d)", lt.kind, rt.kind);
+                semantic_error(cc, line ? line : node->line, "Type error: incompatible types for relational operator (%d vs %d)", lt.kind, rt.kind);
             }
         }
         return make_basic_type(TYPE_INT);
     }
 
     //assignStat -> variable assignOp expr
-    if (strcmp(node->name, "assignStat") == 0) {
+    case AST_ASSIGNSTAT: {
         ASTNode* varNode = node->child;
         ASTNode* assignOpNode = varNode ? varNode->sibling : NULL;
         ASTNode* exprNode = assignOpNode ? assignOpNode->sibling : NULL;
-    Type varType = type_check_pass_rec(varNode, current_class, current_func);
-    Type exprType = type_check_pass_rec(exprNode, current_class, current_func);
+    Type varType = type_check_expr(cc, varNode, current_class, current_func);
+    Type exprType = type_check_expr(cc, exprNode, current_class, current_func);
         if (varType.kind == TYPE_ARRAY) {
             int idxCount = 0;
             typedef struct StackItem3 { ASTNode* node; struct StackItem3* next; } StackItem3;
@@ -673,7 +698,7 @@ static Type type_check_pass_rec(ASTNode* node, SymbolEntry* current_class, Symbo
             while (st) {
                 ASTNode* cur = st->node; StackItem3* nx = st->next; free(st); st = nx;
                 if (!cur) continue;
-                if (cur->name && strcmp(cur->name, "indice") == 0) idxCount++;
+                if (cur->kind == AST_INDICE) idxCount++;
                 if (cur->child) { StackItem3* it = (StackItem3*)malloc(sizeof(StackItem3)); it->node = cur->child; it->next = st; st = it; }
                 for (ASTNode* sib = cur->sibling; sib; sib = sib->sibling) { StackItem3* it = (StackItem3*)malloc(sizeof(StackItem3)); it->node = sib; it->next = st; st = it; }
             }
@@ -683,12 +708,12 @@ static Type type_check_pass_rec(ASTNode* node, SymbolEntry* current_class, Symbo
                     else varType = make_basic_type(TYPE_UNKNOWN);
                 } else {
                     Type t = make_basic_type(TYPE_ARRAY);
-                    t.elementType = (Type*)malloc(sizeof(Type));
+                    t.elementType = (Type*)ast_alloc(cc, sizeof(Type));
                     *(t.elementType) = *(varType.elementType);
                     t.dimensions = varType.dimensions - idxCount;
                     t.dimSizes = NULL;
                     if (varType.dimSizes) {
-                        t.dimSizes = (size_t*)malloc(sizeof(size_t) * t.dimensions);
+                        t.dimSizes = (size_t*)ast_alloc(cc, sizeof(size_t) * t.dimensions);
                         for (int i = 0; i < t.dimensions; ++i) t.dimSizes[i] = varType.dimSizes[i + idxCount];
                     }
                     varType = t;
@@ -697,13 +722,13 @@ static Type type_check_pass_rec(ASTNode* node, SymbolEntry* current_class, Symbo
         }
         if (!type_equal(&varType, &exprType)) {
             int line = varNode && varNode->child ? varNode->child->line : node->line;
-            semantic_error(line, "Type error: cannot assign expression of type '%d' to variable of type '%d'", exprType.kind, varType.kind);
+            semantic_error(cc, line, "Type error: cannot assign expression of type '%d' to variable of type '%d'", exprType.kind, varType.kind);
         }
         return varType;
     }
 
     // variable -> idnestList id indiceList
-    if (strcmp(node->name, "variable") == 0) {
+    case AST_VARIABLE: {
         ASTNode* idnode = find_rightmost_id(node->child);
         
         // Count how many indices are present using helper function
@@ -718,11 +743,11 @@ static Type type_check_pass_rec(ASTNode* node, SymbolEntry* current_class, Symbo
             ASTNode* cur = stack->node;
             StackItem4* nx = stack->next; free(stack); stack = nx;
             if (!cur) continue;
-            if (cur->name && strcmp(cur->name, "indice") == 0 && cur->child) {
-                Type it = type_check_pass_rec(cur->child, current_class, current_func);
+            if (cur->kind == AST_INDICE && cur->child) {
+                Type it = type_check_expr(cc, cur->child, current_class, current_func);
                 if (it.kind != TYPE_INT && it.kind != TYPE_UNKNOWN) {
                     int line = get_node_line(cur);
-                    semantic_error(line ? line : cur->line, "Type error: array index must be integer (got %d)", it.kind);
+                    semantic_error(cc, line ? line : cur->line, "Type error: array index must be integer (got %d)", it.kind);
                 }
             }
             if (cur->child) {
@@ -736,21 +761,21 @@ static Type type_check_pass_rec(ASTNode* node, SymbolEntry* current_class, Symbo
         }
         
         if (!idnode) return make_basic_type(TYPE_UNKNOWN);
-        Type resolved = resolve_id_chain(node->child, current_class, current_func, 0);
+        Type resolved = resolve_id_chain(cc, node->child, current_class, current_func, 0);
         if (resolved.kind != TYPE_UNKNOWN) return resolved;
-        if (node->child && strcmp(node->child->name, "ID") != 0) {
-            Type childT = type_check_pass_rec(node->child, current_class, current_func);
+        if (node->child && node->child->kind != AST_ID) {
+            Type childT = type_check_expr(cc, node->child, current_class, current_func);
             if (childT.kind == TYPE_CLASS) {
-                Type m = resolve_member_with_inheritance(childT, idnode->lexeme);
+                Type m = resolve_member_with_inheritance(cc, childT, idnode->lexeme);
                 if (m.kind != TYPE_UNKNOWN) return m;
             }
         }
         
-        Type varType = get_variable_type(idnode);
+        Type varType = get_variable_type(cc, idnode);
         
         // DEBUG: Print what found
         if (indiceCount > 0) {
-            fprintf(stderr, "[DEBUG VAR] Variable %s has %d indices, varType.kind=%d, dimensions=%d\n", 
+            LOG_DEBUG(LOG_SEMANTIC, "[DEBUG VAR] Variable %s has %d indices, varType.kind=%d, dimensions=%d\n", 
                     idnode ? idnode->lexeme : "NULL", indiceCount, varType.kind, varType.dimensions);
         }
         
@@ -773,84 +798,45 @@ static Type type_check_pass_rec(ASTNode* node, SymbolEntry* current_class, Symbo
     }
 
     // Integer
-    if (strcmp(node->name, "intLit") == 0) {
+    case AST_INTLIT: {
         return make_basic_type(TYPE_INT);
     }
     // Float
-    if (strcmp(node->name, "floatLit") == 0) {
+    case AST_FLOATLIT: {
         return make_basic_type(TYPE_FLOAT);
     }
 
-    // arithExpr -> term arithExprTail
-    if (strcmp(node->name, "arithExpr") == 0) {
-        ASTNode* termNode = node->child;
-        ASTNode* tailNode = termNode ? termNode->sibling : NULL;
-    Type t1 = type_check_pass_rec(termNode, current_class, current_func);
-    Type t2 = type_check_pass_rec(tailNode, current_class, current_func);
-        if (!((t1.kind == TYPE_INT || t1.kind == TYPE_FLOAT || t1.kind == TYPE_UNKNOWN) &&
-              (t2.kind == TYPE_INT || t2.kind == TYPE_FLOAT || t2.kind == TYPE_UNKNOWN))) {
-            int line = get_node_line(node);
-            semantic_error(line ? line : node->line, "Type error: arithmetic operands must be numeric (got %d and %d)", t1.kind, t2.kind);
-        }
-        return promote_arith_type(t1, t2);
-    }
-    // arithExprTail -> addOp term arithExprTail | ε
-    if (strcmp(node->name, "arithExprTail") == 0) {
-        if (!node->child) return make_basic_type(TYPE_INT); 
-        ASTNode* addOpNode = node->child;
-        ASTNode* termNode = addOpNode ? addOpNode->sibling : NULL;
-        ASTNode* tailNode = termNode ? termNode->sibling : NULL;
-    Type t1 = type_check_pass_rec(termNode, current_class, current_func);
-    Type t2 = type_check_pass_rec(tailNode, current_class, current_func);
-        if (!((t1.kind == TYPE_INT || t1.kind == TYPE_FLOAT || t1.kind == TYPE_UNKNOWN) &&
-              (t2.kind == TYPE_INT || t2.kind == TYPE_FLOAT || t2.kind == TYPE_UNKNOWN))) {
-            int line = get_node_line(node);
-            semantic_error(line ? line : node->line, "Type error: arithmetic operands must be numeric (got %d and %d)", t1.kind, t2.kind);
-        }
-        return promote_arith_type(t1, t2);
-    }
-    // term -> factor termTail
-    if (strcmp(node->name, "term") == 0) {
-        ASTNode* factorNode = node->child;
-        ASTNode* tailNode = factorNode ? factorNode->sibling : NULL;
-    Type t1 = type_check_pass_rec(factorNode, current_class, current_func);
-    Type t2 = type_check_pass_rec(tailNode, current_class, current_func);
-        if (!((t1.kind == TYPE_INT || t1.kind == TYPE_FLOAT || t1.kind == TYPE_UNKNOWN) &&
-              (t2.kind == TYPE_INT || t2.kind == TYPE_FLOAT || t2.kind == TYPE_UNKNOWN))) {
-            int line = get_node_line(node);
-            semantic_error(line ? line : node->line, "Type error: arithmetic operands must be numeric (got %d and %d)", t1.kind, t2.kind);
-        }
-        return promote_arith_type(t1, t2);
-    }
-    // termTail -> multOp factor termTail | ε
-    if (strcmp(node->name, "termTail") == 0) {
-        if (!node->child) return make_basic_type(TYPE_INT); // epsilon
-        ASTNode* multOpNode = node->child;
-        ASTNode* factorNode = multOpNode ? multOpNode->sibling : NULL;
-        ASTNode* tailNode = factorNode ? factorNode->sibling : NULL;
-    Type t1 = type_check_pass_rec(factorNode, current_class, current_func);
-    Type t2 = type_check_pass_rec(tailNode, current_class, current_func);
+    // lhs addOp rhs, lhs multOp rhs
+    case AST_PLUS: case AST_MINUS: case AST_OR:
+    case AST_MULT: case AST_DIV: case AST_AND: {
+        ASTNode* left = node->child;
+        ASTNode* right = left ? left->sibling : NULL;
+    Type t1 = type_check_expr(cc, left, current_class, current_func);
+    Type t2 = type_check_expr(cc, right, current_class, current_func);
         if (!((t1.kind == TYPE_INT || t1.kind == TYPE_FLOAT || t1.kind == TYPE_UNKNOWN) &&
               (t2.kind == TYPE_INT || t2.kind == TYPE_FLOAT || t2.kind == TYPE_UNKNOWN))) {
             int line = get_node_line(node);
-            semantic_error(line ? line : node->line, "Type error: arithmetic operands must be numeric (got %d and %d)", t1.kind, t2.kind);
+            semantic_error(cc, line ? line : node->line, "Type error: arithmetic operands must be numeric (got %d and %d)", t1.kind, t2.kind);
         }
         return promote_arith_type(t1, t2);
     }
-    // factor -> variable | intLit | floatLit | (arithExpr) | not factor | sign factor
-    if (strcmp(node->name, "factor") == 0) {
+    // not factor, sign factor
+    case AST_NOT: case AST_NEG: case AST_POS: {
     if (!node->child) return make_basic_type(TYPE_UNKNOWN);
-    return type_check_pass_rec(node->child, current_class, current_func);
+    return type_check_expr(cc, node->child, current_class, current_func);
     }
 
-    // expr -> arithExpr | relExpr
-    if (strcmp(node->name, "expr") == 0) {
+    // expr -> operator tree | nothing (call statement)
+    case AST_EXPR: {
     if (!node->child) return make_basic_type(TYPE_UNKNOWN);
-    return type_check_pass_rec(node->child, current_class, current_func);
+    return type_check_expr(cc, node->child, current_class, current_func);
+    }
+    default:
+        break;
     }
 
     for (ASTNode* c = node->child; c; c = c->sibling) {
-        type_check_pass_rec(c, current_class, current_func);
+        type_check_expr(cc, c, current_class, current_func);
     }
     return make_basic_type(TYPE_UNKNOWN);
 }
@@ -860,18 +846,18 @@ static ASTNode* find_rightmost_id(ASTNode* n) {
     if (!n) return NULL;
     ASTNode* found = NULL;
     for (ASTNode* c = n; c; c = c->sibling) {
-        if (strcmp(c->name, "ID") == 0) found = c;
+        if (c->kind == AST_ID) found = c;
         ASTNode* deeper = find_rightmost_id(c->child);
         if (deeper) found = deeper;
     }
     return found;
 }
 // collect all IDs in an idnest/idnestList
-static char** collect_ids(ASTNode* n, int* out_count) {
+static int* collect_ids(ASTNode* n, int* out_count) {
     *out_count = 0;
     if (!n) return NULL;
     int cap = 8;
-    char** arr = (char**)malloc(sizeof(char*) * cap);
+    int* arr = (int*)malloc(sizeof(int) * cap);
     typedef struct StackItem { ASTNode* node; struct StackItem* next; } StackItem;
     StackItem* stack = NULL;
     StackItem* s0 = (StackItem*)malloc(sizeof(StackItem)); s0->node = n; s0->next = stack; stack = s0;
@@ -879,9 +865,9 @@ static char** collect_ids(ASTNode* n, int* out_count) {
         ASTNode* cur = stack->node;
         StackItem* next = stack->next; free(stack); stack = next;
         if (!cur) continue;
-        if (strcmp(cur->name, "ID") == 0 && cur->lexeme) {
-            if (*out_count >= cap) { cap *= 2; arr = (char**)realloc(arr, sizeof(char*) * cap); }
-            arr[*out_count] = strdup(cur->lexeme);
+        if (cur->kind == AST_ID && cur->lexeme_id != INTERN_NONE) {
+            if (*out_count >= cap) { cap *= 2; arr = (int*)realloc(arr, sizeof(int) * cap); }
+            arr[*out_count] = cur->lexeme_id;
             (*out_count)++;
         }
         for (ASTNode* sib = cur->sibling; sib; sib = sib->sibling) {
@@ -894,242 +880,209 @@ static char** collect_ids(ASTNode* n, int* out_count) {
     return arr;
 }
 
-static void free_id_array(char** arr, int cnt) {
-    if (!arr) return;
-    for (int i = 0; i < cnt; ++i) free(arr[i]);
-    free(arr);
-}
-
-static Type resolve_id_chain(ASTNode* idnest, SymbolEntry* current_class, SymbolEntry* current_function, int reportErrors) {
+static Type resolve_id_chain(CompilerContext* cc, ASTNode* idnest, SymbolEntry* current_class, SymbolEntry* current_function, int reportErrors) {
     Type unknown = make_basic_type(TYPE_UNKNOWN);
     if (!idnest) return unknown;
     int n = 0;
-    char** ids = collect_ids(idnest, &n);
-    if (n == 0) return unknown;
+    int* ids = collect_ids(idnest, &n);
+    if (n == 0) { free(ids); return unknown; }
     Type curType = make_basic_type(TYPE_UNKNOWN);
-    if (strcmp(ids[0], "self") == 0) {
+    if (ids[0] == intern_find(cc, "self")) {
         if (!current_class) {
-            if (reportErrors) semantic_error_rule(idnest->line, "Self-use rule", "'self' used outside of method");
-            free_id_array(ids, n);
+            if (reportErrors) semantic_error_rule(cc, idnest->line, "Self-use rule", "'self' used outside of method");
+            free(ids);
             return unknown;
         }
         curType = current_class->type;
     } else {
-        SymbolEntry* baseSym = st_lookup(ids[0]);
+        SymbolEntry* baseSym = st_lookup_id(cc, ids[0]);
         if (!baseSym) {
             if (reportErrors) {
                 int l = get_node_line(idnest);
-                semantic_error(l ? l : idnest->line, "Undeclared identifier '%s'", ids[0]);
+                semantic_error(cc, l ? l : idnest->line, "Undeclared identifier '%s'", intern_name(cc, ids[0]));
             }
-            free_id_array(ids, n);
+            free(ids);
             return unknown;
         }
         curType = baseSym->type;
     }
 
     for (int i = 1; i < n; ++i) {
-        const char* member = ids[i];
+        const char* member = intern_name(cc, ids[i]);
         if (curType.kind == TYPE_CLASS) {
-            Type m = resolve_member_with_inheritance(curType, member);
+            Type m = resolve_member_with_inheritance(cc, curType, member);
             if (m.kind == TYPE_UNKNOWN) {
-                if (reportErrors) semantic_error(idnest->line, "Member '%s' not found in type '%s'", member, curType.name);
-                free_id_array(ids, n);
+                if (reportErrors) semantic_error(cc, idnest->line, "Member '%s' not found in type '%s'", member, curType.name);
+                free(ids);
                 return unknown;
             }
             curType = m;
         } else {
-            if (reportErrors) semantic_error(idnest->line, "Cannot access member '%s' of non-class type", member);
-            free_id_array(ids, n);
+            if (reportErrors) semantic_error(cc, idnest->line, "Cannot access member '%s' of non-class type", member);
+            free(ids);
             return unknown;
         }
     }
-    free_id_array(ids, n);
+    free(ids);
     return curType;
 }
 
 // scan an expression subtree
-static void check_ids_in_expr(ASTNode* n) {
+static void check_ids_in_expr(CompilerContext* cc, ASTNode* n) {
     if (!n) return;
-    if (strcmp(n->name, "ID") == 0) {
+    if (n->kind == AST_ID) {
         if (n->lexeme) {
-            SymbolEntry* s = st_lookup(n->lexeme);
+            SymbolEntry* s = st_lookup_id(cc, n->lexeme_id);
             if (!s) {
                 int l = get_node_line(n);
-                semantic_error(l ? l : n->line, "Undeclared identifier '%s'", n->lexeme);
+                semantic_error(cc, l ? l : n->line, "Undeclared identifier '%s'", n->lexeme);
             }
         }
         return;
     }
     for (ASTNode* c = n->child; c; c = c->sibling){
-        check_ids_in_expr(c);
+        check_ids_in_expr(cc, c);
     } 
 }
 
 // checks semantics of the generated AST ==================================
-static void resolution_pass_rec(ASTNode* node, SymbolEntry* current_class, SymbolEntry* current_function) {
-    if (!node) return;
-
-    if (strcmp(node->name, "classDecl") == 0) {
-        // enter class scope
-        for (ASTNode* ch = node->child; ch; ch = ch->sibling) {
-            if (strcmp(ch->name, "ID") == 0) {
-                st_enter_scope(ch->lexeme);
-                SymbolEntry* classSym = st_lookup(ch->lexeme);
-                // resolve inside visibilitymemberDeclList
-                for (ASTNode* m = node->child; m; m = m->sibling) {
-                    if (strcmp(m->name, "visibilitymemberDeclList") == 0) {
-                        resolution_pass_rec(m, classSym, current_function);
-                        break;
-                    }
-                }
-                st_exit_scope();
-                break;
-            }
+static AstVisitResult resolution_pre(AstWalk* w, ASTNode* node, void* frame) {
+    CompilerContext* cc = (CompilerContext*)ast_walk_user(w);
+    SemanticFrame* f = (SemanticFrame*)frame;
+    SymbolEntry* current_class = f->current_class;
+    SymbolEntry* current_function = f->current_function;
+    f->scoped = 0;
+
+    switch (node->kind) {
+    case AST_CLASSDECL: {
+        // enter class scope, resolve inside visibilitymemberDeclList
+        ASTNode* id = find_child(node, AST_ID);
+        if (id) {
+            enter_scope(cc, f, id->lexeme);
+            SemanticFrame inner = inner_frame(st_lookup_id(cc, id->lexeme_id), current_function);
+            ast_walk_push_list(w, find_child(node, AST_VISIBILITYMEMBERDECLLIST), &inner);
         }
-    resolution_pass_rec(node->sibling, current_class, current_function);
-        return;
+        return AST_VISIT_SKIP;
     }
 
-    if (strcmp(node->name, "funcDef") == 0) {
-        // funcDef -> funcHead funcBody
+    case AST_FUNCDEF: {
+        // funcDef -> funcHead funcBody: resolve params (if any) and body
         ASTNode* head = node->child;
-        if (head) {
-            for (ASTNode* ch = head->child; ch; ch = ch->sibling) {
-                if (strcmp(ch->name, "ID") == 0) {
-                    st_enter_scope(ch->lexeme);
-                    // resolve params (if any) and body
-                    SymbolEntry* funcSym = st_lookup(ch->lexeme);
-                    for (ASTNode* hh = head->child; hh; hh = hh->sibling) {
-                        resolution_pass_rec(hh, current_class, funcSym);
-                    }
-                    ASTNode* body = head->sibling;
-                    if (body) resolution_pass_rec(body, current_class, funcSym);
-                    st_exit_scope();
-                    break;
-                }
-            }
+        ASTNode* id = head ? find_child(head, AST_ID) : NULL;
+        if (id) {
+            enter_scope(cc, f, id->lexeme);
+            SemanticFrame inner = inner_frame(current_class, st_lookup_id(cc, id->lexeme_id));
+            ast_walk_push_list(w, head->child, &inner);
+            ast_walk_push_list(w, head->sibling, &inner);
         }
-    resolution_pass_rec(node->sibling, current_class, current_function);
-        return;
+        return AST_VISIT_SKIP;
     }
 
     // statBlock -> { statementList }
-    if (strcmp(node->name, "statBlock") == 0 || strcmp(node->name, "block") == 0) {
-    // enter a new block scope
-    st_enter_scope("<block>");
-    resolution_pass_rec(node->child, current_class, current_function);
-    st_exit_scope();
-    resolution_pass_rec(node->sibling, current_class, current_function);
-        return;
-    }
+    case AST_STATBLOCK:
+        // enter a new block scope
+        enter_scope(cc, f, "<block>");
+        return AST_VISIT_CHILDREN;
 
     // variable -> idnestList id indiceList
-    if (strcmp(node->name, "variable") == 0) {
-        Type resolved = resolve_id_chain(node->child, current_class, current_function, 1);
-        (void)resolved;
-        resolution_pass_rec(node->child, current_class, current_function);
-        resolution_pass_rec(node->sibling, current_class, current_function);
-        return;
-    }
+    case AST_VARIABLE:
+        resolve_id_chain(cc, node->child, current_class, current_function, 1);
+        return AST_VISIT_CHILDREN;
 
-    if (strcmp(node->name, "functionCall") == 0) {
+    case AST_FUNCTIONCALL: {
         // idnestList ID (aParams)
         ASTNode* idnode = find_rightmost_id(node->child);
         if (idnode) {
-            Type t = resolve_id_chain(node->child, current_class, current_function, 1);
+            Type t = resolve_id_chain(cc, node->child, current_class, current_function, 1);
             if (t.kind == TYPE_UNKNOWN) {
-                semantic_error(idnode->line, "Undeclared function 814 '%s'", idnode->lexeme);
+                semantic_error(cc, idnode->line, "Undeclared function 814 '%s'", idnode->lexeme);
             }
         }
-    resolution_pass_rec(node->child, current_class, current_function);
-    resolution_pass_rec(node->sibling, current_class, current_function);
-        return;
+        return AST_VISIT_CHILDREN;
     }
 
-    if (strcmp(node->name, "idOrSelf") == 0) {
-       
-        if (node->child && strcmp(node->child->name, "ID") == 0) {
+    case AST_IDORSELF: {
+        if (node->child && node->child->kind == AST_ID) {
             if (node->child->lexeme && strcmp(node->child->lexeme, "self") == 0) {
                 if (!current_function || !current_class) {
-                    semantic_error_rule(node->child->line, "Self-use rule: 'self' only valid inside methods", "'self' used outside of method");
+                    semantic_error_rule(cc, node->child->line, "Self-use rule: 'self' only valid inside methods", "'self' used outside of method");
                 }
             } else {
-                SymbolEntry* s = st_lookup(node->child->lexeme);
-                if (!s) semantic_error_rule(node->child->line, "Name resolution", "Undeclared identifier '%s'", node->child->lexeme);
+                SymbolEntry* s = st_lookup_id(cc, node->child->lexeme_id);
+                if (!s) semantic_error_rule(cc, node->child->line, "Name resolution", "Undeclared identifier '%s'", node->child->lexeme);
             }
         }
-        resolution_pass_rec(node->sibling, current_class, current_function);
-        return;
+        return AST_VISIT_SKIP;
     }
 
-    if (strcmp(node->name, "expr") == 0 || strcmp(node->name, "arithExpr") == 0 ||
-        strcmp(node->name, "term") == 0 || strcmp(node->name, "factor") == 0 ||
-        strcmp(node->name, "arithExprTail") == 0 || strcmp(node->name, "termTail") == 0 ||
-        strcmp(node->name, "aParams") == 0) {
-        check_ids_in_expr(node);
-        
-    resolution_pass_rec(node->child, current_class, current_function);
-    resolution_pass_rec(node->sibling, current_class, current_function);
-        return;
+    case AST_EXPR: case AST_RELEXPR: case AST_APARAMS:
+        check_ids_in_expr(cc, node);
+        return AST_VISIT_CHILDREN;
+
+    default:
+        return AST_VISIT_CHILDREN;
     }
-    resolution_pass_rec(node->child, current_class, current_function);
-    resolution_pass_rec(node->sibling, current_class, current_function);
 }
 
-void semantic_error_rule(int line, const char* rule, const char* fmt, ...) {
-    if (!errf) errf = fopen("files/semantic_errors.txt", "a");
-    if (!errf) return;
+static void resolution_pass(CompilerContext* cc, ASTNode* root) {
+    AstVisitor v = { resolution_pre, leave_scope, sizeof(SemanticFrame), cc };
+    ast_walk(&v, root, NULL);
+}
+
+void semantic_error_rule(CompilerContext* cc, int line, const char* rule, const char* fmt, ...) {
+    if (!cc->errf) cc->errf = compiler_open_output(cc, "semantic_errors.txt", "a");
+    if (!cc->errf) return;
     va_list ap;
     va_start(ap, fmt);
-    if (rule && rule[0]) fprintf(errf, "[%s] ", rule);
-    fprintf(errf, "Line %d: ", line);
-    vfprintf(errf, fmt, ap);
-    fprintf(errf, "\n");
+    if (rule && rule[0]) fprintf(cc->errf, "[%s] ", rule);
+    fprintf(cc->errf, "Line %d: ", line);
+    vfprintf(cc->errf, fmt, ap);
+    fprintf(cc->errf, "\n");
     va_end(ap);
 }
 
 // Basic error reporting
-void semantic_error(int line, const char* fmt, ...) {
-    if (!errf) errf = fopen("files/semantic_errors.txt", "a"); 
-    if (!errf) return;
+void semantic_error(CompilerContext* cc, int line, const char* fmt, ...) {
+    if (!cc->errf) cc->errf = compiler_open_output(cc, "semantic_errors.txt", "a"); 
+    if (!cc->errf) return;
     va_list ap;
     va_start(ap, fmt);
-    fprintf(errf, "Line %d: ", line);
-    vfprintf(errf, fmt, ap);
-    fprintf(errf, "\n");
+    fprintf(cc->errf, "Line %d: ", line);
+    vfprintf(cc->errf, fmt, ap);
+    fprintf(cc->errf, "\n");
     va_end(ap);
 }
 
 // Check assignment statement semantics
-static int check_assignStat(ASTNode* assignNode, SymbolEntry* current_class, SymbolEntry* current_func) {
+static int check_assignStat(CompilerContext* cc, ASTNode* assignNode, SymbolEntry* current_class, SymbolEntry* current_func) {
     if (!assignNode) return 1;
     ASTNode* varNode = assignNode->child;
     ASTNode* assignOpNode = varNode ? varNode->sibling : NULL;
     ASTNode* exprNode = assignOpNode ? assignOpNode->sibling : NULL;
-    Type varType = type_check_pass_rec(varNode, current_class, current_func);
-    Type exprType = type_check_pass_rec(exprNode, current_class, current_func);
+    Type varType = type_check_expr(cc, varNode, current_class, current_func);
+    Type exprType = type_check_expr(cc, exprNode, current_class, current_func);
     if (!type_equal(&varType, &exprType)) {
         int line = varNode && varNode->child ? varNode->child->line : get_node_line(assignNode);
-        semantic_error_rule(line ? line : 0, "R10-assign", "Type error: cannot assign expression of type '%d' to variable of type '%d'", exprType.kind, varType.kind);
+        semantic_error_rule(cc, line ? line : 0, "R10-assign", "Type error: cannot assign expression of type '%d' to variable of type '%d'", exprType.kind, varType.kind);
         return 0;
     }
     return 1;
 }
 
 // Check variable declaration semantic
-static int check_varDecl(ASTNode* varDeclNode, SymbolEntry* current_class, SymbolEntry* current_func) {
+static int check_varDecl(CompilerContext* cc, ASTNode* varDeclNode, SymbolEntry* current_class, SymbolEntry* current_func) {
     if (!varDeclNode) return 1;
-    ASTNode* id = find_child(varDeclNode, "ID");
-    ASTNode* typeNode = find_child(varDeclNode, "type");
+    ASTNode* id = find_child(varDeclNode, AST_ID);
+    ASTNode* typeNode = find_child(varDeclNode, AST_TYPE);
     Type base = get_type_from_typeNode(typeNode);
     int dims = count_array_dims(varDeclNode);
-    Type t = dims > 0 ? make_array_type(base, dims, varDeclNode) : base;
+    Type t = dims > 0 ? make_array_type(cc, base, dims, varDeclNode) : base;
     if (base.kind == TYPE_CLASS) {
         // ensure class exists
-        SymbolEntry* cs = st_lookup(base.name);
+        SymbolEntry* cs = st_lookup(cc, base.name);
         if (!cs) {
             int l = id ? id->line : get_node_line(varDeclNode);
-            semantic_error_rule(l ? l : 0, "R7-decl", "Undefined class type '%s' in variable declaration", base.name);
+            semantic_error_rule(cc, l ? l : 0, "R7-decl", "Undefined class type '%s' in variable declaration", base.name);
             return 0;
         }
     }
@@ -1137,60 +1090,60 @@ static int check_varDecl(ASTNode* varDeclNode, SymbolEntry* current_class, Symbo
 }
 
 // check if-condition is boolean 
-static int check_if_condition(ASTNode* ifNode, SymbolEntry* current_class, SymbolEntry* current_func) {
+static int check_if_condition(CompilerContext* cc, ASTNode* ifNode, SymbolEntry* current_class, SymbolEntry* current_func) {
     if (!ifNode) return 1;
     ASTNode* cond = NULL;
     for (ASTNode* c = ifNode->child; c; c = c->sibling) {
-        if (strcmp(c->name, "relExpr") == 0 || strcmp(c->name, "expr") == 0 || strcmp(c->name, "arithExpr") == 0) { cond = c; break; }
+        if (c->kind == AST_RELEXPR || c->kind == AST_EXPR) { cond = c; break; }
     }
     if (!cond) return 1;
-    Type ct = type_check_pass_rec(cond, current_class, current_func);
+    Type ct = type_check_expr(cc, cond, current_class, current_func);
     if (ct.kind != TYPE_INT && ct.kind != TYPE_UNKNOWN) {
         int l = get_node_line(cond);
-        semantic_error_rule(l ? l : 0, "R11-if", "Condition expression must be Boolean (got %d)", ct.kind);
+        semantic_error_rule(cc, l ? l : 0, "R11-if", "Condition expression must be Boolean (got %d)", ct.kind);
         return 0;
     }
     return 1;
 }
 
 // check while condition is boolean
-static int check_while_condition(ASTNode* whileNode, SymbolEntry* current_class, SymbolEntry* current_func) {
+static int check_while_condition(CompilerContext* cc, ASTNode* whileNode, SymbolEntry* current_class, SymbolEntry* current_func) {
     if (!whileNode) return 1;
     ASTNode* cond = NULL;
     for (ASTNode* c = whileNode->child; c; c = c->sibling) {
-        if (strcmp(c->name, "relExpr") == 0 || strcmp(c->name, "expr") == 0 || strcmp(c->name, "arithExpr") == 0) { cond = c; break; }
+        if (c->kind == AST_RELEXPR || c->kind == AST_EXPR) { cond = c; break; }
     }
     if (!cond) return 1;
-    Type ct = type_check_pass_rec(cond, current_class, current_func);
+    Type ct = type_check_expr(cc, cond, current_class, current_func);
     if (ct.kind != TYPE_INT && ct.kind != TYPE_UNKNOWN) {
         int l = get_node_line(cond);
-        semantic_error_rule(l ? l : 0, "R12-while", "Condition expression must be Boolean (got %d)", ct.kind);
+        semantic_error_rule(cc, l ? l : 0, "R12-while", "Condition expression must be Boolean (got %d)", ct.kind);
         return 0;
     }
     return 1;
 }
 
 // return expression vs enclosing function return type
-static int check_return_vs_function(ASTNode* returnNode, SymbolEntry* current_class, SymbolEntry* current_func) {
+static int check_return_vs_function(CompilerContext* cc, ASTNode* returnNode, SymbolEntry* current_class, SymbolEntry* current_func) {
     if (!returnNode) return 1;
     ASTNode* expr = find_expr_in_subtree(returnNode);
     Type exprType = make_basic_type(TYPE_UNKNOWN);
-    if (expr) exprType = type_check_pass_rec(expr, current_class, current_func);
+    if (expr) exprType = type_check_expr(cc, expr, current_class, current_func);
     if (!current_func) {
         int l = get_node_line(returnNode);
-        semantic_error_rule(l ? l : 0, "R14-return", "Return statement not inside a function");
+        semantic_error_rule(cc, l ? l : 0, "R14-return", "Return statement not inside a function");
         return 0;
     }
     if (current_func->type.kind == TYPE_VOID) {
         if (expr) {
             int l = get_node_line(expr);
-            semantic_error_rule(l ? l : 0, "R14-return", "Void function should not return a value");
+            semantic_error_rule(cc, l ? l : 0, "R14-return", "Void function should not return a value");
             return 0;
         }
     } else {
         if (!type_equal(&current_func->type, &exprType)) {
             int l = expr ? get_node_line(expr) : get_node_line(returnNode);
-            semantic_error_rule(l ? l : 0, "R14-return", "Return type mismatch (expected %d, got %d)", current_func->type.kind, exprType.kind);
+            semantic_error_rule(cc, l ? l : 0, "R14-return", "Return type mismatch (expected %d, got %d)", current_func->type.kind, exprType.kind);
             return 0;
         }
     }
@@ -1198,22 +1151,22 @@ static int check_return_vs_function(ASTNode* returnNode, SymbolEntry* current_cl
 }
 
 // function call arguments and return boolean
-static int check_functionCall_args_bool(ASTNode* callNode, SymbolEntry* current_class, SymbolEntry* current_func) {
+static int check_functionCall_args_bool(CompilerContext* cc, ASTNode* callNode, SymbolEntry* current_class, SymbolEntry* current_func) {
     if (!callNode) return 1;
     ASTNode* idnode = find_rightmost_id(callNode->child);
     if (!idnode) return 1;
-    SymbolEntry* s = st_lookup(idnode->lexeme);
+    SymbolEntry* s = st_lookup_id(cc, idnode->lexeme_id);
     if (!s) {
         int l = get_node_line(idnode);
-        semantic_error_rule(l ? l : idnode->line, "R21-call", "Undeclared function '%s'", idnode->lexeme);
+        semantic_error_rule(cc, l ? l : idnode->line, "R21-call", "Undeclared function '%s'", idnode->lexeme);
         return 0;
     }
     // count args
-    ASTNode* aparams = find_child(callNode, "aParams");
+    ASTNode* aparams = find_child(callNode, AST_APARAMS);
     int argCount = 0;
     if (aparams) {
         for (ASTNode* ch = aparams->child; ch; ch = ch->sibling) {
-            if (strcmp(ch->name, "expr") == 0 || strcmp(ch->name, "arithExpr") == 0 || strcmp(ch->name, "variable") == 0) argCount++;
+            if (ch->kind == AST_EXPR || ch->kind == AST_VARIABLE) argCount++;
         }
     }
     int paramCount = 0;
@@ -1221,7 +1174,7 @@ static int check_functionCall_args_bool(ASTNode* callNode, SymbolEntry* current_
     if (paramTypes || argCount > 0) {
         if (paramCount != argCount) {
             int l = get_node_line(callNode);
-            semantic_error_rule(l ? l : callNode->line, "R21-call", "Argument count mismatch in call to '%s' (expected %d, got %d)", s->name, paramCount, argCount);
+            semantic_error_rule(cc, l ? l : callNode->line, "R21-call", "Argument count mismatch in call to '%s' (expected %d, got %d)", s->name, paramCount, argCount);
             if (paramTypes) free(paramTypes);
             return 0;
         }
@@ -1229,12 +1182,12 @@ static int check_functionCall_args_bool(ASTNode* callNode, SymbolEntry* current_
     if (paramTypes && aparams) {
         int pidx = 0;
         for (ASTNode* ch = aparams->child; ch; ch = ch->sibling) {
-            if (!(strcmp(ch->name, "expr") == 0 || strcmp(ch->name, "arithExpr") == 0 || strcmp(ch->name, "variable") == 0)) continue;
-            Type at = type_check_pass_rec(ch, current_class, current_func);
+            if (!(ch->kind == AST_EXPR || ch->kind == AST_VARIABLE)) continue;
+            Type at = type_check_expr(cc, ch, current_class, current_func);
             if (pidx < paramCount) {
                 if (!type_equal(&at, &paramTypes[pidx])) {
                     int line = get_node_line(ch);
-                    semantic_error_rule(line ? line : ch->line, "R21-call", "Argument type mismatch in call to '%s' for parameter %d (expected %d, got %d)", s->name, pidx+1, paramTypes[pidx].kind, at.kind);
+                    semantic_error_rule(cc, line ? line : ch->line, "R21-call", "Argument type mismatch in call to '%s' for parameter %d (expected %d, got %d)", s->name, pidx+1, paramTypes[pidx].kind, at.kind);
                     free(paramTypes);
                     return 0;
                 }
@@ -1247,38 +1200,38 @@ static int check_functionCall_args_bool(ASTNode* callNode, SymbolEntry* current_
 }
 
 // semantic analyzer driver function == starts semantic analysis ========================
-void run_semantic(ASTNode* root) {
-    g_root = root;
-    st_init();
+void run_semantic(CompilerContext* cc, ASTNode* root) {
+    cc->g_root = root;
+    st_init(cc);
 
     #if defined(_WIN32) || defined(_WIN64)
-    _mkdir("files");
+    _mkdir(cc->output_dir);
     #else
-    mkdir("files", 0755);
+    mkdir(cc->output_dir, 0755);
     #endif
     
-    errf = fopen("files/semantic_errors.txt", "w");
-    if (!errf) {
+    cc->errf = compiler_open_output(cc, "semantic_errors.txt", "w");
+    if (!cc->errf) {
         fprintf(stderr, "Warning: cannot open files/semantic_errors.txt for writing\n");
     }
 
     // declaration_pass: builds symbol table *===========
-    declaration_pass(root);
+    declaration_pass(cc, root);
 
     // resolution_pass: checks the semantics *===========
-    resolution_pass_rec(root, NULL, NULL);
+    resolution_pass(cc, root);
 
-    st_compute_all_frame_layouts();
+    st_compute_all_frame_layouts(cc);
 
     
-    if (errf) { fclose(errf); errf = NULL; }
+    if (cc->errf) { fclose(cc->errf); cc->errf = NULL; }
 
-    st_write_file("files/symbol_table.txt");
-    type_check_pass(root);
+    st_write_file(cc, "symbol_table.txt");
+    type_check_pass(cc, root);
 
     /* check whether any semantic errors were written. */
     int has_errors = 0;
-    FILE* ef = fopen("files/semantic_errors.txt", "r");
+    FILE* ef = compiler_open_output(cc, "semantic_errors.txt", "r");
     if (ef) {
         if (fseek(ef, 0, SEEK_END) == 0) {
             long sz = ftell(ef);
@@ -1290,10 +1243,14 @@ void run_semantic(ASTNode* root) {
     if (has_errors) {
         fprintf(stderr, "[SEMANTIC: UPDATE]: Semantic errors found; check files/semantic_errors.txt to resolve.\n");
         fprintf(stderr, "[SEMANTIC: UPDATE]: Proceeding with code generation for testing purposes.\n");
-        return 0;  // test
+        return;
+    } else if (cc->syntax_error_count > 0) {
+        // the tree is missing whatever recovery skipped
+        printf("[SEMANTIC: UPDATE]: No semantic errors in the partial tree; no code generation after syntax errors.\n");
+        return;
     } else {
         printf("[SEMANTIC: UPDATE]: No semantic errors. AST and symbol table ready for intermediate code generation.\n");
     }
-    generate_ir(root);
+    generate_ir(cc, root);
 
 }
@@ -5,6 +5,6 @@
 
 // run_semantic returns 1 if semantic analysis succeeded with no errors,
 // or 0 if semantic errors were found (check files/semantic_errors.txt).
-int run_semantic(ASTNode* root);
+int run_semantic(struct CompilerContext* cc, ASTNode* root);
 
 #endif
@@ -0,0 +1,354 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "server.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+
+int server_run(const char* socket_path, int tree_format) {
+    (void)tree_format;
+    printf("Error:: --serve=%s needs Unix domain sockets, which this build does not have\n", socket_path);
+    return 1;
+}
+
+#else
+
+#include <errno.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "compiler.h"
+#include "source.h"
+
+#define SERVER_HEADER_MAX 4096
+#define SERVER_SOURCE_MAX (256u * 1024 * 1024)  // larger sources are refused, not buffered
+#define SERVER_ARTIFACT_MAX 8
+
+typedef enum {
+    ARTIFACT_ERRORS,
+    ARTIFACT_QUADS,
+    ARTIFACT_ISA2
+} Artifact;
+
+static const char* artifact_name[] = { "errors", "quads", "isa2" };
+
+// ====== connection I/O ==================================================
+typedef struct {
+    int fd;
+    char in[64 * 1024];
+    size_t start, end;      // unread bytes of in
+    char* out;              // the reply being built, sent in one go
+    size_t out_used, out_cap;
+    int out_failed;         // out of memory building the reply: the connection is dropped
+} Connection;
+
+static int conn_fill(Connection* c) {
+    if (c->start > 0) {
+        memmove(c->in, c->in + c->start, c->end - c->start);
+        c->end -= c->start;
+        c->start = 0;
+    }
+    ssize_t n;
+    do {
+        n = read(c->fd, c->in + c->end, sizeof(c->in) - c->end);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) return 0;
+    c->end += (size_t)n;
+    return 1;
+}
+
+// the next line without its '\n'; 0 at the end of the connection or for a
+// line that does not fit
+static int conn_line(Connection* c, char* line, size_t size) {
+    for (;;) {
+        char* nl = (char*)memchr(c->in + c->start, '\n', c->end - c->start);
+        if (nl) {
+            size_t n = (size_t)(nl - (c->in + c->start));
+            if (n >= size) return 0;
+            memcpy(line, c->in + c->start, n);
+            line[n] = '\0';
+            c->start += n + 1;
+            return 1;
+        }
+        if (c->end - c->start >= size) return 0;
+        if (!conn_fill(c)) return 0;
+    }
+}
+
+static int conn_read(Connection* c, char* out, size_t n) {
+    while (n > 0) {
+        if (c->start == c->end && !conn_fill(c)) return 0;
+        size_t k = c->end - c->start;
+        if (k > n) k = n;
+        memcpy(out, c->in + c->start, k);
+        c->start += k;
+        out += k;
+        n -= k;
+    }
+    return 1;
+}
+
+static void reply_bytes(Connection* c, const void* p, size_t n) {
+    if (c->out_failed) return;
+    if (c->out_used + n > c->out_cap) {
+        size_t cap = c->out_cap ? c->out_cap : 64 * 1024;
+        while (c->out_used + n > cap) cap *= 2;
+        char* grown = (char*)realloc(c->out, cap);
+        if (!grown) {
+            printf("Error:: out of memory for a compile server reply\n");
+            c->out_failed = 1;
+            return;
+        }
+        c->out = grown;
+        c->out_cap = cap;
+    }
+    memcpy(c->out + c->out_used, p, n);
+    c->out_used += n;
+}
+
+static void reply_header(Connection* c, const char* name, size_t bytes) {
+    char line[64];
+    int n = snprintf(line, sizeof(line), "%s %zu\n", name, bytes);
+    reply_bytes(c, line, (size_t)n);
+}
+
+static void reply_output(Connection* c, const CompilerOutput* o) {
+    if (o && o->size) reply_bytes(c, o->data, o->size);
+}
+
+static int reply_send(Connection* c) {
+    if (c->out_failed) {
+        c->out_failed = 0;
+        c->out_used = 0;
+        return 0;
+    }
+    size_t sent = 0;
+    while (sent < c->out_used) {
+        ssize_t n = write(c->fd, c->out + sent, c->out_used - sent);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        sent += (size_t)n;
+    }
+    c->out_used = 0;
+    return 1;
+}
+
+static void reply_error(Connection* c, const char* message) {
+    reply_header(c, "error", strlen(message));
+    reply_bytes(c, message, strlen(message));
+    reply_bytes(c, "done 2\n", 7);
+}
+
+// ====== one request =====================================================
+// "errors,quads" -> the artifacts in that order; 0 for an unknown name
+static int parse_artifacts(char* list, Artifact* wanted, int* count) {
+    *count = 0;
+    for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        if (strcmp(name, "all") == 0) {
+            if (*count + 3 > SERVER_ARTIFACT_MAX) return 0;
+            wanted[(*count)++] = ARTIFACT_ERRORS;
+            wanted[(*count)++] = ARTIFACT_QUADS;
+            wanted[(*count)++] = ARTIFACT_ISA2;
+            continue;
+        }
+        int found = 0;
+        for (int a = 0; a <= ARTIFACT_ISA2 && !found; a++) {
+            if (strcmp(name, artifact_name[a]) != 0) continue;
+            if (*count == SERVER_ARTIFACT_MAX) return 0;
+            wanted[(*count)++] = (Artifact)a;
+            found = 1;
+        }
+        if (!found) return 0;
+    }
+    return *count > 0;
+}
+
+// the whole pipeline on cc, reset first; returns the command line's exit code
+static int compile_request(CompilerContext* cc, char* data, size_t length) {
+    jmp_buf abort_point;
+    compiler_reset(cc);
+    cc->abort_point = &abort_point;
+    if (setjmp(abort_point) != 0) {
+        // the parser left mid-stream: a --pipeline lexer thread runs to the
+        // end and gives the flex scanner back before the next request
+        tokens_drain(cc, &cc->token_stream);
+        cc->abort_point = NULL;
+        return cc->exit_status;
+    }
+    compiler_run(cc, data, length);
+    cc->abort_point = NULL;
+    return cc->syntax_error_count > 0;
+}
+
+static void reply_artifacts(Connection* c, CompilerContext* cc, const Artifact* wanted, int count, int status) {
+    for (int i = 0; i < count; i++) {
+        switch (wanted[i]) {
+        case ARTIFACT_ERRORS: {
+            const CompilerOutput* syntax = compiler_output(cc, "syntax_errors.txt");
+            const CompilerOutput* semantic = compiler_output(cc, "semantic_errors.txt");
+            reply_header(c, "errors", (syntax ? syntax->size : 0) + (semantic ? semantic->size : 0));
+            reply_output(c, syntax);
+            reply_output(c, semantic);
+            break;
+        }
+        case ARTIFACT_QUADS: {
+            const CompilerOutput* o = compiler_output(cc, "quads.txt");
+            reply_header(c, "quads", o ? o->size : 0);
+            reply_output(c, o);
+            break;
+        }
+        case ARTIFACT_ISA2: {
+            const CompilerOutput* o = compiler_output(cc, "object_code.txt");
+            reply_header(c, "isa2", o ? o->size : 0);
+            reply_output(c, o);
+            break;
+        }
+        }
+    }
+    char line[32];
+    int n = snprintf(line, sizeof(line), "done %d\n", status);
+    reply_bytes(c, line, (size_t)n);
+}
+
+// source text is read into text, which keeps the SOURCE_PADDING zero bytes
+// the scanners need after it; returns 0 once the connection is done (a
+// refused source is not read, so the connection cannot go on after it)
+static int serve_request(Connection* c, CompilerContext* cc, char** text, size_t* text_cap, int* quit) {
+    char header[SERVER_HEADER_MAX];
+    if (!conn_line(c, header, sizeof(header))) return 0;
+
+    if (strcmp(header, "quit") == 0) {
+        *quit = 1;
+        reply_bytes(c, "done 0\n", 7);
+        reply_send(c);
+        return 0;
+    }
+
+    char* kind = header;
+    char* list = strchr(kind, ' ');
+    char* arg = list ? strchr(list + 1, ' ') : NULL;
+    if (!arg) {
+        reply_error(c, "expected 'source ARTIFACTS BYTES', 'path ARTIFACTS FILE' or 'quit'");
+        return reply_send(c);
+    }
+    *list++ = '\0';
+    *arg++ = '\0';
+    Artifact wanted[SERVER_ARTIFACT_MAX];
+    int count;
+    if (!parse_artifacts(list, wanted, &count)) {
+        reply_error(c, "artifacts are a comma list of errors, quads, isa2 or all");
+        return reply_send(c);
+    }
+
+    int status;
+    if (strcmp(kind, "source") == 0) {
+        char* end;
+        unsigned long long length = strtoull(arg, &end, 10);
+        if (*end || end == arg || arg[0] == '-') {
+            reply_error(c, "source needs its length in bytes");
+            return reply_send(c);
+        }
+        if (length > SERVER_SOURCE_MAX) {
+            reply_error(c, "source is larger than the server accepts");
+            reply_send(c);
+            return 0;
+        }
+        if (length + SOURCE_PADDING > *text_cap) {
+            free(*text);
+            *text = (char*)malloc((size_t)length + SOURCE_PADDING);
+            *text_cap = *text ? (size_t)length + SOURCE_PADDING : 0;
+            if (!*text) {
+                reply_error(c, "out of memory for the source");
+                reply_send(c);
+                return 0;
+            }
+        }
+        if (!conn_read(c, *text, (size_t)length)) return 0;
+        memset(*text + length, 0, SOURCE_PADDING);
+        status = compile_request(cc, *text, (size_t)length);
+    } else if (strcmp(kind, "path") == 0) {
+        SourceBuffer src = {0};
+        if (source_open(&src, arg) != 0) {
+            char message[SERVER_HEADER_MAX + 32];
+            snprintf(message, sizeof(message), "cannot read source %s", arg);
+            reply_error(c, message);
+            return reply_send(c);
+        }
+        status = compile_request(cc, src.data, src.length);
+        source_close(&src);
+    } else {
+        reply_error(c, "expected 'source ARTIFACTS BYTES', 'path ARTIFACTS FILE' or 'quit'");
+        return reply_send(c);
+    }
+
+    reply_artifacts(c, cc, wanted, count, status);
+    return reply_send(c);
+}
+
+// ====== the server loop =================================================
+int server_run(const char* socket_path, int tree_format) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+        printf("Error:: socket path %s is too long\n", socket_path);
+        return 1;
+    }
+    strcpy(addr.sun_path, socket_path);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        printf("Error:: Cannot create a socket: %s\n", strerror(errno));
+        return 1;
+    }
+    unlink(socket_path);    // left over from a server that did not shut down
+    if (bind(listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 16) != 0) {
+        printf("Error:: Cannot listen on %s: %s\n", socket_path, strerror(errno));
+        close(listener);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);   // a client going away must not end the server
+    printf("Compile server listening on %s\n", socket_path);
+    fflush(stdout);
+
+    CompilerContext* cc = compiler_create("files");
+    cc->outputs_in_memory = 1;
+    cc->tree_format = tree_format;
+    Connection* c = (Connection*)calloc(1, sizeof(Connection));
+    char* text = NULL;
+    size_t text_cap = 0;
+    int quit = 0;
+    unsigned long requests = 0;
+    if (!c) {
+        printf("Error:: out of memory for a compile server connection\n");
+        exit(1);
+    }
+
+    while (!quit) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            printf("Error:: accept on %s failed: %s\n", socket_path, strerror(errno));
+            break;
+        }
+        c->fd = fd;
+        c->start = c->end = 0;
+        c->out_used = 0;
+        while (serve_request(c, cc, &text, &text_cap, &quit)) requests++;
+        close(fd);
+        fflush(stdout);
+    }
+
+    printf("Compile server stopped after %lu request(s)\n", requests);
+    compiler_free(cc);
+    free(c->out);
+    free(c);
+    free(text);
+    close(listener);
+    unlink(socket_path);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+// ====== compile server (--serve=SOCKET) =================================
+// One process listens on a Unix domain socket and compiles request after
+// request with the same CompilerContext: between requests compiler_reset
+// drops what the last one built (the tree arena keeps its blocks), output
+// files stay in memory, and a parser that gives up returns to the server
+// through compiler_exit instead of ending the process. Connections are
+// served one at a time; a connection may carry any number of requests.
+// Syntax trees are written in tree_format (--tree, tree_writer.h).
+//
+// request, one header line (artifacts: a comma list of errors, quads, isa2,
+// or all):
+//   source ARTIFACTS BYTES\n   followed by BYTES bytes of program text (at most
+//                              256 MB; a larger source is refused with an
+//                              error and the connection is closed)
+//   path ARTIFACTS FILE\n      the rest of the line is the source path
+//   quit\n                     stop the server once the reply is sent
+// reply, per requested artifact in the order asked for:
+//   NAME BYTES\n               followed by BYTES bytes (0 if not produced)
+// then
+//   done STATUS\n              the exit code the command line would give
+//                              (0, or 1 after syntax errors), 2 for a bad
+//                              request, whose message comes as "error"
+// errors is syntax_errors.txt followed by semantic_errors.txt, quads is
+// quads.txt and isa2 is object_code.txt.
+int server_run(const char* socket_path, int tree_format);
+
+#endif
@@ -0,0 +1,579 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simd_scan.h"
+#include "symbols.h"
+#include "y.tab.h"
+#include "compiler.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define SCAN_SSE2
+#endif
+#if defined(SCAN_SSE2) && defined(__GNUC__)
+    #include <immintrin.h>
+    #define SCAN_AVX2
+    #define SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(__GNUC__)
+    #define SCAN_CTZ(x) __builtin_ctz(x)
+#else
+    #include <intrin.h>
+    static int SCAN_CTZ(unsigned int x) { unsigned long i; _BitScanForward(&i, x); return (int)i; }
+#endif
+
+// byte classes the scanner skips over in bulk
+enum {
+    CLASS_BLANK,    // [ \t]
+    CLASS_WORD,     // [a-zA-Z0-9_]
+    CLASS_DIGIT,    // [0-9]
+    CLASS_NEWLINE,  // \n
+    CLASS_COMMENT   // bytes that matter inside /* */: * / \n
+};
+
+static int in_class(unsigned char c, int cls) {
+    switch (cls) {
+        case CLASS_BLANK:   return c == ' ' || c == '\t';
+        case CLASS_WORD:    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        case CLASS_DIGIT:   return c >= '0' && c <= '9';
+        case CLASS_NEWLINE: return c == '\n';
+        default:            return c == '*' || c == '/' || c == '\n';
+    }
+}
+
+// ====== scalar fallback =================================================
+// number of leading bytes in p[0..n) whose membership in cls equals want
+static size_t run_scalar(const char* p, size_t n, int cls, int want) {
+    size_t i = 0;
+    while (i < n && in_class((unsigned char)p[i], cls) == want) i++;
+    return i;
+}
+
+// ====== SSE2: 16 bytes per step =========================================
+#ifdef SCAN_SSE2
+static inline unsigned int class_mask16(const char* p, int cls) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    __m128i m;
+    switch (cls) {
+        case CLASS_BLANK:
+            m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+            break;
+        case CLASS_WORD: {
+            // signed compares: bytes >= 0x80 are negative and fall outside every range
+            __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+            __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+            m = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+            break;
+        }
+        case CLASS_DIGIT:
+            m = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+            break;
+        case CLASS_NEWLINE:
+            m = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+            break;
+        default:
+            m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('*')), _mm_cmpeq_epi8(v, _mm_set1_epi8('/'))),
+                             _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+            break;
+    }
+    return (unsigned int)_mm_movemask_epi8(m);
+}
+
+static size_t run_sse2(const char* p, size_t n, int cls, int want) {
+    for (size_t i = 0; i < n; i += 16) {
+        unsigned int m = class_mask16(p + i, cls);
+        unsigned int stop = want ? (~m & 0xFFFFu) : m;
+        if (stop) {
+            size_t at = i + (size_t)SCAN_CTZ(stop);
+            return at < n ? at : n;
+        }
+    }
+    return n;
+}
+#endif
+
+// ====== AVX2: 32 bytes per step =========================================
+#ifdef SCAN_AVX2
+SCAN_TARGET_AVX2
+static inline unsigned int class_mask32(const char* p, int cls) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)p);
+    __m256i m;
+    switch (cls) {
+        case CLASS_BLANK:
+            m = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')));
+            break;
+        case CLASS_WORD: {
+            __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+            __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+            m = _mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+            break;
+        }
+        case CLASS_DIGIT:
+            m = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), v));
+            break;
+        case CLASS_NEWLINE:
+            m = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+            break;
+        default:
+            m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('*')), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('/'))),
+                                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+            break;
+    }
+    return (unsigned int)_mm256_movemask_epi8(m);
+}
+
+SCAN_TARGET_AVX2
+static size_t run_avx2(const char* p, size_t n, int cls, int want) {
+    for (size_t i = 0; i < n; i += 32) {
+        unsigned int m = class_mask32(p + i, cls);
+        unsigned int stop = want ? ~m : m;
+        if (stop) {
+            size_t at = i + (size_t)SCAN_CTZ(stop);
+            return at < n ? at : n;
+        }
+    }
+    return n;
+}
+#endif
+
+// ====== pick the widest run routine the CPU supports ====================
+static int scan_width = -1;
+
+int simd_scan_width() {
+    if (scan_width < 0) {
+        scan_width = 0;
+#ifdef SCAN_SSE2
+        scan_width = 16;
+#endif
+#ifdef SCAN_AVX2
+        if (__builtin_cpu_supports("avx2")) scan_width = 32;
+#endif
+    }
+    return scan_width;
+}
+
+static size_t run(const char* p, size_t n, int cls, int want) {
+#ifdef SCAN_AVX2
+    if (scan_width == 32) return run_avx2(p, n, cls, want);
+#endif
+#ifdef SCAN_SSE2
+    if (scan_width == 16) return run_sse2(p, n, cls, want);
+#endif
+    return run_scalar(p, n, cls, want);
+}
+
+#define SPAN(p, n, cls) run((p), (n), (cls), 1)   // length of the run of cls bytes
+#define FIND(p, n, cls) run((p), (n), (cls), 0)   // distance to the first cls byte
+
+// ====== keywords (same set as the literal rules in tma3.l) ==============
+typedef struct {
+    const char* text;
+    int length;
+    int kind;
+} Keyword;
+
+static const Keyword keywords[] = {
+    {"EXIT", 4, EXIT}, {"PRINT_SYMBOLS", 13, PRINT_SYMBOLS},
+    {"or", 2, OR}, {"and", 3, AND}, {"not", 3, NOT},
+    {"else", 4, ELSE}, {"float", 5, FLOAT}, {"func", 4, FUNC}, {"if", 2, IF},
+    {"implement", 9, IMPLEMENT}, {"class", 5, CLASS}, {"attribute", 9, ATTRIBUTE},
+    {"integer", 7, INTEGER}, {"isa", 3, ISA}, {"private", 7, PRIVATE}, {"public", 6, PUBLIC},
+    {"read", 4, READ}, {"return", 6, RETURN}, {"self", 4, SELF}, {"construct", 9, CONSTRUCT},
+    {"then", 4, THEN}, {"local", 5, LOCAL}, {"void", 4, VOID}, {"while", 5, WHILE},
+    {"write", 5, WRITE}
+};
+
+static int keyword_kind(const char* p, size_t n) {
+    for (size_t k = 0; k < sizeof(keywords) / sizeof(keywords[0]); k++) {
+        if ((size_t)keywords[k].length == n && memcmp(keywords[k].text, p, n) == 0) return keywords[k].kind;
+    }
+    return 0;
+}
+
+// ====== numbers =========================================================
+// longest match of {integer} = [1-9][0-9]*|0
+static size_t integer_len(const char* p, size_t n) {
+    if (n == 0 || p[0] < '0' || p[0] > '9') return 0;
+    if (p[0] == '0') return 1;
+    return 1 + SPAN(p + 1, n - 1, CLASS_DIGIT);
+}
+
+static size_t exponent_len(const char* p, size_t n) {
+    // ([e][+-]?{integer})?
+    if (n == 0 || p[0] != 'e') return 0;
+    size_t i = 1;
+    if (i < n && (p[i] == '+' || p[i] == '-')) i++;
+    size_t k = integer_len(p + i, n - i);
+    return k ? i + k : 0;
+}
+
+// longest match of {float} = {integer}{fraction}([e][+-]?{integer})? with
+// {fraction} = [1-9]*|0\.[0-9]*[1-9]|\.0 ; the integer part may end anywhere
+// inside its digit run, so every split is tried just like the flex DFA does
+static size_t float_len(const char* p, size_t n) {
+    size_t int_max = integer_len(p, n);
+    size_t best = 0;
+    for (size_t ie = 1; ie <= int_max; ie++) {
+        const char* f = p + ie;
+        size_t fn = n - ie;
+
+        // [1-9]* : any prefix of the nonzero run
+        size_t nz = 0;
+        while (nz < fn && f[nz] >= '1' && f[nz] <= '9') nz++;
+        for (size_t k = 0; k <= nz; k++) {
+            size_t end = ie + k;
+            size_t e = exponent_len(p + end, n - end);
+            if (end + e > best) best = end + e;
+        }
+        // 0\.[0-9]*[1-9] : every stop after a nonzero digit
+        if (fn >= 3 && f[0] == '0' && f[1] == '.') {
+            for (size_t k = 2; k < fn && f[k] >= '0' && f[k] <= '9'; k++) {
+                if (f[k] == '0') continue;
+                size_t end = ie + k + 1;
+                size_t e = exponent_len(p + end, n - end);
+                if (end + e > best) best = end + e;
+            }
+        }
+        // \.0
+        if (fn >= 2 && f[0] == '.' && f[1] == '0') {
+            size_t end = ie + 2;
+            size_t e = exponent_len(p + end, n - end);
+            if (end + e > best) best = end + e;
+        }
+    }
+    return best;
+}
+
+// ====== one chunk of the source =========================================
+// Chunks start right after a newline, so the only lexer state that can cross
+// a boundary is an open /* */ comment (its nesting depth). Lines are counted
+// from 0 inside a chunk and rebased when the chunks are stitched together.
+typedef struct {
+    size_t begin;
+    size_t end;
+    int start_depth;        // comment depth the chunk was scanned with
+    int end_depth;          // comment depth left open at end
+    int comment_line;       // relative line of that open comment, -1 if opened before begin
+    int lines;              // newlines in [begin, end)
+    TokenVector tokens;
+    size_t* unknown;        // offsets of bytes no rule matches, reported in order
+    int unknown_count;
+    int unknown_cap;
+} ScanChunk;
+
+static void push(TokenVector* v, int kind, size_t offset, size_t length, int line) {
+    LexToken tok;
+    tok.kind = kind;
+    tok.offset = (int)offset;
+    tok.length = (int)length;
+    tok.line = line;
+    tok.id = INTERN_NONE;   // filled in by intern_tokens() once the stream is in order
+    tokens_push(v, tok);
+}
+
+static void note_unknown(ScanChunk* c, size_t offset) {
+    if (c->unknown_count >= c->unknown_cap) {
+        c->unknown_cap = c->unknown_cap ? c->unknown_cap * 2 : 16;
+        c->unknown = (size_t*)realloc(c->unknown, sizeof(size_t) * c->unknown_cap);
+        if (!c->unknown) {
+            printf("Error:: out of memory in scanner\n");
+            exit(1);
+        }
+    }
+    c->unknown[c->unknown_count++] = offset;
+}
+
+static void scan_chunk(const char* src, ScanChunk* c, int start_depth) {
+    size_t i = c->begin;
+    size_t end = c->end;
+    int line = 0;
+    int depth = start_depth;
+    int comment_line = -1;
+
+    c->start_depth = start_depth;
+    c->tokens.count = 0;
+    c->unknown_count = 0;
+
+    while (i < end) {
+        // inside /* */: jump from one * / \n to the next
+        if (depth > 0) {
+            i += FIND(src + i, end - i, CLASS_COMMENT);
+            if (i >= end) break;
+            if (src[i] == '\n') {
+                line++;
+                i++;
+            } else if (src[i] == '*' && src[i + 1] == '/') {
+                depth--;
+                i += 2;
+            } else if (src[i] == '/' && src[i + 1] == '*') {
+                if (lex_nested_comments) depth++;
+                i += 2;
+            } else {
+                i++;
+            }
+            continue;
+        }
+
+        unsigned char c0 = (unsigned char)src[i];
+        const char* p = src + i;
+        size_t rest = end - i;
+
+        if (c0 == ' ' || c0 == '\t') {
+            i += SPAN(p, rest, CLASS_BLANK);
+            continue;
+        }
+        if (c0 == '\n') {
+            line++;
+            i++;
+            continue;
+        }
+
+        // identifiers, keywords, EXIT / PRINT_SYMBOLS
+        if ((c0 >= 'a' && c0 <= 'z') || (c0 >= 'A' && c0 <= 'Z')) {
+            size_t n = 1 + SPAN(p + 1, rest - 1, CLASS_WORD);
+            int kind = keyword_kind(p, n);
+            push(&c->tokens, kind ? kind : ID, i, n, line);
+            i += n;
+            continue;
+        }
+
+        // {integer} wins a tie with {float}, as it is listed first in tma3.l
+        if (c0 >= '0' && c0 <= '9') {
+            size_t in = integer_len(p, rest);
+            size_t fl = float_len(p, rest);
+            if (fl > in) {
+                push(&c->tokens, FLOAT_LITERAL, i, fl, line);
+                i += fl;
+            } else {
+                push(&c->tokens, INTEGER_LITERAL, i, in, line);
+                i += in;
+            }
+            continue;
+        }
+
+        if (c0 == '_') {
+            push(&c->tokens, ALPHANUM, i, 1, line);
+            i++;
+            continue;
+        }
+
+        // comments
+        if (c0 == '/' && p[1] == '/') {
+            i += 2;
+            i += FIND(src + i, end - i, CLASS_NEWLINE);
+            continue;
+        }
+        if (c0 == '/' && p[1] == '*') {
+            depth = 1;
+            comment_line = line;
+            i += 2;
+            continue;
+        }
+
+        // punctuation and operators
+        int kind = 0;
+        size_t n = 1;
+        switch (c0) {
+            case ';': kind = SEMICOLON; break;
+            case ',': kind = COMMA; break;
+            case '(': kind = LEFTPAREN; break;
+            case ')': kind = RIGHTPAREN; break;
+            case '{': kind = LEFTBRACE; break;
+            case '}': kind = RIGHTBRACE; break;
+            case '[': kind = LEFTBRACKET; break;
+            case ']': kind = RIGHTBRACKET; break;
+            case '.': kind = DOT; break;
+            case '+': kind = PLUS; break;
+            case '-': kind = MINUS; break;
+            case '*': kind = MULTIPLY; break;
+            case '/': kind = DIVIDE; break;
+            case ':':
+                if (p[1] == '=') { kind = ASSIGN; n = 2; } else kind = COLON;
+                break;
+            case '<':
+                if (p[1] == '=') { kind = LOEQ; n = 2; }
+                else if (p[1] == '>') { kind = NEQ; n = 2; }
+                else kind = LESS;
+                break;
+            case '>':
+                if (p[1] == '=') { kind = GOEQ; n = 2; } else kind = ASSIGN;  // tma3.l maps ">" to ASSIGN
+                break;
+            case '=':
+                if (p[1] == '>') { kind = ARROW; n = 2; }
+                break;
+        }
+        if (kind) {
+            push(&c->tokens, kind, i, n, line);
+        } else {
+            note_unknown(c, i);
+        }
+        i += n;
+    }
+
+    c->end_depth = depth;
+    c->comment_line = comment_line;
+    c->lines = line;
+}
+
+// ====== worker threads ==================================================
+typedef struct {
+    const char* src;
+    ScanChunk* chunk;
+} ScanJob;
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+typedef HANDLE ScanThread;
+
+int simd_scan_cpu_count() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+
+static DWORD WINAPI scan_worker(LPVOID arg) {
+    ScanJob* job = (ScanJob*)arg;
+    scan_chunk(job->src, job->chunk, 0);
+    return 0;
+}
+
+static int scan_thread_start(ScanThread* t, ScanJob* job) {
+    *t = CreateThread(NULL, 0, scan_worker, job, 0, NULL);
+    return *t ? 0 : -1;
+}
+
+static void scan_thread_join(ScanThread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+#else
+#include <pthread.h>
+#include <unistd.h>
+typedef pthread_t ScanThread;
+
+int simd_scan_cpu_count() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+static void* scan_worker(void* arg) {
+    ScanJob* job = (ScanJob*)arg;
+    scan_chunk(job->src, job->chunk, 0);
+    return NULL;
+}
+
+static int scan_thread_start(ScanThread* t, ScanJob* job) {
+    return pthread_create(t, NULL, scan_worker, job);
+}
+
+static void scan_thread_join(ScanThread t) {
+    pthread_join(t, NULL);
+}
+#endif
+
+int simd_scan_all(CompilerContext* cc, TokenVector* v, const char* src, size_t len, int threads) {
+    simd_scan_width();
+
+    // split at newlines into at most `threads` chunks of at least SIMD_SCAN_MIN_CHUNK bytes
+    int n = (threads > 1) ? threads : 1;
+    if ((size_t)n > len / SIMD_SCAN_MIN_CHUNK) n = (int)(len / SIMD_SCAN_MIN_CHUNK);
+    if (n < 1) n = 1;
+
+    ScanChunk* chunks = (ScanChunk*)calloc(n, sizeof(ScanChunk));
+    if (!chunks) {
+        printf("Error:: out of memory in scanner\n");
+        exit(1);
+    }
+    int count = 0;
+    size_t begin = 0;
+    for (int k = 0; k < n && begin < len; k++) {
+        size_t end = len;
+        if (k < n - 1) {
+            const char* nl = memchr(src + len * (k + 1) / n, '\n', len - len * (k + 1) / n);
+            end = nl ? (size_t)(nl - src) + 1 : len;
+            if (end <= begin) continue;
+        }
+        chunks[count].begin = begin;
+        chunks[count].end = end;
+        tokens_init(&chunks[count].tokens);
+        count++;
+        begin = end;
+    }
+
+    if (count == 1) {
+        scan_chunk(src, &chunks[0], 0);
+    } else if (count > 1) {
+        ScanJob* jobs = (ScanJob*)malloc(sizeof(ScanJob) * count);
+        ScanThread* pool = (ScanThread*)malloc(sizeof(ScanThread) * count);
+        int* started = (int*)calloc(count, sizeof(int));
+        if (!jobs || !pool || !started) {
+            printf("Error:: out of memory in scanner\n");
+            exit(1);
+        }
+        // chunk 0 runs here; a chunk whose thread fails to start is scanned in the fix-up pass
+        for (int k = 1; k < count; k++) {
+            jobs[k].src = src;
+            jobs[k].chunk = &chunks[k];
+            started[k] = (scan_thread_start(&pool[k], &jobs[k]) == 0);
+        }
+        scan_chunk(src, &chunks[0], 0);
+        for (int k = 1; k < count; k++) {
+            if (started[k]) scan_thread_join(pool[k]);
+            else scan_chunk(src, &chunks[k], 0);
+        }
+        free(started);
+        free(pool);
+        free(jobs);
+    }
+
+    // fix-up: each chunk was scanned assuming no comment was open at its start;
+    // rescan (serially) only the ones where that guess was wrong
+    for (int k = 1; k < count; k++) {
+        if (chunks[k].start_depth != chunks[k - 1].end_depth) {
+            scan_chunk(src, &chunks[k], chunks[k - 1].end_depth);
+        }
+    }
+
+    // stitch, rebasing line numbers, then report unmatched bytes in source order
+    int line = 1;
+    int open_comment_line = 0;
+    int first = v->count;
+    for (int k = 0; k < count; k++) {
+        ScanChunk* c = &chunks[k];
+        for (int t = 0; t < c->tokens.count; t++) {
+            LexToken tok = c->tokens.data[t];
+            tok.line += line;
+            tokens_push(v, tok);
+        }
+        for (int u = 0; u < c->unknown_count; u++) {
+            char ch = src[c->unknown[u]];
+            printf("Your input does not match for any lexemes defined in this language!\nUnknown character: %c (ASCII: %d)\n", ch, (int)ch);
+            cc->lex_errors++;
+        }
+        if (c->end_depth > 0 && c->comment_line >= 0) open_comment_line = line + c->comment_line;
+        line += c->lines;
+    }
+    if (count > 0 && chunks[count - 1].end_depth > 0) {
+        printf("Unterminated comment starting at line %d\n", open_comment_line);
+        cc->lex_errors++;
+    }
+    tokens_intern(cc, v, src, first);
+
+    LexToken eof;
+    eof.kind = 0;
+    eof.offset = (int)len;
+    eof.length = 0;
+    eof.line = line;
+    eof.id = INTERN_NONE;
+    tokens_push(v, eof);
+
+    for (int k = 0; k < count; k++) {
+        tokens_free(&chunks[k].tokens);
+        free(chunks[k].unknown);
+    }
+    free(chunks);
+    return v->count;
+}
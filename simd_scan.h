@@ -0,0 +1,23 @@
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+#include <stddef.h>
+#include "tokens.h"
+
+// vector width used by the byte-class runs (0 = scalar, 16 = SSE2, 32 = AVX2)
+int simd_scan_width();
+
+// smallest piece of source worth handing to its own thread
+#ifndef SIMD_SCAN_MIN_CHUNK
+    #define SIMD_SCAN_MIN_CHUNK (256 * 1024)
+#endif
+
+// online processors, used when --lex-threads=0
+int simd_scan_cpu_count();
+
+// hand-written scanner that yields the same token stream as tma3.l.
+// data must be followed by SOURCE_PADDING zero bytes (see source.h).
+// threads > 1 splits the source at newlines and scans the chunks in parallel.
+int simd_scan_all(struct CompilerContext* cc, TokenVector* v, const char* data, size_t length, int threads);
+
+#endif
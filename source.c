@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "source.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+    #define SOURCE_NO_MMAP
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+static void source_reset(SourceBuffer* src) {
+    src->data = NULL;
+    src->length = 0;
+    src->map_length = 0;
+    src->mapped = 0;
+}
+
+int source_read_stream(SourceBuffer* src, FILE* in) {
+    size_t cap = 64 * 1024;
+    size_t len = 0;
+    char* buf = (char*)malloc(cap);
+    source_reset(src);
+    if (!buf) return -1;
+
+    for (;;) {
+        if (cap - len < SOURCE_PADDING + 4096) {
+            cap *= 2;
+            char* grown = (char*)realloc(buf, cap);
+            if (!grown) {
+                free(buf);
+                return -1;
+            }
+            buf = grown;
+        }
+        size_t n = fread(buf + len, 1, cap - len - SOURCE_PADDING, in);
+        if (n == 0) break;
+        len += n;
+    }
+    memset(buf + len, 0, SOURCE_PADDING);
+
+    src->data = buf;
+    src->length = len;
+    src->map_length = cap;
+    return 0;
+}
+
+// ====== memory mapped input =============================================
+#ifdef SOURCE_NO_MMAP
+
+int source_open(SourceBuffer* src, const char* path) {
+    FILE* in = fopen(path, "rb");
+    source_reset(src);
+    if (!in) return -1;
+    int rc = source_read_stream(src, in);
+    fclose(in);
+    return rc;
+}
+
+void source_close(SourceBuffer* src) {
+    free(src->data);
+    source_reset(src);
+}
+
+#else
+
+int source_open(SourceBuffer* src, const char* path) {
+    struct stat st;
+    source_reset(src);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return -1;
+    }
+
+    size_t length = (size_t)st.st_size;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    // reserve zeroed pages for the text plus padding, then map the file over
+    // the front of it; whatever lies past EOF reads as zero
+    size_t map_length = (length + SOURCE_PADDING + page - 1) / page * page;
+
+    char* base = (char*)mmap(NULL, map_length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    if (length > 0) {
+        void* file = mmap(base, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0);
+        if (file == MAP_FAILED) {
+            munmap(base, map_length);
+            close(fd);
+            return -1;
+        }
+    }
+    close(fd);
+
+    src->data = base;
+    src->length = length;
+    src->map_length = map_length;
+    src->mapped = 1;
+    return 0;
+}
+
+void source_close(SourceBuffer* src) {
+    if (src->mapped) {
+        munmap(src->data, src->map_length);
+    } else {
+        free(src->data);
+    }
+    source_reset(src);
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// zero bytes guaranteed after the text: flex needs two NULs (yy_scan_buffer)
+// and the SIMD scanner may load a full 32-byte vector past the last byte
+#define SOURCE_PADDING 64
+
+// whole program text held in one buffer, followed by SOURCE_PADDING zero bytes
+// so it can be scanned in place and lexemes can point straight into it
+typedef struct {
+    char* data;
+    size_t length;      // bytes of program text, excluding the padding
+    size_t map_length;  // size of the mapping / allocation backing data
+    int mapped;         // 1 if data is a file mapping, 0 if heap memory
+} SourceBuffer;
+
+// map a source file read-only-private; returns 0 on success
+int source_open(SourceBuffer* src, const char* path);
+
+// slurp an already open stream (stdin) into a heap buffer; returns 0 on success
+int source_read_stream(SourceBuffer* src, FILE* in);
+
+void source_close(SourceBuffer* src);
+
+#endif
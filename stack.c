@@ -7,31 +7,28 @@
 #include <string.h>
 #include <ctype.h>
 #include "stack.h"
+#include "symbols.h"
 #include "symbol_table.h"
+#include "log.h"
+#include "compiler.h"
 
-// global variable tracking
-typedef struct VarMap {
-    char* name;
-    int address;
-    struct VarMap* next;
-} VarMap;
+// global variable tracking: static address per interned name, 0 = not allocated yet
+// (kept in the compilation, compiler.h)
 
-static VarMap* global_vars = NULL;
-static int next_global_addr = GLOBAL_BASE;
-
-void init_stack_manager() {
-    while (global_vars) {
-        VarMap* tmp = global_vars;
-        global_vars = global_vars->next;
-        free(tmp->name);
-        free(tmp);
-    }
-    global_vars = NULL;
-    next_global_addr = GLOBAL_BASE;
+void init_stack_manager(CompilerContext* cc) {
+    free(cc->global_addr);
+    cc->global_addr = NULL;
+    cc->global_addr_cap = 0;
+    cc->next_global_addr = GLOBAL_BASE;
+    cc->global_order_count = 0;
+    cc->global_order_hash = 14695981039346656037ull;
+    cc->sp_id = intern(cc, "SP");
+    cc->bp_id = intern(cc, "BP");
+    cc->ptr_id = intern(cc, "PTR");
 }
 
 // find local variables in symbol table
-int is_local_variable(const char* varName) {
+int is_local_variable(CompilerContext* cc, const char* varName) {
     if (!varName) return 0;
     
     // check for virtual registers
@@ -48,24 +45,24 @@ int is_local_variable(const char* varName) {
     }
     
     // look up in symbol table (use global search during code generation)
-    SymbolEntry* sym = st_lookup_global(varName);
+    SymbolEntry* sym = st_lookup_global(cc, varName);
     if (sym) {
-        printf(", scopeLevel=%d, kind=%d\n", sym->scopeLevel, sym->kind);
+        LOG_DEBUG(LOG_CODEGEN, ", scopeLevel=%d, kind=%d\n", sym->scopeLevel, sym->kind);
         if (sym->scopeLevel > 0 && sym->kind != SYM_CLASS) {
             return 1;
         }
     } else {
-        printf(" (NOT FOUND)\n");
+        LOG_DEBUG(LOG_CODEGEN, " (NOT FOUND)\n");
     }
     
     return 0;
 }
 
 // stack offset for local variable from symbol table
-int get_stack_offset(const char* varName) {
+int get_stack_offset(CompilerContext* cc, const char* varName) {
     if (!varName) return 0;
     
-    SymbolEntry* sym = st_lookup_global(varName);
+    SymbolEntry* sym = st_lookup_global(cc, varName);
     if (sym && sym->scopeLevel > 0 && sym->kind != SYM_CLASS) {
         return sym->offset;
     }
@@ -73,36 +70,61 @@ int get_stack_offset(const char* varName) {
     return 0;
 }
 
+// addresses are handed out in first-use order, so the log (and its hash)
+// says everything about the address map; see func_cache.c
+static void record_global(CompilerContext* cc, int nameId) {
+    if (cc->global_order_count == cc->global_order_cap) {
+        cc->global_order_cap = cc->global_order_cap ? cc->global_order_cap * 2 : 256;
+        cc->global_order = realloc(cc->global_order, sizeof(int) * cc->global_order_cap);
+        if (!cc->global_order) {
+            printf("Error:: out of memory for global addresses\n");
+            exit(1);
+        }
+    }
+    cc->global_order[cc->global_order_count++] = nameId;
+    for (const char* p = intern_name(cc, nameId); ; p++) {
+        cc->global_order_hash ^= (unsigned char)*p;
+        cc->global_order_hash *= 1099511628211ull;
+        if (!*p) break;
+    }
+}
+
 // get variable location
-int get_variable_location(const char* varName) {
+int get_variable_location(CompilerContext* cc, const char* varName) {
     if (!varName) return 0;
+    return get_variable_location_id(cc, intern(cc, varName));
+}
+
+int get_variable_location_id(CompilerContext* cc, int nameId) {
+    if (nameId == INTERN_NONE) return 0;
     
     //registers have fixed addresses
-    if (strcmp(varName, "SP") == 0) return VREG_SP;
-    if (strcmp(varName, "BP") == 0) return VREG_BP;
-    if (strcmp(varName, "PTR") == 0) return VREG_PTR;
+    if (nameId == cc->sp_id) return VREG_SP;
+    if (nameId == cc->bp_id) return VREG_BP;
+    if (nameId == cc->ptr_id) return VREG_PTR;
     
+    const char* varName = intern_name(cc, nameId);
     if (isdigit(varName[0]) || (varName[0] == '-' && isdigit(varName[1]))) {
         return -1;
     }
     
-    if (is_local_variable(varName)) {
-        return get_stack_offset(varName);
+    if (is_local_variable(cc, varName)) {
+        return get_stack_offset(cc, varName);
     }
     
     // global variables static addresses
-    for (VarMap* v = global_vars; v; v = v->next) {
-        if (strcmp(v->name, varName) == 0) {
-            return v->address;
-        }
+    if (nameId >= cc->global_addr_cap) {
+        int cap = cc->global_addr_cap ? cc->global_addr_cap : 256;
+        while (cap <= nameId) cap *= 2;
+        cc->global_addr = realloc(cc->global_addr, sizeof(int) * cap);
+        memset(cc->global_addr + cc->global_addr_cap, 0, sizeof(int) * (cap - cc->global_addr_cap));
+        cc->global_addr_cap = cap;
+    }
+    if (cc->global_addr[nameId] == 0) {
+        // allocate new global address
+        cc->global_addr[nameId] = cc->next_global_addr++;
+        record_global(cc, nameId);
     }
     
-    // allocate new global address
-    VarMap* newVar = malloc(sizeof(VarMap));
-    newVar->name = strdup(varName);
-    newVar->address = next_global_addr++;
-    newVar->next = global_vars;
-    global_vars = newVar;
-    
-    return newVar->address;
+    return cc->global_addr[nameId];
 }
@@ -16,15 +16,16 @@
 #define GLOBAL_BASE 5000 
 
 // Check local variable
-int is_local_variable(const char* varName);
+int is_local_variable(struct CompilerContext* cc, const char* varName);
 
 // get offset of local variable
-int get_stack_offset(const char* varName);
+int get_stack_offset(struct CompilerContext* cc, const char* varName);
 
 // get absolute location of variable
-int get_variable_location(const char* varName);
+int get_variable_location(struct CompilerContext* cc, const char* varName);
+int get_variable_location_id(struct CompilerContext* cc, int nameId);
 
 // initialize stack manager
-void init_stack_manager();
+void init_stack_manager(struct CompilerContext* cc);
 
 #endif
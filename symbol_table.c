@@ -1,111 +1,172 @@
 #include "symbol_table.h"
+#include "symbols.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
-static Scope* current_scope = NULL;
-static Scope* all_scopes = NULL;
-static int current_level = 0;
-static int compute_layout_for_scope_ptr(Scope* target);
+#include "compiler.h"
+
+static int compute_layout_for_scope_ptr(CompilerContext* cc, Scope* target);
 
 // create and initialize a scope
-static Scope* create_scope(const char* name, int level, Scope* parent) {
+static Scope* create_scope(CompilerContext* cc, const char* name, int level, Scope* parent) {
     Scope* s = (Scope*)malloc(sizeof(Scope));
     s->level = level;
     strncpy(s->name, name, sizeof(s->name)-1);
     s->name[sizeof(s->name)-1] = '\0';
+    s->name_id = intern(cc, name);
     s->symbols = NULL;
     s->parent = parent;
-    s->nextSibling = all_scopes;
-    all_scopes = s;
+    s->nextSibling = cc->all_scopes;
+    cc->all_scopes = s;
     return s;
 }
 
-void st_init() {
-    if (current_scope) return;
-    current_scope = create_scope("<global>", 0, NULL);
-    current_level = 0;
+void st_init(CompilerContext* cc) {
+    if (cc->current_scope) return;
+    cc->current_scope = create_scope(cc, "<global>", 0, NULL);
+    cc->current_level = 0;
+}
+
+// every scope and entry goes; the types they hold live in the AST arena
+void st_free(CompilerContext* cc) {
+    while (cc->all_scopes) {
+        Scope* next = cc->all_scopes->nextSibling;
+        while (cc->all_scopes->symbols) {
+            SymbolEntry* e = cc->all_scopes->symbols->next;
+            free(cc->all_scopes->symbols);
+            cc->all_scopes->symbols = e;
+        }
+        free(cc->all_scopes);
+        cc->all_scopes = next;
+    }
+    free(cc->global_index);
+    cc->global_index = NULL;
+    cc->global_index_cap = 0;
+    cc->current_scope = NULL;
+    cc->current_level = 0;
 }
 
 // ====================================== support functions for symbol table operations ========================================
-void st_enter_scope(const char* name) {
-    if (!current_scope) st_init();
-    for (Scope* sc = all_scopes; sc; sc = sc->nextSibling) {
-        if (strcmp(sc->name, name) == 0 && sc->parent == current_scope) {
-            current_scope = sc;
-            current_level++;
+void st_enter_scope(CompilerContext* cc, const char* name) {
+    if (!cc->current_scope) st_init(cc);
+    int name_id = intern(cc, name);
+    for (Scope* sc = cc->all_scopes; sc; sc = sc->nextSibling) {
+        if (sc->name_id == name_id && sc->parent == cc->current_scope) {
+            cc->current_scope = sc;
+            cc->current_level++;
             return;
         }
     }
-    Scope* s = create_scope(name, current_level + 1, current_scope);
-    current_scope = s;
-    current_level++;
+    Scope* s = create_scope(cc, name, cc->current_level + 1, cc->current_scope);
+    cc->current_scope = s;
+    cc->current_level++;
 }
 
-void st_exit_scope() {
-    if (!current_scope) return;
-    if (current_scope->parent) current_scope = current_scope->parent;
-    if (current_level > 0) current_level--;
+void st_exit_scope(CompilerContext* cc) {
+    if (!cc->current_scope) return;
+    if (cc->current_scope->parent) cc->current_scope = cc->current_scope->parent;
+    if (cc->current_level > 0) cc->current_level--;
 }
 
-SymbolEntry* st_add_symbol(const char* name, SymbolKind kind, Type type, struct ASTNode* declNode, int line) {
-    if (!current_scope) st_init();
+SymbolEntry* st_add_symbol(CompilerContext* cc, const char* name, SymbolKind kind, Type type, struct ASTNode* declNode, int line) {
+    if (!cc->current_scope) st_init(cc);
+    int name_id = intern(cc, name);
     // check duplicate in local scope
-    for (SymbolEntry* s = current_scope->symbols; s; s = s->next) {
-        if (strcmp(s->name, name) == 0) return NULL; // duplicate
+    for (SymbolEntry* s = cc->current_scope->symbols; s; s = s->next) {
+        if (s->name_id == name_id) return NULL; // duplicate
     }
     SymbolEntry* ent = (SymbolEntry*)malloc(sizeof(SymbolEntry));
     strncpy(ent->name, name, sizeof(ent->name)-1);
     ent->name[sizeof(ent->name)-1] = '\0';
+    ent->name_id = name_id;
     ent->kind = kind;
     ent->type = type;
-    ent->scopeLevel = current_scope->level;
+    ent->scopeLevel = cc->current_scope->level;
     ent->declNode = declNode;
     ent->line = line;
     // compute and store width
-    extern size_t compute_symbol_size(const Type* t, struct ASTNode* declNode);
+    extern size_t compute_symbol_size(CompilerContext* cc, const Type* t, struct ASTNode* declNode);
     if (ent->type.kind == TYPE_ARRAY && ent->type.dimSizes) {
-        ent->width = compute_type_size(&ent->type);
+        ent->width = compute_type_size(cc, &ent->type);
     } else {
-        ent->width = compute_symbol_size(&ent->type, declNode);
+        ent->width = compute_symbol_size(cc, &ent->type, declNode);
         if (ent->width == 0) {
-            ent->width = compute_type_size(&ent->type);
+            ent->width = compute_type_size(cc, &ent->type);
         }
     }
     ent->offset = INT_MIN;
-    ent->next = current_scope->symbols;
-    current_scope->symbols = ent;
+    ent->next = cc->current_scope->symbols;
+    cc->current_scope->symbols = ent;
+    // a new entry may shadow what the index found first
+    free(cc->global_index);
+    cc->global_index = NULL;
+    cc->global_index_cap = 0;
     return ent;
 }
 
-SymbolEntry* st_lookup_local(const char* name) {
-    if (!current_scope) return NULL;
-    for (SymbolEntry* s = current_scope->symbols; s; s = s->next) {
-        if (strcmp(s->name, name) == 0) return s;
+SymbolEntry* st_lookup_local_id(CompilerContext* cc, int name_id) {
+    if (!cc->current_scope || name_id == INTERN_NONE) return NULL;
+    for (SymbolEntry* s = cc->current_scope->symbols; s; s = s->next) {
+        if (s->name_id == name_id) return s;
     }
     return NULL;
 }
 
-SymbolEntry* st_lookup(const char* name) {
-    Scope* s = current_scope;
+SymbolEntry* st_lookup_id(CompilerContext* cc, int name_id) {
+    if (name_id == INTERN_NONE) return NULL;
+    Scope* s = cc->current_scope;
     while (s) {
-        for (SymbolEntry* e = s->symbols; e; e = e->next) if (strcmp(e->name, name) == 0) return e;
+        for (SymbolEntry* e = s->symbols; e; e = e->next) if (e->name_id == name_id) return e;
         s = s->parent;
     }
     return NULL;
 }
 
 // Search all scopes (for code generation phase when current_scope may not be set correctly)
-SymbolEntry* st_lookup_global(const char* name) {
-    Scope* s = all_scopes;
+SymbolEntry* st_lookup_global_id(CompilerContext* cc, int name_id) {
+    if (name_id == INTERN_NONE) return NULL;
+    if (cc->global_index) return name_id < cc->global_index_cap ? cc->global_index[name_id] : NULL;
+    Scope* s = cc->all_scopes;
     while (s) {
         for (SymbolEntry* e = s->symbols; e; e = e->next) {
-            if (strcmp(e->name, name) == 0) return e;
+            if (e->name_id == name_id) return e;
         }
         s = s->nextSibling;
     }
     return NULL;
 }
 
+// code generation looks every operand up by name; once the table is complete
+// one pass records the entry the search above finds first for each name
+// (names interned later, like temporaries, can't have one)
+void st_index_globals(CompilerContext* cc) {
+    free(cc->global_index);
+    cc->global_index_cap = intern_count(cc);
+    cc->global_index = (SymbolEntry**)calloc(cc->global_index_cap ? cc->global_index_cap : 1, sizeof(SymbolEntry*));
+    if (!cc->global_index) {
+        printf("Error:: out of memory indexing the symbol table\n");
+        exit(1);
+    }
+    for (Scope* s = cc->all_scopes; s; s = s->nextSibling) {
+        for (SymbolEntry* e = s->symbols; e; e = e->next) {
+            if (e->name_id >= 0 && e->name_id < cc->global_index_cap && !cc->global_index[e->name_id]) cc->global_index[e->name_id] = e;
+        }
+    }
+}
+
+// string front ends: a name that was never interned cannot be declared anywhere
+SymbolEntry* st_lookup_local(CompilerContext* cc, const char* name) {
+    return st_lookup_local_id(cc, intern_find(cc, name));
+}
+
+SymbolEntry* st_lookup(CompilerContext* cc, const char* name) {
+    return st_lookup_id(cc, intern_find(cc, name));
+}
+
+SymbolEntry* st_lookup_global(CompilerContext* cc, const char* name) {
+    return st_lookup_global_id(cc, intern_find(cc, name));
+}
+
 static const char* kind_to_str(SymbolKind k) {
     switch (k) {
         case SYM_CLASS: return "class";
@@ -147,7 +208,7 @@ static size_t align_up_size(size_t v, size_t align) {
     return ((v + align - 1) / align) * align;
 }
 
-size_t compute_type_size(const Type* t) {
+size_t compute_type_size(CompilerContext* cc, const Type* t) {
     if (!t) return 0;
     switch (t->kind) {
         case TYPE_INT: return ARCH_INT_SIZE;
@@ -155,7 +216,7 @@ size_t compute_type_size(const Type* t) {
         case TYPE_VOID: return 0;
         case TYPE_ARRAY: {
             if (!t->elementType) return 0;
-            size_t elem = compute_type_size(t->elementType);
+            size_t elem = compute_type_size(cc, t->elementType);
             // dimension sizes are present, multiply them to get total element count
             if (t->dimSizes) {
                 size_t prod = 1;
@@ -170,11 +231,12 @@ size_t compute_type_size(const Type* t) {
         case TYPE_CLASS: {
             // Find a scope whose name matches the class name and sum its symbols that are attributes
             size_t total = 0;
-            for (Scope* sc = all_scopes; sc; sc = sc->nextSibling) {
-                if (strcmp(sc->name, t->name) == 0) {
+            int class_id = intern_find(cc, t->name);
+            for (Scope* sc = cc->all_scopes; sc; sc = sc->nextSibling) {
+                if (sc->name_id == class_id) {
                     for (SymbolEntry* e = sc->symbols; e; e = e->next) {
                         if (e->kind == SYM_ATTRIBUTE) {
-                            size_t w = compute_type_size(&e->type);
+                            size_t w = compute_type_size(cc, &e->type);
                             total += align_up_size(w, ARCH_ALIGN);
                         }
                     }
@@ -190,9 +252,9 @@ size_t compute_type_size(const Type* t) {
 }
 
 // =================================== calculate symbol size =====================================================================
-size_t compute_symbol_size(const Type* t, struct ASTNode* declNode) {
+size_t compute_symbol_size(CompilerContext* cc, const Type* t, struct ASTNode* declNode) {
     if (!t) return 0;
-    if (t->kind != TYPE_ARRAY) return compute_type_size(t);
+    if (t->kind != TYPE_ARRAY) return compute_type_size(cc, t);
     // find arraySizeList AST node under declNode
     if (!declNode) return 0;
     struct ASTNode* n = declNode;
@@ -204,21 +266,23 @@ size_t compute_symbol_size(const Type* t, struct ASTNode* declNode) {
         struct ASTNode* cur = stack->node;
         StackItem* next = stack->next; free(stack); stack = next;
         if (!cur) continue;
-        if (cur->name && strcmp(cur->name, "arraySizeList") == 0) { asl = cur; break; }
-        if (cur->name && strcmp(cur->name, "arraySize") == 0) { asl = cur; break; }
+        if (cur->kind == AST_ARRAYSIZELIST) { asl = cur; break; }
+        if (cur->kind == AST_ARRAYSIZE) { asl = cur; break; }
         if (cur->child) { StackItem* it = (StackItem*)malloc(sizeof(StackItem)); it->node = cur->child; it->next = stack; stack = it; }
         for (struct ASTNode* sib = cur->sibling; sib; sib = sib->sibling) { StackItem* it = (StackItem*)malloc(sizeof(StackItem)); it->node = sib; it->next = stack; stack = it; }
     }
+    // the search stops at the first size list, with the rest still stacked
+    while (stack) { StackItem* next = stack->next; free(stack); stack = next; }
     if (!asl) return 0;
     size_t total_elems = 1;
     int found_any = 0;
     // iterate over arraySize children if this is a list node
-    if (strcmp(asl->name, "arraySizeList") == 0) {
+    if (asl->kind == AST_ARRAYSIZELIST) {
         for (struct ASTNode* a = asl->child; a; a = a->sibling) {
             if (!a) continue;
-            if (strcmp(a->name, "arraySize") != 0) continue;
+            if (a->kind != AST_ARRAYSIZE) continue;
             // arraySize -> [ intLit ] | [ ]
-            if (a->child && a->child->name && strcmp(a->child->name, "intLit") == 0 && a->child->lexeme) {
+            if (a->child && a->child->kind == AST_INTLIT && a->child->lexeme) {
                 long v = atol(a->child->lexeme);
                 if (v <= 0) return 0; 
                 total_elems *= (size_t)v;
@@ -227,16 +291,16 @@ size_t compute_symbol_size(const Type* t, struct ASTNode* declNode) {
                 return 0; 
             }
         }
-    } else if (strcmp(asl->name, "arraySize") == 0) {
+    } else if (asl->kind == AST_ARRAYSIZE) {
         struct ASTNode* a = asl;
-        if (a->child && a->child->name && strcmp(a->child->name, "intLit") == 0 && a->child->lexeme) {
+        if (a->child && a->child->kind == AST_INTLIT && a->child->lexeme) {
             long v = atol(a->child->lexeme);
             if (v <= 0) return 0;
             total_elems *= (size_t)v; found_any = 1;
         } else return 0;
     }
     if (!found_any) return 0;
-    size_t elem = compute_type_size(t->elementType);
+    size_t elem = compute_type_size(cc, t->elementType);
     return elem * total_elems;
 }
 
@@ -247,7 +311,7 @@ static void compute_scope_label(Scope* sc, char* buf, size_t n) {
     // look for a parent symbol with same name
     if (sc->parent) {
         for (SymbolEntry* pe = sc->parent->symbols; pe; pe = pe->next) {
-            if (strcmp(pe->name, sc->name) == 0) {
+            if (pe->name_id == sc->name_id) {
                 if (pe->kind == SYM_CLASS) { snprintf(buf, n, "class %s", sc->name); return; }
                 if (pe->kind == SYM_FUNCTION) { snprintf(buf, n, "function %s", sc->name); return; }
             }
@@ -258,9 +322,9 @@ static void compute_scope_label(Scope* sc, char* buf, size_t n) {
 
 
 // ================================== print symbol tablev===============================================================
-void st_print(FILE* out) {
+void st_print(CompilerContext* cc, FILE* out) {
     fprintf(out, "Symbol table:\n\n");
-    for (Scope* sc = all_scopes; sc; sc = sc->nextSibling) {
+    for (Scope* sc = cc->all_scopes; sc; sc = sc->nextSibling) {
         // skip scopes with no symbols
         if (!sc->symbols) continue;
         char scope_label[128]; compute_scope_label(sc, scope_label, sizeof(scope_label));
@@ -281,12 +345,13 @@ void st_print(FILE* out) {
 }
 
 // ============================================== calculating offsets ============================================================
-int st_compute_frame_layout(const char* functionName) {
+int st_compute_frame_layout(CompilerContext* cc, const char* functionName) {
     if (!functionName) return -1;
     // find scope with matching name
     Scope* target = NULL;
-    for (Scope* sc = all_scopes; sc; sc = sc->nextSibling) {
-        if (strcmp(sc->name, functionName) == 0) { target = sc; break; }
+    int function_id = intern_find(cc, functionName);
+    for (Scope* sc = cc->all_scopes; sc; sc = sc->nextSibling) {
+        if (sc->name_id == function_id) { target = sc; break; }
     }
     if (!target) return -1;
 
@@ -303,7 +368,7 @@ int st_compute_frame_layout(const char* functionName) {
     int param_offset = 8;
     for (size_t i = 0; i < params_n; ++i) {
         SymbolEntry* p = params[i];
-        if (p->width == 0) p->width = compute_type_size(&p->type);
+        if (p->width == 0) p->width = compute_type_size(cc, &p->type);
         size_t w = align_up_size(p->width, ARCH_ALIGN);
         p->offset = param_offset;
         param_offset += (int)w;
@@ -323,7 +388,7 @@ int st_compute_frame_layout(const char* functionName) {
     int local_cursor = 0; // will grow negative
     for (size_t i = 0; i < locals_n; ++i) {
         SymbolEntry* l = locals[i];
-        if (l->width == 0) l->width = compute_type_size(&l->type);
+        if (l->width == 0) l->width = compute_type_size(cc, &l->type);
         size_t w = align_up_size(l->width, ARCH_ALIGN);
         local_cursor -= (int)w;
         l->offset = local_cursor;
@@ -348,10 +413,10 @@ int st_compute_frame_layout(const char* functionName) {
 //     }
 // }
 
-void st_write_file(const char* path) {
-    FILE* f = fopen(path, "w");
+void st_write_file(CompilerContext* cc, const char* name) {
+    FILE* f = compiler_open_output(cc, name, "w");
     if (!f) return;
-    st_print(f);
+    st_print(cc, f);
     fclose(f);
 }
 
@@ -376,7 +441,7 @@ int type_equal(const Type* a, const Type* b) {
 
 
 // =========================================== stack structure for function data ==========================================================
-static int compute_layout_for_scope_ptr(Scope* target) {
+static int compute_layout_for_scope_ptr(CompilerContext* cc, Scope* target) {
     if (!target) return -1;
 
     // --- Parameters get + offests
@@ -397,7 +462,7 @@ static int compute_layout_for_scope_ptr(Scope* target) {
         
         for (int j = 0; j < param_count; j++) {
             SymbolEntry* p = params[j];
-            if (p->width == 0) p->width = compute_type_size(&p->type);
+            if (p->width == 0) p->width = compute_type_size(cc, &p->type);
             size_t w = align_up_size(p->width, ARCH_ALIGN);
             p->offset = param_offset;
             param_offset += (int)w;
@@ -417,7 +482,7 @@ static int compute_layout_for_scope_ptr(Scope* target) {
         
         for (int j = 0; j < local_count; j++) {
             SymbolEntry* l = locals[j];
-            if (l->width == 0) l->width = compute_type_size(&l->type);
+            if (l->width == 0) l->width = compute_type_size(cc, &l->type);
             size_t w = align_up_size(l->width, ARCH_ALIGN);
             local_cursor -= (int)w;
             l->offset = local_cursor;
@@ -428,7 +493,7 @@ static int compute_layout_for_scope_ptr(Scope* target) {
 }
 
 // ============================== store class data ===================================================================
-static void compute_class_layout(Scope* target) {
+static void compute_class_layout(CompilerContext* cc, Scope* target) {
     if (!target) return;
     
     int current_offset = 0;
@@ -451,7 +516,7 @@ static void compute_class_layout(Scope* target) {
     // Assign Positive Offsets starting at 0
     for (int j = 0; j < attr_count; j++) {
         SymbolEntry* a = attrs[j];
-        if (a->width == 0) a->width = compute_type_size(&a->type);
+        if (a->width == 0) a->width = compute_type_size(cc, &a->type);
         
         a->offset = current_offset;
         
@@ -462,19 +527,19 @@ static void compute_class_layout(Scope* target) {
 }
 
 // ================ driver function ====================================================================
-void st_compute_all_frame_layouts() {
-    for (Scope* sc = all_scopes; sc; sc = sc->nextSibling) {
+void st_compute_all_frame_layouts(CompilerContext* cc) {
+    for (Scope* sc = cc->all_scopes; sc; sc = sc->nextSibling) {
         if (sc->parent) {
             for (SymbolEntry* e = sc->parent->symbols; e; e = e->next) {
-                if (strcmp(e->name, sc->name) == 0) {
+                if (e->name_id == sc->name_id) {
                     
                     if (e->kind == SYM_FUNCTION) {
                         // if a function => calculate Stack Frame like (-4, -8...)
-                        compute_layout_for_scope_ptr(sc);
+                        compute_layout_for_scope_ptr(cc, sc);
                     }
                     else if (e->kind == SYM_CLASS) {
                         // if a class => alculate Object Layout like (0, 4, 8...)
-                        compute_class_layout(sc);
+                        compute_class_layout(cc, sc);
                     }
                     break;
                 }
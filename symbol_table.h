@@ -36,6 +36,7 @@ typedef struct Type {
 // Symbol entry structure (singly linked list) ============
 typedef struct SymbolEntry {
     char name[64];
+    int name_id;     // interned name, compared instead of name
     SymbolKind kind;
     Type type;
     int scopeLevel;
@@ -51,30 +52,36 @@ typedef struct SymbolEntry {
 typedef struct Scope {
     int level;
     char name[64];
+    int name_id;
     SymbolEntry* symbols;
     struct Scope* parent;
     struct Scope* nextSibling;
 } Scope;
 
 // APIs for symbol table management ============
-void st_init();
-void st_enter_scope(const char* name);
-void st_exit_scope();
-SymbolEntry* st_add_symbol(const char* name, SymbolKind kind, Type type, struct ASTNode* declNode, int line);
-SymbolEntry* st_lookup_local(const char* name);
-SymbolEntry* st_lookup(const char* name);
-SymbolEntry* st_lookup_global(const char* name);  
-void st_print(FILE* out);
-void st_write_file(const char* path);
+void st_init(struct CompilerContext* cc);
+void st_free(struct CompilerContext* cc);
+void st_enter_scope(struct CompilerContext* cc, const char* name);
+void st_exit_scope(struct CompilerContext* cc);
+SymbolEntry* st_add_symbol(struct CompilerContext* cc, const char* name, SymbolKind kind, Type type, struct ASTNode* declNode, int line);
+SymbolEntry* st_lookup_local(struct CompilerContext* cc, const char* name);
+SymbolEntry* st_lookup(struct CompilerContext* cc, const char* name);
+SymbolEntry* st_lookup_global(struct CompilerContext* cc, const char* name);  
+SymbolEntry* st_lookup_local_id(struct CompilerContext* cc, int name_id);
+SymbolEntry* st_lookup_id(struct CompilerContext* cc, int name_id);
+SymbolEntry* st_lookup_global_id(struct CompilerContext* cc, int name_id);
+void st_index_globals(struct CompilerContext* cc);    // make st_lookup_global O(1) until the next st_add_symbol
+void st_print(struct CompilerContext* cc, FILE* out);
+void st_write_file(struct CompilerContext* cc, const char* name);  // output file of cc
 
 // compute size for a type
-size_t compute_type_size(const Type* t);
+size_t compute_type_size(struct CompilerContext* cc, const Type* t);
 
 // compute frame layout (assign offsets)
-int st_compute_frame_layout(const char* functionName);
+int st_compute_frame_layout(struct CompilerContext* cc, const char* functionName);
 
 // find frame layouts for all function scopes
-void st_compute_all_frame_layouts();
+void st_compute_all_frame_layouts(struct CompilerContext* cc);
 
 // helpers ============
 Type make_basic_type(TypeKind k);
@@ -1,49 +1,251 @@
 #include "symbols.h"
+#include "compiler.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_SYMBOLS 1000
+// entries live in fixed-size pages so a Symbol* (and its id) never moves once handed out
+#define SYMBOL_PAGE_BITS 10
+#define SYMBOL_PAGE_SIZE (1 << SYMBOL_PAGE_BITS)
+#define SYMBOL_MAX_PAGES 16384
 
-static struct Symbol symbols[MAX_SYMBOLS];
-static int symbol_count = 0;
+// lexeme text is packed into large blocks: one terminated copy per distinct spelling
+#define TEXT_BLOCK_SIZE (64 * 1024)
 
-void init_symbols() {
-    symbol_count = 0;
+typedef struct TextBlock {
+    struct TextBlock* next;
+    size_t used;
+    size_t cap;
+    char data[];
+} TextBlock;
+
+// the table belongs to the compilation (compiler.h); the page array is
+// allocated on first insert. The hash index slots hold id + 1, 0 means empty.
+
+static unsigned int hash_text(const char* text, size_t length) {
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h ^= (unsigned char)text[i];
+        h *= 16777619u;
+    }
+    return h;
 }
 
-int add_symbol(const char* lexeme, const char* type, const char* token_type) {
-    for (int i = 0; i < symbol_count; i++) {
-        if (strcmp(symbols[i].lexeme, lexeme) == 0) {
-            return i;
+static char* store_text(CompilerContext* cc, const char* text, size_t length) {
+    if (!cc->text_blocks || cc->text_blocks->used + length + 1 > cc->text_blocks->cap) {
+        size_t cap = (length + 1 > TEXT_BLOCK_SIZE) ? length + 1 : TEXT_BLOCK_SIZE;
+        TextBlock* b = (TextBlock*)malloc(sizeof(TextBlock) + cap);
+        if (!b) {
+            printf("Error:: out of memory in symbol table\n");
+            exit(1);
         }
+        b->next = cc->text_blocks;
+        b->used = 0;
+        b->cap = cap;
+        cc->text_blocks = b;
+    }
+    char* out = cc->text_blocks->data + cc->text_blocks->used;
+    memcpy(out, text, length);
+    out[length] = '\0';
+    cc->text_blocks->used += length + 1;
+    return out;
+}
+
+static struct Symbol* entry(CompilerContext* cc, int id) {
+    return &cc->symbol_pages[id >> SYMBOL_PAGE_BITS][id & (SYMBOL_PAGE_SIZE - 1)];
+}
+
+static void grow_index(CompilerContext* cc) {
+    unsigned int new_cap = cc->symbol_slot_cap ? cc->symbol_slot_cap * 2 : 1024;
+    int* new_slots = (int*)calloc(new_cap, sizeof(int));
+    if (!new_slots) {
+        printf("Error:: out of memory in symbol index\n");
+        exit(1);
+    }
+    for (int id = 0; id < cc->symbol_count; id++) {
+        unsigned int i = entry(cc, id)->hash & (new_cap - 1);
+        while (new_slots[i]) i = (i + 1) & (new_cap - 1);
+        new_slots[i] = id + 1;
     }
+    free(cc->symbol_slots);
+    cc->symbol_slots = new_slots;
+    cc->symbol_slot_cap = new_cap;
+}
 
-    symbols[symbol_count].lexeme = strdup(lexeme);
-    symbols[symbol_count].type = strdup(type);
-    symbols[symbol_count].token_type = strdup(token_type);
+void init_symbols(CompilerContext* cc) {
+    for (int p = 0; cc->symbol_pages && p < SYMBOL_MAX_PAGES && cc->symbol_pages[p]; p++) {
+        int base = p << SYMBOL_PAGE_BITS;
+        for (int i = 0; i < SYMBOL_PAGE_SIZE && base + i < cc->symbol_count; i++) {
+            free(cc->symbol_pages[p][i].type);
+            free(cc->symbol_pages[p][i].token_type);
+        }
+        free(cc->symbol_pages[p]);
+        cc->symbol_pages[p] = NULL;
+    }
+    while (cc->text_blocks) {
+        TextBlock* next = cc->text_blocks->next;
+        free(cc->text_blocks);
+        cc->text_blocks = next;
+    }
+    free(cc->symbol_slots);
+    cc->symbol_slots = NULL;
+    cc->symbol_slot_cap = 0;
+    cc->symbol_count = 0;
+}
 
-    symbol_count++;
-    return symbol_count - 1;
+// lookup without inserting; returns the slot index the lexeme occupies or would occupy
+static unsigned int probe(CompilerContext* cc, const char* text, size_t length, unsigned int h) {
+    unsigned int i = h & (cc->symbol_slot_cap - 1);
+    while (cc->symbol_slots[i]) {
+        struct Symbol* s = entry(cc, cc->symbol_slots[i] - 1);
+        if (s->hash == h && (size_t)s->length == length && memcmp(s->lexeme, text, length) == 0) break;
+        i = (i + 1) & (cc->symbol_slot_cap - 1);
+    }
+    return i;
 }
 
-struct Symbol* get_symbol(const char* lexeme) {
-    for (int i = 0; i < symbol_count; i++) {
-        if (strcmp(symbols[i].lexeme, lexeme) == 0) {
-            return &symbols[i];
+int intern_n(CompilerContext* cc, const char* text, size_t length) {
+    if (!text || length == 0) return INTERN_NONE;
+    if ((unsigned int)(cc->symbol_count + 1) * 2 > cc->symbol_slot_cap) grow_index(cc);
+
+    unsigned int h = hash_text(text, length);
+    unsigned int i = probe(cc, text, length, h);
+    if (cc->symbol_slots[i]) return cc->symbol_slots[i] - 1;
+
+    int id = cc->symbol_count;
+    int page = id >> SYMBOL_PAGE_BITS;
+    if (page >= SYMBOL_MAX_PAGES) {
+        printf("Error:: too many distinct identifiers (%d)\n", id);
+        exit(1);
+    }
+    if (!cc->symbol_pages) {
+        cc->symbol_pages = (struct Symbol**)calloc(SYMBOL_MAX_PAGES, sizeof(struct Symbol*));
+        if (!cc->symbol_pages) {
+            printf("Error:: out of memory in symbol table\n");
+            exit(1);
         }
     }
-    return NULL; // Not found
+    if (!cc->symbol_pages[page]) {
+        cc->symbol_pages[page] = (struct Symbol*)calloc(SYMBOL_PAGE_SIZE, sizeof(struct Symbol));
+        if (!cc->symbol_pages[page]) {
+            printf("Error:: out of memory in symbol table\n");
+            exit(1);
+        }
+    }
+    struct Symbol* s = entry(cc, id);
+    s->lexeme = store_text(cc, text, length);
+    s->length = (int)length;
+    s->hash = h;
+    s->type = NULL;
+    s->token_type = NULL;
+
+    cc->symbol_slots[i] = id + 1;
+    cc->symbol_count++;
+    return id;
 }
 
-void print_symbols() {
+int intern(CompilerContext* cc, const char* lexeme) {
+    if (!lexeme) return INTERN_NONE;
+    return intern_n(cc, lexeme, strlen(lexeme));
+}
+
+int intern_find(CompilerContext* cc, const char* lexeme) {
+    if (!lexeme || !lexeme[0] || cc->symbol_slot_cap == 0) return INTERN_NONE;
+    size_t length = strlen(lexeme);
+    unsigned int i = probe(cc, lexeme, length, hash_text(lexeme, length));
+    return cc->symbol_slots[i] ? cc->symbol_slots[i] - 1 : INTERN_NONE;
+}
+
+const char* intern_name(CompilerContext* cc, int id) {
+    if (id < 0 || id >= cc->symbol_count) return "";
+    return entry(cc, id)->lexeme;
+}
+
+int intern_count(CompilerContext* cc) {
+    return cc->symbol_count;
+}
+
+int add_symbol(CompilerContext* cc, const char* lexeme, const char* type, const char* token_type) {
+    if (!lexeme) return INTERN_NONE;
+    return add_symbol_n(cc, lexeme, strlen(lexeme), type, token_type);
+}
+
+int add_symbol_n(CompilerContext* cc, const char* text, size_t length, const char* type, const char* token_type) {
+    int id = intern_n(cc, text, length);
+    if (id == INTERN_NONE) return id;
+    struct Symbol* s = entry(cc, id);
+    if (!s->token_type) {
+        s->type = strdup(type);
+        s->token_type = strdup(token_type);
+    }
+    return id;
+}
+
+struct Symbol* get_symbol(CompilerContext* cc, const char* lexeme) {
+    int id = intern_find(cc, lexeme);
+    if (id == INTERN_NONE || !entry(cc, id)->token_type) return NULL; // Not found
+    return entry(cc, id);
+}
+
+struct Symbol* get_symbol_by_id(CompilerContext* cc, int id) {
+    if (id < 0 || id >= cc->symbol_count) return NULL;
+    return entry(cc, id);
+}
+
+void print_symbols(CompilerContext* cc) {
     printf("\n---------------- SYMBOLS ----------------\n");
     printf("Lexeme\t\tType\t\tToken Type\n");
-    for (int i = 0; i < symbol_count; i++) {
+    for (int i = 0; i < cc->symbol_count; i++) {
+        struct Symbol* s = entry(cc, i);
+        if (!s->token_type) continue; // interned by a later phase, not a source symbol
         printf("%-15s %-15s %-15s\n",
-               symbols[i].lexeme,
-               symbols[i].type,
-               symbols[i].token_type);
+               s->lexeme,
+               s->type,
+               s->token_type);
     }
     printf("----------------------------------------------\n");
 }
+
+// ====== saved symbol tables =============================================
+void symbols_write(CompilerContext* cc, FILE* f) {
+    for (int id = 0; id < cc->symbol_count; id++) {
+        struct Symbol* s = entry(cc, id);
+        int kind = 0;
+        if (s->token_type && strcmp(s->token_type, "ID") == 0) kind = 1;
+        else if (s->token_type && strcmp(s->token_type, "ALPHANUM") == 0) kind = 2;
+        fwrite(&s->length, sizeof(int), 1, f);
+        fwrite(&kind, sizeof(int), 1, f);
+        fwrite(s->lexeme, 1, s->length, f);
+    }
+}
+
+// validate everything before touching the interner, so a stale or foreign
+// file can't leave half a symbol table behind
+int symbols_check(CompilerContext* cc, const char* buf, size_t size, size_t* pos, int count) {
+    if (count < cc->symbol_count) return 0;
+    size_t at = *pos;
+    for (int id = 0; id < count; id++) {
+        int len;
+        if (at > size || size - at < 2 * sizeof(int)) return 0;
+        memcpy(&len, buf + at, sizeof(int));
+        if (len <= 0 || size - at - 2 * sizeof(int) < (size_t)len) return 0;
+        const char* text = buf + at + 2 * sizeof(int);
+        if (id < cc->symbol_count && (entry(cc, id)->length != len || memcmp(entry(cc, id)->lexeme, text, len) != 0)) return 0;
+        at += 2 * sizeof(int) + len;
+    }
+    *pos = at;
+    return 1;
+}
+
+void symbols_replay(CompilerContext* cc, const char* buf, size_t pos, int count) {
+    for (int id = 0; id < count; id++) {
+        int len, kind;
+        memcpy(&len, buf + pos, sizeof(int));
+        memcpy(&kind, buf + pos + sizeof(int), sizeof(int));
+        const char* text = buf + pos + 2 * sizeof(int);
+        if (kind == 1) add_symbol_n(cc, text, len, "id", "ID");
+        else if (kind == 2) add_symbol_n(cc, text, len, "alphanum", "ALPHANUM");
+        else intern_n(cc, text, len);
+        pos += 2 * sizeof(int) + len;
+    }
+}
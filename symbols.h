@@ -1,18 +1,45 @@
-#ifndef SYMBOL_TABLE_H
-#define SYMBOL_TABLE_H
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+struct CompilerContext;
+
+// id returned for "no lexeme" (empty string / missing name)
+#define INTERN_NONE (-1)
 
 struct Symbol {
     char* lexeme;
-    char* type;
+    char* type;         // set only for lexemes registered by the lexer
     char* token_type;
+    unsigned int hash;
+    int length;
 };
 
-void init_symbols(); 
+void init_symbols(struct CompilerContext* cc);
+
+// identifier interner: every distinct lexeme gets one stable integer id ====
+int intern(struct CompilerContext* cc, const char* lexeme);
+int intern_n(struct CompilerContext* cc, const char* text, size_t length);
+int intern_find(struct CompilerContext* cc, const char* lexeme);
+const char* intern_name(struct CompilerContext* cc, int id);
+int intern_count(struct CompilerContext* cc);
 
-int add_symbol(const char* lexeme, const char* type, const char* token_type);
-struct Symbol* get_symbol(const char* lexeme);
+int add_symbol(struct CompilerContext* cc, const char* lexeme, const char* type, const char* token_type);
+int add_symbol_n(struct CompilerContext* cc, const char* text, size_t length, const char* type, const char* token_type);
+struct Symbol* get_symbol(struct CompilerContext* cc, const char* lexeme);
+struct Symbol* get_symbol_by_id(struct CompilerContext* cc, int id);
 
-void print_symbols();
+void print_symbols(struct CompilerContext* cc);
 
-#endif 
+// saved symbol tables (token cache, AST snapshots) ========================
+// count x { int length; int kind; char text[length]; }, kind 0 plain,
+// 1 id, 2 alphanum; ids come back the same when replayed in order
+void symbols_write(struct CompilerContext* cc, FILE* f);
+// 1 if count entries start at buf + *pos and what is interned already is a
+// prefix of them; *pos is moved past them
+int symbols_check(struct CompilerContext* cc, const char* buf, size_t size, size_t* pos, int count);
+void symbols_replay(struct CompilerContext* cc, const char* buf, size_t pos, int count);
 
+#endif
@@ -0,0 +1,31 @@
+# Equivalence test: the LL(1) table parser and the LALR(1) Bison parser must build the same tree and derivation as recursive descent
+$failed = 0
+$files = Get-ChildItem -Path ".\tests" -Filter "*.txt"
+$artifacts = @("syntax_tree.txt", "derivation.txt")
+
+foreach ($file in $files) {
+    .\tma3.exe --parser=rd $file.FullName > $null
+    $expected = $artifacts | ForEach-Object { Get-Content ".\files\$_" -Raw }
+    # a syntax error ends the other parsers at the first one, so only clean files must match
+    $clean = (Get-Content ".\files\syntax_errors.txt" -Raw) -eq $null
+
+    foreach ($parser in @("table", "lalr")) {
+        .\tma3.exe --parser=$parser $file.FullName > $null
+        $actual = $artifacts | ForEach-Object { Get-Content ".\files\$_" -Raw }
+
+        if (-not $clean) {
+            Write-Host "SKIPPED $($file.Name) ($parser, syntax errors)"
+        } elseif (($expected -join "") -ceq ($actual -join "")) {
+            Write-Host "OK      $($file.Name) ($parser)"
+        } else {
+            Write-Host "FAILED  $($file.Name) ($parser)"
+            $failed++
+        }
+    }
+}
+
+if ($failed -gt 0) {
+    Write-Host "$failed run(s) differ from the recursive descent parser."
+    exit 1
+}
+Write-Host "All syntax trees identical."
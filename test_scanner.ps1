@@ -0,0 +1,19 @@
+# Equivalence test: the SIMD scanner must yield the same token stream as flex
+$failed = 0
+$files = Get-ChildItem -Path ".\tests" -Filter "*.txt"
+
+foreach ($file in $files) {
+    $output = .\tma3.exe --scanner=check $file.FullName | Select-String -Pattern "Scanner check"
+    if ($output -match "Scanner check OK") {
+        Write-Host "OK      $($file.Name)"
+    } else {
+        Write-Host "FAILED  $($file.Name): $output"
+        $failed++
+    }
+}
+
+if ($failed -gt 0) {
+    Write-Host "$failed file(s) differ between flex and SIMD scanners."
+    exit 1
+}
+Write-Host "All token streams identical."
@@ -4,21 +4,116 @@
     #include <string.h>
     #include "symbols.h"
     #include "parser.h"
+    #include "source.h"
+    #include "log.h"
+    #include "simd_scan.h"
+    #include "token_cache.h"
+    #include "parallel_parse.h"
+    #include "compiler.h"
+    #include "tree_writer.h"
+    #include "ast_snapshot.h"
+    #include "func_cache.h"
+    #include "ast_visit.h"
+    #include "server.h"
+%}
 
-    extern int yylex();
-    extern int lineno;
-    extern int yywrap();
-    extern struct Token t;
-    extern int yylineno;
+// ====== LALR(1) front end (--parser=lalr) =====
+// The grammar below is the one parser.c accepts (grammar_ll1.txt), written
+// for Bison: its actions build the same nodes as the recursive descent
+// functions, so everything after the parser cannot tell the two apart. The
+// parser is pure (its stacks and lookahead live in yyparse), tokens come from
+// the compilation's token array through lalr_lex, and lists are left
+// recursive, so the parse stack stays flat however long a list gets.
+%code requires {
+    struct ASTNode;
+    struct CompilerContext;
+    typedef struct LalrParse LalrParse;
 
-    int yyparse();
-    void yyerror(const char* s);
-%}
+    // a right-nested list (varDeclOrStmtList holding the next one) built by a
+    // left-recursive rule: head is the outermost list node, tail the innermost
+    // one, which is still empty
+    typedef struct {
+        struct ASTNode* head;
+        struct ASTNode* tail;
+    } LalrList;
+}
+
+%define api.pure full
+%define parse.error verbose
+%param {struct CompilerContext* cc} {LalrParse* lp}
 
 %union {
     int integer_values;
     char* character_values;
     float float_values;
+    int token;                  // index in the token array (lalr_lex)
+    struct ASTNode* node;
+    LalrList list;
+}
+
+%code {
+    #define yylex lalr_lex
+    // lists are flat on the stack, but parentheses and if/while blocks nest
+    #define YYMAXDEPTH 1000000
+    static int lalr_lex(YYSTYPE* lval, CompilerContext* cc, LalrParse* lp);
+    static void yyerror(CompilerContext* cc, LalrParse* lp, const char* message);
+
+    struct LalrParse {
+        CompilerContext* cc;    // for the derivation replay after yyparse
+        ASTNode* root;
+        int started;            // the first token has been handed out
+        // memberDecl nodes whose funcHead recursive descent drops (neither ';'
+        // nor a body follows it), each followed by the head: no tree, but
+        // its derivation steps are written
+        ASTNode** dropped;
+        int dropped_count, dropped_cap;
+    };
+
+    // leaves for a token, as parser.c's token_node and token_leaf make them
+    static ASTNode* lalr_id(CompilerContext* cc, int token) {
+        LexToken* tok = &cc->token_stream.data[token];
+        ASTNode* node = createNodeWithId(cc, "ID", tok->id);
+        node->line = tok->line;
+        return node;
+    }
+
+    static ASTNode* lalr_literal(CompilerContext* cc, const char* name, int token) {
+        return createNodeWithId(cc, name, cc->token_stream.data[token].id);
+    }
+
+    static ASTNode* lalr_node(CompilerContext* cc, const char* name, ASTNode* a, ASTNode* b, ASTNode* c) {
+        ASTNode* node = createNode(cc, name, "");
+        addChild(node, a);
+        addChild(node, b);
+        addChild(node, c);
+        return node;
+    }
+
+    static void list_begin(CompilerContext* cc, LalrList* l, const char* name) {
+        l->head = l->tail = createNode(cc, name, "");
+    }
+
+    // items of the current level, then the next (empty) list node below them
+    static void list_next(CompilerContext* cc, LalrList* l, ASTNode* a, ASTNode* b) {
+        addChild(l->tail, a);
+        addChild(l->tail, b);
+        ASTNode* next = createNode(cc, l->tail->name, "");
+        addChild(l->tail, next);
+        l->tail = next;
+    }
+
+    static void lalr_drop_head(LalrParse* lp, ASTNode* member, ASTNode* head) {
+        if (lp->dropped_count + 2 > lp->dropped_cap) {
+            lp->dropped_cap = lp->dropped_cap ? lp->dropped_cap * 2 : 16;
+            lp->dropped = (ASTNode**)realloc(lp->dropped, sizeof(ASTNode*) * lp->dropped_cap);
+            if (!lp->dropped) {
+                printf("Error:: out of memory while parsing\n");
+                exit(1);
+            }
+        }
+        lp->dropped[lp->dropped_count++] = member;
+        lp->dropped[lp->dropped_count++] = head;
+    }
 }
 
 %token IF ELSE THEN WHILE RETURN READ WRITE
@@ -42,31 +137,434 @@
 %token PRINT_SYMBOLS
 %token EXIT
 
+%type <node> prog classOrImplOrFunc classDecl optId isaIdOpt implDef funcDef
+%type <node> visibility memberDecl funcHead funcBody varDeclOrStmt varDecl
+%type <node> statement statBlock assignStat assignOp expr relExpr
+%type <node> relArith arithExpr optArith term factor variable readVariable
+%type <node> idnest idOrSelf idnestTail indice aParams type returnType fParams
+%type <node> optIntLit addOp multOp relOp
+%type <list> classOrImplOrFuncList idTail visibilitymemberDeclList funcDefList
+%type <list> varDeclOrStmtList statmentList idnestList indiceList someIndices
+%type <list> aParamsTailList arraySizeList fParamsTailList
+
+// Conflicts, all resolved by shifting, which is what recursive descent does:
+// a variable takes every following id and self as another idnest, an id or
+// self takes a following '[' or '(' as its idnestTail and the indices go on
+// while there is a '[' (4 + 1 + 1), and 'local' followed by an id always
+// starts a varDecl (1).
+%expect 6
+
 %%
 
-program:
-    PRINT_SYMBOLS {
-        printf("Yacc:: PRINT_SYMBOLS found.\n");
-        print_symbols();
+// the unit list ends at the first token that cannot start a unit; like
+// recursive descent, parse_program skips whatever follows it
+prog:
+    classOrImplOrFuncList {
+        lp->root = $$ = lalr_node(cc, "prog", $1.head, NULL, NULL);
+        YYACCEPT;
+    }
+;
+
+classOrImplOrFuncList:
+    %empty                                  { list_begin(cc, &$$, "classOrImplOrFuncList"); }
+    | classOrImplOrFuncList classOrImplOrFunc { $$ = $1; list_next(cc, &$$, $2, NULL); }
+;
+
+classOrImplOrFunc:
+    classDecl   { $$ = lalr_node(cc, "classOrImplOrFunc", $1, NULL, NULL); }
+    | implDef   { $$ = lalr_node(cc, "classOrImplOrFunc", $1, NULL, NULL); }
+    | funcDef   { $$ = lalr_node(cc, "classOrImplOrFunc", $1, NULL, NULL); }
+;
+
+optId:
+    %empty  { $$ = NULL; }
+    | ID    { $$ = lalr_id(cc, $<token>1); }
+;
+
+classDecl:
+    CLASS optId isaIdOpt LEFTBRACE visibilitymemberDeclList RIGHTBRACE SEMICOLON {
+        $$ = lalr_node(cc, "classDecl", $2, $3, $5.head);
     }
-    | EXIT {
-        printf("Yacc:: EXIT found.\n");
-        print_symbols();
-        exit(0);
+;
+
+isaIdOpt:
+    %empty              { $$ = createNode(cc, "isaIdOpt", ""); }
+    | ISA optId idTail  { $$ = lalr_node(cc, "isaIdOpt", $2, $3.head, NULL); }
+;
+
+idTail:
+    %empty                  { list_begin(cc, &$$, "idTail"); }
+    | idTail COMMA optId    { $$ = $1; list_next(cc, &$$, $3, NULL); }
+;
+
+visibilitymemberDeclList:
+    %empty                                          { list_begin(cc, &$$, "visibilitymemberDeclList"); }
+    | visibilitymemberDeclList visibility memberDecl { $$ = $1; list_next(cc, &$$, $2, $3); }
+;
+
+visibility:
+    PUBLIC      { $$ = lalr_node(cc, "visibility", createNode(cc, "PUBLIC", ""), NULL, NULL); }
+    | PRIVATE   { $$ = lalr_node(cc, "visibility", createNode(cc, "PRIVATE", ""), NULL, NULL); }
+;
+
+memberDecl:
+    funcHead SEMICOLON              { $$ = lalr_node(cc, "memberDecl", $1, NULL, NULL); }
+    | funcHead funcBody             { $$ = lalr_node(cc, "memberDecl", $1, $2, NULL); }
+    | funcHead funcBody SEMICOLON   { $$ = lalr_node(cc, "memberDecl", $1, $2, NULL); }
+    | funcHead {
+        $$ = createNode(cc, "memberDecl", "");
+        lalr_drop_head(lp, $$, $1);
     }
-    /* instead of using yacc grammar, we tell program to use recursive descent parsing */
-    |{
-        printf("Yacc:: Switching to recursive descent parser...\n");
-        ASTNode* root = parse_program(); // Calling to recursive descent parser
-        (void)root; // root available for later semantic analysis
-        YYACCEPT; // immediately terminates the parsing process of yyparse()
+    | ATTRIBUTE varDecl {
+        $$ = lalr_node(cc, "memberDecl", lalr_node(cc, "attributeDecl", $2, NULL, NULL), NULL, NULL);
+    }
+    | %empty                        { $$ = createNode(cc, "memberDecl", ""); }
+;
+
+implDef:
+    IMPLEMENT optId LEFTBRACE funcDefList RIGHTBRACE {
+        $$ = lalr_node(cc, "implDef", $2, $4.head, NULL);
+    }
+;
+
+funcDefList:
+    %empty                  { list_begin(cc, &$$, "funcDefList"); }
+    | funcDefList funcDef   { $$ = $1; list_next(cc, &$$, $2, NULL); }
+;
+
+// top level and implementations: the body may be left out
+funcDef:
+    funcHead            { $$ = lalr_node(cc, "funcDef", $1, createNode(cc, "funcBody", ""), NULL); }
+    | funcHead funcBody { $$ = lalr_node(cc, "funcDef", $1, $2, NULL); }
+;
+
+funcHead:
+    FUNC optId LEFTPAREN fParams RIGHTPAREN ARROW returnType {
+        $$ = lalr_node(cc, "funcHead", $2, $4, $7);
+    }
+    | CONSTRUCT LEFTPAREN fParams RIGHTPAREN {
+        $$ = lalr_node(cc, "funcHead", $3, NULL, NULL);
+    }
+;
+
+funcBody:
+    LEFTBRACE varDeclOrStmtList RIGHTBRACE { $$ = lalr_node(cc, "funcBody", $2.head, NULL, NULL); }
+;
+
+varDeclOrStmtList:
+    %empty                              { list_begin(cc, &$$, "varDeclOrStmtList"); }
+    | varDeclOrStmtList varDeclOrStmt   { $$ = $1; list_next(cc, &$$, $2, NULL); }
+;
+
+varDeclOrStmt:
+    LOCAL varDecl {
+        $$ = lalr_node(cc, "varDeclOrStmt", lalr_node(cc, "localVarDecl", $2, NULL, NULL), NULL, NULL);
+    }
+    | statement { $$ = lalr_node(cc, "varDeclOrStmt", $1, NULL, NULL); }
+;
+
+varDecl:
+    %empty { $$ = createNode(cc, "varDecl", ""); }
+    | ID COLON type arraySizeList SEMICOLON {
+        $$ = lalr_node(cc, "varDecl", lalr_id(cc, $<token>1), $3, $4.head);
+    }
+;
+
+statement:
+    assignStat SEMICOLON { $$ = lalr_node(cc, "statement", $1, NULL, NULL); }
+    | IF LEFTPAREN relExpr RIGHTPAREN THEN statBlock ELSE statBlock SEMICOLON {
+        $$ = lalr_node(cc, "statement", createNode(cc, "if", ""), $3, $6);
+        addChild($$, $8);
+    }
+    | WHILE LEFTPAREN relExpr RIGHTPAREN statBlock SEMICOLON {
+        $$ = lalr_node(cc, "statement", createNode(cc, "while", ""), $3, $5);
+    }
+    | READ LEFTPAREN readVariable RIGHTPAREN SEMICOLON {
+        $$ = lalr_node(cc, "statement", createNode(cc, "read", ""), $3, NULL);
+    }
+    | WRITE LEFTPAREN expr RIGHTPAREN SEMICOLON {
+        $$ = lalr_node(cc, "statement", createNode(cc, "write", ""), $3, NULL);
+    }
+    | RETURN LEFTPAREN expr RIGHTPAREN SEMICOLON {
+        $$ = lalr_node(cc, "statement", createNode(cc, "return", ""), $3, NULL);
+    }
+;
+
+statBlock:
+    LEFTBRACE statmentList RIGHTBRACE   { $$ = lalr_node(cc, "statBlock", $2.head, NULL, NULL); }
+    | statement                         { $$ = lalr_node(cc, "statBlock", $1, NULL, NULL); }
+    | %empty                            { $$ = lalr_node(cc, "statBlock", createNode(cc, "statement", ""), NULL, NULL); }
+;
+
+statmentList:
+    %empty                      { list_begin(cc, &$$, "statmentList"); }
+    | statmentList statement    { $$ = $1; list_next(cc, &$$, $2, NULL); }
+;
+
+// a call statement is a variable with neither ':=' nor a value
+assignStat:
+    variable assignOp expr { $$ = lalr_node(cc, "assignStat", $1, $2, $3); }
+;
+
+assignOp:
+    %empty      { $$ = createNode(cc, "assignOp", ""); }
+    | ASSIGN    { $$ = lalr_node(cc, "assignOp", createNode(cc, ":=", ""), NULL, NULL); }
+;
+
+// ====== expressions: the operator nodes of parser.c's precedence climbing =====
+// one relational operator at most, and only outside parentheses
+expr:
+    %empty      { $$ = createNode(cc, "expr", ""); }
+    | relArith  { $$ = lalr_node(cc, "expr", $1, NULL, NULL); }
+;
+
+relExpr:
+    %empty      { $$ = createNode(cc, "relExpr", ""); }
+    | relArith  { $$ = lalr_node(cc, "relExpr", $1, NULL, NULL); }
+;
+
+relArith:
+    arithExpr
+    | arithExpr relOp arithExpr { $$ = $2; addChild($$, $1); addChild($$, $3); }
+;
+
+arithExpr:
+    term
+    | arithExpr addOp term { $$ = $2; addChild($$, $1); addChild($$, $3); }
+;
+
+term:
+    factor
+    | term multOp factor { $$ = $2; addChild($$, $1); addChild($$, $3); }
+;
+
+factor:
+    variable
+    | INTEGER_LITERAL                   { $$ = lalr_literal(cc, "intLit", $<token>1); }
+    | FLOAT_LITERAL                     { $$ = lalr_literal(cc, "floatLit", $<token>1); }
+    | LEFTPAREN arithExpr RIGHTPAREN    { $$ = $2; }
+    | NOT factor                        { $$ = lalr_node(cc, "not", $2, NULL, NULL); }
+    | PLUS factor                       { $$ = lalr_node(cc, "pos", $2, NULL, NULL); }
+    | MINUS factor                      { $$ = lalr_node(cc, "neg", $2, NULL, NULL); }
+;
+
+relOp:
+    LESS        { $$ = createNode(cc, "<", ""); }
+    | GREATER   { $$ = createNode(cc, ">", ""); }
+    | LOEQ      { $$ = createNode(cc, "<=", ""); }
+    | GOEQ      { $$ = createNode(cc, ">=", ""); }
+    | NEQ       { $$ = createNode(cc, "<>", ""); }
+;
+
+addOp:
+    PLUS        { $$ = createNode(cc, "+", ""); }
+    | MINUS     { $$ = createNode(cc, "-", ""); }
+    | OR        { $$ = createNode(cc, "or", ""); }
+;
+
+multOp:
+    MULTIPLY    { $$ = createNode(cc, "*", ""); }
+    | DIVIDE    { $$ = createNode(cc, "/", ""); }
+    | AND       { $$ = createNode(cc, "and", ""); }
+;
+
+// ====== variables =====
+variable:
+    idnestList indiceList { $$ = lalr_node(cc, "variable", $1.head, $2.head, NULL); }
+;
+
+// read() also takes a variable without any id
+readVariable:
+    variable
+    | indiceList { $$ = lalr_node(cc, "variable", createNode(cc, "idnestList", ""), $1.head, NULL); }
+;
+
+idnestList:
+    idnest              { list_begin(cc, &$$, "idnestList"); list_next(cc, &$$, $1, NULL); }
+    | idnestList idnest { $$ = $1; list_next(cc, &$$, $2, NULL); }
+;
+
+idnest:
+    idOrSelf idnestTail { $$ = lalr_node(cc, "idnest", $1, $2, NULL); }
+;
+
+idOrSelf:
+    ID      { $$ = lalr_node(cc, "idOrSelf", lalr_id(cc, $<token>1), NULL, NULL); }
+    | SELF  { $$ = lalr_node(cc, "idOrSelf", createNodeWithId(cc, "SELF", cc->self_id), NULL, NULL); }
+;
+
+idnestTail:
+    %empty                                      { $$ = createNode(cc, "idnestTail", ""); }
+    | someIndices optDot                        { $$ = lalr_node(cc, "idnestTail", $1.head, NULL, NULL); }
+    | LEFTPAREN aParams RIGHTPAREN optDot       { $$ = lalr_node(cc, "idnestTail", $2, NULL, NULL); }
+;
+
+optDot:
+    %empty
+    | DOT
+;
+
+indiceList:
+    %empty                  { list_begin(cc, &$$, "indiceList"); }
+    | someIndices
+;
+
+someIndices:
+    indice                  { list_begin(cc, &$$, "indiceList"); list_next(cc, &$$, $1, NULL); }
+    | someIndices indice    { $$ = $1; list_next(cc, &$$, $2, NULL); }
+;
+
+indice:
+    LEFTBRACKET optArith RIGHTBRACKET { $$ = lalr_node(cc, "indice", $2, NULL, NULL); }
+;
+
+optArith:
+    %empty { $$ = NULL; }
+    | arithExpr
+;
+
+aParams:
+    %empty { $$ = createNode(cc, "aParams", ""); }
+    | relArith aParamsTailList {
+        $$ = lalr_node(cc, "aParams", lalr_node(cc, "expr", $1, NULL, NULL), $2.head, NULL);
+    }
+;
+
+aParamsTailList:
+    %empty                          { list_begin(cc, &$$, "aParamsTailList"); }
+    | aParamsTailList COMMA expr    { $$ = $1; list_next(cc, &$$, lalr_node(cc, "aParamsTail", $3, NULL, NULL), NULL); }
+;
+
+// ====== declarations =====
+arraySizeList:
+    %empty { list_begin(cc, &$$, "arraySizeList"); }
+    | arraySizeList LEFTBRACKET optIntLit RIGHTBRACKET {
+        $$ = $1;
+        list_next(cc, &$$, lalr_node(cc, "arraySize", $3, NULL, NULL), NULL);
+    }
+;
+
+optIntLit:
+    %empty              { $$ = NULL; }
+    | INTEGER_LITERAL   { $$ = lalr_literal(cc, "intLit", $<token>1); }
+;
+
+type:
+    %empty      { $$ = createNode(cc, "type", ""); }
+    | INTEGER   { $$ = lalr_node(cc, "type", createNode(cc, "integer", ""), NULL, NULL); }
+    | FLOAT     { $$ = lalr_node(cc, "type", createNode(cc, "float", ""), NULL, NULL); }
+    | ID        { $$ = lalr_node(cc, "type", lalr_id(cc, $<token>1), NULL, NULL); }
+;
+
+returnType:
+    VOID    { $$ = lalr_node(cc, "returnType", createNode(cc, "void", ""), NULL, NULL); }
+    | type  { $$ = lalr_node(cc, "returnType", $1, NULL, NULL); }
+;
+
+fParams:
+    %empty { $$ = createNode(cc, "fParams", ""); }
+    | ID COLON type arraySizeList fParamsTailList {
+        $$ = lalr_node(cc, "fParams", lalr_id(cc, $<token>1), $3, $4.head);
+        addChild($$, $5.head);
+    }
+;
+
+fParamsTailList:
+    %empty { list_begin(cc, &$$, "fParamsTailList"); }
+    | fParamsTailList COMMA optId COLON type arraySizeList {
+        $$ = $1;
+        ASTNode* tail = lalr_node(cc, "fParamsTail", $3, $5, $6.head);
+        list_next(cc, &$$, tail, NULL);
     }
-    
 ;
 
 %%
 
-int main() {
+int main(int argc, char** argv) {
+    // options: --log=SPEC (see log.h), --nested-comments, --scanner=flex|simd|check,
+    // --lex-threads=N, --pipeline, --token-cache=DIR, --derivation=text|binary|ring,
+    // --parser=rd|table|lalr, --syntax-only, --parse-threads=N, --tree=text|json|binary,
+    // --save-ast=FILE, --load-ast=FILE (instead of a source), --incremental=FILE,
+    // --serve=SOCKET (compile server, see server.h), anything else is the source path
+    const char* source_path = NULL;
+    const char* snapshot_path = NULL;
+    const char* serve_path = NULL;
+    int tree_format = TREE_TEXT;
+    log_init();
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--log=", 6) == 0) {
+            if (log_configure(argv[i] + 6) != 0) return 1;
+        } else if (strcmp(argv[i], "--nested-comments") == 0) {
+            lex_nested_comments = 1;
+        } else if (strncmp(argv[i], "--scanner=", 10) == 0) {
+            const char* s = argv[i] + 10;
+            if (strcmp(s, "flex") == 0) lex_scanner = SCANNER_FLEX;
+            else if (strcmp(s, "simd") == 0) lex_scanner = SCANNER_SIMD;
+            else if (strcmp(s, "check") == 0) lex_scanner = SCANNER_CHECK;
+            else {
+                printf("Error:: unknown scanner '%s' (flex, simd, check)\n", s);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--token-cache=", 14) == 0) {
+            token_cache_dir = argv[i] + 14;
+        } else if (strncmp(argv[i], "--derivation=", 13) == 0) {
+            const char* d = argv[i] + 13;
+            if (strcmp(d, "text") == 0) derivation_mode = DERIVATION_TEXT;
+            else if (strcmp(d, "binary") == 0) derivation_mode = DERIVATION_BINARY;
+            else if (strcmp(d, "ring") == 0) derivation_mode = DERIVATION_RING;
+            else {
+                printf("Error:: unknown derivation mode '%s' (text, binary, ring)\n", d);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--parser=", 9) == 0) {
+            const char* e = argv[i] + 9;
+            if (strcmp(e, "rd") == 0) parser_engine = PARSER_RECURSIVE;
+            else if (strcmp(e, "table") == 0) parser_engine = PARSER_TABLE;
+            else if (strcmp(e, "lalr") == 0) parser_engine = PARSER_LALR;
+            else {
+                printf("Error:: unknown parser '%s' (rd, table, lalr)\n", e);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--tree=", 7) == 0) {
+            const char* t = argv[i] + 7;
+            if (strcmp(t, "text") == 0) tree_format = TREE_TEXT;
+            else if (strcmp(t, "json") == 0) tree_format = TREE_NDJSON;
+            else if (strcmp(t, "binary") == 0) tree_format = TREE_BINARY;
+            else {
+                printf("Error:: unknown tree format '%s' (text, json, binary)\n", t);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--save-ast=", 11) == 0) {
+            ast_snapshot_save_path = argv[i] + 11;
+        } else if (strncmp(argv[i], "--incremental=", 14) == 0) {
+            func_cache_path = argv[i] + 14;
+        } else if (strncmp(argv[i], "--serve=", 8) == 0) {
+            serve_path = argv[i] + 8;
+        } else if (strncmp(argv[i], "--load-ast=", 11) == 0) {
+            snapshot_path = argv[i] + 11;
+        } else if (strcmp(argv[i], "--syntax-only") == 0) {
+            parser_syntax_only = 1;
+        } else if (strncmp(argv[i], "--parse-threads=", 16) == 0) {
+            // top-level units on N threads (recursive descent parser); 0 = one per CPU
+            parse_threads = atoi(argv[i] + 16);
+            if (parse_threads <= 0) parse_threads = simd_scan_cpu_count();
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            lex_pipeline = 1;
+        } else if (strncmp(argv[i], "--lex-threads=", 14) == 0) {
+            // large sources are scanned in chunks, each on its own thread with its
+            // own scanner (flex or simd); 0 = one thread per CPU
+            lex_threads = atoi(argv[i] + 14);
+            if (lex_threads <= 0) lex_threads = simd_scan_cpu_count();
+        } else {
+            source_path = argv[i];
+        }
+    }
+
+    if (lex_pipeline && lex_threads > 1) {
+        printf("Error:: --pipeline lexes on one thread; it cannot be combined with --lex-threads\n");
+        return 1;
+    }
+
     printf("======================================\n");
     printf("EEX6363 - Compiler Construction.\n");
     printf("Name: W.M.A.T.Wanninayake.\n");
@@ -76,16 +574,164 @@ int main() {
     printf("Running Lexical Analyzer with Recursive Descent Parser:\n");
     printf("Program flow: Input Text > Lex > Tokens > Recursive Descent Parser > Derivation\n");
 
-    ASTNode* root = parse_program();
-    (void)root;
+    if (serve_path) {
+        // the function cache reads object_code.txt back from disk
+        if (func_cache_path) {
+            printf("Error:: --incremental cannot be combined with --serve\n");
+            return 1;
+        }
+        compiler_init();
+        return server_run(serve_path, tree_format);
+    }
+
+    // whole source is loaded once (mapped when a path is given) and scanned in place
+    SourceBuffer src = {0};
+    int rc = snapshot_path ? 0 : source_path ? source_open(&src, source_path) : source_read_stream(&src, stdin);
+    if (rc != 0) {
+        printf("Error:: Cannot read source %s\n", source_path ? source_path : "from stdin");
+        return 1;
+    }
+
+    // everything the compilation builds lives in its context (compiler.h)
+    compiler_init();
+    CompilerContext* cc = compiler_create("files");
+    cc->tree_format = tree_format;
+    ASTNode* root = snapshot_path ? compiler_run_snapshot(cc, snapshot_path) : compiler_run(cc, src.data, src.length);
+    if (snapshot_path && !root) {
+        compiler_free(cc);
+        return 1;
+    }
     //print root
     printf("root: %d", root);
 
     printf("Program analysis completed.\n");
-    print_symbols();
-    return 0;
+    print_symbols(cc);
+    // whole tree (and the types semantic analysis hung off it) goes in one step
+    LOG_DEBUG(LOG_PARSER, "AST arena: %zu nodes\n", ast_node_count(cc));
+    int failed = cc->syntax_error_count > 0;
+    compiler_free(cc);
+    source_close(&src);
+    return failed;
 }
 
-void yyerror(const char* s) {
-    printf("ERROR OCCURRED:: %s at line %d\n", s, lineno);
+// ====== tokens for the LALR parser =====
+// the current token is handed out and the position only moves on when the
+// next one is asked for, so once yyparse returns the lookahead is the token
+// it stopped at, as after the recursive descent functions. EXIT and
+// PRINT_SYMBOLS are handled the way match() handles them.
+static int lalr_lex(YYSTYPE* lval, CompilerContext* cc, LalrParse* lp) {
+    if (lp->started) advance_token(cc);
+    lp->started = 1;
+    if (lookahead_token == EXIT) {
+        printf("Parser:: EXIT.\n");
+        tokens_drain(cc, &cc->token_stream);
+        print_symbols(cc);
+        compiler_exit(cc, 0);
+    }
+    if (lookahead_token == PRINT_SYMBOLS) {
+        printf("Parser:: PRINT_SYMBOLS.\n");
+        tokens_drain(cc, &cc->token_stream);
+        print_symbols(cc);
+        advance_token(cc);
+    }
+    lval->token = token_pos;
+    return lookahead_token;
+}
+
+// like the table parser, the first syntax error ends the parse
+static void yyerror(CompilerContext* cc, LalrParse* lp, const char* message) {
+    (void)lp;
+    error(cc, (char*)message);
+}
+
+// ====== derivation steps, in recursive descent order =====
+// Bison reduces bottom-up, so the steps are written afterwards from the
+// finished tree in one preorder walk: each node says which step its parser.c
+// function writes. memberDecl writes funcDecl / funcDef between its head and
+// its body, so it replays the head on its own first.
+static AstVisitResult replay_pre(AstWalk* w, ASTNode* node, void* frame) {
+    (void)frame;
+    AstVisitor head = { replay_pre, NULL, 0, ast_walk_user(w) };
+    LalrParse* lp = (LalrParse*)head.user;
+    CompilerContext* cc = lp->cc;
+    ASTNode* c = node->child;
+    switch (node->kind) {
+    case AST_PROG:                  write_derivation(cc, RULE_PROG); break;
+    case AST_CLASSORIMPLORFUNCLIST: write_derivation(cc, c ? RULE_CLASSORIMPLORFUNCLIST_ITEM : RULE_CLASSORIMPLORFUNCLIST_EMPTY); break;
+    case AST_CLASSORIMPLORFUNC:
+        if (c->kind == AST_CLASSDECL) write_derivation(cc, RULE_CLASSORIMPLORFUNC_CLASSDECL);
+        else if (c->kind == AST_IMPLDEF) write_derivation(cc, RULE_CLASSORIMPLORFUNC_IMPLDEF);
+        else write_derivation(cc, RULE_CLASSORIMPLORFUNC_FUNCDEF);
+        break;
+    case AST_CLASSDECL:             write_derivation(cc, RULE_CLASSDECL); break;
+    case AST_IMPLDEF:               write_derivation(cc, RULE_IMPLDEF); break;
+    case AST_FUNCDEF:               write_derivation(cc, RULE_FUNCDEF); break;
+    case AST_VISIBILITY:            write_derivation(cc, c->kind == AST_PUBLIC ? RULE_VISIBILITY_PUBLIC : RULE_VISIBILITY_PRIVATE); break;
+    case AST_MEMBERDECL:
+        if (!c) {
+            for (int i = 0; i < lp->dropped_count; i += 2)
+                if (lp->dropped[i] == node) ast_walk(&head, lp->dropped[i + 1], NULL);
+        } else if (c->kind == AST_ATTRIBUTEDECL) {
+            write_derivation(cc, RULE_MEMBERDECL_ATTRIBUTEDECL);
+        } else {
+            ast_walk(&head, c, NULL);
+            write_derivation(cc, c->sibling ? RULE_MEMBERDECL_FUNCDEF : RULE_MEMBERDECL_FUNCDECL);
+            ast_walk_push(w, c->sibling, NULL);
+            return AST_VISIT_SKIP;
+        }
+        break;
+    case AST_FUNCHEAD: {
+        int rule = RULE_FUNCHEAD_CONSTRUCTOR;
+        for (ASTNode* n = c; n; n = n->sibling)
+            if (n->kind == AST_RETURNTYPE) rule = RULE_FUNCHEAD_FUNC;
+        write_derivation(cc, rule);
+        break;
+    }
+    case AST_FUNCBODY:              if (c) write_derivation(cc, RULE_FUNCBODY); break;
+    case AST_VARDECLORSTMT:         write_derivation(cc, c->kind == AST_LOCALVARDECL ? RULE_VARDECLORSTMT_LOCALVARDECL : RULE_VARDECLORSTMT_STATEMENT); break;
+    case AST_LOCALVARDECL:          write_derivation(cc, RULE_LOCALVARDECL); break;
+    case AST_ATTRIBUTEDECL:         write_derivation(cc, RULE_ATTRIBUTEDECL); break;
+    case AST_STATEMENT:
+        if (!c) break;
+        switch (c->kind) {
+        case AST_ASSIGNSTAT: write_derivation(cc, RULE_STATEMENT_ASSIGN); break;
+        case AST_IF:         write_derivation(cc, RULE_STATEMENT_IF); break;
+        case AST_WHILE:      write_derivation(cc, RULE_STATEMENT_WHILE); break;
+        case AST_READ:       write_derivation(cc, RULE_STATEMENT_READ); break;
+        case AST_WRITE:      write_derivation(cc, RULE_STATEMENT_WRITE); break;
+        default:             write_derivation(cc, RULE_STATEMENT_RETURN); break;
+        }
+        break;
+    case AST_STATBLOCK:             if (c->kind == AST_STATMENTLIST) write_derivation(cc, RULE_STATBLOCK); break;
+    case AST_ASSIGNSTAT:            write_derivation(cc, RULE_ASSIGNSTAT); break;
+    case AST_ASSIGNOP:              if (c) write_derivation(cc, RULE_ASSIGNOP); break;
+    case AST_RELEXPR:               write_derivation(cc, RULE_RELEXPR); break;
+    case AST_INDICE:                write_derivation(cc, RULE_INDICE); break;
+    case AST_VARIABLE:              write_derivation(cc, RULE_VARIABLE); break;
+    case AST_ARRAYSIZELIST:         write_derivation(cc, c ? RULE_ARRAYSIZELIST_ITEM : RULE_ARRAYSIZELIST_EMPTY); break;
+    case AST_ARRAYSIZE:             write_derivation(cc, RULE_ARRAYSIZE); break;
+    case AST_FPARAMSTAILLIST:       write_derivation(cc, c ? RULE_FPARAMSTAILLIST_ITEM : RULE_FPARAMSTAILLIST_EMPTY); break;
+    case AST_FPARAMSTAIL:           write_derivation(cc, RULE_FPARAMSTAIL); break;
+    case AST_IDTAIL:                write_derivation(cc, c ? RULE_IDTAIL : RULE_IDTAIL_EMPTY); break;
+    case AST_ISAIDOPT:              write_derivation(cc, c ? RULE_ISAIDOPT : RULE_ISAIDOPT_EMPTY); break;
+    default: break;
+    }
+    return AST_VISIT_CHILDREN;
+}
+
+// ====== driver for --parser=lalr, called by parse_program =====
+ASTNode* lalr_parse(CompilerContext* cc) {
+    LalrParse lp;
+    memset(&lp, 0, sizeof(lp));
+    lp.cc = cc;
+    yyparse(cc, &lp);   // a syntax error ends in error(), which does not come back
+
+    // the ring only matters for the context of a syntax error, and the
+    // replay comes after the last one could have happened
+    if (derivation_mode != DERIVATION_RING) {
+        AstVisitor replay = { replay_pre, NULL, 0, &lp };
+        ast_walk(&replay, lp.root, NULL);
+    }
+    free(lp.dropped);
+    return lp.root;
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "token_cache.h"
+#include "symbols.h"
+#include "log.h"
+#include "compiler.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <direct.h>
+#define MKDIR(dir) _mkdir(dir)
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#define MKDIR(dir) mkdir(dir, 0755)
+#endif
+
+// file layout (native byte order, the cache is local to one machine):
+//   TokenCacheHeader
+//   char source[length]      the file name is only a hash; a hit is a byte-for-byte match
+//   symbol_count x { int length; int kind; char text[length]; }   kind: 0 plain, 1 id, 2 alphanum
+//   token_count x LexToken
+#define TOKEN_CACHE_MAGIC "TMA3TOK2"
+
+typedef struct {
+    char magic[8];
+    unsigned int token_size;        // sizeof(LexToken), guards against layout changes
+    unsigned int flags;             // lexer options that change the stream
+    unsigned long long hash;
+    unsigned long long length;
+    int symbol_count;
+    int token_count;
+} TokenCacheHeader;
+
+const char* token_cache_dir = NULL;
+
+static unsigned long long content_hash(const char* data, size_t length) {
+    unsigned long long h = 14695981039346656037ull;    // 64-bit FNV-1a
+    for (size_t i = 0; i < length; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static unsigned int lexer_flags() {
+    return lex_nested_comments ? 1u : 0u;
+}
+
+static void cache_path(char* out, size_t n, unsigned long long hash, const char* suffix) {
+    snprintf(out, n, "%s/%016llx%s", token_cache_dir, hash, suffix);
+}
+
+// ====== hit/miss totals kept next to the cached files ===================
+static void record_result(int hit, unsigned long long hash) {
+    char path[1024];
+    long hits = 0, misses = 0;
+    snprintf(path, sizeof(path), "%s/stats.txt", token_cache_dir);
+
+    FILE* f = fopen(path, "r");
+    if (f) {
+        if (fscanf(f, "hits %ld misses %ld", &hits, &misses) != 2) hits = misses = 0;
+        fclose(f);
+    }
+    if (hit) hits++; else misses++;
+    MKDIR(token_cache_dir);
+    f = fopen(path, "w");
+    if (f) {
+        fprintf(f, "hits %ld misses %ld\n", hits, misses);
+        fclose(f);
+    }
+    LOG_INFO(LOG_LEXER, "Token cache: %s (%016llx), totals %ld hits / %ld misses\n",
+             hit ? "hit" : "miss", hash, hits, misses);
+}
+
+// ====== load ============================================================
+static char* read_file(const char* path, size_t* size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* buf = (n > 0) ? (char*)malloc((size_t)n) : NULL;
+    if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *size = (size_t)n;
+    return buf;
+}
+
+static int replay(CompilerContext* cc, const char* buf, size_t size, TokenVector* v, const char* data, size_t length, unsigned long long hash) {
+    TokenCacheHeader h;
+    if (size < sizeof(h)) return 0;
+    memcpy(&h, buf, sizeof(h));
+    if (memcmp(h.magic, TOKEN_CACHE_MAGIC, 8) != 0 || h.token_size != sizeof(LexToken)) return 0;
+    if (h.hash != hash || h.length != length || h.flags != lexer_flags()) return 0;
+    if (h.symbol_count < 0 || h.token_count < 1) return 0;
+    if (size - sizeof(h) < length || memcmp(buf + sizeof(h), data, length) != 0) return 0;   // a hash collision
+
+    // the cached ids are only valid if re-interning hands out the same ones:
+    // what is already interned must be a prefix of the cached table
+    size_t symbols_at = sizeof(h) + length;
+    size_t pos = symbols_at;
+    if (!symbols_check(cc, buf, size, &pos, h.symbol_count)) return 0;
+    if ((size - pos) / sizeof(LexToken) != (size_t)h.token_count || (size - pos) % sizeof(LexToken) != 0) return 0;
+    LexToken last;
+    memcpy(&last, buf + size - sizeof(LexToken), sizeof(last));
+    if (last.kind != 0) return 0;
+
+    symbols_replay(cc, buf, symbols_at, h.symbol_count);
+    for (int i = 0; i < h.token_count; i++) {
+        LexToken tok;
+        memcpy(&tok, buf + pos + i * sizeof(LexToken), sizeof(tok));
+        tokens_push(v, tok);
+    }
+    return 1;
+}
+
+int token_cache_load(CompilerContext* cc, TokenVector* v, const char* data, size_t length) {
+    if (!token_cache_dir) return 0;
+    unsigned long long hash = content_hash(data, length);
+    char path[1024];
+    cache_path(path, sizeof(path), hash, ".tok");
+
+    size_t size = 0;
+    char* buf = read_file(path, &size);
+    int hit = buf ? replay(cc, buf, size, v, data, length, hash) : 0;
+    free(buf);
+    record_result(hit, hash);
+    return hit;
+}
+
+// ====== store ===========================================================
+void token_cache_store(CompilerContext* cc, const TokenVector* v, const char* data, size_t length) {
+    if (!token_cache_dir || v->count == 0 || v->data[v->count - 1].kind != 0) return;
+    if (cc->lex_errors > 0) return;    // the cache can't replay lexer error messages
+
+    unsigned long long hash = content_hash(data, length);
+    char path[1024], tmp[1024];
+    cache_path(path, sizeof(path), hash, ".tok");
+    cache_path(tmp, sizeof(tmp), hash, ".tmp");
+
+    MKDIR(token_cache_dir);
+    FILE* f = fopen(tmp, "wb");
+    if (!f) {
+        printf("Warning:: cannot write token cache %s\n", tmp);
+        return;
+    }
+
+    TokenCacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TOKEN_CACHE_MAGIC, 8);
+    h.token_size = sizeof(LexToken);
+    h.flags = lexer_flags();
+    h.hash = hash;
+    h.length = length;
+    h.symbol_count = intern_count(cc);
+    h.token_count = v->count;
+    fwrite(&h, sizeof(h), 1, f);
+    fwrite(data, 1, length, f);
+
+    symbols_write(cc, f);
+    fwrite(v->data, sizeof(LexToken), v->count, f);
+
+    if (fclose(f) != 0) {
+        remove(tmp);
+        return;
+    }
+    remove(path);   // rename() won't replace an existing file on Windows
+    rename(tmp, path);
+}
@@ -0,0 +1,16 @@
+#ifndef TOKEN_CACHE_H
+#define TOKEN_CACHE_H
+
+#include <stddef.h>
+#include "tokens.h"
+
+// directory holding cached token streams, NULL = caching off (--token-cache=DIR)
+extern const char* token_cache_dir;
+
+// on a hit, fill v (and the interner) from DIR/<hash>.tok and return 1
+int token_cache_load(struct CompilerContext* cc, TokenVector* v, const char* data, size_t length);
+
+// save a clean lex of data (v must end with the kind 0 token)
+void token_cache_store(struct CompilerContext* cc, const TokenVector* v, const char* data, size_t length);
+
+#endif
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "token_queue.h"
+#include "symbols.h"
+#include "compiler.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+    #include <malloc.h>
+    #define queue_pause() SwitchToThread()
+    #define queue_alloc(size) _aligned_malloc(size, 64)
+    #define queue_free(p) _aligned_free(p)
+#else
+    #include <pthread.h>
+    #include <sched.h>
+    #define queue_pause() sched_yield()
+    #define queue_alloc(size) aligned_alloc(64, size)
+    #define queue_free(p) free(p)
+#endif
+
+// head and tail sit on separate cache lines so the two threads don't share one
+struct TokenQueue {
+    LexToken slots[TOKEN_QUEUE_SIZE];
+    _Alignas(64) atomic_size_t head;    // next slot the parser reads
+    _Alignas(64) atomic_size_t tail;    // next slot the lexer writes
+    _Alignas(64) long lexer_stalls;     // written by the lexer thread only
+    long parser_stalls;                 // the rest by the parser thread only
+    size_t max_depth;
+    double depth_sum;
+    long pops;
+    CompilerContext* cc;    // whose scanner (cc->lexer) the thread runs
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE lexer_thread;
+#else
+    pthread_t lexer_thread;
+#endif
+};
+
+// ====== producer: the flex scanner on its own thread ====================
+static void queue_push(TokenQueue* q, LexToken tok) {
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    if (tail - atomic_load_explicit(&q->head, memory_order_acquire) == TOKEN_QUEUE_SIZE) {
+        q->lexer_stalls++;
+        while (tail - atomic_load_explicit(&q->head, memory_order_acquire) == TOKEN_QUEUE_SIZE) queue_pause();
+    }
+    q->slots[tail & (TOKEN_QUEUE_SIZE - 1)] = tok;
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+}
+
+static void lexer_main(TokenQueue* q) {
+    for (;;) {
+        LexToken tok = lexer_next(&q->cc->lexer);
+        queue_push(q, tok);
+        if (tok.kind == 0) break;
+    }
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI lexer_entry(LPVOID arg) {
+    lexer_main((TokenQueue*)arg);
+    return 0;
+}
+#else
+static void* lexer_entry(void* arg) {
+    lexer_main((TokenQueue*)arg);
+    return NULL;
+}
+#endif
+
+TokenQueue* token_queue_start(CompilerContext* cc) {
+    TokenQueue* q = (TokenQueue*)queue_alloc(sizeof(TokenQueue));
+    if (!q) return NULL;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->lexer_stalls = 0;
+    q->parser_stalls = 0;
+    q->max_depth = 0;
+    q->depth_sum = 0;
+    q->pops = 0;
+    q->cc = cc;
+#if defined(_WIN32) || defined(_WIN64)
+    q->lexer_thread = CreateThread(NULL, 0, lexer_entry, q, 0, NULL);
+    if (!q->lexer_thread) {
+        queue_free(q);
+        return NULL;
+    }
+#else
+    if (pthread_create(&q->lexer_thread, NULL, lexer_entry, q) != 0) {
+        queue_free(q);
+        return NULL;
+    }
+#endif
+    return q;
+}
+
+// ====== consumer: the parser ============================================
+LexToken token_queue_pop(TokenQueue* q) {
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (tail == head) {
+        q->parser_stalls++;
+        while ((tail = atomic_load_explicit(&q->tail, memory_order_acquire)) == head) queue_pause();
+    }
+    size_t depth = tail - head;
+    if (depth > q->max_depth) q->max_depth = depth;
+    q->depth_sum += (double)depth;
+    q->pops++;
+
+    LexToken tok = q->slots[head & (TOKEN_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return tok;
+}
+
+TokenQueueStats token_queue_stats(const TokenQueue* q) {
+    TokenQueueStats s;
+    s.tokens = q->pops;
+    s.lexer_stalls = q->lexer_stalls;
+    s.parser_stalls = q->parser_stalls;
+    s.max_depth = q->max_depth;
+    s.avg_depth = q->pops ? q->depth_sum / q->pops : 0.0;
+    return s;
+}
+
+void token_queue_finish(TokenQueue* q) {
+#if defined(_WIN32) || defined(_WIN64)
+    WaitForSingleObject(q->lexer_thread, INFINITE);
+    CloseHandle(q->lexer_thread);
+#else
+    pthread_join(q->lexer_thread, NULL);
+#endif
+    queue_free(q);
+}
@@ -0,0 +1,38 @@
+#ifndef TOKEN_QUEUE_H
+#define TOKEN_QUEUE_H
+
+#include <stddef.h>
+#include "tokens.h"
+
+// bounded single-producer / single-consumer ring between the lexer thread
+// and the parser; must be a power of two
+#ifndef TOKEN_QUEUE_SIZE
+    #define TOKEN_QUEUE_SIZE 4096
+#endif
+
+typedef struct {
+    long tokens;            // tokens passed through the ring
+    long lexer_stalls;      // times the lexer found the ring full (parser is behind)
+    long parser_stalls;     // times the parser found the ring empty (lexer is behind)
+    size_t max_depth;       // most tokens queued at once
+    double avg_depth;       // queue depth seen by the parser, averaged over pops
+} TokenQueueStats;
+
+// one pipelined scan: the compilation's flex scanner on its own thread,
+// filling a ring the parser pops from
+typedef struct TokenQueue TokenQueue;
+struct CompilerContext;
+
+// start lexing cc's source (lexer_scan_source done) on a new thread; NULL if
+// the thread could not be started
+TokenQueue* token_queue_start(struct CompilerContext* cc);
+
+// block until the next token is available; the kind 0 token is the last one
+LexToken token_queue_pop(TokenQueue* q);
+
+TokenQueueStats token_queue_stats(const TokenQueue* q);
+
+// join the lexer thread (after the kind 0 token was popped) and free q
+void token_queue_finish(TokenQueue* q);
+
+#endif
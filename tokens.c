@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tokens.h"
+#include "symbols.h"
+#include "simd_scan.h"
+#include "token_queue.h"
+#include "token_cache.h"
+#include "log.h"
+#include "compiler.h"
+#include "y.tab.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+int lex_scanner = SCANNER_FLEX;
+int lex_threads = 1;
+int lex_pipeline = 0;
+
+// ====== the flex scanner ================================================
+// every compilation scans with its own reentrant scanner (cc->lexer), so
+// compilations on different threads lex at the same time
+static void flex_begin(CompilerContext* cc) {
+    if (cc->source_data) lexer_scan_source(&cc->lexer, cc->source_data, cc->source_length);
+}
+
+static void flex_end(CompilerContext* cc) {
+    LexState* ls = &cc->lexer;
+    if (cc->source_data) lexer_release_source(ls);
+    cc->lex_errors += ls->error_count;
+}
+
+void tokens_init(TokenVector* v) {
+    v->data = NULL;
+    v->count = 0;
+    v->cap = 0;
+}
+
+void tokens_push(TokenVector* v, LexToken tok) {
+    if (v->count >= v->cap) {
+        v->cap = (v->cap == 0) ? 1024 : v->cap * 2;
+        v->data = (LexToken*)realloc(v->data, sizeof(LexToken) * v->cap);
+        if (!v->data) {
+            printf("Error:: out of memory in token vector\n");
+            exit(1);
+        }
+    }
+    v->data[v->count++] = tok;
+}
+
+void tokens_free(TokenVector* v) {
+    free(v->data);
+    tokens_init(v);
+}
+
+void tokens_set_source(CompilerContext* cc, char* data, size_t length) {
+    cc->source_data = data;
+    cc->source_length = length;
+}
+
+static int flex_lex_all(CompilerContext* cc, TokenVector* v) {
+    for (;;) {
+        LexToken tok = lexer_next(&cc->lexer);
+        tokens_push(v, tok);
+        if (tok.kind == 0) break;
+    }
+    return v->count;
+}
+
+// ====== --lex-threads with flex: a scanner per chunk ====================
+// The source is split at newlines the way simd_scan_all splits it (no token
+// spans a newline). flex writes into the buffer it scans and needs two NULs
+// after it, so each chunk is scanned from its own copy, by its own reentrant
+// scanner, on its own thread. Ids are interned and unknown characters
+// reported afterwards on the calling thread, in source order, so the result
+// is the serial scan's.
+typedef struct {
+    LexState lexer;         // chunked: lexer.comment_depth is the depth at the end
+    char* text;             // src[begin, end) and two NULs
+    size_t begin, end;
+    TokenVector tokens;     // without the kind 0 token, offsets and lines chunk-relative
+    int start_depth;        // block comments taken to be open where the chunk starts
+} FlexChunk;
+
+static void flex_chunk_scan(FlexChunk* c, int start_depth) {
+    c->start_depth = start_depth;
+    c->tokens.count = 0;
+    lexer_scan_chunk(&c->lexer, c->text, c->end - c->begin, start_depth);
+    for (;;) {
+        LexToken tok = lexer_next(&c->lexer);
+        if (tok.kind == 0) break;
+        tokens_push(&c->tokens, tok);
+    }
+    lexer_release_source(&c->lexer);
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+typedef HANDLE ChunkThread;
+
+static DWORD WINAPI chunk_worker(LPVOID arg) {
+    flex_chunk_scan((FlexChunk*)arg, 0);
+    return 0;
+}
+
+static int chunk_thread_start(ChunkThread* t, FlexChunk* c) {
+    *t = CreateThread(NULL, 0, chunk_worker, c, 0, NULL);
+    return *t ? 0 : -1;
+}
+
+static void chunk_thread_join(ChunkThread t) {
+    WaitForSingleObject(t, INFINITE);
+    CloseHandle(t);
+}
+#else
+typedef pthread_t ChunkThread;
+
+static void* chunk_worker(void* arg) {
+    flex_chunk_scan((FlexChunk*)arg, 0);
+    return NULL;
+}
+
+static int chunk_thread_start(ChunkThread* t, FlexChunk* c) {
+    return pthread_create(t, NULL, chunk_worker, c);
+}
+
+static void chunk_thread_join(ChunkThread t) {
+    pthread_join(t, NULL);
+}
+#endif
+
+// 0 if the source is too small to be worth splitting (nothing is scanned)
+static int flex_lex_chunks(CompilerContext* cc, TokenVector* v, int threads) {
+    const char* src = cc->source_data;
+    size_t len = cc->source_length;
+    int n = threads;
+    if ((size_t)n > len / SIMD_SCAN_MIN_CHUNK) n = (int)(len / SIMD_SCAN_MIN_CHUNK);
+    if (n < 2) return 0;
+
+    FlexChunk* chunks = (FlexChunk*)calloc(n, sizeof(FlexChunk));
+    ChunkThread* pool = (ChunkThread*)malloc(sizeof(ChunkThread) * n);
+    int* started = (int*)calloc(n, sizeof(int));
+    if (!chunks || !pool || !started) {
+        printf("Error:: out of memory in scanner\n");
+        exit(1);
+    }
+    int count = 0;
+    size_t begin = 0;
+    for (int k = 0; k < n && begin < len; k++) {
+        size_t end = len;
+        if (k < n - 1) {
+            const char* nl = memchr(src + len * (k + 1) / n, '\n', len - len * (k + 1) / n);
+            end = nl ? (size_t)(nl - src) + 1 : len;
+            if (end <= begin) continue;
+        }
+        FlexChunk* c = &chunks[count++];
+        c->begin = begin;
+        c->end = end;
+        c->text = (char*)malloc(end - begin + 2);
+        if (!c->text) {
+            printf("Error:: out of memory in scanner\n");
+            exit(1);
+        }
+        memcpy(c->text, src + begin, end - begin);
+        c->text[end - begin] = c->text[end - begin + 1] = '\0';
+        lexer_create(cc, &c->lexer);
+        c->lexer.chunked = 1;
+        tokens_init(&c->tokens);
+        begin = end;
+    }
+
+    // chunk 0 runs here; a chunk whose thread fails to start is scanned after
+    for (int k = 1; k < count; k++) started[k] = (chunk_thread_start(&pool[k], &chunks[k]) == 0);
+    flex_chunk_scan(&chunks[0], 0);
+    for (int k = 1; k < count; k++) {
+        if (started[k]) chunk_thread_join(pool[k]);
+        else flex_chunk_scan(&chunks[k], 0);
+    }
+
+    // fix-up: each chunk was scanned as if no comment was open at its start;
+    // rescan (serially) only the ones where that guess was wrong
+    for (int k = 1; k < count; k++) {
+        if (chunks[k].start_depth != chunks[k - 1].lexer.comment_depth) {
+            flex_chunk_scan(&chunks[k], chunks[k - 1].lexer.comment_depth);
+        }
+    }
+
+    // stitch, rebasing offsets and lines, then report unknown characters in source order
+    int line = 1;
+    int open_comment_line = 0;
+    int first = v->count;
+    for (int k = 0; k < count; k++) {
+        FlexChunk* c = &chunks[k];
+        for (int t = 0; t < c->tokens.count; t++) {
+            LexToken tok = c->tokens.data[t];
+            tok.offset += (int)c->begin;
+            tok.line += line - 1;
+            tokens_push(v, tok);
+        }
+        for (int u = 0; u < c->lexer.unknown_count; u++) {
+            const char* ch = src + c->begin + c->lexer.unknown[u];
+            printf("Your input does not match for any lexemes defined in this language!\nUnknown character: %.1s (ASCII: %d)\n", ch, ch[0]);
+            cc->lex_errors++;
+        }
+        if (c->lexer.comment_depth > 0 && c->lexer.comment_line > 0) open_comment_line = line + c->lexer.comment_line - 1;
+        line += c->lexer.line - 1;
+    }
+    if (chunks[count - 1].lexer.comment_depth > 0) {
+        printf("Unterminated comment starting at line %d\n", open_comment_line);
+        cc->lex_errors++;
+    }
+    tokens_intern(cc, v, src, first);
+
+    LexToken eof;
+    eof.kind = 0;
+    eof.offset = (int)len;
+    eof.length = 0;
+    eof.line = line;
+    eof.id = INTERN_NONE;
+    tokens_push(v, eof);
+
+    for (int k = 0; k < count; k++) {
+        lexer_destroy(&chunks[k].lexer);
+        tokens_free(&chunks[k].tokens);
+        free(chunks[k].text);
+    }
+    free(started);
+    free(pool);
+    free(chunks);
+    return 1;
+}
+
+// the flex scanner over the whole source, in chunks on lex_threads threads
+// when it is large enough
+static void flex_scan(CompilerContext* cc, TokenVector* v) {
+    if (lex_threads > 1 && cc->source_data && flex_lex_chunks(cc, v, lex_threads)) return;
+    flex_begin(cc);
+    flex_lex_all(cc, v);
+    flex_end(cc);
+}
+
+// ====== interning runs on the calling thread, in token order ============
+// so ids come out exactly as the serial flex scan hands them out
+void tokens_intern(CompilerContext* cc, TokenVector* v, const char* src, int from) {
+    for (int k = from; k < v->count; k++) {
+        LexToken* t = &v->data[k];
+        const char* text = src + t->offset;
+        switch (t->kind) {
+            case ID:              t->id = add_symbol_n(cc, text, t->length, "id", "ID"); break;
+            case ALPHANUM:        t->id = add_symbol_n(cc, text, t->length, "alphanum", "ALPHANUM"); break;
+            case INTEGER_LITERAL:
+            case FLOAT_LITERAL:   t->id = intern_n(cc, text, t->length); break;
+        }
+    }
+}
+
+static int same_token(const LexToken* a, const LexToken* b) {
+    return a->kind == b->kind && a->offset == b->offset && a->length == b->length
+        && a->line == b->line && a->id == b->id;
+}
+
+// ====== lexing pass: scan the whole input before parsing starts =====
+int tokens_lex_all(CompilerContext* cc, TokenVector* v) {
+    if (lex_scanner == SCANNER_SIMD && cc->source_data) {
+        return simd_scan_all(cc, v, cc->source_data, cc->source_length, lex_threads);
+    }
+    if (lex_scanner == SCANNER_CHECK && cc->source_data) {
+        TokenVector simd;
+        tokens_init(&simd);
+        simd_scan_all(cc, &simd, cc->source_data, cc->source_length, lex_threads);
+        flex_scan(cc, v);
+
+        int n = (simd.count < v->count) ? simd.count : v->count;
+        for (int i = 0; i < n; i++) {
+            if (!same_token(&simd.data[i], &v->data[i])) {
+                printf("Scanner check FAILED at token %d: flex kind=%d offset=%d length=%d line=%d, simd kind=%d offset=%d length=%d line=%d\n",
+                       i, v->data[i].kind, v->data[i].offset, v->data[i].length, v->data[i].line,
+                       simd.data[i].kind, simd.data[i].offset, simd.data[i].length, simd.data[i].line);
+                exit(1);
+            }
+        }
+        if (simd.count != v->count) {
+            printf("Scanner check FAILED: flex produced %d tokens, simd %d\n", v->count, simd.count);
+            exit(1);
+        }
+        printf("Scanner check OK: %d tokens identical (simd width %d)\n", v->count, simd_scan_width());
+        tokens_free(&simd);
+        return v->count;
+    }
+    flex_scan(cc, v);
+    return v->count;
+}
+
+// ====== pipelined lexing: the parser pulls tokens as it needs them =====
+void tokens_start(CompilerContext* cc, TokenVector* v) {
+    cc->token_queue = NULL;
+    // a cache hit replaces scanning altogether
+    if (cc->source_data && token_cache_load(cc, v, cc->source_data, cc->source_length)) return;
+
+    if (lex_pipeline && lex_scanner == SCANNER_FLEX) {
+        flex_begin(cc);
+        cc->token_queue = token_queue_start(cc);
+        if (cc->token_queue) {
+            tokens_fill(cc, v, 0);
+            return;
+        }
+        flex_end(cc);
+    }
+    tokens_lex_all(cc, v);
+    if (cc->source_data) token_cache_store(cc, v, cc->source_data, cc->source_length);
+}
+
+void tokens_fill(CompilerContext* cc, TokenVector* v, int index) {
+    while (cc->token_queue && v->count <= index) {
+        LexToken tok = token_queue_pop(cc->token_queue);
+        tokens_push(v, tok);
+        if (tok.kind == 0) {
+            TokenQueueStats s = token_queue_stats(cc->token_queue);
+            token_queue_finish(cc->token_queue);
+            cc->token_queue = NULL;
+
+            flex_end(cc);
+            LOG_INFO(LOG_LEXER, "Token queue: %ld tokens, depth avg %.1f max %zu, lexer stalls (queue full) %ld, parser stalls (queue empty) %ld\n",
+                     s.tokens, s.avg_depth, s.max_depth, s.lexer_stalls, s.parser_stalls);
+            if (cc->source_data) token_cache_store(cc, v, cc->source_data, cc->source_length);
+        }
+    }
+}
+
+void tokens_drain(CompilerContext* cc, TokenVector* v) {
+    while (cc->token_queue) tokens_fill(cc, v, v->count);
+}
@@ -0,0 +1,92 @@
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include <stddef.h>
+
+struct CompilerContext;
+
+// fixed-size token record produced by the lexing pass ===================
+typedef struct {
+    int kind;       // token code from y.tab.h, 0 = end of input
+    int offset;     // byte offset of the lexeme in the source
+    int length;     // lexeme length in bytes
+    int line;
+    int id;         // interned lexeme for ids and literals, INTERN_NONE otherwise
+} LexToken;
+
+// contiguous token array, always terminated by a kind 0 token ============
+typedef struct {
+    LexToken* data;
+    int count;
+    int cap;
+} TokenVector;
+
+// ====== the flex scanner (tma3.l) ======================================
+// a reentrant scanner and what its actions keep (its yyextra points here);
+// each compilation has its own (CompilerContext.lexer), so compilations on
+// different threads lex at the same time
+typedef struct {
+    struct CompilerContext* cc;     // whose lexeme table the actions intern into
+    void* scanner;          // yyscan_t
+    void* buffer;           // YY_BUFFER_STATE over the source, NULL between scans
+    int line;
+    int input_offset;       // bytes consumed so far
+    int token_offset;       // start of the token yylex just returned
+    int token_id;           // its interned lexeme, INTERN_NONE for the rest
+    int error_count;        // unknown characters / unterminated comments this scan
+                            // (added to the compilation's lex_errors, compiler.h)
+    int comment_depth;
+    int comment_line;       // where the open block comment started, 0 = before this chunk
+    // a chunk of a --lex-threads scan: ids and literals are interned and
+    // unknown characters reported afterwards, in source order (tokens.c)
+    int chunked;
+    int* unknown;           // offsets of the unknown characters, chunked only
+    int unknown_count, unknown_cap;
+} LexState;
+
+extern int lex_nested_comments;   // 1 = /* */ comments nest
+
+void tokens_init(TokenVector* v);
+void tokens_push(TokenVector* v, LexToken tok);
+void tokens_free(TokenVector* v);
+
+void lexer_create(struct CompilerContext* cc, LexState* ls);
+void lexer_destroy(LexState* ls);
+
+// point the scanner at a buffer ending in two NULs (SourceBuffer)
+void lexer_scan_source(LexState* ls, char* data, size_t length);
+void lexer_scan_chunk(LexState* ls, char* data, size_t length, int comment_depth);
+void lexer_release_source(LexState* ls);
+
+// the next token, kind 0 at the end of input
+LexToken lexer_next(LexState* ls);
+
+// which scanner fills the token vector
+typedef enum {
+    SCANNER_FLEX,   // generated DFA from tma3.l
+    SCANNER_SIMD,   // simd_scan.c
+    SCANNER_CHECK   // run both, stop if the streams differ
+} ScannerKind;
+
+extern int lex_scanner;
+extern int lex_threads;     // scanner threads for large inputs
+extern int lex_pipeline;    // 1 = flex runs on its own thread, tokens arrive on demand
+
+// intern the ids and literals of v->data[from..] in token order (the
+// parallel scanners leave them for the calling thread)
+void tokens_intern(struct CompilerContext* cc, TokenVector* v, const char* src, int from);
+
+// hand the loaded source to the scanners (see source.h)
+void tokens_set_source(struct CompilerContext* cc, char* data, size_t length);
+
+// scan to end of input and store every token
+int tokens_lex_all(struct CompilerContext* cc, TokenVector* v);
+
+// parser entry points: start lexing (whole input, or the lexer thread when
+// pipelining), make sure v->data[index] exists (or v ends with the kind 0
+// token), and pull everything that is left
+void tokens_start(struct CompilerContext* cc, TokenVector* v);
+void tokens_fill(struct CompilerContext* cc, TokenVector* v, int index);
+void tokens_drain(struct CompilerContext* cc, TokenVector* v);
+
+#endif
@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tree_writer.h"
+#include "compiler.h"
+
+const char* tree_file_name(int format) {
+    switch (format) {
+    case TREE_NDJSON: return "syntax_tree.ndjson";
+    case TREE_BINARY: return "syntax_tree.bin";
+    default:          return "syntax_tree.txt";
+    }
+}
+
+// ====== buffered output =================================================
+#define TREE_BUFFER_SIZE (1 << 20)
+
+typedef struct {
+    FILE* out;
+    char* buf;
+    size_t used;
+    int failed;
+} TreeOut;
+
+static void out_flush(TreeOut* o) {
+    if (o->used && fwrite(o->buf, 1, o->used, o->out) != o->used) o->failed = 1;
+    o->used = 0;
+}
+
+static void out_bytes(TreeOut* o, const void* p, size_t n) {
+    if (n == 0) return;     // p may be NULL, e.g. the root's empty prefix
+    if (o->used + n > TREE_BUFFER_SIZE) {
+        out_flush(o);
+        if (n > TREE_BUFFER_SIZE) {
+            if (fwrite(p, 1, n, o->out) != n) o->failed = 1;
+            return;
+        }
+    }
+    memcpy(o->buf + o->used, p, n);
+    o->used += n;
+}
+
+static void out_str(TreeOut* o, const char* s) {
+    out_bytes(o, s, strlen(s));
+}
+
+static void out_int(TreeOut* o, long v) {
+    char b[24];
+    int n = snprintf(b, sizeof(b), "%ld", v);
+    out_bytes(o, b, (size_t)n);
+}
+
+static void out_u8(TreeOut* o, unsigned v) {
+    unsigned char b = (unsigned char)v;
+    out_bytes(o, &b, 1);
+}
+
+static void out_u16(TreeOut* o, unsigned v) {
+    unsigned char b[2] = { (unsigned char)v, (unsigned char)(v >> 8) };
+    out_bytes(o, b, 2);
+}
+
+static void out_u32(TreeOut* o, uint32_t v) {
+    unsigned char b[4] = { (unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24) };
+    out_bytes(o, b, 4);
+}
+
+static void out_json_string(TreeOut* o, const char* s) {
+    out_bytes(o, "\"", 1);
+    for (; *s; s++) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\') {
+            char e[2] = { '\\', (char)ch };
+            out_bytes(o, e, 2);
+        } else if (ch < 0x20) {
+            char e[8];
+            snprintf(e, sizeof(e), "\\u%04x", ch);
+            out_bytes(o, e, 6);
+        } else {
+            out_bytes(o, s, 1);
+        }
+    }
+    out_bytes(o, "\"", 1);
+}
+
+// ====== one node per format =============================================
+static void text_node(CompilerContext* cc, TreeOut* o, const CompactAST* c, NodeRef n) {
+    const char* lexeme = compact_lexeme(cc, c, n);
+    out_str(o, compact_name(c, n));
+    if (lexeme[0]) {
+        out_bytes(o, " -> ", 4);
+        out_str(o, lexeme);
+    }
+    out_bytes(o, "\n", 1);
+}
+
+static void json_node(CompilerContext* cc, TreeOut* o, const CompactAST* c, NodeRef n, long id, long parent) {
+    out_bytes(o, "{\"id\":", 6);
+    out_int(o, id);
+    out_bytes(o, ",\"parent\":", 10);
+    out_int(o, parent);
+    out_bytes(o, ",\"kind\":", 8);
+    out_json_string(o, compact_name(c, n));
+    out_bytes(o, ",\"lexeme\":", 10);
+    out_json_string(o, compact_lexeme(cc, c, n));
+    out_bytes(o, ",\"line\":", 8);
+    out_int(o, compact_line(c, n));
+    out_bytes(o, "}\n", 2);
+}
+
+static void binary_node(CompilerContext* cc, TreeOut* o, const CompactAST* c, NodeRef n) {
+    uint32_t children = 0;
+    for (NodeRef ch = c->child[n]; ch != NODE_NIL; ch = c->sibling[ch]) children++;
+    const char* lexeme = compact_lexeme(cc, c, n);
+    size_t length = strlen(lexeme);
+    if (length > 0xFFFF) length = 0xFFFF;
+    out_u16(o, c->kind[n]);
+    out_u32(o, children);
+    out_u32(o, (uint32_t)c->line[n]);
+    out_u16(o, (unsigned)length);
+    out_bytes(o, lexeme, length);
+}
+
+static void binary_header(TreeOut* o, uint32_t nodes) {
+    out_bytes(o, TREE_BINARY_MAGIC, 8);
+    out_u16(o, AST_KIND_COUNT);
+    for (int k = 0; k < AST_KIND_COUNT; k++) {
+        size_t length = strlen(ast_kind_name[k]);
+        out_u8(o, (unsigned)length);
+        out_bytes(o, ast_kind_name[k], length);
+    }
+    out_u32(o, nodes);
+}
+
+// ====== the walk ========================================================
+// one frame per open level: the next sibling to visit there and the id of
+// the parent. Text output keeps the indentation of every open level in one
+// buffer, 4 bytes per level below the root's children.
+typedef struct {
+    NodeRef next;
+    long parent;
+} TreeFrame;
+
+typedef struct {
+    TreeFrame* frames;
+    int depth, cap;
+    char* prefix;
+    size_t prefix_length, prefix_cap;
+} TreeWalk;
+
+static void walk_push(TreeWalk* w, NodeRef first, long parent) {
+    if (w->depth == w->cap) {
+        w->cap = w->cap ? w->cap * 2 : 64;
+        w->frames = (TreeFrame*)realloc(w->frames, sizeof(TreeFrame) * w->cap);
+        if (!w->frames) {
+            printf("Error:: out of memory writing the syntax tree\n");
+            exit(1);
+        }
+    }
+    w->frames[w->depth].next = first;
+    w->frames[w->depth].parent = parent;
+    w->depth++;
+}
+
+static void walk_indent(TreeWalk* w, const char* step) {
+    if (w->prefix_length + 4 > w->prefix_cap) {
+        w->prefix_cap = w->prefix_cap ? w->prefix_cap * 2 : 256;
+        w->prefix = (char*)realloc(w->prefix, w->prefix_cap);
+        if (!w->prefix) {
+            printf("Error:: out of memory writing the syntax tree\n");
+            exit(1);
+        }
+    }
+    memcpy(w->prefix + w->prefix_length, step, 4);
+    w->prefix_length += 4;
+}
+
+// preorder below root (root itself is written by the caller as node 0);
+// with out == NULL it only counts the nodes
+static uint32_t walk_children(CompilerContext* cc, const CompactAST* c, NodeRef root, int format, TreeOut* o) {
+    TreeWalk w = {0};
+    uint32_t count = 1;
+    if (c->child[root] != NODE_NIL) walk_push(&w, c->child[root], 0);
+    while (w.depth > 0) {
+        TreeFrame* f = &w.frames[w.depth - 1];
+        NodeRef n = f->next;
+        if (n == NODE_NIL) {
+            w.depth--;
+            if (w.depth > 0 && w.prefix_length >= 4) w.prefix_length -= 4;
+            continue;
+        }
+        f->next = c->sibling[n];
+        long id = count++;
+        int last = c->sibling[n] == NODE_NIL;
+        if (o) {
+            switch (format) {
+            case TREE_NDJSON:
+                json_node(cc, o, c, n, id, f->parent);
+                break;
+            case TREE_BINARY:
+                binary_node(cc, o, c, n);
+                break;
+            default:
+                out_bytes(o, w.prefix, w.prefix_length);
+                out_bytes(o, last ? "`-- " : "|-- ", 4);
+                text_node(cc, o, c, n);
+                break;
+            }
+        }
+        if (c->child[n] != NODE_NIL) {
+            if (format == TREE_TEXT) walk_indent(&w, last ? "    " : "|   ");
+            walk_push(&w, c->child[n], id);
+        }
+    }
+    free(w.frames);
+    free(w.prefix);
+    return count;
+}
+
+int tree_write(CompilerContext* cc, const CompactAST* c, NodeRef root, int format, FILE* out) {
+    if (root == NODE_NIL || !out) return -1;
+    TreeOut o;
+    o.out = out;
+    o.used = 0;
+    o.failed = 0;
+    o.buf = (char*)malloc(TREE_BUFFER_SIZE);
+    if (!o.buf) {
+        printf("Error:: out of memory writing the syntax tree\n");
+        exit(1);
+    }
+
+    switch (format) {
+    case TREE_NDJSON:
+        json_node(cc, &o, c, root, 0, -1);
+        break;
+    case TREE_BINARY:
+        binary_header(&o, walk_children(cc, c, root, format, NULL));
+        binary_node(cc, &o, c, root);
+        break;
+    default:
+        text_node(cc, &o, c, root);
+        break;
+    }
+    walk_children(cc, c, root, format, &o);
+
+    out_flush(&o);
+    free(o.buf);
+    return o.failed ? -1 : 0;
+}
+
+void tree_write_file(CompilerContext* cc, const CompactAST* c, NodeRef root) {
+    const char* file_name = tree_file_name(cc->tree_format);
+    FILE* output_file = compiler_open_output(cc, file_name, cc->tree_format == TREE_BINARY ? "wb" : "w");
+    if (!output_file) {
+        printf("Error:: Cannot create syntax tree file\n");
+        exit(1);
+    }
+    if (tree_write(cc, c, root, cc->tree_format, output_file) != 0) {
+        printf("Error:: Cannot write syntax tree file\n");
+        exit(1);
+    }
+    fclose(output_file);
+    printf("Syntax tree written to %s\n", file_name);
+}
@@ -0,0 +1,43 @@
+#ifndef TREE_WRITER_H
+#define TREE_WRITER_H
+
+#include <stdio.h>
+#include "compact_ast.h"
+
+// ====== syntax tree output formats ======================================
+// --tree=text|json|binary picks what write_syntax_tree produces:
+//   text    files/syntax_tree.txt, the indented |-- / `-- drawing
+//   json    files/syntax_tree.ndjson, one object per node in preorder:
+//           {"id":0,"parent":-1,"kind":"prog","lexeme":"","line":0}
+//   binary  files/syntax_tree.bin, see below
+// Every format is produced by one iterative preorder walk with an explicit
+// stack and a single shared indentation buffer, written through a large
+// output buffer: no recursion, no per-level copies, no limit on depth or
+// on the number of children.
+typedef enum {
+    TREE_TEXT,
+    TREE_NDJSON,
+    TREE_BINARY
+} TreeFormat;
+
+// binary layout, all integers little-endian:
+//   magic "TMA3AST1"
+//   u16 kind count, then per kind: u8 name length, name bytes (ast_kind_name)
+//   u32 node count
+//   per node in preorder: u16 kind, u32 child count, i32 line,
+//                         u16 lexeme length, lexeme bytes
+// a node's children follow it directly, so the child counts are enough to
+// rebuild the tree in one pass
+#define TREE_BINARY_MAGIC "TMA3AST1"
+
+// file name for a format under the output directory
+const char* tree_file_name(int format);
+
+// write the subtree at root; 0 on success, -1 if the output failed
+int tree_write(struct CompilerContext* cc, const CompactAST* c, NodeRef root, int format, FILE* out);
+
+// write it in cc->tree_format to tree_file_name() under cc's output directory;
+// exits if the file can't be written
+void tree_write_file(struct CompilerContext* cc, const CompactAST* c, NodeRef root);
+
+#endif
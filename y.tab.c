@@ -1,23 +1,22 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* A Bison parser, made by GNU Bison 2.4.1.  */
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-/* Skeleton implementation for Bison's Yacc-like parsers in C
-   
-      Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
-   
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
    the Free Software Foundation, either version 3 of the License, or
    (at your option) any later version.
-   
+
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
    GNU General Public License for more details.
-   
+
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -28,13 +27,17 @@
    special exception, which will cause the skeleton and the resulting
    Bison output files to be licensed under the GNU General Public
    License without this special exception.
-   
+
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -42,17 +45,17 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.4.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -60,14 +63,10 @@
 /* Pull parsers.  */
 #define YYPULL 1
 
-/* Using locations.  */
-#define YYLSP_NEEDED 0
-
 
 
-/* Copy the first part of user declarations.  */
 
-/* Line 189 of yacc.c  */
+/* First part of user prologue.  */
 #line 1 "tma3.y"
 
     #include <stdio.h>
@@ -75,217 +74,435 @@
     #include <string.h>
     #include "symbols.h"
     #include "parser.h"
+    #include "source.h"
+    #include "log.h"
+    #include "simd_scan.h"
+    #include "token_cache.h"
+    #include "parallel_parse.h"
+    #include "compiler.h"
+    #include "tree_writer.h"
+    #include "ast_snapshot.h"
+    #include "func_cache.h"
+    #include "ast_visit.h"
+    #include "server.h"
+
+#line 90 "y.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
 
-    extern int yylex();
-    extern int lineno;
-    extern int yywrap();
-    extern struct Token t;
-    extern int yylineno;
-
-    int yyparse();
-    void yyerror(const char* s);
-
-
-/* Line 189 of yacc.c  */
-#line 91 "y.tab.c"
-
-/* Enabling traces.  */
+/* Use api.header.include to #include this header
+   instead of duplicating it here.  */
+#ifndef YY_YY_Y_TAB_H_INCLUDED
+# define YY_YY_Y_TAB_H_INCLUDED
+/* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
 #endif
-
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
+#if YYDEBUG
+extern int yydebug;
 #endif
+/* "%code requires" blocks.  */
+#line 27 "tma3.y"
 
-/* Enabling the token table.  */
-#ifndef YYTOKEN_TABLE
-# define YYTOKEN_TABLE 0
-#endif
+    struct ASTNode;
+    struct CompilerContext;
+    typedef struct LalrParse LalrParse;
 
+    // a right-nested list (varDeclOrStmtList holding the next one) built by a
+    // left-recursive rule: head is the outermost list node, tail the innermost
+    // one, which is still empty
+    typedef struct {
+        struct ASTNode* head;
+        struct ASTNode* tail;
+    } LalrList;
 
-/* Tokens.  */
+#line 139 "y.tab.c"
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     IF = 258,
-     ELSE = 259,
-     THEN = 260,
-     WHILE = 261,
-     RETURN = 262,
-     READ = 263,
-     WRITE = 264,
-     FUNC = 265,
-     CLASS = 266,
-     CONSTRUCT = 267,
-     ATTRIBUTE = 268,
-     IMPLEMENT = 269,
-     ISA = 270,
-     SELF = 271,
-     PUBLIC = 272,
-     PRIVATE = 273,
-     LOCAL = 274,
-     VOID = 275,
-     SEMICOLON = 276,
-     COMMA = 277,
-     DOT = 278,
-     COLON = 279,
-     LEFTPAREN = 280,
-     RIGHTPAREN = 281,
-     LEFTBRACE = 282,
-     RIGHTBRACE = 283,
-     LEFTBRACKET = 284,
-     RIGHTBRACKET = 285,
-     PLUS = 286,
-     MINUS = 287,
-     MULTIPLY = 288,
-     DIVIDE = 289,
-     LESS = 290,
-     GREATER = 291,
-     ASSIGN = 292,
-     GOEQ = 293,
-     LOEQ = 294,
-     NEQ = 295,
-     ARROW = 296,
-     AND = 297,
-     OR = 298,
-     NOT = 299,
-     ID = 300,
-     ALPHANUM = 301,
-     INTEGER = 302,
-     INTEGER_LITERAL = 303,
-     FLOAT = 304,
-     FRACTION = 305,
-     FLOAT_LITERAL = 306,
-     NONZERO = 307,
-     LETTER = 308,
-     DIGIT = 309,
-     PRINT_SYMBOLS = 310,
-     EXIT = 311
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IF = 258,                      /* IF  */
+    ELSE = 259,                    /* ELSE  */
+    THEN = 260,                    /* THEN  */
+    WHILE = 261,                   /* WHILE  */
+    RETURN = 262,                  /* RETURN  */
+    READ = 263,                    /* READ  */
+    WRITE = 264,                   /* WRITE  */
+    FUNC = 265,                    /* FUNC  */
+    CLASS = 266,                   /* CLASS  */
+    CONSTRUCT = 267,               /* CONSTRUCT  */
+    ATTRIBUTE = 268,               /* ATTRIBUTE  */
+    IMPLEMENT = 269,               /* IMPLEMENT  */
+    ISA = 270,                     /* ISA  */
+    SELF = 271,                    /* SELF  */
+    PUBLIC = 272,                  /* PUBLIC  */
+    PRIVATE = 273,                 /* PRIVATE  */
+    LOCAL = 274,                   /* LOCAL  */
+    VOID = 275,                    /* VOID  */
+    SEMICOLON = 276,               /* SEMICOLON  */
+    COMMA = 277,                   /* COMMA  */
+    DOT = 278,                     /* DOT  */
+    COLON = 279,                   /* COLON  */
+    LEFTPAREN = 280,               /* LEFTPAREN  */
+    RIGHTPAREN = 281,              /* RIGHTPAREN  */
+    LEFTBRACE = 282,               /* LEFTBRACE  */
+    RIGHTBRACE = 283,              /* RIGHTBRACE  */
+    LEFTBRACKET = 284,             /* LEFTBRACKET  */
+    RIGHTBRACKET = 285,            /* RIGHTBRACKET  */
+    PLUS = 286,                    /* PLUS  */
+    MINUS = 287,                   /* MINUS  */
+    MULTIPLY = 288,                /* MULTIPLY  */
+    DIVIDE = 289,                  /* DIVIDE  */
+    LESS = 290,                    /* LESS  */
+    GREATER = 291,                 /* GREATER  */
+    ASSIGN = 292,                  /* ASSIGN  */
+    GOEQ = 293,                    /* GOEQ  */
+    LOEQ = 294,                    /* LOEQ  */
+    NEQ = 295,                     /* NEQ  */
+    ARROW = 296,                   /* ARROW  */
+    AND = 297,                     /* AND  */
+    OR = 298,                      /* OR  */
+    NOT = 299,                     /* NOT  */
+    ID = 300,                      /* ID  */
+    ALPHANUM = 301,                /* ALPHANUM  */
+    INTEGER = 302,                 /* INTEGER  */
+    INTEGER_LITERAL = 303,         /* INTEGER_LITERAL  */
+    FLOAT = 304,                   /* FLOAT  */
+    FRACTION = 305,                /* FRACTION  */
+    FLOAT_LITERAL = 306,           /* FLOAT_LITERAL  */
+    NONZERO = 307,                 /* NONZERO  */
+    LETTER = 308,                  /* LETTER  */
+    DIGIT = 309,                   /* DIGIT  */
+    PRINT_SYMBOLS = 310,           /* PRINT_SYMBOLS  */
+    EXIT = 311                     /* EXIT  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
-#define IF 258
-#define ELSE 259
-#define THEN 260
-#define WHILE 261
-#define RETURN 262
-#define READ 263
-#define WRITE 264
-#define FUNC 265
-#define CLASS 266
-#define CONSTRUCT 267
-#define ATTRIBUTE 268
-#define IMPLEMENT 269
-#define ISA 270
-#define SELF 271
-#define PUBLIC 272
-#define PRIVATE 273
-#define LOCAL 274
-#define VOID 275
-#define SEMICOLON 276
-#define COMMA 277
-#define DOT 278
-#define COLON 279
-#define LEFTPAREN 280
-#define RIGHTPAREN 281
-#define LEFTBRACE 282
-#define RIGHTBRACE 283
-#define LEFTBRACKET 284
-#define RIGHTBRACKET 285
-#define PLUS 286
-#define MINUS 287
-#define MULTIPLY 288
-#define DIVIDE 289
-#define LESS 290
-#define GREATER 291
-#define ASSIGN 292
-#define GOEQ 293
-#define LOEQ 294
-#define NEQ 295
-#define ARROW 296
-#define AND 297
-#define OR 298
-#define NOT 299
-#define ID 300
-#define ALPHANUM 301
-#define INTEGER 302
-#define INTEGER_LITERAL 303
-#define FLOAT 304
-#define FRACTION 305
-#define FLOAT_LITERAL 306
-#define NONZERO 307
-#define LETTER 308
-#define DIGIT 309
-#define PRINT_SYMBOLS 310
-#define EXIT 311
-
-
-
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
+union YYSTYPE
 {
-
-/* Line 214 of yacc.c  */
-#line 18 "tma3.y"
+#line 45 "tma3.y"
 
     int integer_values;
     char* character_values;
     float float_values;
+    int token;                  // index in the token array (lalr_lex)
+    struct ASTNode* node;
+    LalrList list;
 
+#line 221 "y.tab.c"
 
-
-/* Line 214 of yacc.c  */
-#line 247 "y.tab.c"
-} YYSTYPE;
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
 # define YYSTYPE_IS_DECLARED 1
 #endif
 
 
-/* Copy the second part of user declarations.  */
 
 
-/* Line 264 of yacc.c  */
-#line 259 "y.tab.c"
+int yyparse (struct CompilerContext* cc, LalrParse* lp);
+
+
+#endif /* !YY_YY_Y_TAB_H_INCLUDED  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IF = 3,                         /* IF  */
+  YYSYMBOL_ELSE = 4,                       /* ELSE  */
+  YYSYMBOL_THEN = 5,                       /* THEN  */
+  YYSYMBOL_WHILE = 6,                      /* WHILE  */
+  YYSYMBOL_RETURN = 7,                     /* RETURN  */
+  YYSYMBOL_READ = 8,                       /* READ  */
+  YYSYMBOL_WRITE = 9,                      /* WRITE  */
+  YYSYMBOL_FUNC = 10,                      /* FUNC  */
+  YYSYMBOL_CLASS = 11,                     /* CLASS  */
+  YYSYMBOL_CONSTRUCT = 12,                 /* CONSTRUCT  */
+  YYSYMBOL_ATTRIBUTE = 13,                 /* ATTRIBUTE  */
+  YYSYMBOL_IMPLEMENT = 14,                 /* IMPLEMENT  */
+  YYSYMBOL_ISA = 15,                       /* ISA  */
+  YYSYMBOL_SELF = 16,                      /* SELF  */
+  YYSYMBOL_PUBLIC = 17,                    /* PUBLIC  */
+  YYSYMBOL_PRIVATE = 18,                   /* PRIVATE  */
+  YYSYMBOL_LOCAL = 19,                     /* LOCAL  */
+  YYSYMBOL_VOID = 20,                      /* VOID  */
+  YYSYMBOL_SEMICOLON = 21,                 /* SEMICOLON  */
+  YYSYMBOL_COMMA = 22,                     /* COMMA  */
+  YYSYMBOL_DOT = 23,                       /* DOT  */
+  YYSYMBOL_COLON = 24,                     /* COLON  */
+  YYSYMBOL_LEFTPAREN = 25,                 /* LEFTPAREN  */
+  YYSYMBOL_RIGHTPAREN = 26,                /* RIGHTPAREN  */
+  YYSYMBOL_LEFTBRACE = 27,                 /* LEFTBRACE  */
+  YYSYMBOL_RIGHTBRACE = 28,                /* RIGHTBRACE  */
+  YYSYMBOL_LEFTBRACKET = 29,               /* LEFTBRACKET  */
+  YYSYMBOL_RIGHTBRACKET = 30,              /* RIGHTBRACKET  */
+  YYSYMBOL_PLUS = 31,                      /* PLUS  */
+  YYSYMBOL_MINUS = 32,                     /* MINUS  */
+  YYSYMBOL_MULTIPLY = 33,                  /* MULTIPLY  */
+  YYSYMBOL_DIVIDE = 34,                    /* DIVIDE  */
+  YYSYMBOL_LESS = 35,                      /* LESS  */
+  YYSYMBOL_GREATER = 36,                   /* GREATER  */
+  YYSYMBOL_ASSIGN = 37,                    /* ASSIGN  */
+  YYSYMBOL_GOEQ = 38,                      /* GOEQ  */
+  YYSYMBOL_LOEQ = 39,                      /* LOEQ  */
+  YYSYMBOL_NEQ = 40,                       /* NEQ  */
+  YYSYMBOL_ARROW = 41,                     /* ARROW  */
+  YYSYMBOL_AND = 42,                       /* AND  */
+  YYSYMBOL_OR = 43,                        /* OR  */
+  YYSYMBOL_NOT = 44,                       /* NOT  */
+  YYSYMBOL_ID = 45,                        /* ID  */
+  YYSYMBOL_ALPHANUM = 46,                  /* ALPHANUM  */
+  YYSYMBOL_INTEGER = 47,                   /* INTEGER  */
+  YYSYMBOL_INTEGER_LITERAL = 48,           /* INTEGER_LITERAL  */
+  YYSYMBOL_FLOAT = 49,                     /* FLOAT  */
+  YYSYMBOL_FRACTION = 50,                  /* FRACTION  */
+  YYSYMBOL_FLOAT_LITERAL = 51,             /* FLOAT_LITERAL  */
+  YYSYMBOL_NONZERO = 52,                   /* NONZERO  */
+  YYSYMBOL_LETTER = 53,                    /* LETTER  */
+  YYSYMBOL_DIGIT = 54,                     /* DIGIT  */
+  YYSYMBOL_PRINT_SYMBOLS = 55,             /* PRINT_SYMBOLS  */
+  YYSYMBOL_EXIT = 56,                      /* EXIT  */
+  YYSYMBOL_YYACCEPT = 57,                  /* $accept  */
+  YYSYMBOL_prog = 58,                      /* prog  */
+  YYSYMBOL_classOrImplOrFuncList = 59,     /* classOrImplOrFuncList  */
+  YYSYMBOL_classOrImplOrFunc = 60,         /* classOrImplOrFunc  */
+  YYSYMBOL_optId = 61,                     /* optId  */
+  YYSYMBOL_classDecl = 62,                 /* classDecl  */
+  YYSYMBOL_isaIdOpt = 63,                  /* isaIdOpt  */
+  YYSYMBOL_idTail = 64,                    /* idTail  */
+  YYSYMBOL_visibilitymemberDeclList = 65,  /* visibilitymemberDeclList  */
+  YYSYMBOL_visibility = 66,                /* visibility  */
+  YYSYMBOL_memberDecl = 67,                /* memberDecl  */
+  YYSYMBOL_implDef = 68,                   /* implDef  */
+  YYSYMBOL_funcDefList = 69,               /* funcDefList  */
+  YYSYMBOL_funcDef = 70,                   /* funcDef  */
+  YYSYMBOL_funcHead = 71,                  /* funcHead  */
+  YYSYMBOL_funcBody = 72,                  /* funcBody  */
+  YYSYMBOL_varDeclOrStmtList = 73,         /* varDeclOrStmtList  */
+  YYSYMBOL_varDeclOrStmt = 74,             /* varDeclOrStmt  */
+  YYSYMBOL_varDecl = 75,                   /* varDecl  */
+  YYSYMBOL_statement = 76,                 /* statement  */
+  YYSYMBOL_statBlock = 77,                 /* statBlock  */
+  YYSYMBOL_statmentList = 78,              /* statmentList  */
+  YYSYMBOL_assignStat = 79,                /* assignStat  */
+  YYSYMBOL_assignOp = 80,                  /* assignOp  */
+  YYSYMBOL_expr = 81,                      /* expr  */
+  YYSYMBOL_relExpr = 82,                   /* relExpr  */
+  YYSYMBOL_relArith = 83,                  /* relArith  */
+  YYSYMBOL_arithExpr = 84,                 /* arithExpr  */
+  YYSYMBOL_term = 85,                      /* term  */
+  YYSYMBOL_factor = 86,                    /* factor  */
+  YYSYMBOL_relOp = 87,                     /* relOp  */
+  YYSYMBOL_addOp = 88,                     /* addOp  */
+  YYSYMBOL_multOp = 89,                    /* multOp  */
+  YYSYMBOL_variable = 90,                  /* variable  */
+  YYSYMBOL_readVariable = 91,              /* readVariable  */
+  YYSYMBOL_idnestList = 92,                /* idnestList  */
+  YYSYMBOL_idnest = 93,                    /* idnest  */
+  YYSYMBOL_idOrSelf = 94,                  /* idOrSelf  */
+  YYSYMBOL_idnestTail = 95,                /* idnestTail  */
+  YYSYMBOL_optDot = 96,                    /* optDot  */
+  YYSYMBOL_indiceList = 97,                /* indiceList  */
+  YYSYMBOL_someIndices = 98,               /* someIndices  */
+  YYSYMBOL_indice = 99,                    /* indice  */
+  YYSYMBOL_optArith = 100,                 /* optArith  */
+  YYSYMBOL_aParams = 101,                  /* aParams  */
+  YYSYMBOL_aParamsTailList = 102,          /* aParamsTailList  */
+  YYSYMBOL_arraySizeList = 103,            /* arraySizeList  */
+  YYSYMBOL_optIntLit = 104,                /* optIntLit  */
+  YYSYMBOL_type = 105,                     /* type  */
+  YYSYMBOL_returnType = 106,               /* returnType  */
+  YYSYMBOL_fParams = 107,                  /* fParams  */
+  YYSYMBOL_fParamsTailList = 108           /* fParamsTailList  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+/* Unqualified %code blocks.  */
+#line 54 "tma3.y"
+
+    #define yylex lalr_lex
+    // lists are flat on the stack, but parentheses and if/while blocks nest
+    #define YYMAXDEPTH 1000000
+    static int lalr_lex(YYSTYPE* lval, CompilerContext* cc, LalrParse* lp);
+    static void yyerror(CompilerContext* cc, LalrParse* lp, const char* message);
+
+    struct LalrParse {
+        CompilerContext* cc;    // for the derivation replay after yyparse
+        ASTNode* root;
+        int started;            // the first token has been handed out
+        // memberDecl nodes whose funcHead recursive descent drops (neither ';'
+        // nor a body follows it), each followed by the head: no tree, but
+        // its derivation steps are written
+        ASTNode** dropped;
+        int dropped_count, dropped_cap;
+    };
+
+    // leaves for a token, as parser.c's token_node and token_leaf make them
+    static ASTNode* lalr_id(CompilerContext* cc, int token) {
+        LexToken* tok = &cc->token_stream.data[token];
+        ASTNode* node = createNodeWithId(cc, "ID", tok->id);
+        node->line = tok->line;
+        return node;
+    }
+
+    static ASTNode* lalr_literal(CompilerContext* cc, const char* name, int token) {
+        return createNodeWithId(cc, name, cc->token_stream.data[token].id);
+    }
+
+    static ASTNode* lalr_node(CompilerContext* cc, const char* name, ASTNode* a, ASTNode* b, ASTNode* c) {
+        ASTNode* node = createNode(cc, name, "");
+        addChild(node, a);
+        addChild(node, b);
+        addChild(node, c);
+        return node;
+    }
+
+    static void list_begin(CompilerContext* cc, LalrList* l, const char* name) {
+        l->head = l->tail = createNode(cc, name, "");
+    }
+
+    // items of the current level, then the next (empty) list node below them
+    static void list_next(CompilerContext* cc, LalrList* l, ASTNode* a, ASTNode* b) {
+        addChild(l->tail, a);
+        addChild(l->tail, b);
+        ASTNode* next = createNode(cc, l->tail->name, "");
+        addChild(l->tail, next);
+        l->tail = next;
+    }
+
+    static void lalr_drop_head(LalrParse* lp, ASTNode* member, ASTNode* head) {
+        if (lp->dropped_count + 2 > lp->dropped_cap) {
+            lp->dropped_cap = lp->dropped_cap ? lp->dropped_cap * 2 : 16;
+            lp->dropped = (ASTNode**)realloc(lp->dropped, sizeof(ASTNode*) * lp->dropped_cap);
+            if (!lp->dropped) {
+                printf("Error:: out of memory while parsing\n");
+                exit(1);
+            }
+        }
+        lp->dropped[lp->dropped_count++] = member;
+        lp->dropped[lp->dropped_count++] = head;
+    }
+
+#line 420 "y.tab.c"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
 typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -293,55 +510,106 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
-# if YYENABLE_NLS
+# if defined YYENABLE_NLS && YYENABLE_NLS
 #  if ENABLE_NLS
 #   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
 #  endif
 # endif
 # ifndef YY_
-#  define YY_(msgid) msgid
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(e) ((void) (e))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(e) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(n) (n)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int yyi)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (yyi)
-    int yyi;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return yyi;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
 #endif
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -358,11 +626,11 @@ YYID (yyi)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#     ifndef _STDLIB_H
-#      define _STDLIB_H 1
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
 #     endif
 #    endif
 #   endif
@@ -370,8 +638,8 @@ YYID (yyi)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -385,111 +653,117 @@ YYID (yyi)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
 #   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
 #  endif
-#  if (defined __cplusplus && ! defined _STDLIB_H \
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef _STDLIB_H
-#    define _STDLIB_H 1
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
 #   endif
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
-/* Copy COUNT objects from FROM to TO.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(To, From, Count) \
-      __builtin_memcpy (To, From, (Count) * sizeof (*(From)))
-#  else
-#   define YYCOPY(To, From, Count)		\
-      do					\
-	{					\
-	  YYSIZE_T yyi;				\
-	  for (yyi = 0; yyi < (Count); yyi++)	\
-	    (To)[yyi] = (From)[yyi];		\
-	}					\
-      while (YYID (0))
-#  endif
-# endif
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack_alloc, Stack)				\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack_alloc, Stack, yysize);			\
-	Stack = &yyptr->Stack_alloc;					\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  4
+#define YYFINAL  3
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   2
+#define YYLAST   185
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  57
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  2
+#define YYNNTS  52
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  4
-/* YYNRULES -- Number of states.  */
-#define YYNSTATES  5
+#define YYNRULES  118
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  184
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   311
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -526,208 +800,290 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,     0,     3,     5,     7
+       0,   162,   162,   169,   170,   174,   175,   176,   180,   181,
+     185,   191,   192,   196,   197,   201,   202,   206,   207,   211,
+     212,   213,   214,   218,   221,   225,   231,   232,   237,   238,
+     242,   245,   251,   255,   256,   260,   263,   267,   268,   274,
+     275,   279,   282,   285,   288,   294,   295,   296,   300,   301,
+     306,   310,   311,   317,   318,   322,   323,   327,   328,   332,
+     333,   337,   338,   342,   343,   344,   345,   346,   347,   348,
+     352,   353,   354,   355,   356,   360,   361,   362,   366,   367,
+     368,   373,   378,   379,   383,   384,   388,   392,   393,   397,
+     398,   399,   403,   404,   408,   409,   413,   414,   418,   422,
+     423,   427,   428,   434,   435,   440,   441,   448,   449,   453,
+     454,   455,   456,   460,   461,   465,   466,   473,   474
 };
+#endif
 
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      58,     0,    -1,    55,    -1,    56,    -1,    -1
-};
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
 
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
-static const yytype_uint8 yyrline[] =
-{
-       0,    48,    48,    52,    58
-};
-#endif
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
 
-#if YYDEBUG || YYERROR_VERBOSE || YYTOKEN_TABLE
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "IF", "ELSE", "THEN", "WHILE", "RETURN",
-  "READ", "WRITE", "FUNC", "CLASS", "CONSTRUCT", "ATTRIBUTE", "IMPLEMENT",
-  "ISA", "SELF", "PUBLIC", "PRIVATE", "LOCAL", "VOID", "SEMICOLON",
-  "COMMA", "DOT", "COLON", "LEFTPAREN", "RIGHTPAREN", "LEFTBRACE",
-  "RIGHTBRACE", "LEFTBRACKET", "RIGHTBRACKET", "PLUS", "MINUS", "MULTIPLY",
-  "DIVIDE", "LESS", "GREATER", "ASSIGN", "GOEQ", "LOEQ", "NEQ", "ARROW",
-  "AND", "OR", "NOT", "ID", "ALPHANUM", "INTEGER", "INTEGER_LITERAL",
-  "FLOAT", "FRACTION", "FLOAT_LITERAL", "NONZERO", "LETTER", "DIGIT",
-  "PRINT_SYMBOLS", "EXIT", "$accept", "program", 0
+  "\"end of file\"", "error", "\"invalid token\"", "IF", "ELSE", "THEN",
+  "WHILE", "RETURN", "READ", "WRITE", "FUNC", "CLASS", "CONSTRUCT",
+  "ATTRIBUTE", "IMPLEMENT", "ISA", "SELF", "PUBLIC", "PRIVATE", "LOCAL",
+  "VOID", "SEMICOLON", "COMMA", "DOT", "COLON", "LEFTPAREN", "RIGHTPAREN",
+  "LEFTBRACE", "RIGHTBRACE", "LEFTBRACKET", "RIGHTBRACKET", "PLUS",
+  "MINUS", "MULTIPLY", "DIVIDE", "LESS", "GREATER", "ASSIGN", "GOEQ",
+  "LOEQ", "NEQ", "ARROW", "AND", "OR", "NOT", "ID", "ALPHANUM", "INTEGER",
+  "INTEGER_LITERAL", "FLOAT", "FRACTION", "FLOAT_LITERAL", "NONZERO",
+  "LETTER", "DIGIT", "PRINT_SYMBOLS", "EXIT", "$accept", "prog",
+  "classOrImplOrFuncList", "classOrImplOrFunc", "optId", "classDecl",
+  "isaIdOpt", "idTail", "visibilitymemberDeclList", "visibility",
+  "memberDecl", "implDef", "funcDefList", "funcDef", "funcHead",
+  "funcBody", "varDeclOrStmtList", "varDeclOrStmt", "varDecl", "statement",
+  "statBlock", "statmentList", "assignStat", "assignOp", "expr", "relExpr",
+  "relArith", "arithExpr", "term", "factor", "relOp", "addOp", "multOp",
+  "variable", "readVariable", "idnestList", "idnest", "idOrSelf",
+  "idnestTail", "optDot", "indiceList", "someIndices", "indice",
+  "optArith", "aParams", "aParamsTailList", "arraySizeList", "optIntLit",
+  "type", "returnType", "fParams", "fParamsTailList", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-148)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+#define YYTABLE_NINF (-1)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
 {
-       0,    57,    58,    58,    58
+    -148,    13,   101,  -148,   -27,   -27,     2,   -27,  -148,  -148,
+    -148,  -148,    14,  -148,    52,    41,    48,    69,  -148,  -148,
+      48,   -27,    76,    60,    80,  -148,    17,    81,  -148,  -148,
+      71,  -148,    32,    94,    98,   102,   103,   105,  -148,    86,
+    -148,  -148,  -148,  -148,   111,    89,     3,  -148,    39,    92,
+     113,    57,  -148,  -148,  -148,  -148,  -148,  -148,    38,    38,
+      38,     3,    38,   110,  -148,  -148,  -148,    38,    38,  -148,
+    -148,   107,  -148,    38,  -148,    -7,     8,   -27,  -148,  -148,
+     116,   112,   109,    38,    38,    38,    38,  -148,  -148,   114,
+    -148,    59,    67,  -148,  -148,   115,   117,  -148,  -148,   118,
+    -148,   119,    71,  -148,    49,   120,  -148,  -148,   121,  -148,
+    -148,  -148,  -148,  -148,  -148,  -148,    86,  -148,    83,    91,
+     130,    35,  -148,  -148,  -148,   137,  -148,  -148,  -148,  -148,
+    -148,  -148,  -148,  -148,    38,    38,  -148,  -148,  -148,    38,
+      31,   132,   133,   134,  -148,  -148,   135,   136,  -148,  -148,
+     139,  -148,   126,   -27,  -148,    31,    49,    67,  -148,  -148,
+    -148,   140,  -148,  -148,  -148,    58,    38,  -148,  -148,  -148,
+     138,   154,    43,  -148,  -148,  -148,    71,    31,  -148,  -148,
+    -148,   142,   109,  -148
 };
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
-       0,     2,     1,     1,     0
+       3,     0,     2,     1,     8,     8,     0,     8,     4,     5,
+       6,     7,    28,     9,     0,    11,   115,     0,    33,    29,
+     115,     8,     0,     0,     0,    26,     0,     0,    13,    15,
+     109,    31,     0,     0,     0,     0,     0,     0,    88,    37,
+      32,    87,    34,    36,     0,    51,    94,    84,    89,     0,
+      12,     0,   112,   110,   111,   105,    25,    27,    55,    55,
+      53,    94,    53,     0,    35,    39,    52,    53,    99,    85,
+      81,    95,    96,   101,    86,    92,   109,     8,    17,    18,
+       0,    24,   117,     0,     0,     0,     0,    64,    65,     0,
+      56,    57,    59,    61,    63,     0,     0,    54,    82,     0,
+      83,     0,   109,    50,   100,     0,    97,   103,     0,    93,
+      90,   113,   114,    30,    14,    10,    37,    16,    22,   107,
+     116,     0,    68,    69,    67,     0,    75,    76,    70,    71,
+      73,    72,    74,    77,     0,     0,    78,    79,    80,     0,
+      47,     0,     0,     0,   105,    98,   102,    92,    23,    19,
+      20,   108,     0,     8,    66,    47,    58,    60,    62,    48,
+      46,     0,    44,    42,    43,     0,    53,    91,    21,   106,
+       0,     0,     0,    41,    38,   104,   109,    47,    45,    49,
+     105,     0,   118,    40
 };
 
-/* YYDEFACT[STATE-NAME] -- Default rule to reduce with in state
-   STATE-NUM when YYTABLE doesn't specify something else to do.  Zero
-   means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
 {
-       4,     2,     3,     0,     1
+    -148,  -148,  -148,  -148,    -4,  -148,  -148,  -148,  -148,  -148,
+    -148,  -148,  -148,   141,    84,    50,  -148,  -148,    51,   -24,
+    -147,  -148,  -148,  -148,   -58,   122,   -44,   -62,    29,   -74,
+    -148,  -148,  -148,   -26,  -148,  -148,   123,  -148,  -148,    19,
+     124,   127,    46,  -148,  -148,  -148,  -137,  -148,   -71,  -148,
+     150,  -148
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
+static const yytype_uint8 yydefgoto[] =
 {
-      -1,     3
+       0,     1,     2,     8,    14,     9,    22,    50,    51,    81,
+     117,    10,    32,    11,    12,    19,    26,    42,    64,   160,
+     161,   172,    44,    67,    96,    89,    97,    91,    92,    93,
+     134,   135,   139,    94,    99,    46,    47,    48,    74,   110,
+      70,    71,    72,   105,   108,   146,    82,   152,    55,   113,
+      24,   120
 };
 
-/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-   STATE-NUM.  */
-#define YYPACT_NINF -56
-static const yytype_int8 yypact[] =
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_uint8 yytable[] =
 {
-     -55,   -56,   -56,     2,   -56
+      45,    15,    43,    17,   101,   112,   104,   165,   171,   103,
+     122,   123,   124,     3,    90,    90,   109,    28,    13,    38,
+      33,   121,    68,    34,    35,    36,    37,    16,   111,   107,
+     181,   144,    68,    38,    33,    98,    39,    34,    35,    36,
+      37,    18,     4,   182,     6,    40,    33,    38,    41,    34,
+      35,    36,    37,    52,    38,    53,    21,    54,   159,    38,
+      56,   154,    41,    83,    73,   158,   126,   127,    68,    84,
+      85,   178,   156,   114,    78,    79,    41,    20,   133,   174,
+     126,   127,    86,    41,    30,    80,    87,   119,    41,    88,
+     126,   127,   133,    23,   128,   129,    25,   130,   131,   132,
+     136,   137,   133,    29,   149,   180,    31,    49,   175,   138,
+      18,     4,     5,     6,    45,     7,    52,   106,    53,    58,
+      54,   106,     4,    59,     6,   116,    66,    60,    61,    45,
+      62,    63,    65,    76,   102,    77,    68,   115,   119,   151,
+     125,   140,   155,   141,   142,   143,    45,   147,   179,   170,
+     145,    45,   153,   162,   163,   164,   169,   166,   177,   109,
+     168,   173,   176,   183,   157,   118,   167,   148,   150,    69,
+      27,     0,     0,    57,     0,    75,     0,     0,     0,     0,
+       0,    95,     0,     0,     0,   100
 };
 
-/* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
+static const yytype_int16 yycheck[] =
 {
-     -56,   -56
+      26,     5,    26,     7,    62,    76,    68,   144,   155,    67,
+      84,    85,    86,     0,    58,    59,    23,    21,    45,    16,
+       3,    83,    29,     6,     7,     8,     9,    25,    20,    73,
+     177,   102,    29,    16,     3,    61,    19,     6,     7,     8,
+       9,    27,    10,   180,    12,    28,     3,    16,    45,     6,
+       7,     8,     9,    45,    16,    47,    15,    49,    27,    16,
+      28,    26,    45,    25,    25,   139,    31,    32,    29,    31,
+      32,    28,   134,    77,    17,    18,    45,    25,    43,    21,
+      31,    32,    44,    45,    24,    28,    48,    29,    45,    51,
+      31,    32,    43,    45,    35,    36,    27,    38,    39,    40,
+      33,    34,    43,    27,    21,   176,    26,    26,   166,    42,
+      27,    10,    11,    12,   140,    14,    45,    71,    47,    25,
+      49,    75,    10,    25,    12,    13,    37,    25,    25,   155,
+      25,    45,    21,    41,    24,    22,    29,    21,    29,    48,
+      26,    26,     5,    26,    26,    26,   172,    26,   172,   153,
+      30,   177,    22,    21,    21,    21,    30,    22,     4,    23,
+      21,    21,    24,    21,   135,    81,   147,   116,   118,    46,
+      20,    -1,    -1,    32,    -1,    48,    -1,    -1,    -1,    -1,
+      -1,    59,    -1,    -1,    -1,    61
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If zero, do what YYDEFACT says.
-   If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
-static const yytype_uint8 yytable[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-       1,     2,     4
+       0,    58,    59,     0,    10,    11,    12,    14,    60,    62,
+      68,    70,    71,    45,    61,    61,    25,    61,    27,    72,
+      25,    15,    63,    45,   107,    27,    73,   107,    61,    27,
+      24,    26,    69,     3,     6,     7,     8,     9,    16,    19,
+      28,    45,    74,    76,    79,    90,    92,    93,    94,    26,
+      64,    65,    45,    47,    49,   105,    28,    70,    25,    25,
+      25,    25,    25,    45,    75,    21,    37,    80,    29,    93,
+      97,    98,    99,    25,    95,    98,    41,    22,    17,    18,
+      28,    66,   103,    25,    31,    32,    44,    48,    51,    82,
+      83,    84,    85,    86,    90,    82,    81,    83,    90,    91,
+      97,    81,    24,    81,    84,   100,    99,    83,   101,    23,
+      96,    20,   105,   106,    61,    21,    13,    67,    71,    29,
+     108,    84,    86,    86,    86,    26,    31,    32,    35,    36,
+      38,    39,    40,    43,    87,    88,    33,    34,    42,    89,
+      26,    26,    26,    26,   105,    30,   102,    26,    75,    21,
+      72,    48,   104,    22,    26,     5,    84,    85,    86,    27,
+      76,    77,    21,    21,    21,   103,    22,    96,    21,    30,
+      61,    77,    78,    21,    21,    81,    24,     4,    28,    76,
+     105,    77,   103,    21
 };
 
-static const yytype_uint8 yycheck[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-      55,    56,     0
+       0,    57,    58,    59,    59,    60,    60,    60,    61,    61,
+      62,    63,    63,    64,    64,    65,    65,    66,    66,    67,
+      67,    67,    67,    67,    67,    68,    69,    69,    70,    70,
+      71,    71,    72,    73,    73,    74,    74,    75,    75,    76,
+      76,    76,    76,    76,    76,    77,    77,    77,    78,    78,
+      79,    80,    80,    81,    81,    82,    82,    83,    83,    84,
+      84,    85,    85,    86,    86,    86,    86,    86,    86,    86,
+      87,    87,    87,    87,    87,    88,    88,    88,    89,    89,
+      89,    90,    91,    91,    92,    92,    93,    94,    94,    95,
+      95,    95,    96,    96,    97,    97,    98,    98,    99,   100,
+     100,   101,   101,   102,   102,   103,   103,   104,   104,   105,
+     105,   105,   105,   106,   106,   107,   107,   108,   108
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
-       0,    55,    56,    58,     0
+       0,     2,     1,     0,     2,     1,     1,     1,     0,     1,
+       7,     0,     3,     0,     3,     0,     3,     1,     1,     2,
+       2,     3,     1,     2,     0,     5,     0,     2,     1,     2,
+       7,     4,     3,     0,     2,     2,     1,     0,     5,     2,
+       9,     6,     5,     5,     5,     3,     1,     0,     0,     2,
+       3,     0,     1,     0,     1,     0,     1,     1,     3,     1,
+       3,     1,     3,     1,     1,     1,     3,     2,     2,     2,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     2,     1,     1,     1,     2,     2,     1,     1,     0,
+       2,     4,     0,     1,     0,     1,     1,     2,     3,     0,
+       1,     0,     2,     0,     3,     0,     4,     0,     1,     0,
+       1,     1,     1,     1,     1,     0,     5,     0,     6
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
 
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
+enum { YYENOMEM = -2 };
 
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
 
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  */
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
-#define YYFAIL		goto yyerrlab
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)					\
-do								\
-  if (yychar == YYEMPTY && yylen == 1)				\
-    {								\
-      yychar = (Token);						\
-      yylval = (Value);						\
-      yytoken = YYTRANSLATE (yychar);				\
-      YYPOPSTACK (1);						\
-      goto yybackup;						\
-    }								\
-  else								\
-    {								\
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
-/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
-   If N is 0, then set CURRENT to the empty location which ends
-   the previous symbol: RHS[0] (always defined).  */
-
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
-#ifndef YYLLOC_DEFAULT
-# define YYLLOC_DEFAULT(Current, Rhs, N)				\
-    do									\
-      if (YYID (N))                                                    \
-	{								\
-	  (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;	\
-	  (Current).first_column = YYRHSLOC (Rhs, 1).first_column;	\
-	  (Current).last_line    = YYRHSLOC (Rhs, N).last_line;		\
-	  (Current).last_column  = YYRHSLOC (Rhs, N).last_column;	\
-	}								\
-      else								\
-	{								\
-	  (Current).first_line   = (Current).last_line   =		\
-	    YYRHSLOC (Rhs, 0).last_line;				\
-	  (Current).first_column = (Current).last_column =		\
-	    YYRHSLOC (Rhs, 0).last_column;				\
-	}								\
-    while (YYID (0))
-#endif
-
-
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
-
-#ifndef YY_LOCATION_PRINT
-# if YYLTYPE_IS_TRIVIAL
-#  define YY_LOCATION_PRINT(File, Loc)			\
-     fprintf (File, "%d.%d-%d.%d",			\
-	      (Loc).first_line, (Loc).first_column,	\
-	      (Loc).last_line,  (Loc).last_column)
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (cc, lp, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
-
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex ()
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -737,80 +1093,60 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, cc, lp); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, struct CompilerContext* cc, LalrParse* lp)
 {
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (cc);
+  YY_USE (lp);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, struct CompilerContext* cc, LalrParse* lp)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, cc, lp);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -818,16 +1154,8 @@ yy_symbol_print (yyoutput, yytype, yyvaluep)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
-#else
 static void
-yy_stack_print (yybottom, yytop)
-    yytype_int16 *yybottom;
-    yytype_int16 *yytop;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -838,63 +1166,56 @@ yy_stack_print (yybottom, yytop)
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_reduce_print (YYSTYPE *yyvsp, int yyrule)
-#else
 static void
-yy_reduce_print (yyvsp, yyrule)
-    YYSTYPE *yyvsp;
-    int yyrule;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, struct CompilerContext* cc, LalrParse* lp)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       		       );
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], cc, lp);
       YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, Rule); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, cc, lp); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -909,49 +1230,81 @@ int yydebug;
 # define YYMAXDEPTH 10000
 #endif
 
-
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
+static YYPTRDIFF_T
 yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
 {
-  YYSIZE_T yylen;
+  YYPTRDIFF_T yylen;
   for (yylen = 0; yystr[yylen]; yylen++)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static char *
 yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
 {
   char *yyd = yydest;
   const char *yys = yysrc;
@@ -961,10 +1314,10 @@ yystpcpy (yydest, yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -972,279 +1325,261 @@ yystpcpy (yydest, yysrc)
    backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
    null, do not copy; instead, return the length of what the result
    would have been.  */
-static YYSIZE_T
+static YYPTRDIFF_T
 yytnamerr (char *yyres, const char *yystr)
 {
   if (*yystr == '"')
     {
-      YYSIZE_T yyn = 0;
+      YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
     do_not_strip_quotes: ;
     }
 
-  if (! yyres)
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
     return yystrlen (yystr);
-
-  return yystpcpy (yyres, yystr) - yyres;
 }
-# endif
+#endif
 
-/* Copy into YYRESULT an error message about the unexpected token
-   YYCHAR while in state YYSTATE.  Return the number of bytes copied,
-   including the terminating null byte.  If YYRESULT is null, do not
-   copy anything; just return the number of bytes that would be
-   copied.  As a special case, return 0 if an ordinary "syntax error"
-   message will do.  Return YYSIZE_MAXIMUM if overflow occurs during
-   size calculation.  */
-static YYSIZE_T
-yysyntax_error (char *yyresult, int yystate, int yychar)
-{
-  int yyn = yypact[yystate];
 
-  if (! (YYPACT_NINF < yyn && yyn <= YYLAST))
-    return 0;
-  else
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
     {
-      int yytype = YYTRANSLATE (yychar);
-      YYSIZE_T yysize0 = yytnamerr (0, yytname[yytype]);
-      YYSIZE_T yysize = yysize0;
-      YYSIZE_T yysize1;
-      int yysize_overflow = 0;
-      enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-      char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-      int yyx;
-
-# if 0
-      /* This is so xgettext sees the translatable formats that are
-	 constructed on the fly.  */
-      YY_("syntax error, unexpected %s");
-      YY_("syntax error, unexpected %s, expecting %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s");
-# endif
-      char *yyfmt;
-      char const *yyf;
-      static char const yyunexpected[] = "syntax error, unexpected %s";
-      static char const yyexpecting[] = ", expecting %s";
-      static char const yyor[] = " or %s";
-      char yyformat[sizeof yyunexpected
-		    + sizeof yyexpecting - 1
-		    + ((YYERROR_VERBOSE_ARGS_MAXIMUM - 2)
-		       * (sizeof yyor - 1))];
-      char const *yyprefix = yyexpecting;
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
 
-      /* Start YYX at -YYN if negative to avoid negative indexes in
-	 YYCHECK.  */
-      int yyxbegin = yyn < 0 ? -yyn : 0;
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
 
-      /* Stay within bounds of both yycheck and yytname.  */
-      int yychecklim = YYLAST - yyn + 1;
-      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-      int yycount = 1;
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
 
-      yyarg[0] = yytname[yytype];
-      yyfmt = yystpcpy (yyformat, yyunexpected);
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
 
-      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-	if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR)
-	  {
-	    if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-	      {
-		yycount = 1;
-		yysize = yysize0;
-		yyformat[sizeof yyunexpected - 1] = '\0';
-		break;
-	      }
-	    yyarg[yycount++] = yytname[yyx];
-	    yysize1 = yysize + yytnamerr (0, yytname[yyx]);
-	    yysize_overflow |= (yysize1 < yysize);
-	    yysize = yysize1;
-	    yyfmt = yystpcpy (yyfmt, yyprefix);
-	    yyprefix = yyor;
-	  }
-
-      yyf = YY_(yyformat);
-      yysize1 = yysize + yystrlen (yyf);
-      yysize_overflow |= (yysize1 < yysize);
-      yysize = yysize1;
-
-      if (yysize_overflow)
-	return YYSIZE_MAXIMUM;
-
-      if (yyresult)
-	{
-	  /* Avoid sprintf, as that infringes on the user's name space.
-	     Don't have undefined behavior even if the translation
-	     produced a string with the wrong number of "%s"s.  */
-	  char *yyp = yyresult;
-	  int yyi = 0;
-	  while ((*yyp = *yyf) != '\0')
-	    {
-	      if (*yyp == '%' && yyf[1] == 's' && yyi < yycount)
-		{
-		  yyp += yytnamerr (yyp, yyarg[yyi++]);
-		  yyf += 2;
-		}
-	      else
-		{
-		  yyp++;
-		  yyf++;
-		}
-	    }
-	}
-      return yysize;
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
     }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
 }
-#endif /* YYERROR_VERBOSE */
-
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
-#else
 static void
-yydestruct (yymsg, yytype, yyvaluep)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, struct CompilerContext* cc, LalrParse* lp)
 {
-  YYUSE (yyvaluep);
-
+  YY_USE (yyvaluep);
+  YY_USE (cc);
+  YY_USE (lp);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
-
-  switch (yytype)
-    {
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
-/* Prevent warnings from -Wmissing-prototypes.  */
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
-
-
-/* The lookahead symbol.  */
-int yychar;
 
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
 
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 
-/*-------------------------.
-| yyparse or yypush_parse.  |
-`-------------------------*/
+/*----------.
+| yyparse.  |
+`----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
-int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void)
-#else
 int
-yyparse ()
-
-#endif
-#endif
+yyparse (struct CompilerContext* cc, LalrParse* lp)
 {
+/* Lookahead token kind.  */
+int yychar;
 
 
-    int yystate;
-    /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-    /* The stacks and their tools:
-       `yyss': related to states.
-       `yyvs': related to semantic values.
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-       Refer to the stacks thru separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
-
-    YYSIZE_T yystacksize;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
-#if YYERROR_VERBOSE
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
@@ -1252,133 +1587,140 @@ yyparse ()
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yytoken = 0;
-  yyss = yyssa;
-  yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
 
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
-  yyssp = yyss;
-  yyvsp = yyvs;
-
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-		    &yystacksize);
-
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss_alloc, yyss);
-	YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
   /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYPACT_NINF)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, cc, lp);
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1393,8 +1735,8 @@ yybackup:
   yyn = yytable[yyn];
   if (yyn <= 0)
     {
-      if (yyn == 0 || yyn == YYTABLE_NINF)
-	goto yyerrlab;
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
       yyn = -yyn;
       goto yyreduce;
     }
@@ -1406,13 +1748,13 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1427,14 +1769,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1447,132 +1789,795 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
+  case 2: /* prog: classOrImplOrFuncList  */
+#line 162 "tma3.y"
+                          {
+        lp->root = (yyval.node) = lalr_node(cc, "prog", (yyvsp[0].list).head, NULL, NULL);
+        YYACCEPT;
+    }
+#line 1799 "y.tab.c"
+    break;
 
-/* Line 1455 of yacc.c  */
-#line 48 "tma3.y"
-    {
-        printf("Yacc:: PRINT_SYMBOLS found.\n");
-        print_symbols();
+  case 3: /* classOrImplOrFuncList: %empty  */
+#line 169 "tma3.y"
+                                            { list_begin(cc, &(yyval.list), "classOrImplOrFuncList"); }
+#line 1805 "y.tab.c"
+    break;
+
+  case 4: /* classOrImplOrFuncList: classOrImplOrFuncList classOrImplOrFunc  */
+#line 170 "tma3.y"
+                                              { (yyval.list) = (yyvsp[-1].list); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 1811 "y.tab.c"
+    break;
+
+  case 5: /* classOrImplOrFunc: classDecl  */
+#line 174 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "classOrImplOrFunc", (yyvsp[0].node), NULL, NULL); }
+#line 1817 "y.tab.c"
+    break;
+
+  case 6: /* classOrImplOrFunc: implDef  */
+#line 175 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "classOrImplOrFunc", (yyvsp[0].node), NULL, NULL); }
+#line 1823 "y.tab.c"
+    break;
+
+  case 7: /* classOrImplOrFunc: funcDef  */
+#line 176 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "classOrImplOrFunc", (yyvsp[0].node), NULL, NULL); }
+#line 1829 "y.tab.c"
+    break;
+
+  case 8: /* optId: %empty  */
+#line 180 "tma3.y"
+            { (yyval.node) = NULL; }
+#line 1835 "y.tab.c"
+    break;
+
+  case 9: /* optId: ID  */
+#line 181 "tma3.y"
+            { (yyval.node) = lalr_id(cc, (yyvsp[0].token)); }
+#line 1841 "y.tab.c"
+    break;
+
+  case 10: /* classDecl: CLASS optId isaIdOpt LEFTBRACE visibilitymemberDeclList RIGHTBRACE SEMICOLON  */
+#line 185 "tma3.y"
+                                                                                 {
+        (yyval.node) = lalr_node(cc, "classDecl", (yyvsp[-5].node), (yyvsp[-4].node), (yyvsp[-2].list).head);
     }
+#line 1849 "y.tab.c"
     break;
 
-  case 3:
+  case 11: /* isaIdOpt: %empty  */
+#line 191 "tma3.y"
+                        { (yyval.node) = createNode(cc, "isaIdOpt", ""); }
+#line 1855 "y.tab.c"
+    break;
 
-/* Line 1455 of yacc.c  */
-#line 52 "tma3.y"
-    {
-        printf("Yacc:: EXIT found.\n");
-        print_symbols();
-        exit(0);
+  case 12: /* isaIdOpt: ISA optId idTail  */
+#line 192 "tma3.y"
+                        { (yyval.node) = lalr_node(cc, "isaIdOpt", (yyvsp[-1].node), (yyvsp[0].list).head, NULL); }
+#line 1861 "y.tab.c"
+    break;
+
+  case 13: /* idTail: %empty  */
+#line 196 "tma3.y"
+                            { list_begin(cc, &(yyval.list), "idTail"); }
+#line 1867 "y.tab.c"
+    break;
+
+  case 14: /* idTail: idTail COMMA optId  */
+#line 197 "tma3.y"
+                            { (yyval.list) = (yyvsp[-2].list); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 1873 "y.tab.c"
+    break;
+
+  case 15: /* visibilitymemberDeclList: %empty  */
+#line 201 "tma3.y"
+                                                    { list_begin(cc, &(yyval.list), "visibilitymemberDeclList"); }
+#line 1879 "y.tab.c"
+    break;
+
+  case 16: /* visibilitymemberDeclList: visibilitymemberDeclList visibility memberDecl  */
+#line 202 "tma3.y"
+                                                     { (yyval.list) = (yyvsp[-2].list); list_next(cc, &(yyval.list), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1885 "y.tab.c"
+    break;
+
+  case 17: /* visibility: PUBLIC  */
+#line 206 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "visibility", createNode(cc, "PUBLIC", ""), NULL, NULL); }
+#line 1891 "y.tab.c"
+    break;
+
+  case 18: /* visibility: PRIVATE  */
+#line 207 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "visibility", createNode(cc, "PRIVATE", ""), NULL, NULL); }
+#line 1897 "y.tab.c"
+    break;
+
+  case 19: /* memberDecl: funcHead SEMICOLON  */
+#line 211 "tma3.y"
+                                    { (yyval.node) = lalr_node(cc, "memberDecl", (yyvsp[-1].node), NULL, NULL); }
+#line 1903 "y.tab.c"
+    break;
+
+  case 20: /* memberDecl: funcHead funcBody  */
+#line 212 "tma3.y"
+                                    { (yyval.node) = lalr_node(cc, "memberDecl", (yyvsp[-1].node), (yyvsp[0].node), NULL); }
+#line 1909 "y.tab.c"
+    break;
+
+  case 21: /* memberDecl: funcHead funcBody SEMICOLON  */
+#line 213 "tma3.y"
+                                    { (yyval.node) = lalr_node(cc, "memberDecl", (yyvsp[-2].node), (yyvsp[-1].node), NULL); }
+#line 1915 "y.tab.c"
+    break;
+
+  case 22: /* memberDecl: funcHead  */
+#line 214 "tma3.y"
+               {
+        (yyval.node) = createNode(cc, "memberDecl", "");
+        lalr_drop_head(lp, (yyval.node), (yyvsp[0].node));
     }
+#line 1924 "y.tab.c"
     break;
 
-  case 4:
+  case 23: /* memberDecl: ATTRIBUTE varDecl  */
+#line 218 "tma3.y"
+                        {
+        (yyval.node) = lalr_node(cc, "memberDecl", lalr_node(cc, "attributeDecl", (yyvsp[0].node), NULL, NULL), NULL, NULL);
+    }
+#line 1932 "y.tab.c"
+    break;
 
-/* Line 1455 of yacc.c  */
-#line 58 "tma3.y"
-    {
-        printf("Yacc:: Switching to recursive descent parser...\n");
-        ASTNode* root = parse_program(); // Calling to recursive descent parser
-        (void)root; // root available for later semantic analysis
-        YYACCEPT; // immediately terminates the parsing process of yyparse()
+  case 24: /* memberDecl: %empty  */
+#line 221 "tma3.y"
+                                    { (yyval.node) = createNode(cc, "memberDecl", ""); }
+#line 1938 "y.tab.c"
+    break;
+
+  case 25: /* implDef: IMPLEMENT optId LEFTBRACE funcDefList RIGHTBRACE  */
+#line 225 "tma3.y"
+                                                     {
+        (yyval.node) = lalr_node(cc, "implDef", (yyvsp[-3].node), (yyvsp[-1].list).head, NULL);
     }
+#line 1946 "y.tab.c"
     break;
 
+  case 26: /* funcDefList: %empty  */
+#line 231 "tma3.y"
+                            { list_begin(cc, &(yyval.list), "funcDefList"); }
+#line 1952 "y.tab.c"
+    break;
 
+  case 27: /* funcDefList: funcDefList funcDef  */
+#line 232 "tma3.y"
+                            { (yyval.list) = (yyvsp[-1].list); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 1958 "y.tab.c"
+    break;
+
+  case 28: /* funcDef: funcHead  */
+#line 237 "tma3.y"
+                        { (yyval.node) = lalr_node(cc, "funcDef", (yyvsp[0].node), createNode(cc, "funcBody", ""), NULL); }
+#line 1964 "y.tab.c"
+    break;
+
+  case 29: /* funcDef: funcHead funcBody  */
+#line 238 "tma3.y"
+                        { (yyval.node) = lalr_node(cc, "funcDef", (yyvsp[-1].node), (yyvsp[0].node), NULL); }
+#line 1970 "y.tab.c"
+    break;
+
+  case 30: /* funcHead: FUNC optId LEFTPAREN fParams RIGHTPAREN ARROW returnType  */
+#line 242 "tma3.y"
+                                                             {
+        (yyval.node) = lalr_node(cc, "funcHead", (yyvsp[-5].node), (yyvsp[-3].node), (yyvsp[0].node));
+    }
+#line 1978 "y.tab.c"
+    break;
+
+  case 31: /* funcHead: CONSTRUCT LEFTPAREN fParams RIGHTPAREN  */
+#line 245 "tma3.y"
+                                             {
+        (yyval.node) = lalr_node(cc, "funcHead", (yyvsp[-1].node), NULL, NULL);
+    }
+#line 1986 "y.tab.c"
+    break;
+
+  case 32: /* funcBody: LEFTBRACE varDeclOrStmtList RIGHTBRACE  */
+#line 251 "tma3.y"
+                                           { (yyval.node) = lalr_node(cc, "funcBody", (yyvsp[-1].list).head, NULL, NULL); }
+#line 1992 "y.tab.c"
+    break;
+
+  case 33: /* varDeclOrStmtList: %empty  */
+#line 255 "tma3.y"
+                                        { list_begin(cc, &(yyval.list), "varDeclOrStmtList"); }
+#line 1998 "y.tab.c"
+    break;
+
+  case 34: /* varDeclOrStmtList: varDeclOrStmtList varDeclOrStmt  */
+#line 256 "tma3.y"
+                                        { (yyval.list) = (yyvsp[-1].list); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 2004 "y.tab.c"
+    break;
+
+  case 35: /* varDeclOrStmt: LOCAL varDecl  */
+#line 260 "tma3.y"
+                  {
+        (yyval.node) = lalr_node(cc, "varDeclOrStmt", lalr_node(cc, "localVarDecl", (yyvsp[0].node), NULL, NULL), NULL, NULL);
+    }
+#line 2012 "y.tab.c"
+    break;
+
+  case 36: /* varDeclOrStmt: statement  */
+#line 263 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "varDeclOrStmt", (yyvsp[0].node), NULL, NULL); }
+#line 2018 "y.tab.c"
+    break;
+
+  case 37: /* varDecl: %empty  */
+#line 267 "tma3.y"
+           { (yyval.node) = createNode(cc, "varDecl", ""); }
+#line 2024 "y.tab.c"
+    break;
+
+  case 38: /* varDecl: ID COLON type arraySizeList SEMICOLON  */
+#line 268 "tma3.y"
+                                            {
+        (yyval.node) = lalr_node(cc, "varDecl", lalr_id(cc, (yyvsp[-4].token)), (yyvsp[-2].node), (yyvsp[-1].list).head);
+    }
+#line 2032 "y.tab.c"
+    break;
+
+  case 39: /* statement: assignStat SEMICOLON  */
+#line 274 "tma3.y"
+                         { (yyval.node) = lalr_node(cc, "statement", (yyvsp[-1].node), NULL, NULL); }
+#line 2038 "y.tab.c"
+    break;
+
+  case 40: /* statement: IF LEFTPAREN relExpr RIGHTPAREN THEN statBlock ELSE statBlock SEMICOLON  */
+#line 275 "tma3.y"
+                                                                              {
+        (yyval.node) = lalr_node(cc, "statement", createNode(cc, "if", ""), (yyvsp[-6].node), (yyvsp[-3].node));
+        addChild((yyval.node), (yyvsp[-1].node));
+    }
+#line 2047 "y.tab.c"
+    break;
+
+  case 41: /* statement: WHILE LEFTPAREN relExpr RIGHTPAREN statBlock SEMICOLON  */
+#line 279 "tma3.y"
+                                                             {
+        (yyval.node) = lalr_node(cc, "statement", createNode(cc, "while", ""), (yyvsp[-3].node), (yyvsp[-1].node));
+    }
+#line 2055 "y.tab.c"
+    break;
+
+  case 42: /* statement: READ LEFTPAREN readVariable RIGHTPAREN SEMICOLON  */
+#line 282 "tma3.y"
+                                                       {
+        (yyval.node) = lalr_node(cc, "statement", createNode(cc, "read", ""), (yyvsp[-2].node), NULL);
+    }
+#line 2063 "y.tab.c"
+    break;
+
+  case 43: /* statement: WRITE LEFTPAREN expr RIGHTPAREN SEMICOLON  */
+#line 285 "tma3.y"
+                                                {
+        (yyval.node) = lalr_node(cc, "statement", createNode(cc, "write", ""), (yyvsp[-2].node), NULL);
+    }
+#line 2071 "y.tab.c"
+    break;
+
+  case 44: /* statement: RETURN LEFTPAREN expr RIGHTPAREN SEMICOLON  */
+#line 288 "tma3.y"
+                                                 {
+        (yyval.node) = lalr_node(cc, "statement", createNode(cc, "return", ""), (yyvsp[-2].node), NULL);
+    }
+#line 2079 "y.tab.c"
+    break;
+
+  case 45: /* statBlock: LEFTBRACE statmentList RIGHTBRACE  */
+#line 294 "tma3.y"
+                                        { (yyval.node) = lalr_node(cc, "statBlock", (yyvsp[-1].list).head, NULL, NULL); }
+#line 2085 "y.tab.c"
+    break;
+
+  case 46: /* statBlock: statement  */
+#line 295 "tma3.y"
+                                        { (yyval.node) = lalr_node(cc, "statBlock", (yyvsp[0].node), NULL, NULL); }
+#line 2091 "y.tab.c"
+    break;
+
+  case 47: /* statBlock: %empty  */
+#line 296 "tma3.y"
+                                        { (yyval.node) = lalr_node(cc, "statBlock", createNode(cc, "statement", ""), NULL, NULL); }
+#line 2097 "y.tab.c"
+    break;
+
+  case 48: /* statmentList: %empty  */
+#line 300 "tma3.y"
+                                { list_begin(cc, &(yyval.list), "statmentList"); }
+#line 2103 "y.tab.c"
+    break;
+
+  case 49: /* statmentList: statmentList statement  */
+#line 301 "tma3.y"
+                                { (yyval.list) = (yyvsp[-1].list); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 2109 "y.tab.c"
+    break;
+
+  case 50: /* assignStat: variable assignOp expr  */
+#line 306 "tma3.y"
+                           { (yyval.node) = lalr_node(cc, "assignStat", (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 2115 "y.tab.c"
+    break;
+
+  case 51: /* assignOp: %empty  */
+#line 310 "tma3.y"
+                { (yyval.node) = createNode(cc, "assignOp", ""); }
+#line 2121 "y.tab.c"
+    break;
+
+  case 52: /* assignOp: ASSIGN  */
+#line 311 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "assignOp", createNode(cc, ":=", ""), NULL, NULL); }
+#line 2127 "y.tab.c"
+    break;
+
+  case 53: /* expr: %empty  */
+#line 317 "tma3.y"
+                { (yyval.node) = createNode(cc, "expr", ""); }
+#line 2133 "y.tab.c"
+    break;
+
+  case 54: /* expr: relArith  */
+#line 318 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "expr", (yyvsp[0].node), NULL, NULL); }
+#line 2139 "y.tab.c"
+    break;
+
+  case 55: /* relExpr: %empty  */
+#line 322 "tma3.y"
+                { (yyval.node) = createNode(cc, "relExpr", ""); }
+#line 2145 "y.tab.c"
+    break;
+
+  case 56: /* relExpr: relArith  */
+#line 323 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "relExpr", (yyvsp[0].node), NULL, NULL); }
+#line 2151 "y.tab.c"
+    break;
+
+  case 58: /* relArith: arithExpr relOp arithExpr  */
+#line 328 "tma3.y"
+                                { (yyval.node) = (yyvsp[-1].node); addChild((yyval.node), (yyvsp[-2].node)); addChild((yyval.node), (yyvsp[0].node)); }
+#line 2157 "y.tab.c"
+    break;
+
+  case 60: /* arithExpr: arithExpr addOp term  */
+#line 333 "tma3.y"
+                           { (yyval.node) = (yyvsp[-1].node); addChild((yyval.node), (yyvsp[-2].node)); addChild((yyval.node), (yyvsp[0].node)); }
+#line 2163 "y.tab.c"
+    break;
+
+  case 62: /* term: term multOp factor  */
+#line 338 "tma3.y"
+                         { (yyval.node) = (yyvsp[-1].node); addChild((yyval.node), (yyvsp[-2].node)); addChild((yyval.node), (yyvsp[0].node)); }
+#line 2169 "y.tab.c"
+    break;
+
+  case 64: /* factor: INTEGER_LITERAL  */
+#line 343 "tma3.y"
+                                        { (yyval.node) = lalr_literal(cc, "intLit", (yyvsp[0].token)); }
+#line 2175 "y.tab.c"
+    break;
+
+  case 65: /* factor: FLOAT_LITERAL  */
+#line 344 "tma3.y"
+                                        { (yyval.node) = lalr_literal(cc, "floatLit", (yyvsp[0].token)); }
+#line 2181 "y.tab.c"
+    break;
+
+  case 66: /* factor: LEFTPAREN arithExpr RIGHTPAREN  */
+#line 345 "tma3.y"
+                                        { (yyval.node) = (yyvsp[-1].node); }
+#line 2187 "y.tab.c"
+    break;
+
+  case 67: /* factor: NOT factor  */
+#line 346 "tma3.y"
+                                        { (yyval.node) = lalr_node(cc, "not", (yyvsp[0].node), NULL, NULL); }
+#line 2193 "y.tab.c"
+    break;
+
+  case 68: /* factor: PLUS factor  */
+#line 347 "tma3.y"
+                                        { (yyval.node) = lalr_node(cc, "pos", (yyvsp[0].node), NULL, NULL); }
+#line 2199 "y.tab.c"
+    break;
+
+  case 69: /* factor: MINUS factor  */
+#line 348 "tma3.y"
+                                        { (yyval.node) = lalr_node(cc, "neg", (yyvsp[0].node), NULL, NULL); }
+#line 2205 "y.tab.c"
+    break;
+
+  case 70: /* relOp: LESS  */
+#line 352 "tma3.y"
+                { (yyval.node) = createNode(cc, "<", ""); }
+#line 2211 "y.tab.c"
+    break;
+
+  case 71: /* relOp: GREATER  */
+#line 353 "tma3.y"
+                { (yyval.node) = createNode(cc, ">", ""); }
+#line 2217 "y.tab.c"
+    break;
+
+  case 72: /* relOp: LOEQ  */
+#line 354 "tma3.y"
+                { (yyval.node) = createNode(cc, "<=", ""); }
+#line 2223 "y.tab.c"
+    break;
+
+  case 73: /* relOp: GOEQ  */
+#line 355 "tma3.y"
+                { (yyval.node) = createNode(cc, ">=", ""); }
+#line 2229 "y.tab.c"
+    break;
+
+  case 74: /* relOp: NEQ  */
+#line 356 "tma3.y"
+                { (yyval.node) = createNode(cc, "<>", ""); }
+#line 2235 "y.tab.c"
+    break;
+
+  case 75: /* addOp: PLUS  */
+#line 360 "tma3.y"
+                { (yyval.node) = createNode(cc, "+", ""); }
+#line 2241 "y.tab.c"
+    break;
+
+  case 76: /* addOp: MINUS  */
+#line 361 "tma3.y"
+                { (yyval.node) = createNode(cc, "-", ""); }
+#line 2247 "y.tab.c"
+    break;
+
+  case 77: /* addOp: OR  */
+#line 362 "tma3.y"
+                { (yyval.node) = createNode(cc, "or", ""); }
+#line 2253 "y.tab.c"
+    break;
+
+  case 78: /* multOp: MULTIPLY  */
+#line 366 "tma3.y"
+                { (yyval.node) = createNode(cc, "*", ""); }
+#line 2259 "y.tab.c"
+    break;
+
+  case 79: /* multOp: DIVIDE  */
+#line 367 "tma3.y"
+                { (yyval.node) = createNode(cc, "/", ""); }
+#line 2265 "y.tab.c"
+    break;
+
+  case 80: /* multOp: AND  */
+#line 368 "tma3.y"
+                { (yyval.node) = createNode(cc, "and", ""); }
+#line 2271 "y.tab.c"
+    break;
+
+  case 81: /* variable: idnestList indiceList  */
+#line 373 "tma3.y"
+                          { (yyval.node) = lalr_node(cc, "variable", (yyvsp[-1].list).head, (yyvsp[0].list).head, NULL); }
+#line 2277 "y.tab.c"
+    break;
+
+  case 83: /* readVariable: indiceList  */
+#line 379 "tma3.y"
+                 { (yyval.node) = lalr_node(cc, "variable", createNode(cc, "idnestList", ""), (yyvsp[0].list).head, NULL); }
+#line 2283 "y.tab.c"
+    break;
+
+  case 84: /* idnestList: idnest  */
+#line 383 "tma3.y"
+                        { list_begin(cc, &(yyval.list), "idnestList"); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 2289 "y.tab.c"
+    break;
+
+  case 85: /* idnestList: idnestList idnest  */
+#line 384 "tma3.y"
+                        { (yyval.list) = (yyvsp[-1].list); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 2295 "y.tab.c"
+    break;
+
+  case 86: /* idnest: idOrSelf idnestTail  */
+#line 388 "tma3.y"
+                        { (yyval.node) = lalr_node(cc, "idnest", (yyvsp[-1].node), (yyvsp[0].node), NULL); }
+#line 2301 "y.tab.c"
+    break;
+
+  case 87: /* idOrSelf: ID  */
+#line 392 "tma3.y"
+            { (yyval.node) = lalr_node(cc, "idOrSelf", lalr_id(cc, (yyvsp[0].token)), NULL, NULL); }
+#line 2307 "y.tab.c"
+    break;
+
+  case 88: /* idOrSelf: SELF  */
+#line 393 "tma3.y"
+            { (yyval.node) = lalr_node(cc, "idOrSelf", createNodeWithId(cc, "SELF", cc->self_id), NULL, NULL); }
+#line 2313 "y.tab.c"
+    break;
+
+  case 89: /* idnestTail: %empty  */
+#line 397 "tma3.y"
+                                                { (yyval.node) = createNode(cc, "idnestTail", ""); }
+#line 2319 "y.tab.c"
+    break;
+
+  case 90: /* idnestTail: someIndices optDot  */
+#line 398 "tma3.y"
+                                                { (yyval.node) = lalr_node(cc, "idnestTail", (yyvsp[-1].list).head, NULL, NULL); }
+#line 2325 "y.tab.c"
+    break;
+
+  case 91: /* idnestTail: LEFTPAREN aParams RIGHTPAREN optDot  */
+#line 399 "tma3.y"
+                                                { (yyval.node) = lalr_node(cc, "idnestTail", (yyvsp[-2].node), NULL, NULL); }
+#line 2331 "y.tab.c"
+    break;
+
+  case 94: /* indiceList: %empty  */
+#line 408 "tma3.y"
+                            { list_begin(cc, &(yyval.list), "indiceList"); }
+#line 2337 "y.tab.c"
+    break;
+
+  case 96: /* someIndices: indice  */
+#line 413 "tma3.y"
+                            { list_begin(cc, &(yyval.list), "indiceList"); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 2343 "y.tab.c"
+    break;
+
+  case 97: /* someIndices: someIndices indice  */
+#line 414 "tma3.y"
+                            { (yyval.list) = (yyvsp[-1].list); list_next(cc, &(yyval.list), (yyvsp[0].node), NULL); }
+#line 2349 "y.tab.c"
+    break;
+
+  case 98: /* indice: LEFTBRACKET optArith RIGHTBRACKET  */
+#line 418 "tma3.y"
+                                      { (yyval.node) = lalr_node(cc, "indice", (yyvsp[-1].node), NULL, NULL); }
+#line 2355 "y.tab.c"
+    break;
+
+  case 99: /* optArith: %empty  */
+#line 422 "tma3.y"
+           { (yyval.node) = NULL; }
+#line 2361 "y.tab.c"
+    break;
+
+  case 101: /* aParams: %empty  */
+#line 427 "tma3.y"
+           { (yyval.node) = createNode(cc, "aParams", ""); }
+#line 2367 "y.tab.c"
+    break;
+
+  case 102: /* aParams: relArith aParamsTailList  */
+#line 428 "tma3.y"
+                               {
+        (yyval.node) = lalr_node(cc, "aParams", lalr_node(cc, "expr", (yyvsp[-1].node), NULL, NULL), (yyvsp[0].list).head, NULL);
+    }
+#line 2375 "y.tab.c"
+    break;
+
+  case 103: /* aParamsTailList: %empty  */
+#line 434 "tma3.y"
+                                    { list_begin(cc, &(yyval.list), "aParamsTailList"); }
+#line 2381 "y.tab.c"
+    break;
+
+  case 104: /* aParamsTailList: aParamsTailList COMMA expr  */
+#line 435 "tma3.y"
+                                    { (yyval.list) = (yyvsp[-2].list); list_next(cc, &(yyval.list), lalr_node(cc, "aParamsTail", (yyvsp[0].node), NULL, NULL), NULL); }
+#line 2387 "y.tab.c"
+    break;
+
+  case 105: /* arraySizeList: %empty  */
+#line 440 "tma3.y"
+           { list_begin(cc, &(yyval.list), "arraySizeList"); }
+#line 2393 "y.tab.c"
+    break;
+
+  case 106: /* arraySizeList: arraySizeList LEFTBRACKET optIntLit RIGHTBRACKET  */
+#line 441 "tma3.y"
+                                                       {
+        (yyval.list) = (yyvsp[-3].list);
+        list_next(cc, &(yyval.list), lalr_node(cc, "arraySize", (yyvsp[-1].node), NULL, NULL), NULL);
+    }
+#line 2402 "y.tab.c"
+    break;
+
+  case 107: /* optIntLit: %empty  */
+#line 448 "tma3.y"
+                        { (yyval.node) = NULL; }
+#line 2408 "y.tab.c"
+    break;
+
+  case 108: /* optIntLit: INTEGER_LITERAL  */
+#line 449 "tma3.y"
+                        { (yyval.node) = lalr_literal(cc, "intLit", (yyvsp[0].token)); }
+#line 2414 "y.tab.c"
+    break;
+
+  case 109: /* type: %empty  */
+#line 453 "tma3.y"
+                { (yyval.node) = createNode(cc, "type", ""); }
+#line 2420 "y.tab.c"
+    break;
+
+  case 110: /* type: INTEGER  */
+#line 454 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "type", createNode(cc, "integer", ""), NULL, NULL); }
+#line 2426 "y.tab.c"
+    break;
+
+  case 111: /* type: FLOAT  */
+#line 455 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "type", createNode(cc, "float", ""), NULL, NULL); }
+#line 2432 "y.tab.c"
+    break;
+
+  case 112: /* type: ID  */
+#line 456 "tma3.y"
+                { (yyval.node) = lalr_node(cc, "type", lalr_id(cc, (yyvsp[0].token)), NULL, NULL); }
+#line 2438 "y.tab.c"
+    break;
+
+  case 113: /* returnType: VOID  */
+#line 460 "tma3.y"
+            { (yyval.node) = lalr_node(cc, "returnType", createNode(cc, "void", ""), NULL, NULL); }
+#line 2444 "y.tab.c"
+    break;
+
+  case 114: /* returnType: type  */
+#line 461 "tma3.y"
+            { (yyval.node) = lalr_node(cc, "returnType", (yyvsp[0].node), NULL, NULL); }
+#line 2450 "y.tab.c"
+    break;
+
+  case 115: /* fParams: %empty  */
+#line 465 "tma3.y"
+           { (yyval.node) = createNode(cc, "fParams", ""); }
+#line 2456 "y.tab.c"
+    break;
+
+  case 116: /* fParams: ID COLON type arraySizeList fParamsTailList  */
+#line 466 "tma3.y"
+                                                  {
+        (yyval.node) = lalr_node(cc, "fParams", lalr_id(cc, (yyvsp[-4].token)), (yyvsp[-2].node), (yyvsp[-1].list).head);
+        addChild((yyval.node), (yyvsp[0].list).head);
+    }
+#line 2465 "y.tab.c"
+    break;
+
+  case 117: /* fParamsTailList: %empty  */
+#line 473 "tma3.y"
+           { list_begin(cc, &(yyval.list), "fParamsTailList"); }
+#line 2471 "y.tab.c"
+    break;
+
+  case 118: /* fParamsTailList: fParamsTailList COMMA optId COLON type arraySizeList  */
+#line 474 "tma3.y"
+                                                           {
+        (yyval.list) = (yyvsp[-5].list);
+        ASTNode* tail = lalr_node(cc, "fParamsTail", (yyvsp[-3].node), (yyvsp[-1].node), (yyvsp[0].list).head);
+        list_next(cc, &(yyval.list), tail, NULL);
+    }
+#line 2481 "y.tab.c"
+    break;
+
+
+#line 2485 "y.tab.c"
 
-/* Line 1455 of yacc.c  */
-#line 1487 "y.tab.c"
       default: break;
     }
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (YY_("syntax error"));
-#else
       {
-	YYSIZE_T yysize = yysyntax_error (0, yystate, yychar);
-	if (yymsg_alloc < yysize && yymsg_alloc < YYSTACK_ALLOC_MAXIMUM)
-	  {
-	    YYSIZE_T yyalloc = 2 * yysize;
-	    if (! (yysize <= yyalloc && yyalloc <= YYSTACK_ALLOC_MAXIMUM))
-	      yyalloc = YYSTACK_ALLOC_MAXIMUM;
-	    if (yymsg != yymsgbuf)
-	      YYSTACK_FREE (yymsg);
-	    yymsg = (char *) YYSTACK_ALLOC (yyalloc);
-	    if (yymsg)
-	      yymsg_alloc = yyalloc;
-	    else
-	      {
-		yymsg = yymsgbuf;
-		yymsg_alloc = sizeof yymsgbuf;
-	      }
-	  }
-
-	if (0 < yysize && yysize <= yymsg_alloc)
-	  {
-	    (void) yysyntax_error (yymsg, yystate, yychar);
-	    yyerror (yymsg);
-	  }
-	else
-	  {
-	    yyerror (YY_("syntax error"));
-	    if (yysize != 0)
-	      goto yyexhaustedlab;
-	  }
+        yypcontext_t yyctx
+          = {yyssp, yytoken};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (cc, lp, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
-	 error, discard it.  */
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, cc, lp);
+          yychar = YYEMPTY;
+        }
     }
 
   /* Else will try to reuse lookahead token after shifting the error
@@ -1584,14 +2589,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -1604,39 +2608,42 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
-      if (yyn != YYPACT_NINF)
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
 
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, cc, lp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
     }
 
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -1647,58 +2654,145 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
-#if !defined(yyoverflow) || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
+  yyerror (cc, lp, YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
-     yydestruct ("Cleanup: discarding lookahead",
-		 yytoken, &yylval);
-  /* Do not reclaim the symbols of the rule which action triggered
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, cc, lp);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, cc, lp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
+  return yyresult;
 }
 
+#line 481 "tma3.y"
+
+
+int main(int argc, char** argv) {
+    // options: --log=SPEC (see log.h), --nested-comments, --scanner=flex|simd|check,
+    // --lex-threads=N, --pipeline, --token-cache=DIR, --derivation=text|binary|ring,
+    // --parser=rd|table|lalr, --syntax-only, --parse-threads=N, --tree=text|json|binary,
+    // --save-ast=FILE, --load-ast=FILE (instead of a source), --incremental=FILE,
+    // --serve=SOCKET (compile server, see server.h), anything else is the source path
+    const char* source_path = NULL;
+    const char* snapshot_path = NULL;
+    const char* serve_path = NULL;
+    int tree_format = TREE_TEXT;
+    log_init();
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--log=", 6) == 0) {
+            if (log_configure(argv[i] + 6) != 0) return 1;
+        } else if (strcmp(argv[i], "--nested-comments") == 0) {
+            lex_nested_comments = 1;
+        } else if (strncmp(argv[i], "--scanner=", 10) == 0) {
+            const char* s = argv[i] + 10;
+            if (strcmp(s, "flex") == 0) lex_scanner = SCANNER_FLEX;
+            else if (strcmp(s, "simd") == 0) lex_scanner = SCANNER_SIMD;
+            else if (strcmp(s, "check") == 0) lex_scanner = SCANNER_CHECK;
+            else {
+                printf("Error:: unknown scanner '%s' (flex, simd, check)\n", s);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--token-cache=", 14) == 0) {
+            token_cache_dir = argv[i] + 14;
+        } else if (strncmp(argv[i], "--derivation=", 13) == 0) {
+            const char* d = argv[i] + 13;
+            if (strcmp(d, "text") == 0) derivation_mode = DERIVATION_TEXT;
+            else if (strcmp(d, "binary") == 0) derivation_mode = DERIVATION_BINARY;
+            else if (strcmp(d, "ring") == 0) derivation_mode = DERIVATION_RING;
+            else {
+                printf("Error:: unknown derivation mode '%s' (text, binary, ring)\n", d);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--parser=", 9) == 0) {
+            const char* e = argv[i] + 9;
+            if (strcmp(e, "rd") == 0) parser_engine = PARSER_RECURSIVE;
+            else if (strcmp(e, "table") == 0) parser_engine = PARSER_TABLE;
+            else if (strcmp(e, "lalr") == 0) parser_engine = PARSER_LALR;
+            else {
+                printf("Error:: unknown parser '%s' (rd, table, lalr)\n", e);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--tree=", 7) == 0) {
+            const char* t = argv[i] + 7;
+            if (strcmp(t, "text") == 0) tree_format = TREE_TEXT;
+            else if (strcmp(t, "json") == 0) tree_format = TREE_NDJSON;
+            else if (strcmp(t, "binary") == 0) tree_format = TREE_BINARY;
+            else {
+                printf("Error:: unknown tree format '%s' (text, json, binary)\n", t);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--save-ast=", 11) == 0) {
+            ast_snapshot_save_path = argv[i] + 11;
+        } else if (strncmp(argv[i], "--incremental=", 14) == 0) {
+            func_cache_path = argv[i] + 14;
+        } else if (strncmp(argv[i], "--serve=", 8) == 0) {
+            serve_path = argv[i] + 8;
+        } else if (strncmp(argv[i], "--load-ast=", 11) == 0) {
+            snapshot_path = argv[i] + 11;
+        } else if (strcmp(argv[i], "--syntax-only") == 0) {
+            parser_syntax_only = 1;
+        } else if (strncmp(argv[i], "--parse-threads=", 16) == 0) {
+            // top-level units on N threads (recursive descent parser); 0 = one per CPU
+            parse_threads = atoi(argv[i] + 16);
+            if (parse_threads <= 0) parse_threads = simd_scan_cpu_count();
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            lex_pipeline = 1;
+        } else if (strncmp(argv[i], "--lex-threads=", 14) == 0) {
+            // large sources are scanned in chunks, each on its own thread with its
+            // own scanner (flex or simd); 0 = one thread per CPU
+            lex_threads = atoi(argv[i] + 14);
+            if (lex_threads <= 0) lex_threads = simd_scan_cpu_count();
+        } else {
+            source_path = argv[i];
+        }
+    }
 
+    if (lex_pipeline && lex_threads > 1) {
+        printf("Error:: --pipeline lexes on one thread; it cannot be combined with --lex-threads\n");
+        return 1;
+    }
 
-/* Line 1675 of yacc.c  */
-#line 67 "tma3.y"
-
-
-int main() {
     printf("======================================\n");
     printf("EEX6363 - Compiler Construction.\n");
     printf("Name: W.M.A.T.Wanninayake.\n");
@@ -1708,16 +2802,164 @@ int main() {
     printf("Running Lexical Analyzer with Recursive Descent Parser:\n");
     printf("Program flow: Input Text > Lex > Tokens > Recursive Descent Parser > Derivation\n");
 
-    ASTNode* root = parse_program();
-    (void)root;
+    if (serve_path) {
+        // the function cache reads object_code.txt back from disk
+        if (func_cache_path) {
+            printf("Error:: --incremental cannot be combined with --serve\n");
+            return 1;
+        }
+        compiler_init();
+        return server_run(serve_path, tree_format);
+    }
+
+    // whole source is loaded once (mapped when a path is given) and scanned in place
+    SourceBuffer src = {0};
+    int rc = snapshot_path ? 0 : source_path ? source_open(&src, source_path) : source_read_stream(&src, stdin);
+    if (rc != 0) {
+        printf("Error:: Cannot read source %s\n", source_path ? source_path : "from stdin");
+        return 1;
+    }
+
+    // everything the compilation builds lives in its context (compiler.h)
+    compiler_init();
+    CompilerContext* cc = compiler_create("files");
+    cc->tree_format = tree_format;
+    ASTNode* root = snapshot_path ? compiler_run_snapshot(cc, snapshot_path) : compiler_run(cc, src.data, src.length);
+    if (snapshot_path && !root) {
+        compiler_free(cc);
+        return 1;
+    }
     //print root
     printf("root: %d", root);
 
     printf("Program analysis completed.\n");
-    print_symbols();
-    return 0;
+    print_symbols(cc);
+    // whole tree (and the types semantic analysis hung off it) goes in one step
+    LOG_DEBUG(LOG_PARSER, "AST arena: %zu nodes\n", ast_node_count(cc));
+    int failed = cc->syntax_error_count > 0;
+    compiler_free(cc);
+    source_close(&src);
+    return failed;
 }
 
-void yyerror(const char* s) {
-    printf("ERROR OCCURRED:: %s at line %d\n", s, lineno);
+// ====== tokens for the LALR parser =====
+// the current token is handed out and the position only moves on when the
+// next one is asked for, so once yyparse returns the lookahead is the token
+// it stopped at, as after the recursive descent functions. EXIT and
+// PRINT_SYMBOLS are handled the way match() handles them.
+static int lalr_lex(YYSTYPE* lval, CompilerContext* cc, LalrParse* lp) {
+    if (lp->started) advance_token(cc);
+    lp->started = 1;
+    if (lookahead_token == EXIT) {
+        printf("Parser:: EXIT.\n");
+        tokens_drain(cc, &cc->token_stream);
+        print_symbols(cc);
+        compiler_exit(cc, 0);
+    }
+    if (lookahead_token == PRINT_SYMBOLS) {
+        printf("Parser:: PRINT_SYMBOLS.\n");
+        tokens_drain(cc, &cc->token_stream);
+        print_symbols(cc);
+        advance_token(cc);
+    }
+    lval->token = token_pos;
+    return lookahead_token;
+}
+
+// like the table parser, the first syntax error ends the parse
+static void yyerror(CompilerContext* cc, LalrParse* lp, const char* message) {
+    (void)lp;
+    error(cc, (char*)message);
+}
+
+// ====== derivation steps, in recursive descent order =====
+// Bison reduces bottom-up, so the steps are written afterwards from the
+// finished tree in one preorder walk: each node says which step its parser.c
+// function writes. memberDecl writes funcDecl / funcDef between its head and
+// its body, so it replays the head on its own first.
+static AstVisitResult replay_pre(AstWalk* w, ASTNode* node, void* frame) {
+    (void)frame;
+    AstVisitor head = { replay_pre, NULL, 0, ast_walk_user(w) };
+    LalrParse* lp = (LalrParse*)head.user;
+    CompilerContext* cc = lp->cc;
+    ASTNode* c = node->child;
+    switch (node->kind) {
+    case AST_PROG:                  write_derivation(cc, RULE_PROG); break;
+    case AST_CLASSORIMPLORFUNCLIST: write_derivation(cc, c ? RULE_CLASSORIMPLORFUNCLIST_ITEM : RULE_CLASSORIMPLORFUNCLIST_EMPTY); break;
+    case AST_CLASSORIMPLORFUNC:
+        if (c->kind == AST_CLASSDECL) write_derivation(cc, RULE_CLASSORIMPLORFUNC_CLASSDECL);
+        else if (c->kind == AST_IMPLDEF) write_derivation(cc, RULE_CLASSORIMPLORFUNC_IMPLDEF);
+        else write_derivation(cc, RULE_CLASSORIMPLORFUNC_FUNCDEF);
+        break;
+    case AST_CLASSDECL:             write_derivation(cc, RULE_CLASSDECL); break;
+    case AST_IMPLDEF:               write_derivation(cc, RULE_IMPLDEF); break;
+    case AST_FUNCDEF:               write_derivation(cc, RULE_FUNCDEF); break;
+    case AST_VISIBILITY:            write_derivation(cc, c->kind == AST_PUBLIC ? RULE_VISIBILITY_PUBLIC : RULE_VISIBILITY_PRIVATE); break;
+    case AST_MEMBERDECL:
+        if (!c) {
+            for (int i = 0; i < lp->dropped_count; i += 2)
+                if (lp->dropped[i] == node) ast_walk(&head, lp->dropped[i + 1], NULL);
+        } else if (c->kind == AST_ATTRIBUTEDECL) {
+            write_derivation(cc, RULE_MEMBERDECL_ATTRIBUTEDECL);
+        } else {
+            ast_walk(&head, c, NULL);
+            write_derivation(cc, c->sibling ? RULE_MEMBERDECL_FUNCDEF : RULE_MEMBERDECL_FUNCDECL);
+            ast_walk_push(w, c->sibling, NULL);
+            return AST_VISIT_SKIP;
+        }
+        break;
+    case AST_FUNCHEAD: {
+        int rule = RULE_FUNCHEAD_CONSTRUCTOR;
+        for (ASTNode* n = c; n; n = n->sibling)
+            if (n->kind == AST_RETURNTYPE) rule = RULE_FUNCHEAD_FUNC;
+        write_derivation(cc, rule);
+        break;
+    }
+    case AST_FUNCBODY:              if (c) write_derivation(cc, RULE_FUNCBODY); break;
+    case AST_VARDECLORSTMT:         write_derivation(cc, c->kind == AST_LOCALVARDECL ? RULE_VARDECLORSTMT_LOCALVARDECL : RULE_VARDECLORSTMT_STATEMENT); break;
+    case AST_LOCALVARDECL:          write_derivation(cc, RULE_LOCALVARDECL); break;
+    case AST_ATTRIBUTEDECL:         write_derivation(cc, RULE_ATTRIBUTEDECL); break;
+    case AST_STATEMENT:
+        if (!c) break;
+        switch (c->kind) {
+        case AST_ASSIGNSTAT: write_derivation(cc, RULE_STATEMENT_ASSIGN); break;
+        case AST_IF:         write_derivation(cc, RULE_STATEMENT_IF); break;
+        case AST_WHILE:      write_derivation(cc, RULE_STATEMENT_WHILE); break;
+        case AST_READ:       write_derivation(cc, RULE_STATEMENT_READ); break;
+        case AST_WRITE:      write_derivation(cc, RULE_STATEMENT_WRITE); break;
+        default:             write_derivation(cc, RULE_STATEMENT_RETURN); break;
+        }
+        break;
+    case AST_STATBLOCK:             if (c->kind == AST_STATMENTLIST) write_derivation(cc, RULE_STATBLOCK); break;
+    case AST_ASSIGNSTAT:            write_derivation(cc, RULE_ASSIGNSTAT); break;
+    case AST_ASSIGNOP:              if (c) write_derivation(cc, RULE_ASSIGNOP); break;
+    case AST_RELEXPR:               write_derivation(cc, RULE_RELEXPR); break;
+    case AST_INDICE:                write_derivation(cc, RULE_INDICE); break;
+    case AST_VARIABLE:              write_derivation(cc, RULE_VARIABLE); break;
+    case AST_ARRAYSIZELIST:         write_derivation(cc, c ? RULE_ARRAYSIZELIST_ITEM : RULE_ARRAYSIZELIST_EMPTY); break;
+    case AST_ARRAYSIZE:             write_derivation(cc, RULE_ARRAYSIZE); break;
+    case AST_FPARAMSTAILLIST:       write_derivation(cc, c ? RULE_FPARAMSTAILLIST_ITEM : RULE_FPARAMSTAILLIST_EMPTY); break;
+    case AST_FPARAMSTAIL:           write_derivation(cc, RULE_FPARAMSTAIL); break;
+    case AST_IDTAIL:                write_derivation(cc, c ? RULE_IDTAIL : RULE_IDTAIL_EMPTY); break;
+    case AST_ISAIDOPT:              write_derivation(cc, c ? RULE_ISAIDOPT : RULE_ISAIDOPT_EMPTY); break;
+    default: break;
+    }
+    return AST_VISIT_CHILDREN;
+}
+
+// ====== driver for --parser=lalr, called by parse_program =====
+ASTNode* lalr_parse(CompilerContext* cc) {
+    LalrParse lp;
+    memset(&lp, 0, sizeof(lp));
+    lp.cc = cc;
+    yyparse(cc, &lp);   // a syntax error ends in error(), which does not come back
+
+    // the ring only matters for the context of a syntax error, and the
+    // replay comes after the last one could have happened
+    if (derivation_mode != DERIVATION_RING) {
+        AstVisitor replay = { replay_pre, NULL, 0, &lp };
+        ast_walk(&replay, lp.root, NULL);
+    }
+    free(lp.dropped);
+    return lp.root;
 }